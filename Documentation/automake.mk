@@ -26,6 +26,7 @@ DOC_SOURCE = \
 	Documentation/topics/index.rst \
 	Documentation/topics/testing.rst \
 	Documentation/topics/test-development.rst \
+	Documentation/topics/usdt-probes.rst \
 	Documentation/topics/high-availability.rst \
 	Documentation/topics/incremental-processing/datapath-sync-graph.png \
 	Documentation/topics/incremental-processing/evpn-arp-graph.png \
@@ -28,6 +28,8 @@ controller_ovn_controller_SOURCES = \
 	controller/lflow.h \
 	controller/lflow-cache.c \
 	controller/lflow-cache.h \
+	controller/lflow-profile.c \
+	controller/lflow-profile.h \
 	controller/lport.c \
 	controller/lport.h \
 	controller/ofctrl.c \
@@ -70,7 +72,11 @@ controller_ovn_controller_SOURCES = \
 	controller/garp_rarp.c \
 	controller/neighbor-exchange.h \
 	controller/neighbor-table-notify.h \
-	controller/host-if-monitor.h
+	controller/host-if-monitor.h \
+	controller/controller-bench.c \
+	controller/controller-bench.h \
+	lib/bench-ovsdb.c \
+	lib/bench-ovsdb.h
 
 if HAVE_NETLINK
 controller_ovn_controller_SOURCES += \
@@ -92,7 +98,10 @@ controller_ovn_controller_SOURCES += \
 	controller/route-table-notify-stub.c
 endif
 
-controller_ovn_controller_LDADD = lib/libovn.la $(OVS_LIBDIR)/libopenvswitch.la
+controller_ovn_controller_LDADD = \
+	lib/libovn.la \
+	$(OVSDB_LIBDIR)/libovsdb.la \
+	$(OVS_LIBDIR)/libopenvswitch.la
 man_MANS += controller/ovn-controller.8
 EXTRA_DIST += controller/ovn-controller.8.xml
 CLEANFILES += controller/ovn-controller.8
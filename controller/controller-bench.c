@@ -0,0 +1,218 @@
+/* Copyright (c) 2026, Red Hat, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <sys/resource.h>
+
+#include "controller-bench.h"
+#include "lflow-cache.h"
+#include "lib/bench-ovsdb.h"
+#include "lib/inc-proc-eng.h"
+#include "ofctrl.h"
+#include "openvswitch/json.h"
+#include "simap.h"
+#include "util.h"
+
+struct controller_bench {
+    struct bench_ovsdb *server; /* Serves the SB and OVS databases. */
+    char *chassis;
+    struct json *runs;          /* Results of controller_bench_add_run(). */
+};
+
+static struct json *
+controller_bench_pair(const char *a, const char *b)
+{
+    return json_array_create_2(json_string_create(a), json_string_create(b));
+}
+
+/* Configures the Open_vSwitch table so that ovn-controller runs as chassis
+ * 'b->chassis', monitors all of the SB database served by 'b->server' and
+ * doesn't depend on any other external_ids for that. */
+static void
+controller_bench_configure_ovs(struct controller_bench *b)
+{
+    const char *remote = bench_ovsdb_remote(b->server);
+    char *chassis_remote = xasprintf("ovn-remote-%s", b->chassis);
+    char *chassis_monitor_all = xasprintf("ovn-monitor-all-%s", b->chassis);
+
+    struct json *keys = json_array_create_empty();
+    json_array_add(keys, json_string_create("system-id"));
+    json_array_add(keys, json_string_create("ovn-remote"));
+    json_array_add(keys, json_string_create(chassis_remote));
+    json_array_add(keys, json_string_create("ovn-monitor-all"));
+    json_array_add(keys, json_string_create(chassis_monitor_all));
+
+    struct json *pairs = json_array_create_empty();
+    json_array_add(pairs, controller_bench_pair("system-id", b->chassis));
+    json_array_add(pairs, controller_bench_pair("ovn-remote", remote));
+    json_array_add(pairs, controller_bench_pair("ovn-monitor-all", "true"));
+
+    struct json *params = json_array_create_1(
+        json_string_create("Open_vSwitch"));
+    struct json *mutations[] = {
+        json_array_create_3(json_string_create("external_ids"),
+                            json_string_create("delete"),
+                            json_array_create_2(json_string_create("set"),
+                                                keys)),
+        json_array_create_3(json_string_create("external_ids"),
+                            json_string_create("insert"),
+                            json_array_create_2(json_string_create("map"),
+                                                pairs)),
+    };
+    for (size_t i = 0; i < ARRAY_SIZE(mutations); i++) {
+        struct json *op = json_object_create();
+
+        json_object_put_string(op, "op", "mutate");
+        json_object_put_string(op, "table", "Open_vSwitch");
+        json_object_put(op, "where", json_array_create_empty());
+        json_object_put(op, "mutations", json_array_create_1(mutations[i]));
+        json_array_add(params, op);
+    }
+
+    bench_ovsdb_transact(b->server, params, "Open_vSwitch configuration");
+
+    free(chassis_remote);
+    free(chassis_monitor_all);
+}
+
+struct controller_bench *
+controller_bench_create(const char *sb_file, const char *ovs_file,
+                        const char *chassis)
+{
+    if (!sb_file || !ovs_file || !chassis) {
+        ovs_fatal(0, "--benchmark-sb, --benchmark-ovs and "
+                  "--benchmark-chassis must be used together");
+    }
+
+    struct controller_bench *b = xzalloc(sizeof *b);
+
+    b->server = bench_ovsdb_create("ovn-controller");
+    bench_ovsdb_add_db(b->server, sb_file);
+    bench_ovsdb_add_db(b->server, ovs_file);
+    b->chassis = xstrdup(chassis);
+    b->runs = json_object_create();
+
+    controller_bench_configure_ovs(b);
+    return b;
+}
+
+void
+controller_bench_destroy(struct controller_bench *b)
+{
+    if (!b) {
+        return;
+    }
+
+    bench_ovsdb_destroy(b->server);
+    json_destroy(b->runs);
+    free(b->chassis);
+    free(b);
+}
+
+const char *
+controller_bench_ovs_remote(const struct controller_bench *b)
+{
+    return bench_ovsdb_remote(b->server);
+}
+
+const char *
+controller_bench_chassis(const struct controller_bench *b)
+{
+    return b->chassis;
+}
+
+void
+controller_bench_run_server(struct controller_bench *b)
+{
+    bench_ovsdb_run(b->server);
+}
+
+/* Records the run 'name' described by 'sample', along with the engine and
+ * ofctrl statistics accumulated since the previous run, and clears them. */
+void
+controller_bench_add_run(struct controller_bench *b, const char *name,
+                         const struct controller_bench_sample *sample)
+{
+    struct json *run = json_object_create();
+
+    json_object_put(run, "wall-usec", json_integer_create(sample->wall_usec));
+    json_object_put(run, "engine-usec",
+                    json_integer_create(sample->engine_usec));
+    json_object_put(run, "ofctrl-put-usec",
+                    json_integer_create(sample->ofctrl_put_usec));
+    json_object_put(run, "loop-runs", json_integer_create(sample->n_runs));
+    json_object_put(run, "lflow-flows",
+                    json_integer_create(sample->n_lflow_flows));
+    json_object_put(run, "pflow-flows",
+                    json_integer_create(sample->n_pflow_flows));
+
+    struct ofctrl_bench_stats of_stats;
+    ofctrl_bench_take_stats(&of_stats);
+
+    struct json *openflow = json_object_create();
+    json_object_put(openflow, "messages",
+                    json_integer_create(of_stats.n_msgs));
+    json_object_put(openflow, "bytes", json_integer_create(of_stats.n_bytes));
+    json_object_put(openflow, "flow-adds",
+                    json_integer_create(of_stats.n_flow_adds));
+    json_object_put(openflow, "flow-mods",
+                    json_integer_create(of_stats.n_flow_mods));
+    json_object_put(openflow, "flow-dels",
+                    json_integer_create(of_stats.n_flow_dels));
+    json_object_put(openflow, "installed-flows",
+                    json_integer_create(of_stats.n_installed_flows));
+    json_object_put(run, "openflow", openflow);
+
+    json_object_put(run, "engine-nodes", engine_get_stats_json());
+    engine_clear_all_stats();
+
+    json_object_put(b->runs, name, run);
+}
+
+/* Prints the results of the benchmark as JSON to stdout. */
+void
+controller_bench_report(struct controller_bench *b,
+                        const struct lflow_cache *lflow_cache,
+                        const struct simap *memory_usage)
+{
+    struct json *result = json_object_create();
+
+    json_object_put_string(result, "chassis", b->chassis);
+    json_object_put(result, "runs", b->runs);
+    b->runs = json_object_create();
+
+    json_object_put(result, "lflow-cache",
+                    lflow_cache_get_stats_json(lflow_cache));
+
+    struct json *memory = json_object_create();
+    const struct simap_node *node;
+    SIMAP_FOR_EACH (node, memory_usage) {
+        json_object_put(memory, node->name, json_integer_create(node->data));
+    }
+    json_object_put(result, "memory", memory);
+
+    struct rusage usage;
+    if (!getrusage(RUSAGE_SELF, &usage)) {
+        json_object_put(result, "peak-rss-kb",
+                        json_integer_create(usage.ru_maxrss));
+    }
+
+    char *s = json_to_string(result, JSSF_PRETTY | JSSF_SORT);
+    puts(s);
+    free(s);
+    json_destroy(result);
+}
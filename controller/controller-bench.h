@@ -0,0 +1,60 @@
+/* Copyright (c) 2026, Red Hat, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OVN_CONTROLLER_BENCH_H
+#define OVN_CONTROLLER_BENCH_H 1
+
+#include <stddef.h>
+
+/* Offline flow compilation benchmark of ovn-controller.
+ *
+ * The SB and Open_vSwitch database files are served by an in-process OVSDB
+ * server (see lib/bench-ovsdb.h), with the Open_vSwitch table configured so
+ * that ovn-controller runs as the given chassis against that SB.  ofctrl
+ * runs in its benchmark mode, without any connection to ovs-vswitchd.
+ *
+ * ovn-controller drives its engine and ofctrl_put() until they settle,
+ * records each run with controller_bench_add_run() and prints the results
+ * with controller_bench_report(). */
+
+struct lflow_cache;
+struct simap;
+
+/* Timings and results of a benchmark run. */
+struct controller_bench_sample {
+    long long int wall_usec;
+    long long int engine_usec;      /* Spent in engine_run(). */
+    long long int ofctrl_put_usec;  /* Spent in ofctrl_put(). */
+    unsigned int n_runs;            /* Loop iterations until settled. */
+    size_t n_lflow_flows;           /* Desired flows, from logical flows. */
+    size_t n_pflow_flows;           /* Desired flows, from physical.c. */
+};
+
+struct controller_bench *controller_bench_create(const char *sb_file,
+                                                 const char *ovs_file,
+                                                 const char *chassis);
+void controller_bench_destroy(struct controller_bench *);
+
+const char *controller_bench_ovs_remote(const struct controller_bench *);
+const char *controller_bench_chassis(const struct controller_bench *);
+void controller_bench_run_server(struct controller_bench *);
+
+void controller_bench_add_run(struct controller_bench *, const char *name,
+                              const struct controller_bench_sample *);
+void controller_bench_report(struct controller_bench *,
+                             const struct lflow_cache *,
+                             const struct simap *memory_usage);
+
+#endif /* controller/controller-bench.h */
@@ -24,6 +24,7 @@
 #include "lib/hmapx.h"
 #include "lib/util.h"
 #include "timeval.h"
+#include "openvswitch/dynamic-string.h"
 #include "openvswitch/vlog.h"
 #include "lib/vswitch-idl.h"
 #include "lib/ovn-sb-idl.h"
@@ -53,6 +54,10 @@ VLOG_DEFINE_THIS_MODULE(if_status);
  * C. At every iteration, based on ofctrl_seqno updates, handled in
  *    if_status_mgr_run():
  * - the flows for a previously claimed interface have been installed in OVS.
+ *
+ * For VIFs, the time at which each of the stages below is reached is
+ * recorded, and the latency of each stage is kept for the last
+ * IF_STATUS_LATENCY_N_SAMPLES interfaces marked "up".
  */
 
 enum if_state {
@@ -85,6 +90,26 @@ enum if_state {
     OIF_MAX,
 };
 
+/* Stages of the installation of a claimed VIF. */
+enum if_stage {
+    IF_STAGE_OVS_IFACE,      /* OVS interface seen by ovn-controller. */
+    IF_STAGE_CLAIMED,        /* Port binding claimed. */
+    IF_STAGE_FLOWS_COMPUTED, /* Flows computed, install seqno requested. */
+    IF_STAGE_FLOWS_ACKED,    /* Install seqno acked by ofctrl. */
+    IF_STAGE_UP_WRITTEN,     /* ovn-installed and/or SB "up" written. */
+    IF_STAGE_INSTALLED,      /* "up" confirmed by the SB and OVS databases. */
+    IF_STAGE_MAX,
+};
+
+/* Names of the latencies between a stage and the previous one. */
+static const char *if_stage_latency_names[] = {
+    [IF_STAGE_CLAIMED]        = "claim",
+    [IF_STAGE_FLOWS_COMPUTED] = "compute",
+    [IF_STAGE_FLOWS_ACKED]    = "install",
+    [IF_STAGE_UP_WRITTEN]     = "mark-up",
+    [IF_STAGE_INSTALLED]      = "confirm",
+};
+
 static const char *if_state_names[] = {
     [OIF_CLAIMED]          = "CLAIMED",
     [OIF_INSTALL_FLOWS]    = "INSTALL_FLOWS",
@@ -191,8 +216,27 @@ struct ovs_iface {
     uint16_t mtu;           /* Extracted from OVS interface.mtu field. */
     enum can_bind bind_type;/* CAN_BIND_AS_MAIN or CAN_BIND_AS_ADDITIONAL */
     bool is_vif;            /* Vifs, container or virtual ports */
+    long long int stage_msec[IF_STAGE_MAX]; /* Time each stage was reached,
+                                             * 0 if not yet. */
+};
+
+/* OVS interface not claimed yet. */
+struct iface_seen {
+    long long int msec;     /* Time the interface was first seen. */
+    bool present;           /* Used by if_status_mgr_track_ifaces(). */
 };
 
+/* Latency of each stage of the installation of a VIF. */
+struct if_status_latency {
+    char *iface_id;
+    long long int total_msec;
+    long long int stage_msec[IF_STAGE_MAX]; /* Time since the previous
+                                             * stage, unused for
+                                             * IF_STAGE_OVS_IFACE. */
+};
+
+#define IF_STATUS_LATENCY_N_SAMPLES 1024
+
 static uint64_t ifaces_usage;
 
 /* State machine manager for all local OVS interfaces. */
@@ -217,6 +261,18 @@ struct if_status_mgr {
      * interfaces have been installed.
      */
     uint32_t iface_seqno;
+
+    /* OVS interfaces with an 'iface-id' not claimed yet, mapping from
+     * 'iface-id' to 'struct iface_seen'. */
+    struct shash ifaces_seen;
+
+    /* Ring of the latencies of the last IF_STATUS_LATENCY_N_SAMPLES VIFs
+     * marked "up", 'n_latency' are valid and the next one is stored at
+     * 'latency_next'. */
+    struct if_status_latency *latency;
+    size_t n_latency;
+    size_t latency_next;
+    uint64_t n_installed;   /* VIFs marked "up" since the last reset. */
 };
 
 static struct ovs_iface *
@@ -230,6 +286,8 @@ static void ovn_uninstall_hash_destroy(struct if_status_mgr *mgr,
                                        struct shash_node *node);
 static void ovs_iface_set_state(struct if_status_mgr *, struct ovs_iface *,
                                 enum if_state);
+static void ovs_iface_set_stage(struct ovs_iface *, enum if_stage);
+static void iface_seen_account_mem(const char *iface_id, bool erase);
 
 static void if_status_mgr_update_bindings(
     struct if_status_mgr *mgr, struct local_binding_data *binding_data,
@@ -239,6 +297,10 @@ static void if_status_mgr_update_bindings(
     bool sb_readonly, bool ovs_readonly);
 
 static void ovn_uninstall_hash_account_mem(const char *name, bool erase);
+static void ifaces_seen_clear(struct if_status_mgr *);
+static void if_status_latency_record(struct if_status_mgr *,
+                                     const struct ovs_iface *);
+
 struct if_status_mgr *
 if_status_mgr_create(void)
 {
@@ -251,6 +313,9 @@ if_status_mgr_create(void)
     shash_init(&mgr->ifaces);
     sset_init(&mgr->claimed_cr);
     shash_init(&mgr->ovn_uninstall_hash);
+    shash_init(&mgr->ifaces_seen);
+    mgr->latency = xcalloc(IF_STATUS_LATENCY_N_SAMPLES,
+                           sizeof *mgr->latency);
     return mgr;
 }
 
@@ -283,9 +348,13 @@ if_status_mgr_destroy(struct if_status_mgr *mgr)
     shash_destroy(&mgr->ifaces);
     sset_destroy(&mgr->claimed_cr);
     shash_destroy(&mgr->ovn_uninstall_hash);
+    ifaces_seen_clear(mgr);
+    shash_destroy(&mgr->ifaces_seen);
     for (size_t i = 0; i < ARRAY_SIZE(mgr->ifaces_per_state); i++) {
         hmapx_destroy(&mgr->ifaces_per_state[i]);
     }
+    if_status_mgr_latency_reset(mgr);
+    free(mgr->latency);
     free(mgr);
 }
 
@@ -554,6 +623,8 @@ if_status_mgr_update(struct if_status_mgr *mgr,
             }
             if (local_binding_is_up(bindings, iface->id, chassis_rec)) {
                 ovs_iface_set_state(mgr, iface, OIF_INSTALLED);
+                ovs_iface_set_stage(iface, IF_STAGE_INSTALLED);
+                if_status_latency_record(mgr, iface);
             }
         } else {
             if (!port_binding_pb_chassis_is_set(chassis_rec, pb_table,
@@ -623,6 +694,7 @@ if_status_mgr_update(struct if_status_mgr *mgr,
              */
             if (iface->is_vif) {
                 ovs_iface_set_state(mgr, iface, OIF_INSTALL_FLOWS);
+                ovs_iface_set_stage(iface, IF_STAGE_FLOWS_COMPUTED);
                 iface->install_seqno = mgr->iface_seqno + 1;
                 new_ifaces = true;
             } else {
@@ -711,6 +783,7 @@ if_status_mgr_run(struct if_status_mgr *mgr,
                                           iface->install_seqno)) {
             continue;
         }
+        ovs_iface_set_stage(iface, IF_STAGE_FLOWS_ACKED);
         /* Wait for ovn-installed to be absent before moving to MARK_UP state.
          * Most of the times ovn-installed is already absent and hence we will
          * not have to wait.
@@ -761,6 +834,18 @@ ovn_uninstall_hash_account_mem(const char *name, bool erase)
     }
 }
 
+static void
+iface_seen_account_mem(const char *iface_id, bool erase)
+{
+    uint32_t size = (strlen(iface_id) + sizeof(struct iface_seen) +
+                     sizeof(struct shash_node));
+    if (erase) {
+        ifaces_usage -= size;
+    } else {
+        ifaces_usage += size;
+    }
+}
+
 uint16_t
 if_status_mgr_iface_get_mtu(const struct if_status_mgr *mgr,
                             const char *iface_id)
@@ -786,6 +871,77 @@ if_status_mgr_iface_update(const struct if_status_mgr *mgr,
     return false;
 }
 
+/* Records when the OVS interface 'iface_rec' was first seen, if it isn't
+ * claimed yet, so that the time until it is claimed can be reported. */
+void
+if_status_mgr_track_iface(struct if_status_mgr *mgr,
+                          const struct ovsrec_interface *iface_rec)
+{
+    const char *iface_id = smap_get(&iface_rec->external_ids, "iface-id");
+    if (!iface_id) {
+        return;
+    }
+
+    struct iface_seen *seen = shash_find_data(&mgr->ifaces_seen, iface_id);
+    if (ovsrec_interface_is_deleted(iface_rec)) {
+        if (seen) {
+            shash_find_and_delete(&mgr->ifaces_seen, iface_id);
+            iface_seen_account_mem(iface_id, true);
+            free(seen);
+        }
+        return;
+    }
+    if (shash_find(&mgr->ifaces, iface_id)) {
+        return;
+    }
+    if (!seen) {
+        seen = xmalloc(sizeof *seen);
+        seen->msec = time_msec();
+        shash_add(&mgr->ifaces_seen, iface_id, seen);
+        iface_seen_account_mem(iface_id, false);
+    }
+    seen->present = true;
+}
+
+/* Same as if_status_mgr_track_iface() for all the interfaces of
+ * 'iface_table', also forgetting the ones that don't exist anymore. */
+void
+if_status_mgr_track_ifaces(struct if_status_mgr *mgr,
+                           const struct ovsrec_interface_table *iface_table)
+{
+    struct shash_node *node;
+
+    SHASH_FOR_EACH (node, &mgr->ifaces_seen) {
+        struct iface_seen *seen = node->data;
+        seen->present = false;
+    }
+
+    const struct ovsrec_interface *iface_rec;
+    OVSREC_INTERFACE_TABLE_FOR_EACH (iface_rec, iface_table) {
+        if_status_mgr_track_iface(mgr, iface_rec);
+    }
+
+    SHASH_FOR_EACH_SAFE (node, &mgr->ifaces_seen) {
+        struct iface_seen *seen = node->data;
+        if (!seen->present) {
+            iface_seen_account_mem(node->name, true);
+            free(seen);
+            shash_delete(&mgr->ifaces_seen, node);
+        }
+    }
+}
+
+static void
+ifaces_seen_clear(struct if_status_mgr *mgr)
+{
+    struct shash_node *node;
+
+    SHASH_FOR_EACH (node, &mgr->ifaces_seen) {
+        iface_seen_account_mem(node->name, true);
+    }
+    shash_clear_free_data(&mgr->ifaces_seen);
+}
+
 static struct ovs_iface *
 ovs_iface_create(struct if_status_mgr *mgr, const char *iface_id,
                  const struct ovsrec_interface *iface_rec,
@@ -798,6 +954,14 @@ ovs_iface_create(struct if_status_mgr *mgr, const char *iface_id,
     iface->id = xstrdup(iface_id);
     shash_add_nocopy(&mgr->ifaces, iface->id, iface);
     ovs_iface_set_state(mgr, iface, state);
+
+    struct iface_seen *seen = shash_find_and_delete(&mgr->ifaces_seen,
+                                                    iface_id);
+    if (seen) {
+        iface->stage_msec[IF_STAGE_OVS_IFACE] = seen->msec;
+        iface_seen_account_mem(iface_id, true);
+        free(seen);
+    }
     if (iface_rec) {
         ovs_iface_account_mem(iface_id, iface_rec->name, false);
         if_status_mgr_iface_update(mgr, iface_rec);
@@ -856,6 +1020,25 @@ ovs_iface_set_state(struct if_status_mgr *mgr, struct ovs_iface *iface,
     iface->state = state;
     hmapx_add(&mgr->ifaces_per_state[iface->state], iface);
     iface->install_seqno = 0;
+
+    /* (Re)claiming restarts the installation, its OVS interface is
+     * considered seen now unless it was seen before being claimed, see
+     * ovs_iface_create(). */
+    if (state == OIF_CLAIMED) {
+        long long int now = time_msec();
+
+        memset(iface->stage_msec, 0, sizeof iface->stage_msec);
+        iface->stage_msec[IF_STAGE_OVS_IFACE] = now;
+        iface->stage_msec[IF_STAGE_CLAIMED] = now;
+    }
+}
+
+static void
+ovs_iface_set_stage(struct ovs_iface *iface, enum if_stage stage)
+{
+    if (!iface->stage_msec[stage]) {
+        iface->stage_msec[stage] = time_msec();
+    }
 }
 
 static void
@@ -903,6 +1086,9 @@ if_status_mgr_update_bindings(struct if_status_mgr *mgr,
         if (iface->is_vif) {
             local_binding_set_up(bindings, iface->id, chassis_rec, ts_now_str,
                                  sb_readonly, ovs_readonly);
+            if (!sb_readonly || !ovs_readonly) {
+                ovs_iface_set_stage(iface, IF_STAGE_UP_WRITTEN);
+            }
         } else if (!sb_readonly) {
             const struct sbrec_port_binding *pb =
                 sbrec_port_binding_table_get_for_uuid(pb_table,
@@ -956,3 +1142,132 @@ if_status_is_port_claimed(const struct if_status_mgr *mgr,
     }
 }
 
+
+/* Records the latency of each installation stage of 'iface', just marked
+ * "up".  A stage that wasn't observed, e.g., the "up" write when it was
+ * already "up", is accounted as reached at the same time as the previous
+ * one. */
+static void
+if_status_latency_record(struct if_status_mgr *mgr,
+                         const struct ovs_iface *iface)
+{
+    struct if_status_latency *l = &mgr->latency[mgr->latency_next];
+    long long int prev = iface->stage_msec[IF_STAGE_OVS_IFACE];
+
+    free(l->iface_id);
+    l->iface_id = xstrdup(iface->id);
+    l->stage_msec[IF_STAGE_OVS_IFACE] = 0;
+    for (size_t i = IF_STAGE_CLAIMED; i < IF_STAGE_MAX; i++) {
+        long long int msec = MAX(iface->stage_msec[i], prev);
+
+        l->stage_msec[i] = msec - prev;
+        prev = msec;
+    }
+    l->total_msec = prev - iface->stage_msec[IF_STAGE_OVS_IFACE];
+
+    mgr->latency_next = (mgr->latency_next + 1) % IF_STATUS_LATENCY_N_SAMPLES;
+    if (mgr->n_latency < IF_STATUS_LATENCY_N_SAMPLES) {
+        mgr->n_latency++;
+    }
+    mgr->n_installed++;
+}
+
+static int
+compare_msec(const void *a_, const void *b_)
+{
+    const long long int *a = a_;
+    const long long int *b = b_;
+
+    return *a < *b ? -1 : *a > *b;
+}
+
+static int
+compare_latency_total(const void *a_, const void *b_)
+{
+    const struct if_status_latency *const *a = a_;
+    const struct if_status_latency *const *b = b_;
+
+    if ((*a)->total_msec != (*b)->total_msec) {
+        return (*a)->total_msec > (*b)->total_msec ? -1 : 1;
+    }
+    return strcmp((*a)->iface_id, (*b)->iface_id);
+}
+
+/* Returns the 'pct' percentile of the 'n' sorted values of 'msec', using
+ * the nearest-rank method. */
+static long long int
+latency_percentile(const long long int *msec, size_t n, unsigned int pct)
+{
+    size_t rank = DIV_ROUND_UP(n * pct, 100);
+
+    return msec[rank ? rank - 1 : 0];
+}
+
+static void
+latency_put_distribution(struct ds *ds, const char *name,
+                         long long int *msec, size_t n)
+{
+    qsort(msec, n, sizeof *msec, compare_msec);
+    ds_put_format(ds, "  %s: p50 %lld ms, p99 %lld ms, max %lld ms\n", name,
+                  latency_percentile(msec, n, 50),
+                  latency_percentile(msec, n, 99), msec[n - 1]);
+}
+
+/* Prints the distribution of the latency of each installation stage of the
+ * last VIFs marked "up" and the 'top_n' slowest of them. */
+void
+if_status_mgr_latency_show(const struct if_status_mgr *mgr, struct ds *ds,
+                           size_t top_n)
+{
+    size_t n = mgr->n_latency;
+
+    ds_put_format(ds, "Interfaces marked up: %"PRIu64"\n", mgr->n_installed);
+    if (!n) {
+        return;
+    }
+
+    ds_put_format(ds, "Latency of the last %"PRIuSIZE":\n", n);
+    long long int *msec = xmalloc(n * sizeof *msec);
+    for (size_t i = 0; i < n; i++) {
+        msec[i] = mgr->latency[i].total_msec;
+    }
+    latency_put_distribution(ds, "total", msec, n);
+    for (size_t stage = IF_STAGE_CLAIMED; stage < IF_STAGE_MAX; stage++) {
+        for (size_t i = 0; i < n; i++) {
+            msec[i] = mgr->latency[i].stage_msec[stage];
+        }
+        latency_put_distribution(ds, if_stage_latency_names[stage], msec, n);
+    }
+    free(msec);
+
+    const struct if_status_latency **sorted = xmalloc(n * sizeof *sorted);
+    for (size_t i = 0; i < n; i++) {
+        sorted[i] = &mgr->latency[i];
+    }
+    qsort(sorted, n, sizeof *sorted, compare_latency_total);
+
+    ds_put_cstr(ds, "Slowest interfaces:\n");
+    for (size_t i = 0; i < MIN(n, top_n); i++) {
+        const struct if_status_latency *l = sorted[i];
+
+        ds_put_format(ds, "  %s: total %lld ms", l->iface_id, l->total_msec);
+        for (size_t stage = IF_STAGE_CLAIMED; stage < IF_STAGE_MAX; stage++) {
+            ds_put_format(ds, ", %s %lld ms", if_stage_latency_names[stage],
+                          l->stage_msec[stage]);
+        }
+        ds_put_char(ds, '\n');
+    }
+    free(sorted);
+}
+
+void
+if_status_mgr_latency_reset(struct if_status_mgr *mgr)
+{
+    for (size_t i = 0; i < mgr->n_latency; i++) {
+        free(mgr->latency[i].iface_id);
+        mgr->latency[i].iface_id = NULL;
+    }
+    mgr->n_latency = 0;
+    mgr->latency_next = 0;
+    mgr->n_installed = 0;
+}
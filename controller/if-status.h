@@ -22,6 +22,7 @@
 #include "binding.h"
 #include "lport.h"
 
+struct ds;
 struct if_status_mgr;
 struct simap;
 
@@ -65,9 +66,17 @@ uint16_t if_status_mgr_iface_get_mtu(const struct if_status_mgr *mgr,
                                      const char *iface_id);
 bool if_status_mgr_iface_update(const struct if_status_mgr *mgr,
                                 const struct ovsrec_interface *iface_rec);
+void if_status_mgr_track_iface(struct if_status_mgr *,
+                               const struct ovsrec_interface *iface_rec);
+void if_status_mgr_track_ifaces(
+    struct if_status_mgr *, const struct ovsrec_interface_table *iface_table);
 bool if_status_is_port_claimed(const struct if_status_mgr *mgr,
                                const char *iface_id);
 bool if_status_reclaimed(struct if_status_mgr *mgr, const char *iface_id);
 struct sset * get_claimed_cr(struct if_status_mgr *mgr);
 
+void if_status_mgr_latency_show(const struct if_status_mgr *, struct ds *,
+                                size_t top_n);
+void if_status_mgr_latency_reset(struct if_status_mgr *);
+
 # endif /* controller/if-status.h */
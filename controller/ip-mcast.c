@@ -158,8 +158,12 @@ igmp_group_update(const struct sbrec_igmp_group *g,
 
     /* set Group protocol */
     if (igmp_support_protocol) {
-         sbrec_igmp_group_set_protocol(g, mcast_snooping_group_protocol_str(
-                                       mc_group->protocol_version));
+        const char *protocol =
+            mcast_snooping_group_protocol_str(mc_group->protocol_version);
+
+        if (!g->protocol || strcmp(g->protocol, protocol)) {
+            sbrec_igmp_group_set_protocol(g, protocol);
+        }
     }
 
     free(old_ports_storage);
@@ -25,8 +25,11 @@
 #include "lflow-cache.h"
 #include "lib/uuid.h"
 #include "memory-trim.h"
+#include "openvswitch/json.h"
+#include "openvswitch/list.h"
 #include "openvswitch/vlog.h"
 #include "ovn/expr.h"
+#include "ovn-metrics.h"
 
 VLOG_DEFINE_THIS_MODULE(lflow_cache);
 
@@ -42,6 +45,7 @@ COVERAGE_DEFINE(lflow_cache_delete);
 COVERAGE_DEFINE(lflow_cache_full);
 COVERAGE_DEFINE(lflow_cache_mem_full);
 COVERAGE_DEFINE(lflow_cache_made_room);
+COVERAGE_DEFINE(lflow_cache_evict);
 COVERAGE_DEFINE(lflow_cache_trim);
 
 static const char *lflow_cache_type_names[LCACHE_T_MAX] = {
@@ -49,10 +53,30 @@ static const char *lflow_cache_type_names[LCACHE_T_MAX] = {
     [LCACHE_T_MATCHES] = "cache-matches",
 };
 
+static const char *lflow_cache_type_stats_names[LCACHE_T_MAX] = {
+    [LCACHE_T_EXPR]    = "expr stats",
+    [LCACHE_T_MATCHES] = "matches stats",
+};
+
+/* Number of least recently used entries considered when looking for an entry
+ * to evict. */
+#define LFLOW_CACHE_EVICT_SAMPLES 8
+
 static struct vlog_rate_limit rl = VLOG_RATE_LIMIT_INIT(5, 1);
 
+struct lflow_cache_type_stats {
+    uint64_t hits;
+    uint64_t misses;      /* Lookups that missed and were followed by
+                           * adding an entry of this type. */
+    uint64_t evictions;
+};
+
 struct lflow_cache {
     struct hmap entries[LCACHE_T_MAX];
+    struct ovs_list lru;  /* Contains 'struct lflow_cache_entry', the most
+                           * recently used first. */
+    uint64_t clock;       /* Eviction priority of the last evicted entry. */
+    struct lflow_cache_type_stats stats[LCACHE_T_MAX];
     struct memory_trimmer *mt;
     uint32_t n_entries;
     uint32_t high_watermark;
@@ -67,17 +91,24 @@ struct lflow_cache {
 
 struct lflow_cache_entry {
     struct hmap_node node;
+    struct ovs_list lru_node; /* In 'struct lflow_cache' lru. */
     struct uuid lflow_uuid; /* key */
     size_t size;
 
+    /* Time it took to build the cached value, in microseconds. */
+    uint64_t cost;
+    /* Eviction priority, the entry with the lowest one is evicted first. */
+    uint64_t priority;
+
     struct lflow_cache_value value;
 };
 
 static bool lflow_cache_make_room__(struct lflow_cache *lc,
-                                    enum lflow_cache_type type);
+                                    enum lflow_cache_type type,
+                                    uint64_t priority, size_t size);
 static struct lflow_cache_value *lflow_cache_add__(
     struct lflow_cache *lc, const struct uuid *lflow_uuid,
-    enum lflow_cache_type type, uint64_t value_size);
+    enum lflow_cache_type type, uint64_t value_size, uint64_t cost);
 static void lflow_cache_delete__(struct lflow_cache *lc,
                                  struct lflow_cache_entry *lce);
 static void lflow_cache_trim__(struct lflow_cache *lc, bool force);
@@ -90,6 +121,7 @@ lflow_cache_create(void)
     for (size_t i = 0; i < LCACHE_T_MAX; i++) {
         hmap_init(&lc->entries[i]);
     }
+    ovs_list_init(&lc->lru);
     lc->mt = memory_trimmer_create();
 
     return lc;
@@ -110,6 +142,7 @@ lflow_cache_flush(struct lflow_cache *lc)
             lflow_cache_delete__(lc, lce);
         }
     }
+    lc->clock = 0;
     lflow_cache_trim__(lc, true);
 }
 
@@ -203,16 +236,120 @@ lflow_cache_get_stats(const struct lflow_cache *lc, struct ds *output)
                       hmap_count(&lc->entries[i]));
     }
     ds_put_format(output, "%-16s: %"PRIu64"\n", "trim count", lc->trim_count);
+    for (size_t i = 0; i < LCACHE_T_MAX; i++) {
+        const struct lflow_cache_type_stats *stats = &lc->stats[i];
+
+        ds_put_format(output, "%-16s: hits %"PRIu64", misses %"PRIu64", "
+                      "evictions %"PRIu64"\n",
+                      lflow_cache_type_stats_names[i], stats->hits,
+                      stats->misses, stats->evictions);
+    }
     ds_put_format(output, "%-16s: %"PRIu64"\n", "Mem usage (KB)",
                   ROUND_UP(lc->mem_usage, 1024) / 1024);
 }
 
+/* Same as lflow_cache_get_stats(), as a JSON object. */
+struct json *
+lflow_cache_get_stats_json(const struct lflow_cache *lc)
+{
+    struct json *json = json_object_create();
+
+    json_object_put(json, "enabled",
+                    json_boolean_create(lflow_cache_is_enabled(lc)));
+    json_object_put(json, "high-watermark",
+                    json_integer_create(lc->high_watermark));
+    json_object_put(json, "total", json_integer_create(lc->n_entries));
+    json_object_put(json, "trim-count", json_integer_create(lc->trim_count));
+    json_object_put(json, "mem-usage-kb",
+                    json_integer_create(ROUND_UP(lc->mem_usage, 1024)
+                                        / 1024));
+    for (size_t i = 0; i < LCACHE_T_MAX; i++) {
+        const struct lflow_cache_type_stats *stats = &lc->stats[i];
+        struct json *type = json_object_create();
+
+        json_object_put(type, "entries",
+                        json_integer_create(hmap_count(&lc->entries[i])));
+        json_object_put(type, "hits", json_integer_create(stats->hits));
+        json_object_put(type, "misses", json_integer_create(stats->misses));
+        json_object_put(type, "evictions",
+                        json_integer_create(stats->evictions));
+        json_object_put(json, lflow_cache_type_names[i], type);
+    }
+    return json;
+}
+
+/* Same as lflow_cache_get_stats(), as OpenMetrics families.  See
+ * lib/ovn-metrics.h. */
+void
+lflow_cache_get_metrics(const struct lflow_cache *lc, struct ds *output)
+{
+    ovn_metrics_put_family(output, "ovn_lflow_cache_enabled", "gauge", NULL,
+                           "Whether the logical flow cache is enabled.");
+    ovn_metrics_put_uint(output, "ovn_lflow_cache_enabled", NULL, NULL,
+                         lflow_cache_is_enabled(lc));
+
+    ovn_metrics_put_family(output, "ovn_lflow_cache_entries", "gauge", NULL,
+                           "Number of entries of the logical flow cache.");
+    for (size_t i = 0; i < LCACHE_T_MAX; i++) {
+        ovn_metrics_put_uint(output, "ovn_lflow_cache_entries", "type",
+                             lflow_cache_type_names[i],
+                             hmap_count(&lc->entries[i]));
+    }
+
+    ovn_metrics_put_family(output, "ovn_lflow_cache_high_watermark", "gauge",
+                           NULL, "Highest number of entries of the logical "
+                           "flow cache since the last trim.");
+    ovn_metrics_put_uint(output, "ovn_lflow_cache_high_watermark", NULL, NULL,
+                         lc->high_watermark);
+
+    ovn_metrics_put_family(output, "ovn_lflow_cache_memory_bytes", "gauge",
+                           "bytes", "Memory used by the logical flow cache.");
+    ovn_metrics_put_uint(output, "ovn_lflow_cache_memory_bytes", NULL, NULL,
+                         lc->mem_usage);
+
+    ovn_metrics_put_family(output, "ovn_lflow_cache_trims", "counter", NULL,
+                           "Number of trims of the logical flow cache.");
+    ovn_metrics_put_uint(output, "ovn_lflow_cache_trims_total", NULL, NULL,
+                         lc->trim_count);
+
+    static const struct {
+        const char *name;
+        size_t offset;          /* In 'struct lflow_cache_type_stats'. */
+        const char *help;
+    } families[] = {
+        { "ovn_lflow_cache_hits",
+          offsetof(struct lflow_cache_type_stats, hits),
+          "Number of logical flow cache lookups that found an entry." },
+        { "ovn_lflow_cache_misses",
+          offsetof(struct lflow_cache_type_stats, misses),
+          "Number of logical flow cache misses followed by the addition of "
+          "an entry." },
+        { "ovn_lflow_cache_evictions",
+          offsetof(struct lflow_cache_type_stats, evictions),
+          "Number of entries evicted from the logical flow cache." },
+    };
+    for (size_t f = 0; f < ARRAY_SIZE(families); f++) {
+        char *total = xasprintf("%s_total", families[f].name);
+
+        ovn_metrics_put_family(output, families[f].name, "counter", NULL,
+                               families[f].help);
+        for (size_t i = 0; i < LCACHE_T_MAX; i++) {
+            const uint64_t *value = (const uint64_t *)
+                ((const char *) &lc->stats[i] + families[f].offset);
+
+            ovn_metrics_put_uint(output, total, "type",
+                                 lflow_cache_type_names[i], *value);
+        }
+        free(total);
+    }
+}
+
 void
 lflow_cache_add_expr(struct lflow_cache *lc, const struct uuid *lflow_uuid,
-                     struct expr *expr, size_t expr_sz)
+                     struct expr *expr, size_t expr_sz, uint64_t cost)
 {
     struct lflow_cache_value *lcv =
-        lflow_cache_add__(lc, lflow_uuid, LCACHE_T_EXPR, expr_sz);
+        lflow_cache_add__(lc, lflow_uuid, LCACHE_T_EXPR, expr_sz, cost);
 
     if (!lcv) {
         expr_destroy(expr);
@@ -225,10 +362,11 @@ lflow_cache_add_expr(struct lflow_cache *lc, const struct uuid *lflow_uuid,
 void
 lflow_cache_add_matches(struct lflow_cache *lc, const struct uuid *lflow_uuid,
                         uint32_t conj_id_ofs, uint32_t n_conjs,
-                        struct hmap *matches, size_t matches_sz)
+                        struct hmap *matches, size_t matches_sz,
+                        uint64_t cost)
 {
     struct lflow_cache_value *lcv =
-        lflow_cache_add__(lc, lflow_uuid, LCACHE_T_MATCHES, matches_sz);
+        lflow_cache_add__(lc, lflow_uuid, LCACHE_T_MATCHES, matches_sz, cost);
 
     if (!lcv) {
         expr_matches_destroy(matches);
@@ -241,13 +379,10 @@ lflow_cache_add_matches(struct lflow_cache *lc, const struct uuid *lflow_uuid,
     lcv->conj_id_ofs = conj_id_ofs;
 }
 
-struct lflow_cache_value *
-lflow_cache_get(struct lflow_cache *lc, const struct uuid *lflow_uuid)
+static struct lflow_cache_entry *
+lflow_cache_find__(const struct lflow_cache *lc,
+                   const struct uuid *lflow_uuid)
 {
-    if (!lflow_cache_is_enabled(lc)) {
-        return NULL;
-    }
-
     size_t hash = uuid_hash(lflow_uuid);
 
     for (size_t i = 0; i < LCACHE_T_MAX; i++) {
@@ -255,51 +390,126 @@ lflow_cache_get(struct lflow_cache *lc, const struct uuid *lflow_uuid)
 
         HMAP_FOR_EACH_WITH_HASH (lce, node, hash, &lc->entries[i]) {
             if (uuid_equals(&lce->lflow_uuid, lflow_uuid)) {
-                COVERAGE_INC(lflow_cache_hit);
-                return &lce->value;
+                return lce;
             }
         }
     }
-    COVERAGE_INC(lflow_cache_miss);
     return NULL;
 }
 
+/* Returns the eviction priority of an entry that took 'cost' microseconds to
+ * build and uses 'size' bytes.  This is the GreedyDual-Size policy: the
+ * priority is the rebuild cost per KB of memory, offset by the priority of
+ * the last evicted entry, so that entries that are not used anymore
+ * eventually age out even if they were expensive to build. */
+static uint64_t
+lflow_cache_priority__(const struct lflow_cache *lc, uint64_t cost,
+                       size_t size)
+{
+    return lc->clock + cost * 1024 / MAX(size, 1);
+}
+
+struct lflow_cache_value *
+lflow_cache_get(struct lflow_cache *lc, const struct uuid *lflow_uuid)
+{
+    if (!lflow_cache_is_enabled(lc)) {
+        return NULL;
+    }
+
+    struct lflow_cache_entry *lce = lflow_cache_find__(lc, lflow_uuid);
+    if (!lce) {
+        COVERAGE_INC(lflow_cache_miss);
+        return NULL;
+    }
+
+    COVERAGE_INC(lflow_cache_hit);
+    lc->stats[lce->value.type].hits++;
+    lce->priority = lflow_cache_priority__(lc, lce->cost, lce->size);
+    ovs_list_remove(&lce->lru_node);
+    ovs_list_push_front(&lc->lru, &lce->lru_node);
+    return &lce->value;
+}
+
 void
 lflow_cache_delete(struct lflow_cache *lc, const struct uuid *lflow_uuid)
 {
-    if (!lc) {
+    if (!lflow_cache_is_enabled(lc)) {
         return;
     }
 
-    struct lflow_cache_value *lcv = lflow_cache_get(lc, lflow_uuid);
-    if (lcv) {
+    struct lflow_cache_entry *lce = lflow_cache_find__(lc, lflow_uuid);
+    if (lce) {
         COVERAGE_INC(lflow_cache_delete);
-        lflow_cache_delete__(lc, CONTAINER_OF(lcv, struct lflow_cache_entry,
-                                              value));
+        lflow_cache_delete__(lc, lce);
         lflow_cache_trim__(lc, false);
         memory_trimmer_record_activity(lc->mt);
     }
 }
 
+/* Returns the entry with the lowest priority among the least recently used
+ * ones, preferring to evict entries of a less "important" type, i.e.,
+ * LCACHE_T_EXPR over LCACHE_T_MATCHES, on ties. */
+static struct lflow_cache_entry *
+lflow_cache_find_victim__(const struct lflow_cache *lc)
+{
+    struct lflow_cache_entry *victim = NULL;
+    struct lflow_cache_entry *lce;
+    size_t n_samples = 0;
+
+    LIST_FOR_EACH_REVERSE (lce, lru_node, &lc->lru) {
+        if (!victim
+            || lce->priority < victim->priority
+            || (lce->priority == victim->priority
+                && lce->value.type < victim->value.type)) {
+            victim = lce;
+        }
+        if (++n_samples == LFLOW_CACHE_EVICT_SAMPLES) {
+            break;
+        }
+    }
+    return victim;
+}
+
+/* Evicts entries until there is room for a new entry of 'type' with
+ * 'priority' that uses 'size' bytes.  Entries are only evicted in favor of
+ * an entry that is at least as expensive to rebuild, and, on ties, is not of
+ * a less "important" type.  Returns false if there isn't enough room. */
 static bool
-lflow_cache_make_room__(struct lflow_cache *lc, enum lflow_cache_type type)
+lflow_cache_make_room__(struct lflow_cache *lc, enum lflow_cache_type type,
+                        uint64_t priority, size_t size)
 {
-    /* When the cache becomes full, the rule is to prefer more "important"
-     * cache entries over less "important" ones.  That is, evict entries of
-     * type LCACHE_T_EXPR if there's no room to add an entry of type
-     * LCACHE_T_MATCHES.
-     */
-    for (size_t i = 0; i < type; i++) {
-        if (hmap_count(&lc->entries[i]) > 0) {
-            struct lflow_cache_entry *lce =
-                CONTAINER_OF(hmap_first(&lc->entries[i]),
-                             struct lflow_cache_entry, node);
+    if (size > lc->max_mem_usage) {
+        COVERAGE_INC(lflow_cache_mem_full);
+        return false;
+    }
 
-            lflow_cache_delete__(lc, lce);
-            return true;
+    bool made_room = false;
+    while (lc->n_entries >= lc->capacity
+           || size + lc->mem_usage > lc->max_mem_usage) {
+        struct lflow_cache_entry *victim = lflow_cache_find_victim__(lc);
+
+        if (!victim
+            || victim->priority > priority
+            || (victim->priority == priority && victim->value.type > type)) {
+            if (lc->n_entries >= lc->capacity) {
+                COVERAGE_INC(lflow_cache_full);
+            } else {
+                COVERAGE_INC(lflow_cache_mem_full);
+            }
+            return false;
         }
+
+        COVERAGE_INC(lflow_cache_evict);
+        lc->stats[victim->value.type].evictions++;
+        lc->clock = MAX(lc->clock, victim->priority);
+        lflow_cache_delete__(lc, victim);
+        made_room = true;
+    }
+
+    if (made_room) {
+        COVERAGE_INC(lflow_cache_made_room);
     }
-    return false;
+    return true;
 }
 
 void
@@ -331,28 +541,22 @@ lflow_cache_wait(struct lflow_cache *lc)
 
 static struct lflow_cache_value *
 lflow_cache_add__(struct lflow_cache *lc, const struct uuid *lflow_uuid,
-                  enum lflow_cache_type type, uint64_t value_size)
+                  enum lflow_cache_type type, uint64_t value_size,
+                  uint64_t cost)
 {
     if (!lflow_cache_is_enabled(lc) || !lflow_uuid) {
         return NULL;
     }
 
+    lc->stats[type].misses++;
+
     struct lflow_cache_entry *lce;
     size_t size = sizeof *lce + value_size;
-    if (size + lc->mem_usage > lc->max_mem_usage) {
-        COVERAGE_INC(lflow_cache_mem_full);
+    uint64_t priority = lflow_cache_priority__(lc, cost, size);
+    if (!lflow_cache_make_room__(lc, type, priority, size)) {
         return NULL;
     }
 
-    if (lc->n_entries == lc->capacity) {
-        if (!lflow_cache_make_room__(lc, type)) {
-            COVERAGE_INC(lflow_cache_full);
-            return NULL;
-        } else {
-            COVERAGE_INC(lflow_cache_made_room);
-        }
-    }
-
     memory_trimmer_record_activity(lc->mt);
     lc->mem_usage += size;
 
@@ -360,8 +564,11 @@ lflow_cache_add__(struct lflow_cache *lc, const struct uuid *lflow_uuid,
     lce = xzalloc(sizeof *lce);
     lce->lflow_uuid = *lflow_uuid;
     lce->size = size;
+    lce->cost = cost;
+    lce->priority = priority;
     lce->value.type = type;
     hmap_insert(&lc->entries[type], &lce->node, uuid_hash(lflow_uuid));
+    ovs_list_push_front(&lc->lru, &lce->lru_node);
     lc->n_entries++;
     lc->high_watermark = MAX(lc->high_watermark, lc->n_entries);
     return &lce->value;
@@ -372,6 +579,7 @@ lflow_cache_delete__(struct lflow_cache *lc, struct lflow_cache_entry *lce)
 {
     ovs_assert(lc->n_entries > 0);
     hmap_remove(&lc->entries[lce->value.type], &lce->node);
+    ovs_list_remove(&lce->lru_node);
     lc->n_entries--;
     switch (lce->value.type) {
     case LCACHE_T_NONE:
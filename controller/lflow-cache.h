@@ -64,13 +64,19 @@ void lflow_cache_enable(struct lflow_cache *, bool enabled, uint32_t capacity,
                         uint32_t trim_wmark_perc, uint32_t trim_timeout_ms);
 bool lflow_cache_is_enabled(const struct lflow_cache *);
 void lflow_cache_get_stats(const struct lflow_cache *, struct ds *output);
+struct json *lflow_cache_get_stats_json(const struct lflow_cache *);
+void lflow_cache_get_metrics(const struct lflow_cache *, struct ds *output);
 
+/* 'cost' is the time, in microseconds, it took to build the cached value.
+ * When the cache is full, entries that are cheap to rebuild relative to their
+ * size are evicted first. */
 void lflow_cache_add_expr(struct lflow_cache *, const struct uuid *lflow_uuid,
-                          struct expr *expr, size_t expr_sz);
+                          struct expr *expr, size_t expr_sz, uint64_t cost);
 void lflow_cache_add_matches(struct lflow_cache *,
                              const struct uuid *lflow_uuid,
                              uint32_t conj_id_ofs, uint32_t n_conjs,
-                             struct hmap *matches, size_t matches_sz);
+                             struct hmap *matches, size_t matches_sz,
+                             uint64_t cost);
 
 struct lflow_cache_value *lflow_cache_get(struct lflow_cache *,
                                           const struct uuid *lflow_uuid);
@@ -0,0 +1,535 @@
+/* Copyright (c) 2026, Red Hat, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include "lflow-profile.h"
+
+#include "byte-order.h"
+#include "hash.h"
+#include "lib/ovn-sb-idl.h"
+#include "lib/vec.h"
+#include "ofctrl.h"
+#include "openvswitch/dynamic-string.h"
+#include "openvswitch/hmap.h"
+#include "openvswitch/match.h"
+#include "openvswitch/ofp-flow.h"
+#include "openvswitch/vlog.h"
+#include "smap.h"
+#include "timeval.h"
+#include "util.h"
+#include "uuid.h"
+
+VLOG_DEFINE_THIS_MODULE(lflow_profile);
+
+/* An OpenFlow flow seen during the profile, identified by its cookie,
+ * table, priority and match. */
+struct lflow_profile_flow {
+    struct hmap_node hmap_node; /* In 'profile_flows'. */
+    uint32_t cookie;
+    uint8_t table_id;
+    uint16_t priority;
+    uint32_t match_hash;
+
+    /* Counters of the flow when the profile started, zero if the flow was
+     * installed after that. */
+    uint64_t base_packets;
+    uint64_t base_bytes;
+    /* Latest counters of the flow. */
+    uint64_t n_packets;
+    uint64_t n_bytes;
+    /* Hits of the previous instances of the flow, if it was reinstalled
+     * during the profile. */
+    uint64_t prev_packets;
+    uint64_t prev_bytes;
+};
+
+/* Translations of a logical flow during the profile. */
+struct lflow_profile_translation {
+    struct hmap_node hmap_node; /* In 'profile_translations'. */
+    struct uuid lflow_uuid;
+    uint64_t n;                 /* Number of translations. */
+    uint64_t usec;              /* Total time spent in the translations. */
+};
+
+static bool profile_active;
+static uint64_t profile_interval_msec;
+
+/* Time the profile was started and stopped, 0 if it never was. */
+static long long int profile_start_msec;
+static long long int profile_stop_msec;
+
+/* Time the first and the last flow statistics of the profile were
+ * processed, 0 if none were. */
+static long long int profile_first_stats_msec;
+static long long int profile_last_stats_msec;
+
+/* Contains 'struct lflow_profile_flow'. */
+static struct hmap profile_flows = HMAP_INITIALIZER(&profile_flows);
+/* Contains 'struct lflow_profile_translation'. */
+static struct hmap profile_translations =
+    HMAP_INITIALIZER(&profile_translations);
+
+static void
+lflow_profile_clear(void)
+{
+    struct lflow_profile_flow *f;
+    HMAP_FOR_EACH_POP (f, hmap_node, &profile_flows) {
+        free(f);
+    }
+
+    struct lflow_profile_translation *t;
+    HMAP_FOR_EACH_POP (t, hmap_node, &profile_translations) {
+        free(t);
+    }
+}
+
+/* Starts a new profile, the statistics of all the OpenFlow flows are dumped
+ * every 'interval_sec' seconds. */
+void
+lflow_profile_start(unsigned int interval_sec)
+{
+    lflow_profile_clear();
+
+    profile_active = true;
+    profile_interval_msec = interval_sec * 1000ULL;
+    profile_start_msec = time_msec();
+    profile_stop_msec = 0;
+    profile_first_stats_msec = 0;
+    profile_last_stats_msec = 0;
+
+    VLOG_INFO("Started logical flow profiling, OpenFlow statistics are "
+              "dumped every %u seconds.", interval_sec);
+}
+
+void
+lflow_profile_stop(void)
+{
+    if (!profile_active) {
+        return;
+    }
+
+    profile_active = false;
+    profile_stop_msec = time_msec();
+    VLOG_INFO("Stopped logical flow profiling.");
+}
+
+bool
+lflow_profile_is_active(void)
+{
+    return profile_active;
+}
+
+void
+lflow_profile_destroy(void)
+{
+    lflow_profile_clear();
+    hmap_destroy(&profile_flows);
+    hmap_destroy(&profile_translations);
+}
+
+void
+lflow_profile_add_translation(const struct uuid *lflow_uuid, uint64_t usec)
+{
+    if (!profile_active) {
+        return;
+    }
+
+    struct lflow_profile_translation *t;
+    uint32_t hash = uuid_hash(lflow_uuid);
+    HMAP_FOR_EACH_WITH_HASH (t, hmap_node, hash, &profile_translations) {
+        if (uuid_equals(&t->lflow_uuid, lflow_uuid)) {
+            goto found;
+        }
+    }
+
+    t = xzalloc(sizeof *t);
+    t->lflow_uuid = *lflow_uuid;
+    hmap_insert(&profile_translations, &t->hmap_node, hash);
+
+found:
+    t->n++;
+    t->usec += usec;
+}
+
+/* Runs in the statctrl thread. */
+void
+lflow_profile_process_flow_stats(struct vector *stats,
+                                 struct ofputil_flow_stats *ofp_stats)
+{
+    uint64_t cookie = ntohll(ofp_stats->cookie);
+
+    /* The cookie of the flows of logical flows is the first 32 bits of
+     * their UUID, skip the others. */
+    if (!cookie || cookie > UINT32_MAX
+        || ofp_stats->packet_count == UINT64_MAX
+        || ofp_stats->byte_count == UINT64_MAX) {
+        return;
+    }
+
+    struct lflow_profile_flow_stats s = {
+        .cookie = cookie,
+        .table_id = ofp_stats->table_id,
+        .priority = ofp_stats->priority,
+        .match_hash = match_hash(&ofp_stats->match, 0),
+        .age_msec = ofp_stats->duration_sec * 1000ULL
+                    + ofp_stats->duration_nsec / 1000000,
+        .n_packets = ofp_stats->packet_count,
+        .n_bytes = ofp_stats->byte_count,
+    };
+    vector_push(stats, &s);
+}
+
+static uint32_t
+lflow_profile_flow_hash(const struct lflow_profile_flow_stats *s)
+{
+    uint32_t hash = hash_add(s->match_hash, s->cookie);
+    hash = hash_add(hash, ((uint32_t) s->table_id << 16) | s->priority);
+    return hash_finish(hash, 0);
+}
+
+static struct lflow_profile_flow *
+lflow_profile_flow_find(const struct lflow_profile_flow_stats *s,
+                        uint32_t hash)
+{
+    struct lflow_profile_flow *f;
+    HMAP_FOR_EACH_WITH_HASH (f, hmap_node, hash, &profile_flows) {
+        if (f->cookie == s->cookie && f->table_id == s->table_id
+            && f->priority == s->priority && f->match_hash == s->match_hash) {
+            return f;
+        }
+    }
+    return NULL;
+}
+
+/* Runs in the main thread.  'stats' may contain only part of a dump, the
+ * latest counters of each flow are kept. */
+void
+lflow_profile_stats_run(struct vector *stats, uint64_t *req_delay,
+                        void *data OVS_UNUSED)
+{
+    *req_delay = profile_active ? profile_interval_msec : 0;
+    if (!profile_active || vector_is_empty(stats)) {
+        return;
+    }
+
+    long long int now = time_msec();
+    if (!profile_first_stats_msec) {
+        profile_first_stats_msec = now;
+    }
+    profile_last_stats_msec = now;
+
+    const struct lflow_profile_flow_stats *s;
+    VECTOR_FOR_EACH_PTR (stats, s) {
+        uint32_t hash = lflow_profile_flow_hash(s);
+        struct lflow_profile_flow *f = lflow_profile_flow_find(s, hash);
+
+        if (!f) {
+            f = xzalloc(sizeof *f);
+            f->cookie = s->cookie;
+            f->table_id = s->table_id;
+            f->priority = s->priority;
+            f->match_hash = s->match_hash;
+            /* Only the hits since the first statistics count for the
+             * flows that were already installed then. */
+            if (now - (long long int) s->age_msec
+                <= profile_first_stats_msec) {
+                f->base_packets = s->n_packets;
+                f->base_bytes = s->n_bytes;
+            }
+            hmap_insert(&profile_flows, &f->hmap_node, hash);
+        } else if (s->n_packets < f->n_packets || s->n_bytes < f->n_bytes) {
+            /* The flow was reinstalled. */
+            f->prev_packets += f->n_packets - f->base_packets;
+            f->prev_bytes += f->n_bytes - f->base_bytes;
+            f->base_packets = 0;
+            f->base_bytes = 0;
+        }
+        f->n_packets = s->n_packets;
+        f->n_bytes = s->n_bytes;
+    }
+}
+
+/* Profile of a logical flow. */
+struct lflow_profile_entry {
+    struct hmap_node hmap_node; /* By uuid_hash(), i.e., by cookie. */
+    const struct sbrec_logical_flow *lflow;
+    uint64_t n_packets;
+    uint64_t n_bytes;
+    size_t n_flows;             /* Number of desired OpenFlow flows. */
+    uint64_t n_translations;
+    uint64_t translation_usec;
+};
+
+/* Profile of the logical flows of a stage. */
+struct lflow_profile_stage {
+    struct hmap_node hmap_node;
+    const char *pipeline;
+    int64_t table_id;
+    const char *name;
+    size_t n_lflows;
+    uint64_t n_packets;
+    uint64_t n_bytes;
+    size_t n_flows;
+    uint64_t translation_usec;
+};
+
+static const char *
+lflow_profile_stage_name(const struct sbrec_logical_flow *lflow)
+{
+    return smap_get_def(&lflow->external_ids, "stage-name", "");
+}
+
+static struct lflow_profile_entry *
+lflow_profile_entry_find(const struct hmap *entries, const struct uuid *uuid)
+{
+    struct lflow_profile_entry *e;
+    HMAP_FOR_EACH_WITH_HASH (e, hmap_node, uuid_hash(uuid), entries) {
+        if (uuid_equals(&e->lflow->header_.uuid, uuid)) {
+            return e;
+        }
+    }
+    return NULL;
+}
+
+static struct lflow_profile_entry *
+lflow_profile_entry_find_by_cookie(const struct hmap *entries,
+                                   uint32_t cookie)
+{
+    struct lflow_profile_entry *e;
+    HMAP_FOR_EACH_WITH_HASH (e, hmap_node, cookie, entries) {
+        if (e->lflow->header_.uuid.parts[0] == cookie) {
+            return e;
+        }
+    }
+    return NULL;
+}
+
+static void
+lflow_profile_add_to_stage(struct hmap *stages,
+                           const struct lflow_profile_entry *e)
+{
+    const struct sbrec_logical_flow *lflow = e->lflow;
+    const char *name = lflow_profile_stage_name(lflow);
+    uint32_t hash = hash_string(name, hash_string(lflow->pipeline,
+                                                  lflow->table_id));
+
+    struct lflow_profile_stage *stage;
+    HMAP_FOR_EACH_WITH_HASH (stage, hmap_node, hash, stages) {
+        if (stage->table_id == lflow->table_id
+            && !strcmp(stage->pipeline, lflow->pipeline)
+            && !strcmp(stage->name, name)) {
+            goto found;
+        }
+    }
+
+    stage = xzalloc(sizeof *stage);
+    stage->pipeline = lflow->pipeline;
+    stage->table_id = lflow->table_id;
+    stage->name = name;
+    hmap_insert(stages, &stage->hmap_node, hash);
+
+found:
+    stage->n_lflows++;
+    stage->n_packets += e->n_packets;
+    stage->n_bytes += e->n_bytes;
+    stage->n_flows += e->n_flows;
+    stage->translation_usec += e->translation_usec;
+}
+
+static int
+lflow_profile_compare_uuid(const struct lflow_profile_entry *a,
+                           const struct lflow_profile_entry *b)
+{
+    return uuid_compare_3way(&a->lflow->header_.uuid, &b->lflow->header_.uuid);
+}
+
+/* Sorts by decreasing packets and bytes. */
+static int
+lflow_profile_compare_hits(const void *a_, const void *b_)
+{
+    const struct lflow_profile_entry *const *a = a_;
+    const struct lflow_profile_entry *const *b = b_;
+
+    if ((*a)->n_packets != (*b)->n_packets) {
+        return (*a)->n_packets < (*b)->n_packets ? 1 : -1;
+    }
+    if ((*a)->n_bytes != (*b)->n_bytes) {
+        return (*a)->n_bytes < (*b)->n_bytes ? 1 : -1;
+    }
+    return lflow_profile_compare_uuid(*a, *b);
+}
+
+/* Sorts by decreasing OpenFlow flows and translation time. */
+static int
+lflow_profile_compare_cost(const void *a_, const void *b_)
+{
+    const struct lflow_profile_entry *const *a = a_;
+    const struct lflow_profile_entry *const *b = b_;
+
+    if ((*a)->n_flows != (*b)->n_flows) {
+        return (*a)->n_flows < (*b)->n_flows ? 1 : -1;
+    }
+    if ((*a)->translation_usec != (*b)->translation_usec) {
+        return (*a)->translation_usec < (*b)->translation_usec ? 1 : -1;
+    }
+    return lflow_profile_compare_uuid(*a, *b);
+}
+
+/* Sorts by pipeline, ingress first, table and name. */
+static int
+lflow_profile_compare_stages(const void *a_, const void *b_)
+{
+    const struct lflow_profile_stage *const *a = a_;
+    const struct lflow_profile_stage *const *b = b_;
+    bool a_egress = !strcmp((*a)->pipeline, "egress");
+    bool b_egress = !strcmp((*b)->pipeline, "egress");
+
+    if (a_egress != b_egress) {
+        return a_egress ? 1 : -1;
+    }
+    if ((*a)->table_id != (*b)->table_id) {
+        return (*a)->table_id < (*b)->table_id ? -1 : 1;
+    }
+    return strcmp((*a)->name, (*b)->name);
+}
+
+static void
+lflow_profile_put_entry(struct ds *ds, const struct lflow_profile_entry *e)
+{
+    const struct sbrec_logical_flow *lflow = e->lflow;
+
+    ds_put_format(ds, "  "UUID_FMT" %s table %"PRId64" (%s): packets %"PRIu64
+                  ", bytes %"PRIu64", flows %"PRIuSIZE", translations %"
+                  PRIu64", translation time %"PRIu64" us\n",
+                  UUID_ARGS(&lflow->header_.uuid), lflow->pipeline,
+                  lflow->table_id, lflow_profile_stage_name(lflow),
+                  e->n_packets, e->n_bytes, e->n_flows, e->n_translations,
+                  e->translation_usec);
+}
+
+/* Prints the profile of the logical flows of 'lflow_table': the 'top_n'
+ * logical flows with the most packets, the 'top_n' ones with the most
+ * OpenFlow flows in 'flow_table' and the totals per logical stage. */
+void
+lflow_profile_show(struct ds *ds,
+                   const struct sbrec_logical_flow_table *lflow_table,
+                   const struct ovn_desired_flow_table *flow_table,
+                   size_t top_n)
+{
+    if (!profile_start_msec) {
+        ds_put_cstr(ds, "Logical flow profiling was never started.\n");
+        return;
+    }
+
+    long long int end_msec = profile_active ? time_msec() : profile_stop_msec;
+    ds_put_format(ds, "Status: %s\n", profile_active ? "active" : "stopped");
+    ds_put_format(ds, "Duration: %.3f seconds\n",
+                  (end_msec - profile_start_msec) / 1000.0);
+    ds_put_format(ds, "Flow statistics window: %.3f seconds\n",
+                  (profile_last_stats_msec - profile_first_stats_msec)
+                  / 1000.0);
+
+    struct hmap entries = HMAP_INITIALIZER(&entries);
+    const struct sbrec_logical_flow *lflow;
+    SBREC_LOGICAL_FLOW_TABLE_FOR_EACH (lflow, lflow_table) {
+        struct lflow_profile_entry *e = xzalloc(sizeof *e);
+
+        e->lflow = lflow;
+        e->n_flows = ovn_desired_flow_table_count_sb_flows(
+            flow_table, &lflow->header_.uuid);
+        hmap_insert(&entries, &e->hmap_node, uuid_hash(&lflow->header_.uuid));
+    }
+
+    const struct lflow_profile_flow *f;
+    HMAP_FOR_EACH (f, hmap_node, &profile_flows) {
+        struct lflow_profile_entry *e =
+            lflow_profile_entry_find_by_cookie(&entries, f->cookie);
+        if (e) {
+            e->n_packets += f->prev_packets + f->n_packets - f->base_packets;
+            e->n_bytes += f->prev_bytes + f->n_bytes - f->base_bytes;
+        }
+    }
+
+    const struct lflow_profile_translation *t;
+    HMAP_FOR_EACH (t, hmap_node, &profile_translations) {
+        struct lflow_profile_entry *e =
+            lflow_profile_entry_find(&entries, &t->lflow_uuid);
+        if (e) {
+            e->n_translations += t->n;
+            e->translation_usec += t->usec;
+        }
+    }
+
+    size_t n_entries = hmap_count(&entries);
+    struct lflow_profile_entry **sorted =
+        xmalloc(n_entries * sizeof *sorted);
+    struct hmap stages = HMAP_INITIALIZER(&stages);
+    size_t i = 0;
+
+    struct lflow_profile_entry *e;
+    HMAP_FOR_EACH (e, hmap_node, &entries) {
+        sorted[i++] = e;
+        lflow_profile_add_to_stage(&stages, e);
+    }
+
+    ds_put_format(ds, "Top %"PRIuSIZE" logical flows by packets:\n", top_n);
+    qsort(sorted, n_entries, sizeof *sorted, lflow_profile_compare_hits);
+    for (i = 0; i < MIN(top_n, n_entries) && sorted[i]->n_packets; i++) {
+        lflow_profile_put_entry(ds, sorted[i]);
+    }
+
+    ds_put_format(ds, "Top %"PRIuSIZE" logical flows by OpenFlow flows:\n",
+                  top_n);
+    qsort(sorted, n_entries, sizeof *sorted, lflow_profile_compare_cost);
+    for (i = 0; i < MIN(top_n, n_entries)
+                && (sorted[i]->n_flows || sorted[i]->translation_usec); i++) {
+        lflow_profile_put_entry(ds, sorted[i]);
+    }
+
+    size_t n_stages = hmap_count(&stages);
+    struct lflow_profile_stage **sorted_stages =
+        xmalloc(n_stages * sizeof *sorted_stages);
+    struct lflow_profile_stage *stage;
+    i = 0;
+    HMAP_FOR_EACH (stage, hmap_node, &stages) {
+        sorted_stages[i++] = stage;
+    }
+    qsort(sorted_stages, n_stages, sizeof *sorted_stages,
+          lflow_profile_compare_stages);
+
+    ds_put_cstr(ds, "Logical stages:\n");
+    for (i = 0; i < n_stages; i++) {
+        stage = sorted_stages[i];
+        ds_put_format(ds, "  %s table %"PRId64" (%s): lflows %"PRIuSIZE
+                      ", packets %"PRIu64", bytes %"PRIu64", flows %"
+                      PRIuSIZE", translation time %"PRIu64" us\n",
+                      stage->pipeline, stage->table_id, stage->name,
+                      stage->n_lflows, stage->n_packets, stage->n_bytes,
+                      stage->n_flows, stage->translation_usec);
+    }
+
+    HMAP_FOR_EACH_POP (stage, hmap_node, &stages) {
+        free(stage);
+    }
+    hmap_destroy(&stages);
+    free(sorted_stages);
+
+    HMAP_FOR_EACH_POP (e, hmap_node, &entries) {
+        free(e);
+    }
+    hmap_destroy(&entries);
+    free(sorted);
+}
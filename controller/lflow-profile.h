@@ -0,0 +1,71 @@
+/* Copyright (c) 2026, Red Hat, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LFLOW_PROFILE_H
+#define LFLOW_PROFILE_H 1
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Per logical flow profiling.
+ *
+ * While a profile is active, statctrl periodically dumps the statistics of
+ * all the OpenFlow flows of the integration bridge, and lflow.c records the
+ * time spent translating each logical flow.  The packets and bytes of the
+ * OpenFlow flows are rolled up to the logical flows through their cookie,
+ * which is the first 32 bits of the logical flow UUID.
+ *
+ * Profiling is started with lflow_profile_start() and stopped with
+ * lflow_profile_stop(), the results are kept until the next start. */
+
+struct ds;
+struct ofputil_flow_stats;
+struct ovn_desired_flow_table;
+struct sbrec_logical_flow_table;
+struct uuid;
+struct vector;
+
+/* Statistics of an OpenFlow flow, as dumped by statctrl. */
+struct lflow_profile_flow_stats {
+    uint32_t cookie;
+    uint8_t table_id;
+    uint16_t priority;
+    uint32_t match_hash;
+    uint64_t age_msec;
+    uint64_t n_packets;
+    uint64_t n_bytes;
+};
+
+void lflow_profile_start(unsigned int interval_sec);
+void lflow_profile_stop(void);
+bool lflow_profile_is_active(void);
+void lflow_profile_destroy(void);
+
+void lflow_profile_add_translation(const struct uuid *lflow_uuid,
+                                   uint64_t usec);
+
+/* statctrl stats node callbacks. */
+void lflow_profile_process_flow_stats(struct vector *stats,
+                                      struct ofputil_flow_stats *ofp_stats);
+void lflow_profile_stats_run(struct vector *stats, uint64_t *req_delay,
+                             void *data);
+
+void lflow_profile_show(struct ds *,
+                        const struct sbrec_logical_flow_table *,
+                        const struct ovn_desired_flow_table *,
+                        size_t top_n);
+
+#endif /* controller/lflow-profile.h */
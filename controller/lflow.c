@@ -20,6 +20,7 @@
 #include "ha-chassis.h"
 #include "lb.h"
 #include "lflow-cache.h"
+#include "lflow-profile.h"
 #include "local_data.h"
 #include "lport.h"
 #include "ofctrl.h"
@@ -28,6 +29,7 @@
 #include "openvswitch/ofpbuf.h"
 #include "openvswitch/vlog.h"
 #include "ovn-controller.h"
+#include "ovs-usdt.h"
 #include "ovn/actions.h"
 #include "ovn/expr.h"
 #include "lib/lb.h"
@@ -40,6 +42,7 @@
 #include "physical.h"
 #include "simap.h"
 #include "sset.h"
+#include "timeval.h"
 
 VLOG_DEFINE_THIS_MODULE(lflow);
 
@@ -387,9 +390,64 @@ lflow_parse_actions(const struct sbrec_logical_flow *lflow,
     return true;
 }
 
+/* Returns true if the SB port group 'pg_name' is the one generated for 'dp'.
+ * See get_sb_port_group_name(). */
+static bool
+port_group_is_for_dp(const char *pg_name,
+                     const struct sbrec_datapath_binding *dp)
+{
+    char *end;
+    long long int dp_key = strtoll(pg_name, &end, 10);
+    return end != pg_name && *end == '_' && dp_key == dp->tunnel_key;
+}
+
+/* Creates a fake port group with the single lport in 'pg_diff_added' and
+ * another lport of the real port group 'pg', which serves as the dummy
+ * element.  If the dummy lport resolves to a port of 'dp', its tracking
+ * address is stored in '*dummy_ip' so that the generated flows can be
+ * discarded. */
+static struct expr_constant_set *
+pg_fake_set_create(const struct expr_constant_set *pg,
+                   const struct expr_constant_set *pg_diff_added,
+                   const struct sbrec_datapath_binding *dp,
+                   const struct lflow_ctx_in *l_ctx_in,
+                   struct in6_addr *dummy_ip, bool *has_dummy_ip)
+{
+    struct expr_constant_set *fake_pg = xzalloc(sizeof *fake_pg);
+    fake_pg->type = EXPR_C_STRING;
+    fake_pg->in_curlies = true;
+    fake_pg->values = VECTOR_CAPACITY_INITIALIZER(struct expr_constant, 2);
+
+    struct expr_constant c =
+        vector_get(&pg_diff_added->values, 0, struct expr_constant);
+    const char *added = c.string;
+    c.string = xstrdup(added);
+    vector_push(&fake_pg->values, &c);
+
+    *has_dummy_ip = false;
+    VECTOR_FOR_EACH (&pg->values, c) {
+        if (strcmp(c.string, added)) {
+            const struct sbrec_port_binding *pb =
+                lport_lookup_by_name(l_ctx_in->sbrec_port_binding_by_name,
+                                     c.string);
+            if (pb && pb->datapath == dp) {
+                struct in6_addr mask;
+                expr_port_key_to_as_ip(pb->tunnel_key, dummy_ip, &mask);
+                *has_dummy_ip = true;
+            }
+            c.string = xstrdup(c.string);
+            vector_push(&fake_pg->values, &c);
+            break;
+        }
+    }
+    return fake_pg;
+}
+
 /* Parses the lflow regarding the changed address set 'as_name', and generates
- * ovs flows for the newly added addresses in 'as_diff_added' only. It is
- * similar to consider_logical_flow__, with the below differences:
+ * ovs flows for the newly added addresses in 'as_diff_added' only.  If 'type'
+ * is OBJDEP_TYPE_PORTGROUP, 'as_name' is a port group instead and
+ * 'as_diff_added' contains the newly added local lports.  It is similar to
+ * consider_logical_flow__, with the below differences:
  *
  * - It has one more arg 'as_ref_count' to deduce how many flows are expected
  *   to be added.
@@ -408,6 +466,7 @@ static bool
 consider_lflow_for_added_as_ips__(
                         const struct sbrec_logical_flow *lflow,
                         const struct sbrec_datapath_binding *dp,
+                        enum objdep_type type,
                         const char *as_name,
                         size_t as_ref_count,
                         const struct expr_constant_set *as_diff_added,
@@ -415,6 +474,13 @@ consider_lflow_for_added_as_ips__(
                         struct lflow_ctx_out *l_ctx_out)
 {
     bool handled = true;
+    bool is_pg = type == OBJDEP_TYPE_PORTGROUP;
+    if (is_pg && !port_group_is_for_dp(as_name, dp)) {
+        /* The SB port group is specific to another datapath of the lflow's
+         * datapath group. */
+        return true;
+    }
+
     struct local_datapath *ldp = get_local_datapath(l_ctx_in->local_datapaths,
                                                     dp->tunnel_key);
     if (!ldp) {
@@ -468,6 +534,8 @@ consider_lflow_for_added_as_ips__(
     };
 
     struct hmap matches = HMAP_INITIALIZER(&matches);
+    struct shash *sets = (struct shash *) (is_pg ? l_ctx_in->port_groups
+                                                 : l_ctx_in->addr_sets);
     const struct expr_constant_set *fake_as = as_diff_added;
     struct expr_constant_set *new_fake_as = NULL;
     struct in6_addr dummy_ip;
@@ -478,7 +546,14 @@ consider_lflow_for_added_as_ips__(
      * fake address set with 2 elements, so that the lflow parsing would
      * generate exactly the same format of flows as it would when parsing with
      * the original address set. */
-    if (vector_len(&as_diff_added->values) == 1) {
+    if (vector_len(&as_diff_added->values) == 1 && is_pg) {
+        /* A made up lport name wouldn't resolve, so use another member of
+         * the port group as the dummy one. */
+        new_fake_as = pg_fake_set_create(shash_find_data(sets, as_name),
+                                         as_diff_added, dp, l_ctx_in,
+                                         &dummy_ip, &has_dummy_ip);
+        fake_as = new_fake_as;
+    } else if (vector_len(&as_diff_added->values) == 1) {
         new_fake_as = xzalloc(sizeof *new_fake_as);
         new_fake_as->values =
             VECTOR_CAPACITY_INITIALIZER(struct expr_constant, 2);
@@ -506,7 +581,7 @@ consider_lflow_for_added_as_ips__(
      * references in this lflow, and replace all the "big" address sets with a
      * small faked one. */
     struct expr_constant_set *real_as =
-        shash_replace((struct shash *)l_ctx_in->addr_sets, as_name, fake_as);
+        shash_replace(sets, as_name, fake_as);
     /* We are here because of the address set update, so it must be found. */
     ovs_assert(real_as);
 
@@ -516,7 +591,7 @@ consider_lflow_for_added_as_ips__(
                                               l_ctx_in->template_vars,
                                               &template_vars_ref,
                                               l_ctx_out->lflow_deps_mgr, NULL);
-    shash_replace((struct shash *)l_ctx_in->addr_sets, as_name, real_as);
+    shash_replace(sets, as_name, real_as);
     if (new_fake_as) {
         expr_constant_set_destroy(new_fake_as);
         free(new_fake_as);
@@ -558,11 +633,12 @@ consider_lflow_for_added_as_ips__(
      */
     size_t n_values = vector_len(&as_diff_added->values);
     if (hmap_count(&matches) != as_ref_count * n_values) {
-        VLOG_DBG("lflow "UUID_FMT", addrset %s: Generated flows count "
+        VLOG_DBG("lflow "UUID_FMT", %s %s: Generated flows count "
                  "(%"PRIuSIZE") " "doesn't match added addresses count "
                  "(%"PRIuSIZE") and ref_count (%"PRIuSIZE"). "
                  "Need reprocessing.",
-                 UUID_ARGS(&lflow->header_.uuid), as_name,
+                 UUID_ARGS(&lflow->header_.uuid), objdep_type_name(type),
+                 as_name,
                  hmap_count(&matches), n_values, as_ref_count);
         handled = false;
         goto done;
@@ -598,6 +674,7 @@ done:
 static bool
 consider_lflow_for_added_as_ips(
                         const struct sbrec_logical_flow *lflow,
+                        enum objdep_type type,
                         const char *as_name,
                         size_t as_ref_count,
                         const struct expr_constant_set *as_diff_added,
@@ -615,13 +692,13 @@ consider_lflow_for_added_as_ips(
     ovs_assert(!dp_group || !dp);
 
     if (dp) {
-        return consider_lflow_for_added_as_ips__(lflow, dp, as_name,
+        return consider_lflow_for_added_as_ips__(lflow, dp, type, as_name,
                                                  as_ref_count, as_diff_added,
                                                  l_ctx_in, l_ctx_out);
     }
     for (size_t i = 0; dp_group && i < dp_group->n_datapaths; i++) {
         if (!consider_lflow_for_added_as_ips__(lflow, dp_group->datapaths[i],
-                                               as_name, as_ref_count,
+                                               type, as_name, as_ref_count,
                                                as_diff_added, l_ctx_in,
                                                l_ctx_out)) {
             return false;
@@ -630,24 +707,23 @@ consider_lflow_for_added_as_ips(
     return true;
 }
 
-/* Check if an address set update can be handled without reprocessing the
- * lflow. */
+/* Check if an update of the address set or port group 'name', found in
+ * 'sets', can be handled without reprocessing the lflow. */
 static bool
-as_update_can_be_handled(const char *as_name, struct addr_set_diff *as_diff,
-                         struct lflow_ctx_in *l_ctx_in)
+set_update_can_be_handled(const struct shash *sets, const char *name,
+                          const struct expr_constant_set *added,
+                          const struct expr_constant_set *deleted)
 {
-    struct expr_constant_set *as = shash_find_data(l_ctx_in->addr_sets,
-                                                   as_name);
-    ovs_assert(as);
-    size_t n_values = vector_len(&as->values);
-    size_t n_added = as_diff->added ? vector_len(&as_diff->added->values) : 0;
-    size_t n_deleted =
-        as_diff->deleted ? vector_len(&as_diff->deleted->values) : 0;
-    size_t old_as_size = n_values + n_deleted - n_added;
+    struct expr_constant_set *cs = shash_find_data(sets, name);
+    ovs_assert(cs);
+    size_t n_values = vector_len(&cs->values);
+    size_t n_added = added ? vector_len(&added->values) : 0;
+    size_t n_deleted = deleted ? vector_len(&deleted->values) : 0;
+    size_t old_size = n_values + n_deleted - n_added;
 
     /* If the change may impact n_conj, i.e. the template of the flows would
      * change, we must reprocess the lflow. */
-    if (old_as_size <= 1 || n_values <= 1) {
+    if (old_size <= 1 || n_values <= 1) {
         return false;
     }
 
@@ -660,6 +736,121 @@ as_update_can_be_handled(const char *as_name, struct addr_set_diff *as_diff,
     return true;
 }
 
+/* Check if an address set update can be handled without reprocessing the
+ * lflow. */
+static bool
+as_update_can_be_handled(const char *as_name, struct addr_set_diff *as_diff,
+                         struct lflow_ctx_in *l_ctx_in)
+{
+    /* Flows are tracked by name, which must not be shared with a port
+     * group. */
+    if (l_ctx_in->port_groups && shash_find(l_ctx_in->port_groups, as_name)) {
+        return false;
+    }
+    return set_update_can_be_handled(l_ctx_in->addr_sets, as_name,
+                                     as_diff->added, as_diff->deleted);
+}
+
+/* Check if a port group update can be handled without reprocessing the
+ * lflow. */
+static bool
+pg_update_can_be_handled(const char *pg_name, struct port_group_diff *pg_diff,
+                         struct lflow_ctx_in *l_ctx_in)
+{
+    if (!pg_diff->added && !pg_diff->deleted) {
+        /* The diff isn't known. */
+        return false;
+    }
+    if (l_ctx_in->addr_sets && shash_find(l_ctx_in->addr_sets, pg_name)) {
+        return false;
+    }
+    return set_update_can_be_handled(l_ctx_in->port_groups, pg_name,
+                                     pg_diff->added, pg_diff->deleted);
+}
+
+/* Removes the flows generated for the deleted addresses or lports in
+ * 'deleted' and adds flows for the ones in 'added', for all the lflows that
+ * reference the address set or port group 'name'. */
+static bool
+lflow_handle_set_update(enum objdep_type type, const char *name,
+                        const struct expr_constant_set *added,
+                        const struct expr_constant_set *deleted,
+                        struct lflow_ctx_in *l_ctx_in,
+                        struct lflow_ctx_out *l_ctx_out,
+                        bool *changed)
+{
+    struct resource_to_objects_node *resource_node =
+        objdep_mgr_find_objs(l_ctx_out->lflow_deps_mgr, type, name);
+    if (!resource_node) {
+        *changed = false;
+        return true;
+    }
+
+    *changed = false;
+
+    bool ret = true;
+    struct object_to_resources_list_node *resource_list_node;
+    RESOURCE_FOR_EACH_OBJ (resource_list_node, resource_node) {
+        const struct uuid *obj_uuid = &resource_list_node->obj_uuid;
+        if (uuidset_find(l_ctx_out->objs_processed, obj_uuid)) {
+            VLOG_DBG("lflow "UUID_FMT"has been processed, skip.",
+                     UUID_ARGS(obj_uuid));
+            continue;
+        }
+        const struct sbrec_logical_flow *lflow =
+            sbrec_logical_flow_table_get_for_uuid(l_ctx_in->logical_flow_table,
+                                                  obj_uuid);
+        if (!lflow) {
+            /* lflow deletion should be handled in the corresponding input
+             * handler, so we can skip here. */
+            VLOG_DBG("lflow "UUID_FMT" not found while handling updates of "
+                     "%s %s, skip.",
+                     UUID_ARGS(obj_uuid), objdep_type_name(type), name);
+            continue;
+        }
+        *changed = true;
+
+        if (deleted) {
+            struct addrset_info as_info;
+            const struct expr_constant *c;
+            VECTOR_FOR_EACH_PTR (&deleted->values, c) {
+                if (type == OBJDEP_TYPE_PORTGROUP) {
+                    const struct sbrec_port_binding *pb = lport_lookup_by_name(
+                        l_ctx_in->sbrec_port_binding_by_name, c->string);
+                    if (!pb) {
+                        /* The lport is gone, its tunnel key is unknown. */
+                        ret = false;
+                        goto done;
+                    }
+                    as_info.name = name;
+                    expr_port_key_to_as_ip(pb->tunnel_key, &as_info.ip,
+                                           &as_info.mask);
+                } else if (!as_info_from_expr_const(name, c, &as_info)) {
+                    continue;
+                }
+                if (!ofctrl_remove_flows_for_as_ip(
+                        l_ctx_out->flow_table, obj_uuid, &as_info,
+                        resource_list_node->ref_count)) {
+                    ret = false;
+                    goto done;
+                }
+            }
+        }
+
+        if (added) {
+            if (!consider_lflow_for_added_as_ips(lflow, type, name,
+                                                 resource_list_node->ref_count,
+                                                 added, l_ctx_in, l_ctx_out)) {
+                ret = false;
+                goto done;
+            }
+        }
+    }
+
+done:
+    return ret;
+}
+
 /* Handles address set update incrementally - processes only the diff
  * (added/deleted) addresses in the address set. If it cannot handle the update
  * incrementally, returns false, so that the caller will trigger reprocessing
@@ -716,67 +907,31 @@ lflow_handle_addr_set_update(const char *as_name,
         return false;
     }
 
-    struct resource_to_objects_node *resource_node =
-        objdep_mgr_find_objs(l_ctx_out->lflow_deps_mgr, OBJDEP_TYPE_ADDRSET,
-                             as_name);
-    if (!resource_node) {
-        *changed = false;
-        return true;
-    }
-
-    *changed = false;
-
-    bool ret = true;
-    struct object_to_resources_list_node *resource_list_node;
-    RESOURCE_FOR_EACH_OBJ (resource_list_node, resource_node) {
-        const struct uuid *obj_uuid = &resource_list_node->obj_uuid;
-        if (uuidset_find(l_ctx_out->objs_processed, obj_uuid)) {
-            VLOG_DBG("lflow "UUID_FMT"has been processed, skip.",
-                     UUID_ARGS(obj_uuid));
-            continue;
-        }
-        const struct sbrec_logical_flow *lflow =
-            sbrec_logical_flow_table_get_for_uuid(l_ctx_in->logical_flow_table,
-                                                  obj_uuid);
-        if (!lflow) {
-            /* lflow deletion should be handled in the corresponding input
-             * handler, so we can skip here. */
-            VLOG_DBG("lflow "UUID_FMT" not found while handling updates of "
-                     "address set %s, skip.",
-                     UUID_ARGS(obj_uuid), as_name);
-            continue;
-        }
-        *changed = true;
-
-        if (as_diff->deleted) {
-            struct addrset_info as_info;
-            const struct expr_constant *c;
-            VECTOR_FOR_EACH_PTR (&as_diff->deleted->values, c) {
-                if (!as_info_from_expr_const(as_name, c, &as_info)) {
-                    continue;
-                }
-                if (!ofctrl_remove_flows_for_as_ip(
-                        l_ctx_out->flow_table, obj_uuid, &as_info,
-                        resource_list_node->ref_count)) {
-                    ret = false;
-                    goto done;
-                }
-            }
-        }
+    return lflow_handle_set_update(OBJDEP_TYPE_ADDRSET, as_name,
+                                   as_diff->added, as_diff->deleted,
+                                   l_ctx_in, l_ctx_out, changed);
+}
 
-        if (as_diff->added) {
-            if (!consider_lflow_for_added_as_ips(lflow, as_name,
-                                                 resource_list_node->ref_count,
-                                                 as_diff->added,
-                                                 l_ctx_in, l_ctx_out)) {
-                ret = false;
-                goto done;
-            }
-        }
+/* Handles port group update incrementally - processes only the local lports
+ * added to or deleted from the port group, similar to
+ * lflow_handle_addr_set_update().  The flows generated for a port group
+ * member are tracked by the tunnel key of the lport.  Returns false if the
+ * update can't be handled incrementally, for the same reasons as an address
+ * set update, or if a deleted lport's port binding is already gone. */
+bool
+lflow_handle_port_group_update(const char *pg_name,
+                               struct port_group_diff *pg_diff,
+                               struct lflow_ctx_in *l_ctx_in,
+                               struct lflow_ctx_out *l_ctx_out,
+                               bool *changed)
+{
+    if (!pg_update_can_be_handled(pg_name, pg_diff, l_ctx_in)) {
+        return false;
     }
 
-done:
-    return ret;
+    return lflow_handle_set_update(OBJDEP_TYPE_PORTGROUP, pg_name,
+                                   pg_diff->added, pg_diff->deleted,
+                                   l_ctx_in, l_ctx_out, changed);
 }
 
 bool
@@ -999,7 +1154,7 @@ convert_match_to_expr(const struct sbrec_logical_flow *lflow,
                       bool *pg_addr_set_ref)
 {
     struct shash addr_sets_ref = SHASH_INITIALIZER(&addr_sets_ref);
-    struct sset port_groups_ref = SSET_INITIALIZER(&port_groups_ref);
+    struct shash port_groups_ref = SHASH_INITIALIZER(&port_groups_ref);
     char *error = NULL;
 
     struct lex_str match_s;
@@ -1032,18 +1187,20 @@ convert_match_to_expr(const struct sbrec_logical_flow *lflow,
                                      &lflow->header_.uuid,
                                      *(size_t *) addr_sets_ref_node->data);
     }
-    const char *port_group_name;
-    SSET_FOR_EACH (port_group_name, &port_groups_ref) {
-        objdep_mgr_add(mgr, OBJDEP_TYPE_PORTGROUP, port_group_name,
-                       &lflow->header_.uuid);
+    struct shash_node *port_groups_ref_node;
+    SHASH_FOR_EACH (port_groups_ref_node, &port_groups_ref) {
+        objdep_mgr_add_with_refcount(mgr, OBJDEP_TYPE_PORTGROUP,
+                                     port_groups_ref_node->name,
+                                     &lflow->header_.uuid,
+                                     *(size_t *) port_groups_ref_node->data);
     }
 
     if (pg_addr_set_ref) {
-        *pg_addr_set_ref = (!sset_is_empty(&port_groups_ref) ||
+        *pg_addr_set_ref = (!shash_is_empty(&port_groups_ref) ||
                             !shash_is_empty(&addr_sets_ref));
     }
     shash_destroy_free_data(&addr_sets_ref);
-    sset_destroy(&port_groups_ref);
+    shash_destroy_free_data(&port_groups_ref);
 
     if (!error) {
         if (*prereqs) {
@@ -1155,6 +1312,12 @@ consider_logical_flow__(const struct sbrec_logical_flow *lflow,
     struct hmap *matches = NULL;
     size_t matches_size = 0;
 
+    /* Time spent building the expr and the matches, used by the cache to
+     * decide which entries are worth keeping. */
+    long long int start_usec = time_usec();
+    uint64_t expr_cost = 0;
+    uint64_t matches_cost = 0;
+
     bool pg_addr_set_ref = false;
 
     if (lcv_type == LCACHE_T_MATCHES
@@ -1183,6 +1346,7 @@ consider_logical_flow__(const struct sbrec_logical_flow *lflow,
         if (!expr) {
             goto done;
         }
+        expr_cost = time_usec() - start_usec;
         break;
     case LCACHE_T_EXPR:
         expr = expr_clone(lcv->expr);
@@ -1243,9 +1407,17 @@ consider_logical_flow__(const struct sbrec_logical_flow *lflow,
         matches = lcv->expr_matches;
         break;
     }
+    matches_cost = time_usec() - start_usec;
 
     add_matches_to_flow_table(lflow, ldp, matches, ptable, output_ptable,
                               &ovnacts, ingress, l_ctx_in, l_ctx_out);
+    if (lflow_profile_is_active()) {
+        lflow_profile_add_translation(&lflow->header_.uuid,
+                                      time_usec() - start_usec);
+    }
+    OVS_USDT_PROBE(consider_logical_flow__, compiled, &lflow->header_.uuid,
+                   dp->tunnel_key, lflow->pipeline, lflow->table_id,
+                   lcv_type, hmap_count(matches), matches_cost);
 
     /* Update cache if needed. */
     switch (lcv_type) {
@@ -1257,12 +1429,14 @@ consider_logical_flow__(const struct sbrec_logical_flow *lflow,
                                             &lflow->header_.uuid)) {
                 lflow_cache_add_matches(l_ctx_out->lflow_cache,
                                         &lflow->header_.uuid, start_conj_id,
-                                        n_conjs, matches, matches_size);
+                                        n_conjs, matches, matches_size,
+                                        matches_cost);
                 matches = NULL;
             } else if (cached_expr) {
                 lflow_cache_add_expr(l_ctx_out->lflow_cache,
                                      &lflow->header_.uuid,
-                                     cached_expr, expr_size(cached_expr));
+                                     cached_expr, expr_size(cached_expr),
+                                     expr_cost);
                 cached_expr = NULL;
             }
         }
@@ -171,6 +171,17 @@ bool lflow_handle_addr_set_update(const char *as_name, struct addr_set_diff *,
                                   struct lflow_ctx_in *,
                                   struct lflow_ctx_out *,
                                   bool *changed);
+/* Local members added to/deleted from a port group.  Both are NULL if the
+ * port group changed in a way that can't be expressed as a delta. */
+struct port_group_diff {
+    struct expr_constant_set *added;
+    struct expr_constant_set *deleted;
+};
+bool lflow_handle_port_group_update(const char *pg_name,
+                                    struct port_group_diff *,
+                                    struct lflow_ctx_in *,
+                                    struct lflow_ctx_out *,
+                                    bool *changed);
 bool lflow_handle_changed_ref(enum objdep_type, const char *res_name,
                               struct uuidset *objs_todo,
                               const void *in_arg, void *out_arg);
@@ -16,6 +16,8 @@
 #include <config.h>
 #include <stdbool.h>
 
+#include "coverage.h"
+
 #include "lflow.h"
 #include "lib/mac-binding-index.h"
 #include "lib/vec.h"
@@ -35,6 +37,16 @@ VLOG_DEFINE_THIS_MODULE(mac_cache);
 #define BUFFERED_PACKETS_TIMEOUT_MS 10000
 #define BUFFERED_PACKETS_LOOKUP_MS  100
 
+/* Memory available for the data of all the buffered packets, including
+ * the ones ready to be sent. */
+#define BP_POOL_SLOT_SIZE           2048
+#define BP_POOL_MAX_BYTES           (8 * 1024 * 1024)
+
+COVERAGE_DEFINE(buffered_packets_drop_queue_full);
+COVERAGE_DEFINE(buffered_packets_drop_lru);
+COVERAGE_DEFINE(buffered_packets_drop_no_memory);
+COVERAGE_DEFINE(buffered_packets_drop_expired);
+
 static uint32_t
 mac_binding_data_hash(const struct mac_binding_data *mb_data);
 static inline bool
@@ -66,6 +78,11 @@ static void
 buffered_packets_remove(struct buffered_packets_ctx *ctx,
                         struct buffered_packets *bp);
 
+static void bp_pool_init(struct bp_pool *pool);
+static void bp_pool_destroy(struct bp_pool *pool);
+static void *bp_pool_alloc(struct bp_pool *pool, size_t size);
+static void bp_pool_free(struct bp_pool *pool, void *p, size_t size);
+
 static void
 buffered_packets_db_lookup(struct buffered_packets *bp,
                            struct ds *ip, struct eth_addr *mac,
@@ -447,6 +464,21 @@ mac_binding_stats_run(struct vector *stats_vec, uint64_t *req_delay,
     }
 }
 
+/* Adds to 'cookies' the OpenFlow cookies of the MAC bindings that have
+ * aging enabled, the cookie of a MAC binding flow is the first 32 bits of
+ * the Southbound record UUID. */
+void
+mac_binding_stats_collect_cookies(struct vector *cookies, void *data)
+{
+    struct mac_cache_data *cache_data = data;
+
+    struct mac_binding *mb;
+    HMAP_FOR_EACH (mb, hmap_node, &cache_data->mac_bindings) {
+        uint64_t cookie = mb->data.cookie;
+        vector_push(cookies, &cookie);
+    }
+}
+
 /* FDB stat processing. */
 void
 fdb_stats_process_flow_stats(struct vector *stats_vec,
@@ -542,11 +574,26 @@ fdb_stats_run(struct vector *stats_vec, uint64_t *req_delay, void *data)
     }
 }
 
+/* Adds to 'cookies' the OpenFlow cookies of the FDB entries that have
+ * aging enabled. */
+void
+fdb_stats_collect_cookies(struct vector *cookies, void *data)
+{
+    struct mac_cache_data *cache_data = data;
+
+    struct fdb *fdb;
+    HMAP_FOR_EACH (fdb, hmap_node, &cache_data->fdbs) {
+        uint64_t cookie = fdb->sbrec_fdb->header_.uuid.parts[0];
+        vector_push(cookies, &cookie);
+    }
+}
+
 /* Packet buffering. */
 void
-bp_packet_data_destroy(struct bp_packet_data *pd) {
-    free(pd->pin.packet);
-    ofpbuf_delete(pd->continuation);
+bp_packet_data_destroy(struct buffered_packets_ctx *ctx,
+                       struct bp_packet_data *pd) {
+    bp_pool_free(&ctx->pool, pd->pin.packet,
+                 pd->pin.packet_len + pd->continuation.size);
 }
 
 struct buffered_packets *
@@ -568,6 +615,7 @@ buffered_packets_add(struct buffered_packets_ctx *ctx,
         bp->lookup_at_ms = 0;
         bp->queue = VECTOR_CAPACITY_INITIALIZER(struct bp_packet_data,
                                                 BUFFER_QUEUE_DEPTH);
+        ovs_list_push_back(&ctx->lru, &bp->lru_node);
     }
 
     bp->expire_at_ms = time_msec() + BUFFERED_PACKETS_TIMEOUT_MS;
@@ -575,20 +623,76 @@ buffered_packets_add(struct buffered_packets_ctx *ctx,
     return bp;
 }
 
+/* Allocates 'size' bytes from the pool of 'ctx', dropping the oldest
+ * packets of the least recently used destinations other than 'bp' if
+ * needed.  Returns NULL if there is still not enough memory. */
+static void *
+buffered_packets_alloc(struct buffered_packets_ctx *ctx,
+                       struct buffered_packets *bp, size_t size)
+{
+    void *p = bp_pool_alloc(&ctx->pool, size);
+
+    while (!p) {
+        struct buffered_packets *lru = NULL;
+        struct buffered_packets *iter;
+        LIST_FOR_EACH (iter, lru_node, &ctx->lru) {
+            if (iter != bp) {
+                lru = iter;
+                break;
+            }
+        }
+        if (!lru) {
+            return NULL;
+        }
+
+        if (vector_is_empty(&lru->queue)) {
+            buffered_packets_remove(ctx, lru);
+            continue;
+        }
+
+        struct bp_packet_data pd;
+        vector_remove(&lru->queue, 0, &pd);
+        bp_packet_data_destroy(ctx, &pd);
+        COVERAGE_INC(buffered_packets_drop_lru);
+        if (vector_is_empty(&lru->queue)) {
+            buffered_packets_remove(ctx, lru);
+        }
+
+        p = bp_pool_alloc(&ctx->pool, size);
+    }
+
+    return p;
+}
+
 void
-buffered_packets_packet_data_enqueue(struct buffered_packets *bp,
+buffered_packets_packet_data_enqueue(struct buffered_packets_ctx *ctx,
+                                     struct buffered_packets *bp,
                                      const struct ofputil_packet_in *pin,
                                      const struct ofpbuf *continuation)
 {
     if (vector_len(&bp->queue) == BUFFER_QUEUE_DEPTH) {
         struct bp_packet_data pd;
         vector_remove(&bp->queue, 0, &pd);
-        bp_packet_data_destroy(&pd);
+        bp_packet_data_destroy(ctx, &pd);
+        COVERAGE_INC(buffered_packets_drop_queue_full);
+    }
+
+    /* Mark 'bp' as the most recently used. */
+    ovs_list_remove(&bp->lru_node);
+    ovs_list_push_back(&ctx->lru, &bp->lru_node);
+
+    char *buf = buffered_packets_alloc(ctx, bp,
+                                       pin->packet_len + continuation->size);
+    if (!buf) {
+        COVERAGE_INC(buffered_packets_drop_no_memory);
+        return;
     }
+    memcpy(buf, pin->packet, pin->packet_len);
+    memcpy(buf + pin->packet_len, continuation->data, continuation->size);
 
     struct bp_packet_data pd = (struct bp_packet_data) {
         .pin = (struct ofputil_packet_in) {
-            .packet = xmemdup(pin->packet, pin->packet_len),
+            .packet = buf,
             .packet_len = pin->packet_len,
             .flow_metadata = pin->flow_metadata,
             .reason = pin->reason,
@@ -599,8 +703,9 @@ buffered_packets_packet_data_enqueue(struct buffered_packets *bp,
             .userdata = NULL,
             .userdata_len = 0,
         },
-        .continuation = ofpbuf_clone(continuation),
     };
+    ofpbuf_use_const(&pd.continuation, buf + pin->packet_len,
+                     continuation->size);
 
     vector_push(&bp->queue, &pd);
 }
@@ -620,6 +725,8 @@ buffered_packets_ctx_run(struct buffered_packets_ctx *ctx,
         struct eth_addr mac = eth_addr_zero;
         /* Remove expired buffered packets. */
         if (now > bp->expire_at_ms) {
+            COVERAGE_ADD(buffered_packets_drop_expired,
+                         vector_len(&bp->queue));
             buffered_packets_remove(ctx, bp);
             continue;
         }
@@ -674,13 +781,15 @@ void
 buffered_packets_ctx_init(struct buffered_packets_ctx *ctx) {
     ctx->ready_packets_data = VECTOR_EMPTY_INITIALIZER(struct bp_packet_data);
     hmap_init(&ctx->buffered_packets);
+    ovs_list_init(&ctx->lru);
+    bp_pool_init(&ctx->pool);
 }
 
 void
 buffered_packets_ctx_destroy(struct buffered_packets_ctx *ctx) {
     struct bp_packet_data *pd;
     VECTOR_FOR_EACH_PTR (&ctx->ready_packets_data, pd) {
-        bp_packet_data_destroy(pd);
+        bp_packet_data_destroy(ctx, pd);
     }
     vector_destroy(&ctx->ready_packets_data);
 
@@ -689,6 +798,7 @@ buffered_packets_ctx_destroy(struct buffered_packets_ctx *ctx) {
         buffered_packets_remove(ctx, bp);
     }
     hmap_destroy(&ctx->buffered_packets);
+    bp_pool_destroy(&ctx->pool);
 }
 
 static uint32_t
@@ -790,14 +900,80 @@ buffered_packets_remove(struct buffered_packets_ctx *ctx,
                         struct buffered_packets *bp) {
     struct bp_packet_data *pd;
     VECTOR_FOR_EACH_PTR (&bp->queue, pd) {
-        bp_packet_data_destroy(pd);
+        bp_packet_data_destroy(ctx, pd);
     }
 
     hmap_remove(&ctx->buffered_packets, &bp->hmap_node);
+    ovs_list_remove(&bp->lru_node);
     vector_destroy(&bp->queue);
     free(bp);
 }
 
+static void
+bp_pool_init(struct bp_pool *pool)
+{
+    pool->n_slots = BP_POOL_MAX_BYTES / BP_POOL_SLOT_SIZE;
+    pool->slots = xmalloc(pool->n_slots * BP_POOL_SLOT_SIZE);
+    pool->free_slots = VECTOR_CAPACITY_INITIALIZER(void *, pool->n_slots);
+    /* Push the slots in reverse order, so that they are used from the
+     * start of the memory. */
+    for (size_t i = pool->n_slots; i > 0; i--) {
+        void *slot = pool->slots + (i - 1) * BP_POOL_SLOT_SIZE;
+        vector_push(&pool->free_slots, &slot);
+    }
+    pool->n_bytes = 0;
+    pool->max_bytes = BP_POOL_MAX_BYTES;
+}
+
+static void
+bp_pool_destroy(struct bp_pool *pool)
+{
+    vector_destroy(&pool->free_slots);
+    free(pool->slots);
+}
+
+static bool
+bp_pool_owns(const struct bp_pool *pool, const void *p)
+{
+    const char *c = p;
+
+    return c >= pool->slots
+           && c < pool->slots + pool->n_slots * BP_POOL_SLOT_SIZE;
+}
+
+/* Returns a buffer of 'size' bytes, or NULL if it would exceed the memory
+ * limit of 'pool'. */
+static void *
+bp_pool_alloc(struct bp_pool *pool, size_t size)
+{
+    size_t cost = MAX(size, BP_POOL_SLOT_SIZE);
+
+    if (pool->n_bytes + cost > pool->max_bytes) {
+        return NULL;
+    }
+
+    void *p;
+    if (size <= BP_POOL_SLOT_SIZE && !vector_is_empty(&pool->free_slots)) {
+        vector_pop(&pool->free_slots, &p);
+    } else {
+        p = xmalloc(size);
+    }
+    pool->n_bytes += cost;
+
+    return p;
+}
+
+static void
+bp_pool_free(struct bp_pool *pool, void *p, size_t size)
+{
+    pool->n_bytes -= MAX(size, BP_POOL_SLOT_SIZE);
+    if (bp_pool_owns(pool, p)) {
+        vector_push(&pool->free_slots, &p);
+    } else {
+        free(p);
+    }
+}
+
 static void
 buffered_packets_db_lookup(struct buffered_packets *bp, struct ds *ip,
                            struct eth_addr *mac,
@@ -946,3 +1122,11 @@ mac_binding_probe_stats_run(struct vector *stats_vec, uint64_t *req_delay,
         VLOG_DBG("MAC probe binding statistics delay: %"PRIu64, *req_delay);
     }
 }
+
+void
+mac_binding_probe_stats_collect_cookies(struct vector *cookies, void *data)
+{
+    struct mac_binding_probe_data *probe_data = data;
+
+    mac_binding_stats_collect_cookies(cookies, probe_data->cache_data);
+}
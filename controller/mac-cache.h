@@ -110,12 +110,16 @@ struct mac_cache_stats {
 };
 
 struct bp_packet_data {
-    struct ofpbuf *continuation;
+    /* The packet and the continuation data are stored in a single buffer
+     * allocated from 'struct bp_pool'. */
+    struct ofpbuf continuation;
     struct ofputil_packet_in pin;
 };
 
 struct buffered_packets {
     struct hmap_node hmap_node;
+    /* In 'struct buffered_packets_ctx' 'lru' list. */
+    struct ovs_list lru_node;
 
     struct mac_binding_data mb_data;
 
@@ -129,11 +133,27 @@ struct buffered_packets {
     long long int lookup_at_ms;
 };
 
+/* Preallocated memory for the buffered packets data, made of fixed-size
+ * slots.  The packets that don't fit in a slot are allocated from the heap,
+ * but they still count against the memory limit of the pool. */
+struct bp_pool {
+    char *slots;
+    size_t n_slots;
+    /* Pointers to the free slots. */
+    struct vector free_slots;
+    /* Bytes in use, slots and heap allocations. */
+    size_t n_bytes;
+    size_t max_bytes;
+};
+
 struct buffered_packets_ctx {
     /* Map of all buffered packets waiting for the MAC address. */
     struct hmap buffered_packets;
+    /* 'struct buffered_packets' from the least to the most recently used. */
+    struct ovs_list lru;
     /* List of packet data that are ready to be sent. */
     struct vector ready_packets_data;
+    struct bp_pool pool;
 };
 
 /* Thresholds. */
@@ -201,20 +221,26 @@ mac_binding_stats_process_flow_stats(struct vector *stats_vec,
 void mac_binding_stats_run(struct vector *stats_vec, uint64_t *req_delay,
                            void *data);
 
+void mac_binding_stats_collect_cookies(struct vector *cookies, void *data);
+
 /* FDB stat processing. */
 void fdb_stats_process_flow_stats(struct vector *stats_vec,
                                   struct ofputil_flow_stats *ofp_stats);
 
 void fdb_stats_run(struct vector *stats_vec, uint64_t *req_delay, void *data);
 
+void fdb_stats_collect_cookies(struct vector *cookies, void *data);
+
 /* Packet buffering. */
-void bp_packet_data_destroy(struct bp_packet_data *pd);
+void bp_packet_data_destroy(struct buffered_packets_ctx *ctx,
+                            struct bp_packet_data *pd);
 
 struct buffered_packets *
 buffered_packets_add(struct buffered_packets_ctx *ctx,
                      struct mac_binding_data mb_data);
 
-void buffered_packets_packet_data_enqueue(struct buffered_packets *bp,
+void buffered_packets_packet_data_enqueue(struct buffered_packets_ctx *ctx,
+                                          struct buffered_packets *bp,
                                           const struct ofputil_packet_in *pin,
                                           const struct ofpbuf *continuation);
 
@@ -240,4 +266,7 @@ void mac_binding_probe_stats_process_flow_stats(
 void mac_binding_probe_stats_run(struct vector *stats_vec, uint64_t *req_delay,
                                  void *data);
 
+void mac_binding_probe_stats_collect_cookies(struct vector *cookies,
+                                             void *data);
+
 #endif /* controller/mac-cache.h */
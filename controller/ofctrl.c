@@ -43,8 +43,10 @@
 #include "openvswitch/ofpbuf.h"
 #include "openvswitch/vlog.h"
 #include "ovn/actions.h"
+#include "ovs-usdt.h"
 #include "lib/extend-table.h"
 #include "lib/lb.h"
+#include "lib/ovn-metrics.h"
 #include "openvswitch/poll-loop.h"
 #include "physical.h"
 #include "openvswitch/rconn.h"
@@ -357,6 +359,10 @@ static enum ofctrl_state state;
 /* Release wait before clear stage. */
 static bool wait_before_clear_proceed = false;
 
+/* Offline benchmark mode, see ofctrl_bench_start(). */
+static bool bench_mode;
+static struct ofctrl_bench_stats bench_stats;
+
 /* Transaction IDs for messages in flight to the switch. */
 static ovs_be32 xid, xid2;
 
@@ -770,7 +776,7 @@ recv_S_UPDATE_FLOWS(const struct ofp_header *oh, enum ofptype type,
 enum mf_field_id
 ofctrl_get_mf_field_id(void)
 {
-    if (!rconn_is_connected(swconn)) {
+    if (!bench_mode && !rconn_is_connected(swconn)) {
         return 0;
     }
     return (state == S_WAIT_BEFORE_CLEAR
@@ -896,6 +902,12 @@ queue_msg(struct ofpbuf *msg)
 {
     const struct ofp_header *oh = msg->data;
     ovs_be32 xid_ = oh->xid;
+    if (bench_mode) {
+        bench_stats.n_msgs++;
+        bench_stats.n_bytes += msg->size;
+        ofpbuf_delete(msg);
+        return xid_;
+    }
     rconn_send(swconn, msg, tx_counter);
     return xid_;
 }
@@ -1941,6 +1953,20 @@ ovn_desired_flow_table_destroy(struct ovn_desired_flow_table *flow_table)
     hmap_destroy(&flow_table->uuid_flow_table);
 }
 
+/* Returns the number of desired flows of 'flow_table' generated for the SB
+ * record 'sb_uuid'. */
+size_t
+ovn_desired_flow_table_count_sb_flows(
+    const struct ovn_desired_flow_table *flow_table,
+    const struct uuid *sb_uuid)
+{
+    struct hmap *uuid_flow_table =
+        CONST_CAST(struct hmap *, &flow_table->uuid_flow_table);
+    struct sb_to_flow *stf = sb_to_flow_find(uuid_flow_table, sb_uuid);
+
+    return stf ? ovs_list_size(&stf->flows) : 0;
+}
+
 
 /* Installed flow table operations. */
 static void
@@ -2009,6 +2035,16 @@ add_flow_mod(struct ofputil_flow_mod *fm,
         return false;
     }
 
+    if (bench_mode) {
+        if (fm->command == OFPFC_ADD) {
+            bench_stats.n_flow_adds++;
+        } else if (fm->command == OFPFC_MODIFY_STRICT) {
+            bench_stats.n_flow_mods++;
+        } else {
+            bench_stats.n_flow_dels++;
+        }
+    }
+
     ovs_list_push_back(msgs, &bundle_msg->list_node);
     return true;
 }
@@ -2661,6 +2697,9 @@ add_ct_flush_tuple(const struct ovn_lb_5tuple *tuple,
 bool
 ofctrl_has_backlog(void)
 {
+    if (bench_mode) {
+        return false;
+    }
     if (rconn_packet_counter_n_packets(tx_counter)
         || rconn_get_version(swconn) < 0) {
         return true;
@@ -2767,6 +2806,9 @@ ofctrl_put(struct ovn_desired_flow_table *lflow_table,
         return;
     }
 
+    OVS_USDT_PROBE(ofctrl_put, start, req_cfg, lflows_changed,
+                   pflows_changed);
+
     /* Iterate through ct zones that need to be flushed. */
     struct shash_node *iter;
     SHASH_FOR_EACH(iter, pending_ct_zones) {
@@ -2966,20 +3008,24 @@ ofctrl_put(struct ovn_desired_flow_table *lflow_table,
 
     acl_ids_flush_expired(tracked_acl_ids, rconn_get_version(swconn), &msgs);
 
+    /* Number of messages queued, not counting the barrier, for the USDT
+     * probe only. */
+    size_t n_msgs OVS_UNUSED = 0;
     if (!ovs_list_is_empty(&msgs)) {
-        /* Add a barrier to the list of messages. */
+        /* Add a barrier after the messages. */
         struct ofpbuf *barrier = ofputil_encode_barrier_request(OFP15_VERSION);
         const struct ofp_header *oh = barrier->data;
         ovs_be32 xid_ = oh->xid;
-        ovs_list_push_back(&msgs, &barrier->list_node);
 
         acl_ids_record_barrier_xid(tracked_acl_ids, xid_);
 
-        /* Queue the messages. */
+        /* Queue the messages, followed by the barrier. */
         struct ofpbuf *msg;
         LIST_FOR_EACH_POP (msg, list_node, &msgs) {
             queue_msg(msg);
+            n_msgs++;
         }
+        queue_msg(barrier);
 
         /* Store the barrier's xid with any newly sent ct flushes. */
         SHASH_FOR_EACH(iter, pending_ct_zones) {
@@ -3036,6 +3082,10 @@ ofctrl_put(struct ovn_desired_flow_table *lflow_table,
         cur_cfg = req_cfg;
     }
 
+    OVS_USDT_PROBE(ofctrl_put, end, req_cfg, n_msgs,
+                   hmap_count(&installed_lflows),
+                   hmap_count(&installed_pflows));
+
     lflow_table->change_tracked = true;
     ovs_assert(ovs_list_is_empty(&lflow_table->tracked_flows));
 
@@ -3148,7 +3198,7 @@ ofctrl_inject_pkt(const struct ovsrec_bridge *br_int, const char *flow_s,
 bool
 ofctrl_is_connected(void)
 {
-    return rconn_is_connected(swconn);
+    return bench_mode || rconn_is_connected(swconn);
 }
 
 void
@@ -3166,3 +3216,54 @@ ofctrl_get_memory_usage(struct simap *usage)
                    ROUND_UP(rconn_packet_counter_n_bytes(tx_counter), 1024)
                    / 1024);
 }
+
+/* Adds the OpenFlow flow counts as OpenMetrics families.  See
+ * lib/ovn-metrics.h. */
+void
+ofctrl_get_metrics(struct ds *output)
+{
+    ovn_metrics_put_family(output, "ovn_ofctrl_installed_flows", "gauge",
+                           NULL, "Number of OpenFlow flows installed in "
+                           "the integration bridge.");
+    ovn_metrics_put_uint(output, "ovn_ofctrl_installed_flows", "type",
+                         "logical", hmap_count(&installed_lflows));
+    ovn_metrics_put_uint(output, "ovn_ofctrl_installed_flows", "type",
+                         "physical", hmap_count(&installed_pflows));
+
+    ovn_metrics_put_family(output, "ovn_ofctrl_pending_flow_updates",
+                           "gauge", NULL, "Number of flow updates sent to "
+                           "the integration bridge and not acknowledged "
+                           "yet.");
+    ovn_metrics_put_uint(output, "ovn_ofctrl_pending_flow_updates", NULL,
+                         NULL, ovs_list_size(&flow_updates));
+
+    ovn_metrics_put_family(output, "ovn_ofctrl_nb_cfg", "gauge", NULL,
+                           "Last nb_cfg whose flows are installed in the "
+                           "integration bridge.");
+    ovn_metrics_put_uint(output, "ovn_ofctrl_nb_cfg", NULL, NULL, cur_cfg);
+}
+
+/* Switches ofctrl to the offline benchmark mode, in which ofctrl_run() must
+ * not be called.  ofctrl behaves as if it had just connected to a switch
+ * without any flow and allocated the first tunnel metadata field for the
+ * Geneve option: the next ofctrl_put() installs all the desired flows.  The
+ * messages for the switch are dropped and only accounted in the statistics
+ * returned by ofctrl_bench_take_stats(). */
+void
+ofctrl_bench_start(void)
+{
+    bench_mode = true;
+    mff_ovn_geneve = MFF_TUN_METADATA0;
+    run_S_CLEAR_FLOWS();
+}
+
+/* Stores the statistics accumulated since the previous call in 'stats' and
+ * clears them. */
+void
+ofctrl_bench_take_stats(struct ofctrl_bench_stats *stats)
+{
+    *stats = bench_stats;
+    stats->n_installed_flows = hmap_count(&installed_lflows)
+                               + hmap_count(&installed_pflows);
+    memset(&bench_stats, 0, sizeof bench_stats);
+}
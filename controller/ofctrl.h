@@ -24,6 +24,7 @@
 #include "hindex.h"
 #include "lib/uuidset.h"
 
+struct ds;
 struct ovn_extend_table;
 struct hmap;
 struct match;
@@ -138,6 +139,8 @@ bool ofctrl_remove_flows_for_as_ip(struct ovn_desired_flow_table *,
 void ovn_desired_flow_table_init(struct ovn_desired_flow_table *);
 void ovn_desired_flow_table_clear(struct ovn_desired_flow_table *);
 void ovn_desired_flow_table_destroy(struct ovn_desired_flow_table *);
+size_t ovn_desired_flow_table_count_sb_flows(
+    const struct ovn_desired_flow_table *, const struct uuid *sb_uuid);
 
 void ofctrl_check_and_add_flow_metered(struct ovn_desired_flow_table *,
                                        uint8_t table_id, uint16_t priority,
@@ -150,5 +153,20 @@ void ofctrl_check_and_add_flow_metered(struct ovn_desired_flow_table *,
 
 bool ofctrl_is_connected(void);
 void ofctrl_get_memory_usage(struct simap *usage);
+void ofctrl_get_metrics(struct ds *output);
+
+/* Offline benchmark mode: ofctrl acts as if it was connected to the switch
+ * but only accounts for the messages it would send. */
+struct ofctrl_bench_stats {
+    uint64_t n_msgs;            /* OpenFlow messages, including bundles. */
+    uint64_t n_bytes;
+    uint64_t n_flow_adds;       /* Flow mods, per command. */
+    uint64_t n_flow_mods;
+    uint64_t n_flow_dels;
+    size_t n_installed_flows;   /* Currently installed flows. */
+};
+
+void ofctrl_bench_start(void);
+void ofctrl_bench_take_stats(struct ofctrl_bench_stats *);
 
 #endif /* controller/ofctrl.h */
@@ -28,6 +28,7 @@
 #include "binding.h"
 #include "chassis.h"
 #include "command-line.h"
+#include "controller-bench.h"
 #include "compiler.h"
 #include "daemon.h"
 #include "dirs.h"
@@ -41,6 +42,7 @@
 #include "lb.h"
 #include "lflow.h"
 #include "lflow-cache.h"
+#include "lflow-profile.h"
 #include "lib/lflow-conj-ids.h"
 #include "lib/vswitch-idl.h"
 #include "lib/ovsdb-types.h"
@@ -59,6 +61,7 @@
 #include "lib/mac-binding-index.h"
 #include "lib/mcast-group-index.h"
 #include "lib/ovn-dirs.h"
+#include "lib/ovn-metrics.h"
 #include "lib/ovn-sb-idl.h"
 #include "lib/ovn-util.h"
 #include "ovsport.h"
@@ -121,6 +124,13 @@ static unixctl_cb_func debug_dump_peer_ports;
 static unixctl_cb_func debug_dump_lflow_conj_ids;
 static unixctl_cb_func lflow_cache_flush_cmd;
 static unixctl_cb_func lflow_cache_show_stats_cmd;
+static unixctl_cb_func lflow_profile_start_cmd;
+static unixctl_cb_func lflow_profile_stop_cmd;
+static unixctl_cb_func lflow_profile_show_cmd;
+static unixctl_cb_func if_status_mgr_latency_show_cmd;
+static unixctl_cb_func if_status_mgr_latency_reset_cmd;
+static unixctl_cb_func pinctrl_show_packet_in_stats_cmd;
+static unixctl_cb_func pinctrl_show_mcast_snoop_stats_cmd;
 static unixctl_cb_func debug_delay_nb_cfg_report;
 
 #define DEFAULT_BRIDGE_NAME "br-int"
@@ -157,6 +167,11 @@ static const char *ssl_ca_cert_file;
 /* --unixctl-path: Path to use for unixctl server socket. */
 static char *unixctl_path;
 
+/* Offline benchmark mode, see controller-bench.h. */
+static const char *benchmark_sb_file;
+static const char *benchmark_ovs_file;
+static const char *benchmark_chassis;
+
 /* By default don't set an upper bound for the lflow cache and enable auto
  * trimming above 10K logical flows when reducing cache size by 50%.
  */
@@ -171,6 +186,19 @@ struct controller_engine_ctx {
     struct if_status_mgr *if_mgr;
 };
 
+/* Auxiliary data of controller_put_metrics(). */
+struct controller_metrics_aux {
+    const struct controller_engine_ctx *ctrl_engine_ctx;
+    struct ovsdb_idl_loop *ovs_idl_loop;
+    struct ovsdb_idl_loop *ovnsb_idl_loop;
+};
+
+/* Auxiliary data of lflow_profile_show_cmd(). */
+struct lflow_profile_aux {
+    struct ovsdb_idl_loop *ovnsb_idl_loop;
+    const struct ovn_desired_flow_table *flow_table;
+};
+
 /* Pending packet to be injected into connected OVS. */
 struct pending_pkt {
     /* Setting 'conn' indicates that a request is pending. */
@@ -1034,7 +1062,7 @@ en_ofctrl_is_connected_run(struct engine_node *node OVS_UNUSED, void *data)
 }
 
 struct ed_type_if_status_mgr {
-    const struct if_status_mgr *manager;
+    struct if_status_mgr *manager;
     const struct ovsrec_interface_table *iface_table;
 };
 
@@ -1059,6 +1087,7 @@ en_if_status_mgr_run(struct engine_node *node, void *data_)
     struct controller_engine_ctx *ctrl_ctx = engine_get_context()->client_ctx;
     data->manager = ctrl_ctx->if_mgr;
     data->iface_table = EN_OVSDB_GET(engine_get_input("OVS_interface", node));
+    if_status_mgr_track_ifaces(data->manager, data->iface_table);
 
     const struct ovsrec_interface *iface;
     OVSREC_INTERFACE_TABLE_FOR_EACH (iface, data->iface_table) {
@@ -1078,6 +1107,7 @@ if_status_mgr_ovs_interface_handler(struct engine_node *node OVS_UNUSED,
 
     const struct ovsrec_interface *iface;
     OVSREC_INTERFACE_TABLE_FOR_EACH_TRACKED (iface, data_->iface_table) {
+        if_status_mgr_track_iface(data_->manager, iface);
         if (if_status_mgr_iface_update(data_->manager, iface)) {
             result = EN_HANDLED_UPDATED;
         }
@@ -2062,7 +2092,9 @@ struct ed_type_port_groups{
     bool change_tracked;
     struct sset new;
     struct sset deleted;
-    struct sset updated;
+    /* Port groups whose local lports changed, each with the
+     * 'struct port_group_diff' of 'port_groups_cs_local'. */
+    struct shash updated;
 };
 
 static void
@@ -2110,6 +2142,20 @@ port_group_ssets_clear(struct shash *port_group_ssets)
     }
 }
 
+static void
+port_group_diff_destroy(struct port_group_diff *pg_diff)
+{
+    if (pg_diff->added) {
+        expr_constant_set_destroy(pg_diff->added);
+        free(pg_diff->added);
+    }
+    if (pg_diff->deleted) {
+        expr_constant_set_destroy(pg_diff->deleted);
+        free(pg_diff->deleted);
+    }
+    free(pg_diff);
+}
+
 static void *
 en_port_groups_init(struct engine_node *node OVS_UNUSED,
                     struct engine_arg *arg OVS_UNUSED)
@@ -2121,13 +2167,29 @@ en_port_groups_init(struct engine_node *node OVS_UNUSED,
     pg->change_tracked = false;
     sset_init(&pg->new);
     sset_init(&pg->deleted);
-    sset_init(&pg->updated);
+    shash_init(&pg->updated);
     return pg;
 }
 
+static void
+en_port_groups_clear_tracked_data(void *data_)
+{
+    struct ed_type_port_groups *pg = data_;
+    sset_clear(&pg->new);
+    sset_clear(&pg->deleted);
+    struct shash_node *node;
+    SHASH_FOR_EACH_SAFE (node, &pg->updated) {
+        port_group_diff_destroy(node->data);
+    }
+    shash_clear(&pg->updated);
+    pg->change_tracked = false;
+}
+
 static void
 en_port_groups_cleanup(void *data)
 {
+    en_port_groups_clear_tracked_data(data);
+
     struct ed_type_port_groups *pg = data;
 
     expr_const_sets_destroy(&pg->port_groups_cs_local);
@@ -2138,7 +2200,7 @@ en_port_groups_cleanup(void *data)
 
     sset_destroy(&pg->new);
     sset_destroy(&pg->deleted);
-    sset_destroy(&pg->updated);
+    shash_destroy(&pg->updated);
 }
 
 static void
@@ -2156,13 +2218,55 @@ port_groups_init(const struct sbrec_port_group_table *port_group_table,
     }
 }
 
+/* Updates the const set of local lports of port group 'pg' and, if the local
+ * lports changed, records the diff in 'updated'. */
+static void
+port_group_cs_local_update(const struct sbrec_port_group *pg,
+                           const struct sset *local_lports,
+                           struct shash *port_groups_cs_local,
+                           struct shash *updated)
+{
+    struct expr_constant_set *cs_old =
+        shash_find_and_delete(port_groups_cs_local, pg->name);
+    expr_const_sets_add_strings(port_groups_cs_local, pg->name,
+                                (const char *const *) pg->ports,
+                                pg->n_ports, local_lports);
+
+    struct port_group_diff *pg_diff = xzalloc(sizeof *pg_diff);
+    if (cs_old) {
+        expr_constant_set_strings_diff(
+            cs_old, shash_find_data(port_groups_cs_local, pg->name),
+            &pg_diff->added, &pg_diff->deleted);
+        expr_constant_set_destroy(cs_old);
+        free(cs_old);
+
+        if (!pg_diff->added && !pg_diff->deleted) {
+            /* Only non-local lports changed, which has no impact on the
+             * generated constant set. */
+            port_group_diff_destroy(pg_diff);
+            return;
+        }
+    }
+
+    struct port_group_diff *old_diff = shash_find_data(updated, pg->name);
+    if (old_diff) {
+        /* Updated more than once in this iteration.  Don't bother merging
+         * the diffs, the related lflows will be reprocessed. */
+        port_group_diff_destroy(pg_diff);
+        pg_diff = xzalloc(sizeof *pg_diff);
+        port_group_diff_destroy(shash_replace(updated, pg->name, pg_diff));
+        return;
+    }
+    shash_add(updated, pg->name, pg_diff);
+}
+
 static void
 port_groups_update(const struct sbrec_port_group_table *port_group_table,
                    const struct sset *local_lports,
                    struct shash *port_group_ssets,
                    struct shash *port_groups_cs_local,
                    struct sset *new, struct sset *deleted,
-                   struct sset *updated)
+                   struct shash *updated)
 {
     const struct sbrec_port_group *pg;
     SBREC_PORT_GROUP_TABLE_FOR_EACH_TRACKED (pg, port_group_table) {
@@ -2176,28 +2280,19 @@ port_groups_update(const struct sbrec_port_group_table *port_group_table,
     SBREC_PORT_GROUP_TABLE_FOR_EACH_TRACKED (pg, port_group_table) {
         if (!sbrec_port_group_is_deleted(pg)) {
             port_group_ssets_add_or_update(port_group_ssets, pg);
-            expr_const_sets_add_strings(port_groups_cs_local, pg->name,
-                                        (const char *const *) pg->ports,
-                                        pg->n_ports, local_lports);
             if (sbrec_port_group_is_new(pg)) {
+                expr_const_sets_add_strings(port_groups_cs_local, pg->name,
+                                            (const char *const *) pg->ports,
+                                            pg->n_ports, local_lports);
                 sset_add(new, pg->name);
             } else {
-                sset_add(updated, pg->name);
+                port_group_cs_local_update(pg, local_lports,
+                                           port_groups_cs_local, updated);
             }
         }
     }
 }
 
-static void
-en_port_groups_clear_tracked_data(void *data_)
-{
-    struct ed_type_port_groups *pg = data_;
-    sset_clear(&pg->new);
-    sset_clear(&pg->deleted);
-    sset_clear(&pg->updated);
-    pg->change_tracked = false;
-}
-
 static enum engine_node_state
 en_port_groups_run(struct engine_node *node, void *data)
 {
@@ -2235,7 +2330,7 @@ port_groups_sb_port_group_handler(struct engine_node *node, void *data)
                        &pg->new, &pg->deleted, &pg->updated);
 
     if (!sset_is_empty(&pg->new) || !sset_is_empty(&pg->deleted) ||
-            !sset_is_empty(&pg->updated)) {
+            !shash_is_empty(&pg->updated)) {
         result = EN_HANDLED_UPDATED;
     } else {
         result = EN_HANDLED_UNCHANGED;
@@ -2289,17 +2384,16 @@ port_groups_runtime_data_handler(struct engine_node *node, void *data)
             }
         }
         if (need_update) {
-            expr_const_sets_add_strings(&pg->port_groups_cs_local, pg_sb->name,
-                                        (const char *const *) pg_sb->ports,
-                                        pg_sb->n_ports,
-                                        &rt_data->related_lports.lport_names);
-            sset_add(&pg->updated, pg_sb->name);
+            port_group_cs_local_update(pg_sb,
+                                       &rt_data->related_lports.lport_names,
+                                       &pg->port_groups_cs_local,
+                                       &pg->updated);
         }
     }
 
 out:
     if (!sset_is_empty(&pg->new) || !sset_is_empty(&pg->deleted) ||
-            !sset_is_empty(&pg->updated)) {
+            !shash_is_empty(&pg->updated)) {
         result = EN_HANDLED_UPDATED;
     } else {
         result = EN_HANDLED_UNCHANGED;
@@ -4301,13 +4395,22 @@ lflow_output_port_groups_handler(struct engine_node *node, void *data)
             result = EN_HANDLED_UPDATED;
         }
     }
-    SSET_FOR_EACH (ref_name, &pg_data->updated) {
-        if (!objdep_mgr_handle_change(l_ctx_out.lflow_deps_mgr,
-                                      OBJDEP_TYPE_PORTGROUP, ref_name,
-                                      lflow_handle_changed_ref,
-                                      l_ctx_out.objs_processed,
-                                      &l_ctx_in, &l_ctx_out, &changed)) {
-            return EN_UNHANDLED;
+    struct shash_node *shash_node;
+    SHASH_FOR_EACH (shash_node, &pg_data->updated) {
+        struct port_group_diff *pg_diff = shash_node->data;
+        if (!lflow_handle_port_group_update(shash_node->name, pg_diff,
+                                            &l_ctx_in, &l_ctx_out,
+                                            &changed)) {
+            VLOG_DBG("Can't incrementally handle the change of port group %s."
+                     " Reprocess related lflows.", shash_node->name);
+            if (!objdep_mgr_handle_change(l_ctx_out.lflow_deps_mgr,
+                                          OBJDEP_TYPE_PORTGROUP,
+                                          shash_node->name,
+                                          lflow_handle_changed_ref,
+                                          l_ctx_out.objs_processed,
+                                          &l_ctx_in, &l_ctx_out, &changed)) {
+                return EN_UNHANDLED;
+            }
         }
         if (changed) {
             result = EN_HANDLED_UPDATED;
@@ -7111,6 +7214,247 @@ ovsdb_idl_loop_next_cfg_inc(struct ovsdb_idl_loop *idl_loop)
     }
 }
 
+/* Maximum number of loop iterations for the engine to settle in the offline
+ * benchmark mode. */
+#define BENCH_MAX_RUNS 100
+
+/* Runs the database IDLs of the offline benchmark until they got all the
+ * data and the integration bridge is set up.  Without a connection to
+ * ovs-vswitchd, only the OVS features advertised by the datapath
+ * capabilities are supported, and the number of groups and meters isn't
+ * limited. */
+static void
+bench_wait_for_dbs(struct controller_bench *bench,
+                   struct ovsdb_idl_loop *ovs_idl_loop,
+                   struct ovsdb_idl_loop *ovnsb_idl_loop,
+                   struct controller_engine_ctx *ctrl_engine_ctx,
+                   struct ovsdb_idl_index *sbrec_chassis_by_name)
+{
+    unsigned int expected_cond_seqno = UINT_MAX;
+
+    for (;;) {
+        struct ovsdb_idl_txn *ovs_idl_txn = ovsdb_idl_loop_run(ovs_idl_loop);
+        update_sb_db(ovs_idl_loop->idl, ovnsb_idl_loop->idl, NULL, NULL,
+                     ctrl_engine_ctx, &expected_cond_seqno);
+        struct ovsdb_idl_txn *ovnsb_idl_txn =
+            ovsdb_idl_loop_run(ovnsb_idl_loop);
+
+        const struct ovsrec_bridge *br_int = NULL;
+        const struct ovsrec_datapath *br_int_dp = NULL;
+        process_br_int(ovs_idl_txn,
+                       ovsrec_bridge_table_get(ovs_idl_loop->idl),
+                       ovsrec_open_vswitch_table_get(ovs_idl_loop->idl),
+                       &br_int,
+                       ovsrec_server_has_datapath_table(ovs_idl_loop->idl)
+                       ? &br_int_dp
+                       : NULL);
+
+        bool ready = br_int && ovs_idl_txn && ovnsb_idl_txn
+                     && ovsdb_idl_get_condition_seqno(ovnsb_idl_loop->idl)
+                        == expected_cond_seqno;
+        if (ready) {
+            ovs_feature_support_run(br_int_dp ? &br_int_dp->capabilities
+                                              : NULL,
+                                    NULL, 0);
+
+            struct ed_type_lflow_output *lflow_output_data =
+                engine_get_internal_data(&en_lflow_output);
+            ovn_extend_table_reinit(&lflow_output_data->group_table,
+                                    UINT32_MAX);
+            ovn_extend_table_reinit(&lflow_output_data->meter_table,
+                                    UINT32_MAX);
+        }
+
+        int ovnsb_txn_status = ovsdb_idl_loop_commit_and_wait(ovnsb_idl_loop);
+        int ovs_txn_status = ovsdb_idl_loop_commit_and_wait(ovs_idl_loop);
+        ovsdb_idl_track_clear(ovnsb_idl_loop->idl);
+        ovsdb_idl_track_clear(ovs_idl_loop->idl);
+        if (ready && ovnsb_txn_status != -1 && ovs_txn_status != -1) {
+            break;
+        }
+
+        controller_bench_run_server(bench);
+        poll_block();
+    }
+
+    const char *chassis_id = controller_bench_chassis(bench);
+    if (!chassis_lookup_by_name(sbrec_chassis_by_name, chassis_id)) {
+        ovs_fatal(0, "chassis %s not found in the Southbound database",
+                  chassis_id);
+    }
+}
+
+/* Runs one iteration of the offline benchmark loop, i.e., the parts of the
+ * main loop that compute the desired flows and hand them to ofctrl, and
+ * accounts for it in 'sample'.  Returns true if another iteration is
+ * needed to process the changes it made. */
+static bool
+bench_run_once(struct ovsdb_idl_loop *ovs_idl_loop,
+               struct ovsdb_idl_loop *ovnsb_idl_loop,
+               struct controller_engine_ctx *ctrl_engine_ctx,
+               struct ovsdb_idl_index *sbrec_meter_by_name,
+               struct controller_bench_sample *sample)
+{
+    engine_init_run();
+
+    struct ovsdb_idl_txn *ovs_idl_txn = ovsdb_idl_loop_run(ovs_idl_loop);
+    update_sb_db(ovs_idl_loop->idl, ovnsb_idl_loop->idl, NULL, NULL,
+                 ctrl_engine_ctx, NULL);
+    struct ovsdb_idl_txn *ovnsb_idl_txn = ovsdb_idl_loop_run(ovnsb_idl_loop);
+
+    struct engine_context eng_ctx = {
+        .ovs_idl_txn = ovs_idl_txn,
+        .ovnsb_idl_txn = ovnsb_idl_txn,
+        .client_ctx = ctrl_engine_ctx,
+    };
+    engine_set_context(&eng_ctx);
+
+    if (lflow_cache_is_enabled(ctrl_engine_ctx->lflow_cache)) {
+        lflow_handle_cached_flows(
+            ctrl_engine_ctx->lflow_cache,
+            sbrec_logical_flow_table_get(ovnsb_idl_loop->idl));
+    }
+
+    long long int start = time_usec();
+    engine_run(ovnsb_idl_txn != NULL);
+    sample->engine_usec += time_usec() - start;
+    sample->n_runs++;
+
+    struct ed_type_lflow_output *lflow_output_data =
+        engine_get_data(&en_lflow_output);
+    struct ed_type_pflow_output *pflow_output_data =
+        engine_get_data(&en_pflow_output);
+    struct ed_type_ct_zones *ct_zones_data = engine_get_data(&en_ct_zones);
+    struct ed_type_lb_data *lb_data = engine_get_data(&en_lb_data);
+    struct ed_type_runtime_data *runtime_data =
+        engine_get_data(&en_runtime_data);
+    if (lflow_output_data && pflow_output_data && ct_zones_data && lb_data) {
+        start = time_usec();
+        ofctrl_put(&lflow_output_data->flow_table,
+                   &pflow_output_data->flow_table,
+                   &ct_zones_data->ctx.pending,
+                   &ct_zones_data->ctx.current,
+                   &lb_data->removed_tuples,
+                   runtime_data ? &runtime_data->local_datapaths : NULL,
+                   sbrec_meter_by_name,
+                   sbrec_ecmp_nexthop_table_get(ovnsb_idl_loop->idl),
+                   0,
+                   engine_node_changed(&en_lflow_output),
+                   engine_node_changed(&en_pflow_output),
+                   engine_get_data(&en_acl_id),
+                   true);
+        sample->ofctrl_put_usec += time_usec() - start;
+        sample->n_lflow_flows =
+            hmap_count(&lflow_output_data->flow_table.match_flow_table);
+        sample->n_pflow_flows =
+            hmap_count(&pflow_output_data->flow_table.match_flow_table);
+    }
+
+    bool again = !ovs_idl_txn || !ovnsb_idl_txn
+                 || engine_has_updated() || engine_canceled();
+
+    again |= ovsdb_idl_loop_commit_and_wait(ovnsb_idl_loop) == -1;
+    again |= ovsdb_idl_loop_commit_and_wait(ovs_idl_loop) == -1;
+    ovsdb_idl_track_clear(ovnsb_idl_loop->idl);
+    ovsdb_idl_track_clear(ovs_idl_loop->idl);
+
+    return again;
+}
+
+/* Forces a full recompute and runs the offline benchmark loop until the
+ * engine and the databases settle.  Records the results as run 'name'. */
+static void
+bench_recompute(struct controller_bench *bench, const char *name,
+                struct ovsdb_idl_loop *ovs_idl_loop,
+                struct ovsdb_idl_loop *ovnsb_idl_loop,
+                struct controller_engine_ctx *ctrl_engine_ctx,
+                struct ovsdb_idl_index *sbrec_meter_by_name)
+{
+    struct controller_bench_sample sample = {0};
+    long long int start = time_usec();
+
+    engine_set_force_recompute();
+    while (bench_run_once(ovs_idl_loop, ovnsb_idl_loop, ctrl_engine_ctx,
+                          sbrec_meter_by_name, &sample)) {
+        if (sample.n_runs >= BENCH_MAX_RUNS) {
+            VLOG_WARN("benchmark run %s didn't settle after %u iterations",
+                      name, sample.n_runs);
+            break;
+        }
+        controller_bench_run_server(bench);
+        poll_immediate_wake();
+        poll_block();
+    }
+    sample.wall_usec = time_usec() - start;
+
+    controller_bench_add_run(bench, name, &sample);
+}
+
+/* Runs the offline flow compilation benchmark and prints its results.
+ * First, all the flows are computed and installed from scratch, then they
+ * are fully recomputed again and compared to the installed ones.  Returns
+ * the exit status of ovn-controller. */
+static int
+run_benchmark(struct controller_bench *bench,
+              struct ovsdb_idl_loop *ovs_idl_loop,
+              struct ovsdb_idl_loop *ovnsb_idl_loop,
+              struct controller_engine_ctx *ctrl_engine_ctx,
+              struct ovsdb_idl_index *sbrec_chassis_by_name,
+              struct ovsdb_idl_index *sbrec_meter_by_name)
+{
+    ofctrl_bench_start();
+    bench_wait_for_dbs(bench, ovs_idl_loop, ovnsb_idl_loop, ctrl_engine_ctx,
+                       sbrec_chassis_by_name);
+
+    engine_clear_all_stats();
+    bench_recompute(bench, "initial", ovs_idl_loop, ovnsb_idl_loop,
+                    ctrl_engine_ctx, sbrec_meter_by_name);
+    bench_recompute(bench, "recompute", ovs_idl_loop, ovnsb_idl_loop,
+                    ctrl_engine_ctx, sbrec_meter_by_name);
+
+    struct simap usage = SIMAP_INITIALIZER(&usage);
+    lflow_cache_get_memory_usage(ctrl_engine_ctx->lflow_cache, &usage);
+    ofctrl_get_memory_usage(&usage);
+    local_datapath_memory_usage(&usage);
+    ovsdb_idl_get_memory_usage(ovnsb_idl_loop->idl, &usage);
+    ovsdb_idl_get_memory_usage(ovs_idl_loop->idl, &usage);
+    controller_bench_report(bench, ctrl_engine_ctx->lflow_cache, &usage);
+    simap_destroy(&usage);
+
+    return EXIT_SUCCESS;
+}
+
+static void
+controller_get_memory_usage(const struct controller_engine_ctx *ctx,
+                            struct ovsdb_idl_loop *ovs_idl_loop,
+                            struct ovsdb_idl_loop *ovnsb_idl_loop,
+                            struct simap *usage)
+{
+    lflow_cache_get_memory_usage(ctx->lflow_cache, usage);
+    ofctrl_get_memory_usage(usage);
+    if_status_mgr_get_memory_usage(ctx->if_mgr, usage);
+    local_datapath_memory_usage(usage);
+    ovsdb_idl_get_memory_usage(ovnsb_idl_loop->idl, usage);
+    ovsdb_idl_get_memory_usage(ovs_idl_loop->idl, usage);
+}
+
+/* Implements ovn_metrics_cb. */
+static void
+controller_put_metrics(struct ds *ds, void *aux_)
+{
+    const struct controller_metrics_aux *aux = aux_;
+    struct simap usage = SIMAP_INITIALIZER(&usage);
+
+    controller_get_memory_usage(aux->ctrl_engine_ctx, aux->ovs_idl_loop,
+                                aux->ovnsb_idl_loop, &usage);
+    ovn_metrics_put_memory(ds, &usage);
+    simap_destroy(&usage);
+
+    lflow_cache_get_metrics(aux->ctrl_engine_ctx->lflow_cache, ds);
+    ofctrl_get_metrics(ds);
+    pinctrl_get_packet_in_metrics(ds);
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -7141,6 +7485,16 @@ main(int argc, char *argv[])
 
     daemonize_complete();
 
+    /* In benchmark mode, connect to the databases served from within the
+     * process. */
+    struct controller_bench *bench = NULL;
+    if (benchmark_sb_file || benchmark_ovs_file || benchmark_chassis) {
+        bench = controller_bench_create(benchmark_sb_file, benchmark_ovs_file,
+                                        benchmark_chassis);
+        free(ovs_remote);
+        ovs_remote = xstrdup(controller_bench_ovs_remote(bench));
+    }
+
     /* Register ofctrl seqno types. */
     ofctrl_seq_type_nb_cfg = ofctrl_seqno_add_type();
 
@@ -7282,16 +7636,22 @@ main(int argc, char *argv[])
 
     update_sb_monitors(ovnsb_idl_loop.idl, NULL, NULL, NULL, NULL, false);
 
-    stopwatch_create(CONTROLLER_LOOP_STOPWATCH_NAME, SW_MS);
-    stopwatch_create(OFCTRL_PUT_STOPWATCH_NAME, SW_MS);
-    stopwatch_create(PINCTRL_RUN_STOPWATCH_NAME, SW_MS);
-    stopwatch_create(PATCH_RUN_STOPWATCH_NAME, SW_MS);
-    stopwatch_create(CT_ZONE_COMMIT_STOPWATCH_NAME, SW_MS);
-    stopwatch_create(IF_STATUS_MGR_RUN_STOPWATCH_NAME, SW_MS);
-    stopwatch_create(IF_STATUS_MGR_UPDATE_STOPWATCH_NAME, SW_MS);
-    stopwatch_create(OFCTRL_SEQNO_RUN_STOPWATCH_NAME, SW_MS);
-    stopwatch_create(BFD_RUN_STOPWATCH_NAME, SW_MS);
-    stopwatch_create(VIF_PLUG_RUN_STOPWATCH_NAME, SW_MS);
+    static const char *stopwatches[] = {
+        CONTROLLER_LOOP_STOPWATCH_NAME,
+        OFCTRL_PUT_STOPWATCH_NAME,
+        PINCTRL_RUN_STOPWATCH_NAME,
+        PATCH_RUN_STOPWATCH_NAME,
+        CT_ZONE_COMMIT_STOPWATCH_NAME,
+        IF_STATUS_MGR_RUN_STOPWATCH_NAME,
+        IF_STATUS_MGR_UPDATE_STOPWATCH_NAME,
+        OFCTRL_SEQNO_RUN_STOPWATCH_NAME,
+        BFD_RUN_STOPWATCH_NAME,
+        VIF_PLUG_RUN_STOPWATCH_NAME,
+    };
+    for (size_t i = 0; i < ARRAY_SIZE(stopwatches); i++) {
+        stopwatch_create(stopwatches[i], SW_MS);
+        ovn_metrics_add_stopwatch(stopwatches[i]);
+    }
 
     inc_proc_ovn_controller_init(&ovnsb_idl_loop, &ovs_idl_loop,
                                  sbrec_chassis_by_name,
@@ -7378,6 +7738,22 @@ main(int argc, char *argv[])
                              lflow_cache_show_stats_cmd,
                              &lflow_output_data->pd);
 
+    struct lflow_profile_aux lflow_profile_aux = {
+        .ovnsb_idl_loop = &ovnsb_idl_loop,
+        .flow_table = &lflow_output_data->flow_table,
+    };
+    unixctl_command_register("lflow/profile-start", "[INTERVAL]", 0, 1,
+                             lflow_profile_start_cmd, NULL);
+    unixctl_command_register("lflow/profile-stop", "", 0, 0,
+                             lflow_profile_stop_cmd, NULL);
+    unixctl_command_register("lflow/profile-show", "[N]", 0, 1,
+                             lflow_profile_show_cmd, &lflow_profile_aux);
+    unixctl_command_register("pinctrl/show-packet-in-stats", "", 0, 0,
+                             pinctrl_show_packet_in_stats_cmd, NULL);
+    unixctl_command_register("pinctrl/show-mcast-snoop-stats", "", 0, 0,
+                             pinctrl_show_mcast_snoop_stats_cmd, NULL);
+    ovn_metrics_init();
+
     bool reset_ovnsb_idl_min_index = false;
     unixctl_command_register("sb-cluster-state-reset", "", 0, 0,
                              cluster_state_reset_cmd,
@@ -7433,6 +7809,17 @@ main(int argc, char *argv[])
         .if_mgr = if_status_mgr_create(),
     };
     struct if_status_mgr *if_mgr = ctrl_engine_ctx.if_mgr;
+    unixctl_command_register("if-status-mgr/latency-show", "[N]", 0, 1,
+                             if_status_mgr_latency_show_cmd, if_mgr);
+    unixctl_command_register("if-status-mgr/latency-reset", "", 0, 0,
+                             if_status_mgr_latency_reset_cmd, if_mgr);
+
+    struct controller_metrics_aux metrics_aux = {
+        .ctrl_engine_ctx = &ctrl_engine_ctx,
+        .ovs_idl_loop = &ovs_idl_loop,
+        .ovnsb_idl_loop = &ovnsb_idl_loop,
+    };
+    ovn_metrics_register(controller_put_metrics, &metrics_aux);
 
     struct shash vif_plug_deleted_iface_ids =
         SHASH_INITIALIZER(&vif_plug_deleted_iface_ids);
@@ -7442,6 +7829,15 @@ main(int argc, char *argv[])
     char *ovn_version = ovn_get_internal_version();
     VLOG_INFO("OVN internal version is : [%s]", ovn_version);
 
+    if (bench) {
+        retval = run_benchmark(bench, &ovs_idl_loop, &ovnsb_idl_loop,
+                               &ctrl_engine_ctx, sbrec_chassis_by_name,
+                               sbrec_meter_by_name);
+        /* Leave the databases as they are, they aren't saved anyway. */
+        exit_args.exiting = true;
+        exit_args.restart = true;
+    }
+
     /* Main loop. */
     int ovnsb_txn_status = 1;
     bool sb_monitor_all = false;
@@ -7453,12 +7849,8 @@ main(int argc, char *argv[])
         if (memory_should_report()) {
             struct simap usage = SIMAP_INITIALIZER(&usage);
 
-            lflow_cache_get_memory_usage(ctrl_engine_ctx.lflow_cache, &usage);
-            ofctrl_get_memory_usage(&usage);
-            if_status_mgr_get_memory_usage(if_mgr, &usage);
-            local_datapath_memory_usage(&usage);
-            ovsdb_idl_get_memory_usage(ovnsb_idl_loop.idl, &usage);
-            ovsdb_idl_get_memory_usage(ovs_idl_loop.idl, &usage);
+            controller_get_memory_usage(&ctrl_engine_ctx, &ovs_idl_loop,
+                                        &ovnsb_idl_loop, &usage);
             memory_report(&usage);
             simap_destroy(&usage);
         }
@@ -7985,6 +8377,7 @@ main(int argc, char *argv[])
         if (!ovnsb_txn_status) {
             VLOG_INFO("OVNSB commit failed, force recompute next time.");
             engine_set_force_recompute_immediate();
+            pinctrl_ovnsb_commit_failed();
         } else if (ovnsb_txn_status == 1) {
             ovsdb_idl_loop_next_cfg_inc(&ovnsb_idl_loop);
         } else if (ovnsb_txn_status == -1) {
@@ -8110,6 +8503,7 @@ loop_done:
      * destroyed and joined in case they are accessing engine data. */
     pinctrl_destroy();
     statctrl_destroy();
+    lflow_profile_destroy();
 
     engine_set_context(NULL);
     engine_cleanup();
@@ -8129,6 +8523,7 @@ loop_done:
 
     ovsdb_idl_loop_destroy(&ovs_idl_loop);
     ovsdb_idl_loop_destroy(&ovnsb_idl_loop);
+    controller_bench_destroy(bench);
 
     ovs_feature_support_destroy();
     free(br_int_remote.target);
@@ -8174,6 +8569,9 @@ parse_options(int argc, char *argv[])
         SSL_OPTION_ENUMS,
         OPT_ENABLE_DUMMY_VIF_PLUG,
         OPT_DUMP_INC_PROC_GRAPH,
+        OPT_BENCHMARK_SB,
+        OPT_BENCHMARK_OVS,
+        OPT_BENCHMARK_CHASSIS,
     };
 
     static struct option long_options[] = {
@@ -8190,6 +8588,10 @@ parse_options(int argc, char *argv[])
          OPT_ENABLE_DUMMY_VIF_PLUG},
         {"dump-inc-proc-graph", optional_argument, NULL,
          OPT_DUMP_INC_PROC_GRAPH},
+        {"benchmark-sb", required_argument, NULL, OPT_BENCHMARK_SB},
+        {"benchmark-ovs", required_argument, NULL, OPT_BENCHMARK_OVS},
+        {"benchmark-chassis", required_argument, NULL,
+         OPT_BENCHMARK_CHASSIS},
         {NULL, 0, NULL, 0}
     };
     char *short_options = ovs_cmdl_long_options_to_short_options(long_options);
@@ -8266,6 +8668,18 @@ parse_options(int argc, char *argv[])
             inc_proc_graph_dump(optarg);
             exit(EXIT_SUCCESS);
 
+        case OPT_BENCHMARK_SB:
+            benchmark_sb_file = optarg;
+            break;
+
+        case OPT_BENCHMARK_OVS:
+            benchmark_ovs_file = optarg;
+            break;
+
+        case OPT_BENCHMARK_CHASSIS:
+            benchmark_chassis = optarg;
+            break;
+
         case 'n':
             free(cli_system_id);
             cli_system_id = xstrdup(optarg);
@@ -8308,6 +8722,10 @@ usage(void)
     printf("\nOther options:\n"
            "  -u, --unixctl=SOCKET    set control socket name\n"
            "  -n                      custom chassis name\n"
+           "  --benchmark-sb=FILE     offline benchmark on SB database FILE\n"
+           "  --benchmark-ovs=FILE    offline benchmark on OVS database FILE\n"
+           "  --benchmark-chassis=NAME\n"
+           "                          offline benchmark as chassis NAME\n"
            "  -h, --help              display this help message\n"
            "  -V, --version           display version information\n");
     exit(EXIT_SUCCESS);
@@ -8404,6 +8822,104 @@ lflow_cache_show_stats_cmd(struct unixctl_conn *conn, int argc OVS_UNUSED,
     ds_destroy(&ds);
 }
 
+static void
+lflow_profile_start_cmd(struct unixctl_conn *conn, int argc,
+                        const char *argv[], void *arg OVS_UNUSED)
+{
+    unsigned int interval = 5;
+
+    if (argc > 1 && (!str_to_uint(argv[1], 10, &interval) || !interval)) {
+        unixctl_command_reply_error(conn, "Invalid interval.");
+        return;
+    }
+
+    lflow_profile_start(interval);
+    unixctl_command_reply(conn, NULL);
+}
+
+static void
+lflow_profile_stop_cmd(struct unixctl_conn *conn, int argc OVS_UNUSED,
+                       const char *argv[] OVS_UNUSED, void *arg OVS_UNUSED)
+{
+    lflow_profile_stop();
+    unixctl_command_reply(conn, NULL);
+}
+
+static void
+lflow_profile_show_cmd(struct unixctl_conn *conn, int argc,
+                       const char *argv[], void *arg_)
+{
+    struct lflow_profile_aux *aux = arg_;
+    unsigned int top_n = 10;
+
+    if (argc > 1 && (!str_to_uint(argv[1], 10, &top_n) || !top_n)) {
+        unixctl_command_reply_error(conn, "Invalid number of logical flows.");
+        return;
+    }
+
+    struct ds ds = DS_EMPTY_INITIALIZER;
+    lflow_profile_show(&ds,
+                       sbrec_logical_flow_table_get(aux->ovnsb_idl_loop->idl),
+                       aux->flow_table, top_n);
+    unixctl_command_reply(conn, ds_cstr(&ds));
+    ds_destroy(&ds);
+}
+
+static void
+if_status_mgr_latency_show_cmd(struct unixctl_conn *conn, int argc,
+                               const char *argv[], void *if_mgr_)
+{
+    struct if_status_mgr *if_mgr = if_mgr_;
+    unsigned int top_n = 10;
+
+    if (argc > 1 && !str_to_uint(argv[1], 10, &top_n)) {
+        unixctl_command_reply_error(conn, "Invalid number of interfaces.");
+        return;
+    }
+
+    struct ds ds = DS_EMPTY_INITIALIZER;
+    if_status_mgr_latency_show(if_mgr, &ds, top_n);
+    unixctl_command_reply(conn, ds_cstr(&ds));
+    ds_destroy(&ds);
+}
+
+static void
+if_status_mgr_latency_reset_cmd(struct unixctl_conn *conn,
+                                int argc OVS_UNUSED,
+                                const char *argv[] OVS_UNUSED, void *if_mgr_)
+{
+    struct if_status_mgr *if_mgr = if_mgr_;
+
+    if_status_mgr_latency_reset(if_mgr);
+    unixctl_command_reply(conn, NULL);
+}
+
+static void
+pinctrl_show_packet_in_stats_cmd(struct unixctl_conn *conn,
+                                 int argc OVS_UNUSED,
+                                 const char *argv[] OVS_UNUSED,
+                                 void *arg OVS_UNUSED)
+{
+    struct ds ds = DS_EMPTY_INITIALIZER;
+
+    pinctrl_get_packet_in_stats(&ds);
+    unixctl_command_reply(conn, ds_cstr(&ds));
+    ds_destroy(&ds);
+}
+
+static void
+pinctrl_show_mcast_snoop_stats_cmd(struct unixctl_conn *conn,
+                                   int argc OVS_UNUSED,
+                                   const char *argv[] OVS_UNUSED,
+                                   void *arg OVS_UNUSED)
+{
+    struct ds ds = DS_EMPTY_INITIALIZER;
+
+    pinctrl_get_mcast_snoop_stats(&ds);
+    unixctl_command_reply(conn, ds_cstr(&ds));
+    ds_destroy(&ds);
+}
+
 static void
 cluster_state_reset_cmd(struct unixctl_conn *conn, int argc OVS_UNUSED,
                const char *argv[] OVS_UNUSED, void *idl_reset_)
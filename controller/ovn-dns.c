@@ -19,6 +19,8 @@
 #include "include/openvswitch/shash.h"
 #include "include/openvswitch/thread.h"
 #include "lib/cmap.h"
+#include "lib/hash.h"
+#include "lib/ovs-atomic.h"
 #include "openvswitch/vlog.h"
 
 /* OVN includes. */
@@ -41,6 +43,19 @@ struct dns_data {
 /* shash of 'struct dns_data'. */
 static struct cmap dns_cache_;
 
+/* Cache of 'struct ovn_dns_answer', hashed by datapath and query name.
+ *
+ * Entries are inserted by the pinctrl threads that build the answers and
+ * removed by the main thread whenever a DNS record with a matching name and
+ * datapath changes.  Readers walk the cmap under RCU protection, writers
+ * are serialized by 'dns_answers_mutex'.  'dns_answers_seqno' is
+ * incremented on every invalidation so that an answer built from a DNS
+ * record that changed in the meantime is never inserted. */
+#define DNS_ANSWERS_MAX 65536
+static struct cmap dns_answers_;
+static struct ovs_mutex dns_answers_mutex = OVS_MUTEX_INITIALIZER;
+static atomic_uint64_t dns_answers_seqno = 0;
+
 static void update_cache_with_dns_rec(const struct sbrec_dns *,
                                       struct dns_data *,
                                       const struct uuid *uuid,
@@ -50,11 +65,14 @@ static struct dns_data *dns_data_find(const struct uuid *uuid,
 static struct dns_data *dns_data_alloc(struct uuid uuid);
 static void dns_data_destroy(struct dns_data *dns_data);
 static void destroy_dns_cache(struct cmap *dns_cache);
+static void dns_answers_invalidate(const struct dns_data *);
+static void dns_answers_flush(void);
 
 void
 ovn_dns_cache_init(void)
 {
     cmap_init(&dns_cache_);
+    cmap_init(&dns_answers_);
 }
 
 void
@@ -62,6 +80,8 @@ ovn_dns_cache_destroy(void)
 {
     destroy_dns_cache(&dns_cache_);
     cmap_destroy(&dns_cache_);
+    dns_answers_flush();
+    cmap_destroy(&dns_answers_);
 }
 
 void
@@ -88,6 +108,8 @@ ovn_dns_sync_cache(const struct sbrec_dns_table *dns_table)
             ovsrcu_postpone(dns_data_destroy, existing);
         }
     }
+
+    dns_answers_flush();
 }
 
 void
@@ -103,6 +125,7 @@ ovn_dns_update_cache(const struct sbrec_dns_table *dns_table)
         if (sbrec_dns_is_deleted(sbrec_dns) && existing) {
             cmap_remove(&dns_cache_, &existing->cmap_node,
                         uuid_hash(&existing->uuid));
+            dns_answers_invalidate(existing);
             ovsrcu_postpone(dns_data_destroy, existing);
         } else {
             update_cache_with_dns_rec(sbrec_dns, existing, uuid,
@@ -144,6 +167,92 @@ ovn_dns_lookup(const char *query_name, uint64_t dp_key, bool *ovn_owned)
     return answer_data;
 }
 
+static uint32_t
+dns_answer_hash(const char *query_name, uint64_t dp_key)
+{
+    return hash_string(query_name, hash_uint64(dp_key));
+}
+
+struct ovn_dns_answer *
+ovn_dns_answer_alloc(const char *query_name, uint64_t dp_key,
+                     uint16_t query_type, bool ovn_owned)
+{
+    struct ovn_dns_answer *answer = xzalloc(sizeof *answer);
+    answer->dp_key = dp_key;
+    answer->query_name = xstrdup(query_name);
+    answer->query_type = query_type;
+    answer->ovn_owned = ovn_owned;
+    for (size_t i = 0; i < ARRAY_SIZE(answer->rrs); i++) {
+        ofpbuf_init(&answer->rrs[i], 0);
+    }
+    return answer;
+}
+
+void
+ovn_dns_answer_destroy(struct ovn_dns_answer *answer)
+{
+    if (!answer) {
+        return;
+    }
+    for (size_t i = 0; i < ARRAY_SIZE(answer->rrs); i++) {
+        ofpbuf_uninit(&answer->rrs[i]);
+    }
+    free(answer->query_name);
+    free(answer);
+}
+
+/* Returns the cached answer for 'query_name' (in lowercase) and
+ * 'query_type' on datapath 'dp_key', if any.  The answer remains valid
+ * until the calling thread quiesces. */
+const struct ovn_dns_answer *
+ovn_dns_answer_lookup(const char *query_name, uint64_t dp_key,
+                      uint16_t query_type)
+{
+    struct ovn_dns_answer *answer;
+    CMAP_FOR_EACH_WITH_HASH (answer, cmap_node,
+                             dns_answer_hash(query_name, dp_key),
+                             &dns_answers_) {
+        if (answer->dp_key == dp_key && answer->query_type == query_type
+            && !strcmp(answer->query_name, query_name)) {
+            return answer;
+        }
+    }
+    return NULL;
+}
+
+/* Returns the current sequence number of the answer cache.  It must be
+ * read before looking up the DNS records the answer is built from, and
+ * passed to ovn_dns_answer_cache_insert(). */
+uint64_t
+ovn_dns_answer_cache_seqno(void)
+{
+    uint64_t seqno;
+    atomic_read(&dns_answers_seqno, &seqno);
+    return seqno;
+}
+
+/* Inserts 'answer' in the cache, taking ownership of it.  The answer is
+ * destroyed instead if the cache was invalidated since 'seqno' was read,
+ * if the cache is full or if another thread already inserted the same
+ * answer. */
+void
+ovn_dns_answer_cache_insert(struct ovn_dns_answer *answer, uint64_t seqno)
+{
+    uint32_t hash = dns_answer_hash(answer->query_name, answer->dp_key);
+
+    ovs_mutex_lock(&dns_answers_mutex);
+    if (seqno == ovn_dns_answer_cache_seqno()
+        && cmap_count(&dns_answers_) < DNS_ANSWERS_MAX
+        && !ovn_dns_answer_lookup(answer->query_name, answer->dp_key,
+                                  answer->query_type)) {
+        cmap_insert(&dns_answers_, &answer->cmap_node, hash);
+        answer = NULL;
+    }
+    ovs_mutex_unlock(&dns_answers_mutex);
+
+    ovn_dns_answer_destroy(answer);
+}
+
 
 /* Static functions. */
 static void
@@ -167,8 +276,10 @@ update_cache_with_dns_rec(const struct sbrec_dns *sbrec_dns,
     } else {
         cmap_replace(dns_cache, &existing->cmap_node, &dns_data->cmap_node,
                      uuid_hash(uuid));
+        dns_answers_invalidate(existing);
         ovsrcu_postpone(dns_data_destroy, existing);
     }
+    dns_answers_invalidate(dns_data);
 }
 
 static struct dns_data *
@@ -216,3 +327,54 @@ destroy_dns_cache(struct cmap *dns_cache)
         ovsrcu_postpone(dns_data_destroy, dns_data);
     }
 }
+
+/* Removes from the answer cache all the answers to queries for the names
+ * of 'dns_data' on its datapaths.  Must be called after 'dns_data' was
+ * inserted in, replaced in or removed from the DNS cache. */
+static void
+dns_answers_invalidate(const struct dns_data *dns_data)
+{
+    uint64_t orig;
+
+    ovs_mutex_lock(&dns_answers_mutex);
+    atomic_add(&dns_answers_seqno, 1, &orig);
+
+    struct smap_node *node;
+    SMAP_FOR_EACH (node, &dns_data->records) {
+        if (cmap_is_empty(&dns_answers_)) {
+            break;
+        }
+        for (size_t i = 0; i < dns_data->n_dps; i++) {
+            uint64_t dp_key = dns_data->dps[i];
+            uint32_t hash = dns_answer_hash(node->key, dp_key);
+            struct ovn_dns_answer *answer;
+
+            CMAP_FOR_EACH_WITH_HASH (answer, cmap_node, hash,
+                                     &dns_answers_) {
+                if (answer->dp_key == dp_key
+                    && !strcmp(answer->query_name, node->key)) {
+                    cmap_remove(&dns_answers_, &answer->cmap_node, hash);
+                    ovsrcu_postpone(ovn_dns_answer_destroy, answer);
+                }
+            }
+        }
+    }
+    ovs_mutex_unlock(&dns_answers_mutex);
+}
+
+static void
+dns_answers_flush(void)
+{
+    struct ovn_dns_answer *answer;
+    uint64_t orig;
+
+    ovs_mutex_lock(&dns_answers_mutex);
+    atomic_add(&dns_answers_seqno, 1, &orig);
+
+    CMAP_FOR_EACH (answer, cmap_node, &dns_answers_) {
+        cmap_remove(&dns_answers_, &answer->cmap_node,
+                    dns_answer_hash(answer->query_name, answer->dp_key));
+        ovsrcu_postpone(ovn_dns_answer_destroy, answer);
+    }
+    ovs_mutex_unlock(&dns_answers_mutex);
+}
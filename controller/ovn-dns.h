@@ -16,9 +16,29 @@
 #ifndef OVN_DNS_H
 #define OVN_DNS_H
 
+#include "cmap.h"
+#include "openvswitch/ofpbuf.h"
+
 struct shash;
 struct sbrec_dns_table;
 
+/* Pre-encoded answer to a DNS query for 'query_name' and 'query_type' on
+ * the datapath with tunnel key 'dp_key'.
+ *
+ * The resource records are stored without their NAME, which is copied from
+ * the query when building the reply.  'rrs[0]' holds the A or PTR records
+ * and 'rrs[1]' the AAAA records, 'n_rrs[i]' records of the same length
+ * each, so that they can be shuffled for every reply. */
+struct ovn_dns_answer {
+    struct cmap_node cmap_node;
+    uint64_t dp_key;
+    char *query_name;           /* Lowercase. */
+    uint16_t query_type;
+    bool ovn_owned;
+    struct ofpbuf rrs[2];
+    size_t n_rrs[2];
+};
+
 void ovn_dns_cache_init(void);
 void ovn_dns_cache_destroy(void);
 void ovn_dns_sync_cache(const struct sbrec_dns_table *);
@@ -26,4 +46,15 @@ void ovn_dns_update_cache(const struct sbrec_dns_table *);
 const char *ovn_dns_lookup(const char *query_name, uint64_t dp_key,
                            bool *ovn_owned);
 
+struct ovn_dns_answer *ovn_dns_answer_alloc(const char *query_name,
+                                            uint64_t dp_key,
+                                            uint16_t query_type,
+                                            bool ovn_owned);
+void ovn_dns_answer_destroy(struct ovn_dns_answer *);
+const struct ovn_dns_answer *ovn_dns_answer_lookup(const char *query_name,
+                                                   uint64_t dp_key,
+                                                   uint16_t query_type);
+uint64_t ovn_dns_answer_cache_seqno(void);
+void ovn_dns_answer_cache_insert(struct ovn_dns_answer *, uint64_t seqno);
+
 #endif /* OVN_DNS_H */
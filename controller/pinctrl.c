@@ -28,6 +28,7 @@
 #include "local_data.h"
 #include "lport.h"
 #include "mac-cache.h"
+#include "mpsc-queue.h"
 #include "nx-match.h"
 #include "ofctrl.h"
 #include "latch.h"
@@ -41,6 +42,10 @@
 #include "openvswitch/ofp-switch.h"
 #include "openvswitch/ofp-util.h"
 #include "openvswitch/vlog.h"
+#include "ovs-atomic.h"
+#include "ovs-thread.h"
+#include "ovs-usdt.h"
+#include "lib/ovn-metrics.h"
 #include "lib/random.h"
 #include "lib/crc32c.h"
 
@@ -53,6 +58,7 @@
 #include "lib/mcast-group-index.h"
 #include "lib/ovn-l7.h"
 #include "lib/ovn-util.h"
+#include "lib/timer-wheel.h"
 #include "ovn/logical-fields.h"
 #include "openvswitch/poll-loop.h"
 #include "openvswitch/rconn.h"
@@ -86,9 +92,9 @@ VLOG_DEFINE_THIS_MODULE(pinctrl);
  *   - put_arp/put_nd - These actions stores the IPv4/IPv6 and MAC addresses
  *                      in the 'MAC_Binding' table.
  *                      The function 'pinctrl_handle_put_mac_binding()' (which
- *                      is called with in the pinctrl_handler thread), stores
- *                      the IPv4/IPv6 and MAC addresses in the
- *                      hmap - put_mac_bindings.
+ *                      is called within a packet-in worker or the
+ *                      pinctrl_handler thread), stores the IPv4/IPv6 and MAC
+ *                      addresses in the hmap - put_mac_bindings.
  *
  *                      pinctrl_run(), reads these mac bindings from the hmap
  *                      'put_mac_bindings' and writes to the 'MAC_Binding'
@@ -119,16 +125,23 @@ VLOG_DEFINE_THIS_MODULE(pinctrl);
  *                      ip_mcast_snoop_run() which runs in the
  *                      pinctrl_handler() thread configures the per datapath
  *                      mcast_snoop_map entries according to mcast_cfg_map.
+ *                      The groups changed by reports and member timeouts
+ *                      are tracked per datapath so that ip_mcast_sync()
+ *                      only writes those, walking all the groups only on
+ *                      configuration changes and periodically.
  *
  * pinctrl module also periodically sends IPv6 Router Solicitation requests
  * and gARPs (for the router gateway IPs and configured NAT addresses).
  *
  * IPv6 RA handling - pinctrl_run() prepares the IPv6 RA information
- *                    (see prepare_ipv6_ras()) in the shash 'ipv6_ras' by
+ *                    (see prepare_ipv6_ras()) in the cmap 'ipv6_ras' by
  *                    looking into the Southbound DB table - Port_Binding.
+ *                    The RA configuration of a port is immutable once
+ *                    published, pinctrl_run() replaces it with RCU only if
+ *                    it changed.
  *
  *                    pinctrl_handler thread sends the periodic IPv6 RAs using
- *                    the shash - 'ipv6_ras'
+ *                    the cmap - 'ipv6_ras', without taking 'pinctrl_mutex'.
  *
  * g/rARP handling    - pinctrl_run() prepares the g/rARP information
  *                     (see send_garp_rarp_prepare()) in the shash
@@ -144,6 +157,17 @@ VLOG_DEFINE_THIS_MODULE(pinctrl);
  *                    pinctrl_handler thread sends the periodic IGMP queries
  *                    by walking the mcast_query_list.
  *
+ * Packet-in workers - When 'external_ids:ovn-pinctrl-packet-in-threads' is
+ *                    set in the local Open_vSwitch table, pinctrl_handler
+ *                    only decodes the packet-ins and hands them off to that
+ *                    many worker threads through lock-free queues.  The
+ *                    packet-ins are sharded by packet type and datapath so
+ *                    that packets of the same type on the same datapath are
+ *                    still processed in order.  Handlers that access shared
+ *                    state keep taking 'pinctrl_mutex'.  IGMP/MLD packets
+ *                    are always processed by pinctrl_handler because the
+ *                    multicast snooping state is owned by that thread.
+ *
  * Notification between pinctrl_handler() and pinctrl_run()
  * -------------------------------------------------------
  * 'struct seq' is used for notification between pinctrl_handler() thread
@@ -206,9 +230,13 @@ static void run_put_mac_bindings(
     struct ovsdb_idl_txn *ovnsb_idl_txn,
     struct ovsdb_idl_index *sbrec_datapath_binding_by_key,
     struct ovsdb_idl_index *sbrec_port_binding_by_key,
-    struct ovsdb_idl_index *sbrec_mac_binding_by_lport_ip)
+    struct ovsdb_idl_index *sbrec_mac_binding_by_lport_ip,
+    size_t *budget)
     OVS_REQUIRES(pinctrl_mutex);
 static void wait_put_mac_bindings(void);
+static size_t learned_entries_configure(
+    const struct ovsrec_open_vswitch_table *ovs_table)
+    OVS_REQUIRES(pinctrl_mutex);
 static void send_mac_binding_buffered_pkts(struct rconn *swconn)
     OVS_REQUIRES(pinctrl_mutex);
 
@@ -267,11 +295,9 @@ static void destroy_ipv6_ras(void);
 static void ipv6_ra_wait(long long int send_ipv6_ra_time);
 static void prepare_ipv6_ras(
         const struct shash *local_active_ports_ras,
-        struct ovsdb_idl_index *sbrec_port_binding_by_name)
-    OVS_REQUIRES(pinctrl_mutex);
+        struct ovsdb_idl_index *sbrec_port_binding_by_name);
 static void send_ipv6_ras(struct rconn *swconn,
-                          long long int *send_ipv6_ra_time)
-    OVS_REQUIRES(pinctrl_mutex);
+                          long long int *send_ipv6_ra_time);
 
 static void ip_mcast_snoop_init(void);
 static void ip_mcast_snoop_destroy(void);
@@ -280,6 +306,8 @@ static void ip_mcast_snoop_run(void)
 static void ip_mcast_querier_run(struct rconn *swconn,
                                  long long int *query_time);
 static void ip_mcast_querier_wait(long long int query_time);
+static void ip_mcast_sync_failed(void)
+    OVS_REQUIRES(pinctrl_mutex);
 static void ip_mcast_sync(
     struct ovsdb_idl_txn *ovnsb_idl_txn,
     const struct sbrec_chassis *chassis,
@@ -374,9 +402,11 @@ static void run_put_fdbs(struct ovsdb_idl_txn *ovnsb_idl_txn,
             struct ovsdb_idl_index *sbrec_port_binding_by_key,
             struct ovsdb_idl_index *sbrec_datapath_binding_by_key,
                         struct ovsdb_idl_index *sbrec_fdb_by_dp_key_mac,
-                        uint64_t cur_cfg)
+                        uint64_t cur_cfg, size_t *budget)
                         OVS_REQUIRES(pinctrl_mutex);
 static void wait_put_fdbs(void);
+static void put_fdbs_commit_failed(void)
+    OVS_REQUIRES(pinctrl_mutex);
 static void pinctrl_handle_put_fdb(const struct flow *md,
                                    const struct flow *headers)
                                    OVS_REQUIRES(pinctrl_mutex);
@@ -385,11 +415,22 @@ static void set_from_ctrl_flag_in_pkt_metadata(struct ofputil_packet_in *);
 
 COVERAGE_DEFINE(pinctrl_drop_put_mac_binding);
 COVERAGE_DEFINE(pinctrl_drop_put_fdb);
+COVERAGE_DEFINE(pinctrl_mac_binding_coalesced);
+COVERAGE_DEFINE(pinctrl_mac_binding_suppressed);
+COVERAGE_DEFINE(pinctrl_mac_binding_committed);
+COVERAGE_DEFINE(pinctrl_mac_binding_deferred);
+COVERAGE_DEFINE(pinctrl_fdb_coalesced);
+COVERAGE_DEFINE(pinctrl_fdb_suppressed);
+COVERAGE_DEFINE(pinctrl_fdb_committed);
+COVERAGE_DEFINE(pinctrl_fdb_deferred);
 COVERAGE_DEFINE(pinctrl_drop_buffered_packets_map);
 COVERAGE_DEFINE(pinctrl_drop_controller_event);
 COVERAGE_DEFINE(pinctrl_drop_put_vport_binding);
 COVERAGE_DEFINE(pinctrl_notify_main_thread);
 COVERAGE_DEFINE(pinctrl_total_pin_pkts);
+COVERAGE_DEFINE(pinctrl_packet_out);
+COVERAGE_DEFINE(pinctrl_dhcp_reply_cache_hit);
+COVERAGE_DEFINE(pinctrl_dhcp_reply_cache_miss);
 
 /* DNS query statistics - thread-safe coverage counters */
 COVERAGE_DEFINE(dns_query_total);
@@ -400,6 +441,8 @@ COVERAGE_DEFINE(dns_query_type_any);
 COVERAGE_DEFINE(dns_query_type_other);
 COVERAGE_DEFINE(dns_cache_hit);
 COVERAGE_DEFINE(dns_cache_miss);
+COVERAGE_DEFINE(dns_answer_cache_hit);
+COVERAGE_DEFINE(dns_answer_cache_miss);
 COVERAGE_DEFINE(dns_error_truncated);
 COVERAGE_DEFINE(dns_skipped_not_request);
 COVERAGE_DEFINE(dns_error_no_query);
@@ -590,6 +633,13 @@ queue_msg(struct rconn *swconn, struct ofpbuf *msg)
     return xid;
 }
 
+static void
+queue_packet_out(struct rconn *swconn, struct ofpbuf *msg)
+{
+    COVERAGE_INC(pinctrl_packet_out);
+    queue_msg(swconn, msg);
+}
+
 /* Sets up 'swconn', a newly (re)connected connection to a switch. */
 static void
 pinctrl_setup(struct rconn *swconn)
@@ -629,7 +679,7 @@ enqueue_packet(struct rconn *swconn, enum ofp_version version,
 
     match_set_in_port(&po.flow_metadata, OFPP_CONTROLLER);
     enum ofputil_protocol proto = ofputil_protocol_from_ofp_version(version);
-    queue_msg(swconn, ofputil_encode_packet_out(&po, proto));
+    queue_packet_out(swconn, ofputil_encode_packet_out(&po, proto));
 }
 
 static void
@@ -741,7 +791,7 @@ pinctrl_forward_pkt(struct rconn *swconn, int64_t dp_key,
     };
     match_set_in_port(&po.flow_metadata, OFPP_CONTROLLER);
     enum ofputil_protocol proto = ofputil_protocol_from_ofp_version(version);
-    queue_msg(swconn, ofputil_encode_packet_out(&po, proto));
+    queue_packet_out(swconn, ofputil_encode_packet_out(&po, proto));
     ofpbuf_uninit(&ofpacts);
 }
 
@@ -973,7 +1023,7 @@ pinctrl_parse_dhcpv6_advt(struct rconn *swconn, const struct flow *ip_flow,
     };
     match_set_in_port(&po.flow_metadata, OFPP_CONTROLLER);
     enum ofputil_protocol proto = ofputil_protocol_from_ofp_version(version);
-    queue_msg(swconn, ofputil_encode_packet_out(&po, proto));
+    queue_packet_out(swconn, ofputil_encode_packet_out(&po, proto));
     dp_packet_uninit(&packet);
     ofpbuf_uninit(&ofpacts);
 
@@ -1255,7 +1305,7 @@ ipv6_prefixd_send(struct rconn *swconn, struct ipv6_prefixd_state *pfd)
     match_set_in_port(&po.flow_metadata, OFPP_CONTROLLER);
     enum ofp_version version = rconn_get_version(swconn);
     enum ofputil_protocol proto = ofputil_protocol_from_ofp_version(version);
-    queue_msg(swconn, ofputil_encode_packet_out(&po, proto));
+    queue_packet_out(swconn, ofputil_encode_packet_out(&po, proto));
     dp_packet_uninit(&packet);
     ofpbuf_uninit(&ofpacts);
 
@@ -1538,7 +1588,7 @@ destroy_buffered_packets_ctx(void)
     buffered_packets_ctx_destroy(&buffered_packets_ctx);
 }
 
-/* Called with in the pinctrl_handler thread context. */
+/* Called within a packet-in worker or the pinctrl_handler thread context. */
 static void
 pinctrl_handle_buffered_packets(const struct ofputil_packet_in *pin,
                                 const struct ofpbuf *continuation,
@@ -1567,13 +1617,14 @@ OVS_REQUIRES(pinctrl_mutex)
         return;
     }
 
-    buffered_packets_packet_data_enqueue(bp, pin, continuation);
+    buffered_packets_packet_data_enqueue(&buffered_packets_ctx, bp, pin,
+                                         continuation);
 
     /* There is a chance that the MAC binding was already created. */
     notify_pinctrl_main();
 }
 
-/* Called with in the pinctrl_handler thread context. */
+/* Called within a packet-in worker or the pinctrl_handler thread context. */
 static void
 pinctrl_handle_arp(struct rconn *swconn, const struct flow *ip_flow,
                    const struct ofputil_packet_in *pin,
@@ -1637,7 +1688,7 @@ pinctrl_handle_arp(struct rconn *swconn, const struct flow *ip_flow,
     dp_packet_uninit(&packet);
 }
 
-/* Called with in the pinctrl_handler thread context. */
+/* Called within a packet-in worker or the pinctrl_handler thread context. */
 static void
 pinctrl_handle_icmp(struct rconn *swconn, const struct flow *ip_flow,
                     struct dp_packet *pkt_in,
@@ -1803,7 +1854,7 @@ pinctrl_handle_icmp(struct rconn *swconn, const struct flow *ip_flow,
     ofpbuf_uninit(&ofpacts);
 }
 
-/* Called with in the pinctrl_handler thread context. */
+/* Called within a packet-in worker or the pinctrl_handler thread context. */
 static void
 pinctrl_handle_tcp_reset(struct rconn *swconn, const struct flow *ip_flow,
                          struct dp_packet *pkt_in,
@@ -2181,7 +2232,7 @@ dhcp_parse_options(const char **in_dhcp_pptr, const char *end)
     return parsed_dhcp_opts;
 }
 
-/* Called with in the pinctrl_handler thread context. */
+/* Called within a packet-in worker or the pinctrl_handler thread context. */
 static void
 pinctrl_handle_dhcp_relay_req_chk(struct rconn *swconn,
                                   struct dp_packet *pkt_in,
@@ -2326,7 +2377,7 @@ exit:
     }
 }
 
-/* Called with in the pinctrl_handler thread context. */
+/* Called within a packet-in worker or the pinctrl_handler thread context. */
 static void
 pinctrl_handle_dhcp_relay_resp_chk(
     struct rconn *swconn,
@@ -2538,7 +2589,136 @@ exit:
     }
 }
 
-/* Called with in the pinctrl_handler thread context. */
+/* Cache of the encoded DHCP and DHCPv6 reply options.
+ *
+ * The options of a reply only depend on the options carried by the
+ * userdata of the put_dhcp_opts and put_dhcpv6_opts actions, and on a few
+ * fields of the request.  The key of an entry is made of these request
+ * fields followed by the userdata options, so an entry can never be used
+ * once the DHCP_Options it was built from change: the logical flows carry
+ * new userdata and the stale entry is no longer hit.  The DHCPv4 offered
+ * address is pulled from the userdata before the key is built, it is not
+ * part of the key: it is not encoded in the reply options, only copied to
+ * the yiaddr field of each reply.  The DHCPv6 offered address is an IA_NA
+ * option, hence part of the key.  Reply packets built from an entry only
+ * differ by the headers copied from the request (xid, client MAC) and by
+ * the addresses, lengths and checksums that are filled in for each reply.
+ *
+ * The cache can be accessed by several packet-in worker threads, hence the
+ * mutex.  It is flushed when it reaches DHCP_REPLY_CACHE_MAX_ENTRIES. */
+#define DHCP_REPLY_CACHE_MAX_ENTRIES 4096
+
+struct dhcp_reply_cache_entry {
+    struct hmap_node hmap_node;
+    struct ofpbuf *key;
+    struct ofpbuf *reply_opts;
+    ovs_be32 next_server;       /* DHCPv4 only. */
+};
+
+/* Request fields the DHCPv4 reply options depend on. */
+struct dhcp_reply_cache_key {
+    uint8_t family;             /* AF_INET. */
+    uint8_t req_msg_type;
+    uint8_t msg_type;
+    uint8_t ipxe_req;
+    ovs_be32 siaddr;
+};
+
+/* Request fields the DHCPv6 reply options depend on. */
+struct dhcpv6_reply_cache_key {
+    uint8_t family;             /* AF_INET6. */
+    uint8_t status_only;
+    uint8_t ipxe_req;
+    uint8_t fqdn_flags;
+    ovs_be32 iaid;
+};
+
+static struct ovs_mutex dhcp_reply_cache_mutex = OVS_MUTEX_INITIALIZER;
+static struct hmap dhcp_reply_cache OVS_GUARDED_BY(dhcp_reply_cache_mutex)
+    = HMAP_INITIALIZER(&dhcp_reply_cache);
+
+static void
+dhcp_reply_cache_flush(void)
+    OVS_REQUIRES(dhcp_reply_cache_mutex)
+{
+    struct dhcp_reply_cache_entry *e;
+    HMAP_FOR_EACH_POP (e, hmap_node, &dhcp_reply_cache) {
+        ofpbuf_delete(e->key);
+        ofpbuf_delete(e->reply_opts);
+        free(e);
+    }
+}
+
+static struct dhcp_reply_cache_entry *
+dhcp_reply_cache_find(const struct ofpbuf *key, uint32_t hash)
+    OVS_REQUIRES(dhcp_reply_cache_mutex)
+{
+    struct dhcp_reply_cache_entry *e;
+    HMAP_FOR_EACH_WITH_HASH (e, hmap_node, hash, &dhcp_reply_cache) {
+        if (e->key->size == key->size
+            && !memcmp(e->key->data, key->data, key->size)) {
+            return e;
+        }
+    }
+    return NULL;
+}
+
+/* Looks up 'key' in the cache.  On success, appends the cached reply
+ * options to 'reply_opts', stores the cached next server address in
+ * '*next_server' and returns true. */
+static bool
+dhcp_reply_cache_lookup(const struct ofpbuf *key, struct ofpbuf *reply_opts,
+                        ovs_be32 *next_server)
+{
+    uint32_t hash = hash_bytes(key->data, key->size, 0);
+
+    ovs_mutex_lock(&dhcp_reply_cache_mutex);
+    struct dhcp_reply_cache_entry *e = dhcp_reply_cache_find(key, hash);
+    if (e) {
+        ofpbuf_put(reply_opts, e->reply_opts->data, e->reply_opts->size);
+        *next_server = e->next_server;
+    }
+    ovs_mutex_unlock(&dhcp_reply_cache_mutex);
+
+    if (e) {
+        COVERAGE_INC(pinctrl_dhcp_reply_cache_hit);
+        return true;
+    }
+    COVERAGE_INC(pinctrl_dhcp_reply_cache_miss);
+    return false;
+}
+
+static void
+dhcp_reply_cache_add(const struct ofpbuf *key,
+                     const struct ofpbuf *reply_opts, ovs_be32 next_server)
+{
+    uint32_t hash = hash_bytes(key->data, key->size, 0);
+
+    ovs_mutex_lock(&dhcp_reply_cache_mutex);
+    if (!dhcp_reply_cache_find(key, hash)) {
+        if (hmap_count(&dhcp_reply_cache) >= DHCP_REPLY_CACHE_MAX_ENTRIES) {
+            dhcp_reply_cache_flush();
+        }
+
+        struct dhcp_reply_cache_entry *e = xmalloc(sizeof *e);
+        e->key = ofpbuf_clone(key);
+        e->reply_opts = ofpbuf_clone(reply_opts);
+        e->next_server = next_server;
+        hmap_insert(&dhcp_reply_cache, &e->hmap_node, hash);
+    }
+    ovs_mutex_unlock(&dhcp_reply_cache_mutex);
+}
+
+static void
+dhcp_reply_cache_destroy(void)
+{
+    ovs_mutex_lock(&dhcp_reply_cache_mutex);
+    dhcp_reply_cache_flush();
+    hmap_destroy(&dhcp_reply_cache);
+    ovs_mutex_unlock(&dhcp_reply_cache_mutex);
+}
+
+/* Called within a packet-in worker or the pinctrl_handler thread context. */
 static void
 pinctrl_handle_put_dhcp_opts(
     struct rconn *swconn,
@@ -2550,6 +2730,10 @@ pinctrl_handle_put_dhcp_opts(
     enum ofputil_protocol proto = ofputil_protocol_from_ofp_version(version);
     struct dp_packet *pkt_out_ptr = NULL;
     struct ofpbuf *dhcp_inform_reply_buf = NULL;
+    uint64_t reply_key_stub[512 / 8];
+    struct ofpbuf reply_key = OFPBUF_STUB_INITIALIZER(reply_key_stub);
+    uint64_t reply_opts_stub[512 / 8];
+    struct ofpbuf reply_opts = OFPBUF_STUB_INITIALIZER(reply_opts_stub);
     uint32_t success = 0;
 
     /* Parse result field. */
@@ -2712,73 +2896,116 @@ pinctrl_handle_put_dhcp_opts(
         goto exit;
     }
 
-    /* Frame the DHCP reply packet
-     * Total DHCP options length will be options stored in the
-     * reply_dhcp_opts_ptr + 16 bytes. Note that the DHCP options stored in
-     * reply_dhcp_opts_ptr are not included in DHCPNAK messages.
-     *
-     * --------------------------------------------------------------
-     *| 4 Bytes (dhcp cookie) | 3 Bytes (option type) | DHCP options |
-     * --------------------------------------------------------------
-     *| 4 Bytes padding | 1 Byte (option end 0xFF ) | 4 Bytes padding|
-     * --------------------------------------------------------------
-     */
-    ovs_be32 next_server = in_dhcp_data->siaddr;
-    bool bootfile_name_set = false;
-    in_dhcp_ptr = reply_dhcp_opts_ptr->data;
-    end = (const char *)reply_dhcp_opts_ptr->data + reply_dhcp_opts_ptr->size;
+    /* The reply options only depend on the userdata and on the fields of
+     * the request stored in 'cache_key', look them up in the cache before
+     * processing the userdata. */
+    struct dhcp_reply_cache_key cache_key = {
+        .family = AF_INET,
+        .req_msg_type = dhcp_opts.dhcp_msg_type,
+        .msg_type = msg_type,
+        .ipxe_req = dhcp_opts.ipxe_req,
+        .siaddr = in_dhcp_data->siaddr,
+    };
+    ofpbuf_put(&reply_key, &cache_key, sizeof cache_key);
+    ofpbuf_put(&reply_key, userdata->data, userdata->size);
 
-    while (in_dhcp_ptr < end) {
-        struct dhcp_opt_header *in_dhcp_opt =
-            (struct dhcp_opt_header *)in_dhcp_ptr;
+    ovs_be32 next_server;
+    if (!dhcp_reply_cache_lookup(&reply_key, &reply_opts, &next_server)) {
+        next_server = in_dhcp_data->siaddr;
+        bool bootfile_name_set = false;
+        in_dhcp_ptr = reply_dhcp_opts_ptr->data;
+        end = (const char *)reply_dhcp_opts_ptr->data
+              + reply_dhcp_opts_ptr->size;
 
-        switch (in_dhcp_opt->code) {
-        case DHCP_OPT_NEXT_SERVER_CODE:
-            next_server = get_unaligned_be32(DHCP_OPT_PAYLOAD(in_dhcp_opt));
-            break;
-        case DHCP_OPT_BOOTFILE_CODE: ;
-            unsigned char *ptr = (unsigned char *)in_dhcp_opt;
-            int len = sizeof *in_dhcp_opt + in_dhcp_opt->len;
-            struct dhcp_opt_header *next_dhcp_opt =
-                (struct dhcp_opt_header *)(ptr + len);
-
-            if (next_dhcp_opt->code == DHCP_OPT_BOOTFILE_ALT_CODE) {
-                if (!dhcp_opts.ipxe_req) {
-                    ofpbuf_pull(reply_dhcp_opts_ptr, len);
-                    next_dhcp_opt->code = DHCP_OPT_BOOTFILE_CODE;
-                } else {
-                    char *buf = xmalloc(len);
+        while (in_dhcp_ptr < end) {
+            struct dhcp_opt_header *in_dhcp_opt =
+                (struct dhcp_opt_header *)in_dhcp_ptr;
 
-                    memcpy(buf, in_dhcp_opt, len);
-                    ofpbuf_pull(reply_dhcp_opts_ptr,
-                                sizeof *in_dhcp_opt + next_dhcp_opt->len);
-                    memcpy(reply_dhcp_opts_ptr->data, buf, len);
-                    free(buf);
+            switch (in_dhcp_opt->code) {
+            case DHCP_OPT_NEXT_SERVER_CODE:
+                next_server =
+                    get_unaligned_be32(DHCP_OPT_PAYLOAD(in_dhcp_opt));
+                break;
+            case DHCP_OPT_BOOTFILE_CODE: ;
+                unsigned char *ptr = (unsigned char *)in_dhcp_opt;
+                int len = sizeof *in_dhcp_opt + in_dhcp_opt->len;
+                struct dhcp_opt_header *next_dhcp_opt =
+                    (struct dhcp_opt_header *)(ptr + len);
+
+                if (next_dhcp_opt->code == DHCP_OPT_BOOTFILE_ALT_CODE) {
+                    if (!dhcp_opts.ipxe_req) {
+                        ofpbuf_pull(reply_dhcp_opts_ptr, len);
+                        next_dhcp_opt->code = DHCP_OPT_BOOTFILE_CODE;
+                    } else {
+                        char *buf = xmalloc(len);
+
+                        memcpy(buf, in_dhcp_opt, len);
+                        ofpbuf_pull(reply_dhcp_opts_ptr,
+                                    sizeof *in_dhcp_opt + next_dhcp_opt->len);
+                        memcpy(reply_dhcp_opts_ptr->data, buf, len);
+                        free(buf);
+                    }
+                }
+                bootfile_name_set = true;
+                break;
+            case DHCP_OPT_BOOTFILE_ALT_CODE:
+                if (!bootfile_name_set) {
+                    in_dhcp_opt->code = DHCP_OPT_BOOTFILE_CODE;
                 }
+                break;
             }
-            bootfile_name_set = true;
-            break;
-        case DHCP_OPT_BOOTFILE_ALT_CODE:
-            if (!bootfile_name_set) {
-                in_dhcp_opt->code = DHCP_OPT_BOOTFILE_CODE;
+
+            in_dhcp_ptr += sizeof *in_dhcp_opt;
+            if (in_dhcp_ptr > end) {
+                break;
+            }
+            in_dhcp_ptr += in_dhcp_opt->len;
+            if (in_dhcp_ptr > end) {
+                break;
             }
-            break;
         }
 
-        in_dhcp_ptr += sizeof *in_dhcp_opt;
-        if (in_dhcp_ptr > end) {
-            break;
+        /* Frame the DHCP reply options.
+         * Total DHCP options length will be options stored in the
+         * reply_dhcp_opts_ptr + 16 bytes. Note that the DHCP options stored
+         * in reply_dhcp_opts_ptr are not included in DHCPNAK messages.
+         *
+         * --------------------------------------------------------------
+         *| 4 Bytes (dhcp cookie) | 3 Bytes (option type) | DHCP options |
+         * --------------------------------------------------------------
+         *| 4 Bytes padding | 1 Byte (option end 0xFF ) | 4 Bytes padding|
+         * --------------------------------------------------------------
+         */
+        ovs_be32 magic_cookie = htonl(DHCP_MAGIC_COOKIE);
+        ofpbuf_put(&reply_opts, &magic_cookie, sizeof(ovs_be32));
+
+        uint16_t out_dhcp_opts_size = 12;
+        if (msg_type != DHCP_MSG_NAK) {
+            out_dhcp_opts_size += reply_dhcp_opts_ptr->size;
         }
-        in_dhcp_ptr += in_dhcp_opt->len;
-        if (in_dhcp_ptr > end) {
-            break;
+        uint8_t *out_dhcp_opts = ofpbuf_put_zeros(&reply_opts,
+                                                  out_dhcp_opts_size);
+        /* DHCP option - type */
+        out_dhcp_opts[0] = DHCP_OPT_MSG_TYPE;
+        out_dhcp_opts[1] = 1;
+        out_dhcp_opts[2] = msg_type;
+        out_dhcp_opts += 3;
+
+        if (msg_type != DHCP_MSG_NAK) {
+            memcpy(out_dhcp_opts, reply_dhcp_opts_ptr->data,
+                   reply_dhcp_opts_ptr->size);
+            out_dhcp_opts += reply_dhcp_opts_ptr->size;
         }
-    }
 
-    uint16_t new_l4_size = UDP_HEADER_LEN + DHCP_HEADER_LEN + 16;
-    if (msg_type != DHCP_MSG_NAK) {
-        new_l4_size += reply_dhcp_opts_ptr->size;
+        /* Padding */
+        out_dhcp_opts += 4;
+        /* End */
+        out_dhcp_opts[0] = DHCP_OPT_END;
+
+        dhcp_reply_cache_add(&reply_key, &reply_opts, next_server);
     }
+
+    uint16_t new_l4_size = UDP_HEADER_LEN + DHCP_HEADER_LEN + reply_opts.size;
     size_t new_packet_size = pkt_in->l4_ofs + new_l4_size;
 
     struct dp_packet pkt_out;
@@ -2810,31 +3037,7 @@ pinctrl_handle_put_dhcp_opts(
         dhcp_data->yiaddr = 0;
     }
 
-    ovs_be32 magic_cookie = htonl(DHCP_MAGIC_COOKIE);
-    dp_packet_put(&pkt_out, &magic_cookie, sizeof(ovs_be32));
-
-    uint16_t out_dhcp_opts_size = 12;
-    if (msg_type != DHCP_MSG_NAK) {
-      out_dhcp_opts_size += reply_dhcp_opts_ptr->size;
-    }
-    uint8_t *out_dhcp_opts = dp_packet_put_zeros(&pkt_out,
-                                                 out_dhcp_opts_size);
-    /* DHCP option - type */
-    out_dhcp_opts[0] = DHCP_OPT_MSG_TYPE;
-    out_dhcp_opts[1] = 1;
-    out_dhcp_opts[2] = msg_type;
-    out_dhcp_opts += 3;
-
-    if (msg_type != DHCP_MSG_NAK) {
-        memcpy(out_dhcp_opts, reply_dhcp_opts_ptr->data,
-               reply_dhcp_opts_ptr->size);
-        out_dhcp_opts += reply_dhcp_opts_ptr->size;
-    }
-
-    /* Padding */
-    out_dhcp_opts += 4;
-    /* End */
-    out_dhcp_opts[0] = DHCP_OPT_END;
+    dp_packet_put(&pkt_out, reply_opts.data, reply_opts.size);
 
     udp->udp_len = htons(new_l4_size);
 
@@ -2880,6 +3083,8 @@ exit:
     if (dhcp_inform_reply_buf) {
         ofpbuf_delete(dhcp_inform_reply_buf);
     }
+    ofpbuf_uninit(&reply_key);
+    ofpbuf_uninit(&reply_opts);
 }
 
 static void
@@ -3070,7 +3275,7 @@ compose_dhcpv6_status(struct ofpbuf *userdata, struct ofpbuf *opts)
     return true;
 }
 
-/* Called with in the pinctrl_handler thread context. */
+/* Called within a packet-in worker or the pinctrl_handler thread context. */
 static void
 pinctrl_handle_put_dhcpv6_opts(
     struct rconn *swconn,
@@ -3207,18 +3412,38 @@ pinctrl_handle_put_dhcpv6_opts(
     struct ofpbuf out_dhcpv6_opts =
         OFPBUF_STUB_INITIALIZER(out_ofpacts_dhcpv6_opts_stub);
 
-    bool compose = false;
-    if (status_only) {
-        compose = compose_dhcpv6_status(userdata, &out_dhcpv6_opts);
-    } else {
-        compose = compose_out_dhcpv6_opts(userdata, &out_dhcpv6_opts, iaid,
-                                          ipxe_req, fqdn_flags);
-    }
+    struct dhcpv6_reply_cache_key cache_key = {
+        .family = AF_INET6,
+        .status_only = status_only,
+        .ipxe_req = ipxe_req,
+        .fqdn_flags = fqdn_flags,
+        .iaid = iaid,
+    };
+    uint64_t reply_key_stub[512 / 8];
+    struct ofpbuf reply_key = OFPBUF_STUB_INITIALIZER(reply_key_stub);
+    ofpbuf_put(&reply_key, &cache_key, sizeof cache_key);
+    ofpbuf_put(&reply_key, userdata->data, userdata->size);
+
+    ovs_be32 next_server;
+    if (!dhcp_reply_cache_lookup(&reply_key, &out_dhcpv6_opts,
+                                 &next_server)) {
+        bool compose = false;
+        if (status_only) {
+            compose = compose_dhcpv6_status(userdata, &out_dhcpv6_opts);
+        } else {
+            compose = compose_out_dhcpv6_opts(userdata, &out_dhcpv6_opts,
+                                              iaid, ipxe_req, fqdn_flags);
+        }
 
-    if (!compose) {
-        VLOG_WARN_RL(&rl, "Invalid userdata");
-        goto exit;
+        if (!compose) {
+            VLOG_WARN_RL(&rl, "Invalid userdata");
+            ofpbuf_uninit(&reply_key);
+            ofpbuf_uninit(&out_dhcpv6_opts);
+            goto exit;
+        }
+        dhcp_reply_cache_add(&reply_key, &out_dhcpv6_opts, 0);
     }
+    ofpbuf_uninit(&reply_key);
 
     uint16_t new_l4_size
         = (UDP_HEADER_LEN + 4 + sizeof *in_opt_client_id +
@@ -3311,13 +3536,13 @@ put_be32(struct ofpbuf *buf, ovs_be32 x)
  *                RDATA field.
  *  - RDATA    -> a variable length string of octets that
  *                describes the resource.
+ *
+ * The NAME is not part of the answers stored in 'struct ovn_dns_answer',
+ * it is copied from the query by dns_put_answers().
  */
 static void
-dns_build_base_answer(
-    struct ofpbuf *dns_answer, const uint8_t *in_queryname,
-    uint16_t query_length, int query_type)
+dns_build_base_answer(struct ofpbuf *dns_answer, int query_type)
 {
-    ofpbuf_put(dns_answer, in_queryname, query_length);
     put_be16(dns_answer, htons(query_type));
     put_be16(dns_answer, htons(DNS_CLASS_IN));
     put_be32(dns_answer, htonl(DNS_DEFAULT_RR_TTL));
@@ -3325,36 +3550,27 @@ dns_build_base_answer(
 
 /* Populates dns_answer struct with a TYPE A answer. */
 static void
-dns_build_a_answer(
-    struct ofpbuf *dns_answer, const uint8_t *in_queryname,
-    uint16_t query_length, const ovs_be32 addr)
+dns_build_a_answer(struct ofpbuf *dns_answer, const ovs_be32 addr)
 {
-    dns_build_base_answer(dns_answer, in_queryname, query_length,
-                          DNS_QUERY_TYPE_A);
+    dns_build_base_answer(dns_answer, DNS_QUERY_TYPE_A);
     put_be16(dns_answer, htons(sizeof(ovs_be32)));
     put_be32(dns_answer, addr);
 }
 
 /* Populates dns_answer struct with a TYPE AAAA answer. */
 static void
-dns_build_aaaa_answer(
-    struct ofpbuf *dns_answer, const uint8_t *in_queryname,
-    uint16_t query_length, const struct in6_addr *addr)
+dns_build_aaaa_answer(struct ofpbuf *dns_answer, const struct in6_addr *addr)
 {
-    dns_build_base_answer(dns_answer, in_queryname, query_length,
-                          DNS_QUERY_TYPE_AAAA);
+    dns_build_base_answer(dns_answer, DNS_QUERY_TYPE_AAAA);
     put_be16(dns_answer, htons(sizeof(*addr)));
     ofpbuf_put(dns_answer, addr, sizeof(*addr));
 }
 
 /* Populates dns_answer struct with a TYPE PTR answer. */
 static void
-dns_build_ptr_answer(
-    struct ofpbuf *dns_answer, const uint8_t *in_queryname,
-    uint16_t query_length, const char *answer_data)
+dns_build_ptr_answer(struct ofpbuf *dns_answer, const char *answer_data)
 {
-    dns_build_base_answer(dns_answer, in_queryname, query_length,
-                          DNS_QUERY_TYPE_PTR);
+    dns_build_base_answer(dns_answer, DNS_QUERY_TYPE_PTR);
 
     size_t encoded_len = 0;
     char *encoded = encode_fqdn_string(answer_data, &encoded_len);
@@ -3365,10 +3581,84 @@ dns_build_ptr_answer(
     free(encoded);
 }
 
+/* Builds the answer to a 'query_type' query for 'query_name' on 'dp_key'
+ * from the 'answer_data' of the matching DNS record.  Returns NULL if
+ * 'answer_data' cannot be parsed. */
+static struct ovn_dns_answer *
+dns_answer_create(const char *query_name, uint64_t dp_key,
+                  uint16_t query_type, const char *answer_data,
+                  bool ovn_owned)
+{
+    struct ovn_dns_answer *answer =
+        ovn_dns_answer_alloc(query_name, dp_key, query_type, ovn_owned);
+
+    if (query_type == DNS_QUERY_TYPE_PTR) {
+        dns_build_ptr_answer(&answer->rrs[0], answer_data);
+        answer->n_rrs[0] = 1;
+        return answer;
+    }
+
+    struct lport_addresses ip_addrs;
+    if (!extract_ip_addresses(answer_data, &ip_addrs)) {
+        ovn_dns_answer_destroy(answer);
+        return NULL;
+    }
+
+    if (query_type == DNS_QUERY_TYPE_A ||
+        query_type == DNS_QUERY_TYPE_ANY) {
+        for (size_t i = 0; i < ip_addrs.n_ipv4_addrs; i++) {
+            dns_build_a_answer(&answer->rrs[0], ip_addrs.ipv4_addrs[i].addr);
+        }
+        answer->n_rrs[0] = ip_addrs.n_ipv4_addrs;
+    }
+
+    if (query_type == DNS_QUERY_TYPE_AAAA ||
+        query_type == DNS_QUERY_TYPE_ANY) {
+        for (size_t i = 0; i < ip_addrs.n_ipv6_addrs; i++) {
+            dns_build_aaaa_answer(&answer->rrs[1],
+                                  &ip_addrs.ipv6_addrs[i].addr);
+        }
+        answer->n_rrs[1] = ip_addrs.n_ipv6_addrs;
+    }
+
+    destroy_lport_addresses(&ip_addrs);
+    return answer;
+}
+
+/* Appends the resource records of 'answer' to 'dns_answer', prefixed by the
+ * 'query_length' bytes long 'in_queryname'.  The records of each address
+ * family are shuffled for round-robin load balancing.  Returns the number
+ * of records appended. */
+static uint16_t
+dns_put_answers(struct ofpbuf *dns_answer,
+                const struct ovn_dns_answer *answer,
+                const uint8_t *in_queryname, uint16_t query_length)
+{
+    uint16_t ancount = 0;
+
+    for (size_t i = 0; i < ARRAY_SIZE(answer->rrs); i++) {
+        size_t n = answer->n_rrs[i];
+        if (!n) {
+            continue;
+        }
+
+        const uint8_t *rrs = answer->rrs[i].data;
+        size_t rr_len = answer->rrs[i].size / n;
+        size_t *order = shuffled_range(n);
+        for (size_t j = 0; j < n; j++) {
+            ofpbuf_put(dns_answer, in_queryname, query_length);
+            ofpbuf_put(dns_answer, rrs + order[j] * rr_len, rr_len);
+        }
+        free(order);
+        ancount += n;
+    }
+    return ancount;
+}
+
 #define DNS_RCODE_SERVER_REFUSE 0x5
 #define DNS_QUERY_TYPE_CLASS_LEN (2 * sizeof(ovs_be16))
 
-/* Called with in the pinctrl_handler thread context. */
+/* Called within a packet-in worker or the pinctrl_handler thread context. */
 static void
 pinctrl_handle_dns_lookup(
     struct rconn *swconn,
@@ -3506,69 +3796,62 @@ pinctrl_handle_dns_lookup(
     uint32_t query_l4_size = rest - l4_start;
 
     uint64_t dp_key = ntohll(pin->flow_metadata.flow.metadata);
-    bool ovn_owned = false;
-    const char *answer_data = ovn_dns_lookup(ds_cstr(&query_name), dp_key,
-                                             &ovn_owned);
+    char *query_name_lower = str_tolower(ds_cstr(&query_name));
     ds_destroy(&query_name);
-    if (!answer_data) {
-        COVERAGE_INC(dns_cache_miss);
-        goto exit;
-    }
-    COVERAGE_INC(dns_cache_hit);
-
-
-    uint16_t ancount = 0;
-    uint64_t dns_ans_stub[128 / 8];
-    struct ofpbuf dns_answer = OFPBUF_STUB_INITIALIZER(dns_ans_stub);
 
-    if (query_type == DNS_QUERY_TYPE_PTR) {
-        dns_build_ptr_answer(&dns_answer, in_queryname, idx, answer_data);
-        ancount++;
+    /* The sequence number must be read before looking up the DNS records a
+     * new answer is built from. */
+    uint64_t seqno = ovn_dns_answer_cache_seqno();
+    struct ovn_dns_answer *new_answer = NULL;
+    const struct ovn_dns_answer *answer =
+        ovn_dns_answer_lookup(query_name_lower, dp_key, query_type);
+    if (answer) {
+        COVERAGE_INC(dns_answer_cache_hit);
+        COVERAGE_INC(dns_cache_hit);
     } else {
-        struct lport_addresses ip_addrs;
-        if (!extract_ip_addresses(answer_data, &ip_addrs)) {
+        COVERAGE_INC(dns_answer_cache_miss);
+
+        bool ovn_owned = false;
+        const char *answer_data = ovn_dns_lookup(query_name_lower, dp_key,
+                                                 &ovn_owned);
+        if (!answer_data) {
+            COVERAGE_INC(dns_cache_miss);
+            free(query_name_lower);
             goto exit;
         }
+        COVERAGE_INC(dns_cache_hit);
 
-        /* Shuffle indices for round-robin load balancing. */
-        size_t *ipv4_order = shuffled_range(ip_addrs.n_ipv4_addrs);
-        size_t *ipv6_order = shuffled_range(ip_addrs.n_ipv6_addrs);
-
-        if (query_type == DNS_QUERY_TYPE_A ||
-            query_type == DNS_QUERY_TYPE_ANY) {
-            for (size_t i = 0; i < ip_addrs.n_ipv4_addrs; i++) {
-                ovs_be32 addr = ip_addrs.ipv4_addrs[ipv4_order[i]].addr;
-                dns_build_a_answer(&dns_answer, in_queryname, idx, addr);
-                ancount++;
-            }
-        }
-
-        if (query_type == DNS_QUERY_TYPE_AAAA ||
-            query_type == DNS_QUERY_TYPE_ANY) {
-            for (size_t i = 0; i < ip_addrs.n_ipv6_addrs; i++) {
-                struct in6_addr *addr =
-                    &ip_addrs.ipv6_addrs[ipv6_order[i]].addr;
-                dns_build_aaaa_answer(&dns_answer, in_queryname, idx, addr);
-                ancount++;
-            }
+        new_answer = dns_answer_create(query_name_lower, dp_key, query_type,
+                                       answer_data, ovn_owned);
+        if (!new_answer) {
+            free(query_name_lower);
+            goto exit;
         }
+        answer = new_answer;
+    }
+    free(query_name_lower);
 
-        free(ipv4_order);
-        free(ipv6_order);
-
-        /* DNS is configured with a record for this domain with
-         * an IPv4/IPV6 only, so instead of ignoring this A/AAAA query,
-         * we can reply with  RCODE = 5 (server refuses) and that
-         * will speed up the DNS process by not letting the customer
-         * wait for a timeout.
-         */
-        if (ovn_owned && (query_type == DNS_QUERY_TYPE_AAAA ||
-            query_type == DNS_QUERY_TYPE_A) && !ancount) {
-            send_refuse = true;
-            COVERAGE_INC(dns_unsupported_ovn_owned);
-        }
+    uint64_t dns_ans_stub[128 / 8];
+    struct ofpbuf dns_answer = OFPBUF_STUB_INITIALIZER(dns_ans_stub);
+    uint16_t ancount = dns_put_answers(&dns_answer, answer, in_queryname,
+                                       idx);
+
+    /* DNS is configured with a record for this domain with
+     * an IPv4/IPV6 only, so instead of ignoring this A/AAAA query,
+     * we can reply with  RCODE = 5 (server refuses) and that
+     * will speed up the DNS process by not letting the customer
+     * wait for a timeout.
+     */
+    if (answer->ovn_owned && (query_type == DNS_QUERY_TYPE_AAAA ||
+        query_type == DNS_QUERY_TYPE_A) && !ancount) {
+        send_refuse = true;
+        COVERAGE_INC(dns_unsupported_ovn_owned);
+    }
 
-        destroy_lport_addresses(&ip_addrs);
+    /* The cache takes ownership of the answer, it's not used past this
+     * point. */
+    if (new_answer) {
+        ovn_dns_answer_cache_insert(new_answer, seqno);
     }
 
     if (!ancount && !send_refuse) {
@@ -3665,166 +3948,558 @@ exit:
     dp_packet_uninit(pkt_out_ptr);
 }
 
-/* Called with in the pinctrl_handler thread context. */
-static void
-process_packet_in(struct rconn *swconn, const struct ofp_header *msg)
-{
-    static struct vlog_rate_limit rl = VLOG_RATE_LIMIT_INIT(1, 5);
-
-    struct ofputil_packet_in pin;
-    struct ofpbuf continuation;
-    enum ofperr error = ofputil_decode_packet_in(msg, true, NULL, NULL, &pin,
-                                                 NULL, NULL, &continuation);
+/* Packet-in types, used to shard the packet-ins between the packet-in
+ * workers and to report per type statistics. */
+enum pinctrl_pin_type {
+    PIN_T_ARP_ND,       /* ARP/ND resolution and MAC/FDB learning. */
+    PIN_T_DHCP,         /* DHCPv4/DHCPv6 replies and relay. */
+    PIN_T_DNS,          /* DNS lookups. */
+    PIN_T_ICMP,         /* ICMP errors, TCP resets and SCTP aborts. */
+    PIN_T_MCAST,        /* IGMP/MLD snooping. */
+    PIN_T_SVC_MON,      /* Service monitor health checks. */
+    PIN_T_BFD,          /* BFD messages. */
+    PIN_T_OTHER,        /* Everything else. */
+    PIN_T_MAX,
+};
 
-    if (error) {
-        VLOG_WARN_RL(&rl, "error decoding packet-in: %s",
-                     ofperr_to_string(error));
-        return;
-    }
-    if (pin.reason != OFPR_ACTION) {
-        return;
-    }
+static const char *pinctrl_pin_type_names[PIN_T_MAX] = {
+    [PIN_T_ARP_ND]  = "arp-nd",
+    [PIN_T_DHCP]    = "dhcp",
+    [PIN_T_DNS]     = "dns",
+    [PIN_T_ICMP]    = "icmp",
+    [PIN_T_MCAST]   = "mcast",
+    [PIN_T_SVC_MON] = "svc-monitor",
+    [PIN_T_BFD]     = "bfd",
+    [PIN_T_OTHER]   = "other",
+};
 
-    struct ofpbuf userdata = ofpbuf_const_initializer(pin.userdata,
-                                                      pin.userdata_len);
-    const struct action_header *ah = ofpbuf_pull(&userdata, sizeof *ah);
-    if (!ah) {
-        VLOG_WARN_RL(&rl, "packet-in userdata lacks action header");
-        return;
-    }
+struct pinctrl_pin_stats {
+    atomic_uint64_t n_packets;     /* Processed packet-ins. */
+    atomic_count n_queued;         /* Packet-ins waiting for a worker. */
+    atomic_uint64_t max_queued;    /* Only updated by pinctrl_handler. */
+    atomic_uint64_t total_latency; /* In microseconds. */
+    atomic_uint64_t max_latency;   /* In microseconds. */
+};
 
-    struct dp_packet packet;
-    dp_packet_use_const(&packet, pin.packet, pin.packet_len);
-    struct flow headers;
-    flow_extract(&packet, &headers);
+static struct pinctrl_pin_stats pin_stats[PIN_T_MAX];
 
-    switch (ntohl(ah->opcode)) {
-    case ACTION_OPCODE_ARP:
-        pinctrl_handle_arp(swconn, &headers, &pin, &userdata, &continuation);
-        break;
-    case ACTION_OPCODE_IGMP:
-        pinctrl_ip_mcast_handle(swconn, &headers, &packet, &pin.flow_metadata,
-                                &userdata);
-        break;
+/* Upper limit for 'external_ids:ovn-pinctrl-packet-in-threads'. */
+#define PINCTRL_MAX_PIN_WORKERS 64
 
-    case ACTION_OPCODE_PUT_ARP:
-        ovs_mutex_lock(&pinctrl_mutex);
-        pinctrl_handle_put_mac_binding(&pin.flow_metadata.flow, &headers,
-                                       true);
-        ovs_mutex_unlock(&pinctrl_mutex);
-        break;
+/* Number of packet-in workers requested by the main thread. */
+static atomic_uint pin_workers_requested;
 
-    case ACTION_OPCODE_DHCP_RELAY_REQ_CHK:
-        pinctrl_handle_dhcp_relay_req_chk(swconn, &packet, &pin,
-                                          &userdata, &continuation);
-        break;
+/* A decoded packet-in.  'pin', 'continuation' and 'userdata' point into
+ * 'msg'. */
+struct pinctrl_pin {
+    struct mpsc_queue_node node;   /* In 'struct pinctrl_pin_worker' queue. */
+    struct ofpbuf *msg;
+    struct ofputil_packet_in pin;
+    struct ofpbuf continuation;
+    struct ofpbuf userdata;        /* Past the action header. */
+    uint32_t opcode;
+    enum pinctrl_pin_type type;
+    long long int recv_usec;       /* When the packet-in was received. */
+};
 
-    case ACTION_OPCODE_DHCP_RELAY_RESP_CHK:
-        pinctrl_handle_dhcp_relay_resp_chk(swconn, &packet, &pin,
-                                           &userdata, &continuation);
-        break;
+struct pinctrl_pin_worker {
+    pthread_t thread;
+    struct rconn *swconn;
+    struct mpsc_queue queue;       /* Contains 'struct pinctrl_pin'. */
+    struct seq *seq;               /* Changed when packet-ins are queued. */
+    bool notify;                   /* Packet-ins queued since last change. */
+    struct latch exit;
+};
 
-    case ACTION_OPCODE_PUT_DHCP_OPTS:
-        pinctrl_handle_put_dhcp_opts(swconn, &packet, &pin, &headers,
-                                     &userdata, &continuation);
-        break;
+/* Only accessed by the pinctrl_handler thread. */
+static struct pinctrl_pin_worker *pin_workers;
+static size_t n_pin_workers;
 
+static enum pinctrl_pin_type
+pinctrl_pin_type_from_opcode(uint32_t opcode)
+{
+    switch (opcode) {
+    case ACTION_OPCODE_ARP:
+    case ACTION_OPCODE_PUT_ARP:
     case ACTION_OPCODE_ND_NA:
-        pinctrl_handle_nd_na(swconn, &headers, &pin.flow_metadata, &userdata,
-                             false);
-        break;
-
     case ACTION_OPCODE_ND_NA_ROUTER:
-        pinctrl_handle_nd_na(swconn, &headers, &pin.flow_metadata, &userdata,
-                             true);
-        break;
-
     case ACTION_OPCODE_PUT_ND:
-        ovs_mutex_lock(&pinctrl_mutex);
-        pinctrl_handle_put_mac_binding(&pin.flow_metadata.flow, &headers,
-                                       false);
-        ovs_mutex_unlock(&pinctrl_mutex);
-        break;
-
+    case ACTION_OPCODE_ND_NS:
     case ACTION_OPCODE_PUT_FDB:
-        ovs_mutex_lock(&pinctrl_mutex);
-        pinctrl_handle_put_fdb(&pin.flow_metadata.flow, &headers);
-        ovs_mutex_unlock(&pinctrl_mutex);
-        break;
-
+        return PIN_T_ARP_ND;
+    case ACTION_OPCODE_PUT_DHCP_OPTS:
     case ACTION_OPCODE_PUT_DHCPV6_OPTS:
-        pinctrl_handle_put_dhcpv6_opts(swconn, &packet, &pin, &userdata,
-                                       &continuation);
-        break;
-
+    case ACTION_OPCODE_DHCP_RELAY_REQ_CHK:
+    case ACTION_OPCODE_DHCP_RELAY_RESP_CHK:
+    case ACTION_OPCODE_DHCP6_SERVER:
+        return PIN_T_DHCP;
     case ACTION_OPCODE_DNS_LOOKUP:
-        pinctrl_handle_dns_lookup(swconn, &packet, &pin, &userdata,
-                                  &continuation);
-        break;
-
-    case ACTION_OPCODE_LOG:
-        handle_acl_log(&headers, &userdata,
-                       pin.table_id < OFTABLE_LOG_EGRESS_PIPELINE
-                       ? "from-lport" : "to-lport");
-        break;
-
-    case ACTION_OPCODE_PUT_ND_RA_OPTS:
-        pinctrl_handle_put_nd_ra_opts(swconn, &headers, &packet, &pin,
-                                      &userdata, &continuation);
-        break;
-
-    case ACTION_OPCODE_ND_NS:
-        pinctrl_handle_nd_ns(swconn, &headers, &pin, &userdata, &continuation);
-        break;
-
+        return PIN_T_DNS;
     case ACTION_OPCODE_ICMP:
-        pinctrl_handle_icmp(swconn, &headers, &packet, &pin.flow_metadata,
-                            &userdata, true, false);
-        break;
-
     case ACTION_OPCODE_ICMP4_ERROR:
     case ACTION_OPCODE_ICMP6_ERROR:
-        pinctrl_handle_icmp(swconn, &headers, &packet, &pin.flow_metadata,
-                            &userdata, false, false);
-        break;
-
     case ACTION_OPCODE_TCP_RESET:
-        pinctrl_handle_tcp_reset(swconn, &headers, &packet, &pin.flow_metadata,
-                                 &userdata, false);
-        break;
-
     case ACTION_OPCODE_SCTP_ABORT:
-        pinctrl_handle_sctp_abort(swconn, &headers, &packet,
-                                  &pin.flow_metadata, &userdata, false);
-        break;
-
     case ACTION_OPCODE_REJECT:
-        pinctrl_handle_reject(swconn, &headers, &packet, &pin.flow_metadata,
-                              &userdata);
-        break;
-
-    case ACTION_OPCODE_EVENT:
-        ovs_mutex_lock(&pinctrl_mutex);
-        pinctrl_handle_event(&userdata);
+        return PIN_T_ICMP;
+    case ACTION_OPCODE_IGMP:
+        return PIN_T_MCAST;
+    case ACTION_OPCODE_HANDLE_SVC_CHECK:
+        return PIN_T_SVC_MON;
+    case ACTION_OPCODE_BFD_MSG:
+        return PIN_T_BFD;
+    default:
+        return PIN_T_OTHER;
+    }
+}
+
+static void
+pinctrl_pin_stats_update_max(atomic_uint64_t *max, uint64_t value)
+{
+    uint64_t cur;
+
+    atomic_read_relaxed(max, &cur);
+    while (value > cur
+           && !atomic_compare_exchange_weak_relaxed(max, &cur, value)) {
+        continue;
+    }
+}
+
+static void pinctrl_handle_packet_in(struct rconn *swconn,
+                                     struct pinctrl_pin *ppin);
+
+/* Called within a packet-in worker thread context. */
+static void
+pinctrl_pin_worker_drain(struct pinctrl_pin_worker *w)
+{
+    struct mpsc_queue_node *node;
+
+    MPSC_QUEUE_FOR_EACH_POP (node, &w->queue) {
+        struct pinctrl_pin *ppin = CONTAINER_OF(node, struct pinctrl_pin,
+                                                node);
+
+        atomic_count_dec(&pin_stats[ppin->type].n_queued);
+        pinctrl_handle_packet_in(w->swconn, ppin);
+        ofpbuf_delete(ppin->msg);
+        free(ppin);
+    }
+}
+
+/* Packet-in worker pthread function. */
+static void *
+pinctrl_pin_worker_main(void *arg)
+{
+    struct pinctrl_pin_worker *w = arg;
+
+    mpsc_queue_acquire(&w->queue);
+    for (;;) {
+        ovsrcu_quiesce_end();
+
+        /* pinctrl_handler() stops queueing packet-ins before setting the
+         * latch, so everything queued is processed before exiting. */
+        bool exiting = latch_is_set(&w->exit);
+        uint64_t seq = seq_read(w->seq);
+
+        pinctrl_pin_worker_drain(w);
+        if (exiting) {
+            break;
+        }
+
+        seq_wait(w->seq, seq);
+        latch_wait(&w->exit);
+
+        ovsrcu_quiesce_start();
+        poll_block();
+    }
+    mpsc_queue_release(&w->queue);
+
+    return NULL;
+}
+
+/* Called within the pinctrl_handler thread context. */
+static void
+pinctrl_pin_workers_set(struct rconn *swconn, size_t n_workers)
+{
+    if (n_workers == n_pin_workers) {
+        return;
+    }
+
+    /* Let the current workers process what is already queued so that
+     * packet-ins of the same shard are not reordered. */
+    for (size_t i = 0; i < n_pin_workers; i++) {
+        latch_set(&pin_workers[i].exit);
+    }
+    for (size_t i = 0; i < n_pin_workers; i++) {
+        struct pinctrl_pin_worker *w = &pin_workers[i];
+
+        xpthread_join(w->thread, NULL);
+        mpsc_queue_destroy(&w->queue);
+        seq_destroy(w->seq);
+        latch_destroy(&w->exit);
+    }
+    free(pin_workers);
+    pin_workers = NULL;
+
+    n_pin_workers = n_workers;
+    if (!n_workers) {
+        VLOG_INFO("Processing packet-ins in the pinctrl thread.");
+        return;
+    }
+
+    pin_workers = xcalloc(n_workers, sizeof *pin_workers);
+    for (size_t i = 0; i < n_workers; i++) {
+        struct pinctrl_pin_worker *w = &pin_workers[i];
+
+        w->swconn = swconn;
+        mpsc_queue_init(&w->queue);
+        w->seq = seq_create();
+        latch_init(&w->exit);
+        w->thread = ovs_thread_create("ovn_pinctrl_pin",
+                                      pinctrl_pin_worker_main, w);
+    }
+    VLOG_INFO("Processing packet-ins in %"PRIuSIZE" worker threads.",
+              n_workers);
+}
+
+/* Called within the pinctrl_handler thread context. */
+static void
+pinctrl_pin_workers_notify(void)
+{
+    for (size_t i = 0; i < n_pin_workers; i++) {
+        struct pinctrl_pin_worker *w = &pin_workers[i];
+
+        if (w->notify) {
+            w->notify = false;
+            seq_change(w->seq);
+        }
+    }
+}
+
+/* Called by pinctrl_run(). Runs with in the main ovn-controller
+ * thread context. */
+static void
+pinctrl_pin_workers_configure(
+    const struct ovsrec_open_vswitch_table *ovs_table)
+{
+    const struct ovsrec_open_vswitch *cfg =
+        ovsrec_open_vswitch_table_first(ovs_table);
+    unsigned int n_workers = 0;
+
+    if (cfg) {
+        n_workers = MIN(smap_get_uint(&cfg->external_ids,
+                                      "ovn-pinctrl-packet-in-threads", 0),
+                        PINCTRL_MAX_PIN_WORKERS);
+    }
+
+    unsigned int cur;
+    atomic_read_relaxed(&pin_workers_requested, &cur);
+    if (cur != n_workers) {
+        atomic_store_relaxed(&pin_workers_requested, n_workers);
+        notify_pinctrl_handler();
+    }
+}
+
+void
+pinctrl_get_packet_in_stats(struct ds *output)
+{
+    unsigned int n_workers;
+
+    atomic_read_relaxed(&pin_workers_requested, &n_workers);
+    ds_put_format(output, "%-12s: %u\n", "threads", n_workers);
+    for (size_t i = 0; i < PIN_T_MAX; i++) {
+        struct pinctrl_pin_stats *stats = &pin_stats[i];
+        uint64_t n_packets, max_queued, total_latency, max_latency;
+
+        atomic_read_relaxed(&stats->n_packets, &n_packets);
+        atomic_read_relaxed(&stats->max_queued, &max_queued);
+        atomic_read_relaxed(&stats->total_latency, &total_latency);
+        atomic_read_relaxed(&stats->max_latency, &max_latency);
+        ds_put_format(output, "%-12s: packets %"PRIu64", queued %u, "
+                      "max-queued %"PRIu64", avg-latency-us %"PRIu64", "
+                      "max-latency-us %"PRIu64"\n",
+                      pinctrl_pin_type_names[i], n_packets,
+                      atomic_count_get(&stats->n_queued), max_queued,
+                      n_packets ? total_latency / n_packets : 0,
+                      max_latency);
+    }
+}
+
+/* Same as pinctrl_get_packet_in_stats(), as OpenMetrics families.  See
+ * lib/ovn-metrics.h. */
+void
+pinctrl_get_packet_in_metrics(struct ds *output)
+{
+    unsigned int n_workers;
+
+    atomic_read_relaxed(&pin_workers_requested, &n_workers);
+    ovn_metrics_put_family(output, "ovn_pinctrl_packet_in_threads", "gauge",
+                           NULL, "Number of packet-in worker threads.");
+    ovn_metrics_put_uint(output, "ovn_pinctrl_packet_in_threads", NULL, NULL,
+                         n_workers);
+
+    ovn_metrics_put_family(output, "ovn_pinctrl_packet_in", "counter", NULL,
+                           "Number of processed packet-ins.");
+    for (size_t i = 0; i < PIN_T_MAX; i++) {
+        uint64_t n_packets;
+
+        atomic_read_relaxed(&pin_stats[i].n_packets, &n_packets);
+        ovn_metrics_put_uint(output, "ovn_pinctrl_packet_in_total", "type",
+                             pinctrl_pin_type_names[i], n_packets);
+    }
+
+    ovn_metrics_put_family(output, "ovn_pinctrl_packet_in_queued", "gauge",
+                           NULL, "Number of packet-ins waiting for a "
+                           "worker thread.");
+    for (size_t i = 0; i < PIN_T_MAX; i++) {
+        ovn_metrics_put_uint(output, "ovn_pinctrl_packet_in_queued", "type",
+                             pinctrl_pin_type_names[i],
+                             atomic_count_get(&pin_stats[i].n_queued));
+    }
+
+    ovn_metrics_put_family(output, "ovn_pinctrl_packet_in_max_queued",
+                           "gauge", NULL, "Highest number of packet-ins "
+                           "waiting for a worker thread.");
+    for (size_t i = 0; i < PIN_T_MAX; i++) {
+        uint64_t max_queued;
+
+        atomic_read_relaxed(&pin_stats[i].max_queued, &max_queued);
+        ovn_metrics_put_uint(output, "ovn_pinctrl_packet_in_max_queued",
+                             "type", pinctrl_pin_type_names[i], max_queued);
+    }
+
+    ovn_metrics_put_family(output, "ovn_pinctrl_packet_in_latency_seconds",
+                           "counter", "seconds", "Time from the reception "
+                           "to the end of the processing of packet-ins.");
+    for (size_t i = 0; i < PIN_T_MAX; i++) {
+        uint64_t total_latency;
+
+        atomic_read_relaxed(&pin_stats[i].total_latency, &total_latency);
+        ovn_metrics_put_double(output,
+                               "ovn_pinctrl_packet_in_latency_seconds_total",
+                               "type", pinctrl_pin_type_names[i],
+                               total_latency / 1e6);
+    }
+
+    ovn_metrics_put_family(output,
+                           "ovn_pinctrl_packet_in_max_latency_seconds",
+                           "gauge", "seconds", "Highest time from the "
+                           "reception to the end of the processing of a "
+                           "packet-in.");
+    for (size_t i = 0; i < PIN_T_MAX; i++) {
+        uint64_t max_latency;
+
+        atomic_read_relaxed(&pin_stats[i].max_latency, &max_latency);
+        ovn_metrics_put_double(output,
+                               "ovn_pinctrl_packet_in_max_latency_seconds",
+                               "type", pinctrl_pin_type_names[i],
+                               max_latency / 1e6);
+    }
+}
+
+/* Called with in the pinctrl_handler thread context. */
+static void
+process_packet_in(struct rconn *swconn, struct ofpbuf *msg)
+{
+    static struct vlog_rate_limit rl = VLOG_RATE_LIMIT_INIT(1, 5);
+
+    struct pinctrl_pin ppin = {
+        .msg = msg,
+        .recv_usec = time_usec(),
+    };
+    enum ofperr error = ofputil_decode_packet_in(msg->data, true, NULL, NULL,
+                                                 &ppin.pin, NULL, NULL,
+                                                 &ppin.continuation);
+
+    if (error) {
+        VLOG_WARN_RL(&rl, "error decoding packet-in: %s",
+                     ofperr_to_string(error));
+        goto out;
+    }
+    if (ppin.pin.reason != OFPR_ACTION) {
+        goto out;
+    }
+
+    ppin.userdata = ofpbuf_const_initializer(ppin.pin.userdata,
+                                             ppin.pin.userdata_len);
+    const struct action_header *ah = ofpbuf_pull(&ppin.userdata, sizeof *ah);
+    if (!ah) {
+        VLOG_WARN_RL(&rl, "packet-in userdata lacks action header");
+        goto out;
+    }
+    ppin.opcode = ntohl(ah->opcode);
+    ppin.type = pinctrl_pin_type_from_opcode(ppin.opcode);
+
+    if (n_pin_workers && ppin.type != PIN_T_MCAST) {
+        struct pinctrl_pin_stats *stats = &pin_stats[ppin.type];
+        uint32_t dp_key = ntohll(ppin.pin.flow_metadata.flow.metadata);
+        struct pinctrl_pin_worker *w =
+            &pin_workers[hash_2words(ppin.type, dp_key) % n_pin_workers];
+
+        struct pinctrl_pin *queued = xmemdup(&ppin, sizeof ppin);
+
+        atomic_count_inc(&stats->n_queued);
+        pinctrl_pin_stats_update_max(&stats->max_queued,
+                                     atomic_count_get(&stats->n_queued));
+        mpsc_queue_insert(&w->queue, &queued->node);
+        w->notify = true;
+        return;
+    }
+
+    pinctrl_handle_packet_in(swconn, &ppin);
+
+out:
+    ofpbuf_delete(msg);
+}
+
+/* Called within a packet-in worker or the pinctrl_handler thread
+ * context. */
+static void
+pinctrl_handle_packet_in(struct rconn *swconn, struct pinctrl_pin *ppin)
+{
+    static struct vlog_rate_limit rl = VLOG_RATE_LIMIT_INIT(1, 5);
+
+    struct ofputil_packet_in *pin = &ppin->pin;
+    struct ofpbuf *continuation = &ppin->continuation;
+    struct ofpbuf *userdata = &ppin->userdata;
+
+    struct dp_packet packet;
+    dp_packet_use_const(&packet, pin->packet, pin->packet_len);
+    struct flow headers;
+    flow_extract(&packet, &headers);
+
+    OVS_USDT_PROBE(pinctrl_handle_packet_in, start, ppin->opcode,
+                   ntohll(pin->flow_metadata.flow.metadata),
+                   pin->flow_metadata.flow.regs[MFF_LOG_INPORT - MFF_REG0],
+                   ntohll(pin->cookie), pin->packet_len,
+                   time_usec() - ppin->recv_usec);
+
+    switch (ppin->opcode) {
+    case ACTION_OPCODE_ARP:
+        pinctrl_handle_arp(swconn, &headers, pin, userdata, continuation);
+        break;
+    case ACTION_OPCODE_IGMP:
+        pinctrl_ip_mcast_handle(swconn, &headers, &packet, &pin->flow_metadata,
+                                userdata);
+        break;
+
+    case ACTION_OPCODE_PUT_ARP:
+        ovs_mutex_lock(&pinctrl_mutex);
+        pinctrl_handle_put_mac_binding(&pin->flow_metadata.flow, &headers,
+                                       true);
+        ovs_mutex_unlock(&pinctrl_mutex);
+        break;
+
+    case ACTION_OPCODE_DHCP_RELAY_REQ_CHK:
+        pinctrl_handle_dhcp_relay_req_chk(swconn, &packet, pin,
+                                          userdata, continuation);
+        break;
+
+    case ACTION_OPCODE_DHCP_RELAY_RESP_CHK:
+        pinctrl_handle_dhcp_relay_resp_chk(swconn, &packet, pin,
+                                           userdata, continuation);
+        break;
+
+    case ACTION_OPCODE_PUT_DHCP_OPTS:
+        pinctrl_handle_put_dhcp_opts(swconn, &packet, pin, &headers,
+                                     userdata, continuation);
+        break;
+
+    case ACTION_OPCODE_ND_NA:
+        pinctrl_handle_nd_na(swconn, &headers, &pin->flow_metadata, userdata,
+                             false);
+        break;
+
+    case ACTION_OPCODE_ND_NA_ROUTER:
+        pinctrl_handle_nd_na(swconn, &headers, &pin->flow_metadata, userdata,
+                             true);
+        break;
+
+    case ACTION_OPCODE_PUT_ND:
+        ovs_mutex_lock(&pinctrl_mutex);
+        pinctrl_handle_put_mac_binding(&pin->flow_metadata.flow, &headers,
+                                       false);
+        ovs_mutex_unlock(&pinctrl_mutex);
+        break;
+
+    case ACTION_OPCODE_PUT_FDB:
+        ovs_mutex_lock(&pinctrl_mutex);
+        pinctrl_handle_put_fdb(&pin->flow_metadata.flow, &headers);
+        ovs_mutex_unlock(&pinctrl_mutex);
+        break;
+
+    case ACTION_OPCODE_PUT_DHCPV6_OPTS:
+        pinctrl_handle_put_dhcpv6_opts(swconn, &packet, pin, userdata,
+                                       continuation);
+        break;
+
+    case ACTION_OPCODE_DNS_LOOKUP:
+        pinctrl_handle_dns_lookup(swconn, &packet, pin, userdata,
+                                  continuation);
+        break;
+
+    case ACTION_OPCODE_LOG:
+        handle_acl_log(&headers, userdata,
+                       pin->table_id < OFTABLE_LOG_EGRESS_PIPELINE
+                       ? "from-lport" : "to-lport");
+        break;
+
+    case ACTION_OPCODE_PUT_ND_RA_OPTS:
+        pinctrl_handle_put_nd_ra_opts(swconn, &headers, &packet, pin,
+                                      userdata, continuation);
+        break;
+
+    case ACTION_OPCODE_ND_NS:
+        pinctrl_handle_nd_ns(swconn, &headers, pin, userdata, continuation);
+        break;
+
+    case ACTION_OPCODE_ICMP:
+        pinctrl_handle_icmp(swconn, &headers, &packet, &pin->flow_metadata,
+                            userdata, true, false);
+        break;
+
+    case ACTION_OPCODE_ICMP4_ERROR:
+    case ACTION_OPCODE_ICMP6_ERROR:
+        pinctrl_handle_icmp(swconn, &headers, &packet, &pin->flow_metadata,
+                            userdata, false, false);
+        break;
+
+    case ACTION_OPCODE_TCP_RESET:
+        pinctrl_handle_tcp_reset(swconn, &headers, &packet,
+                                 &pin->flow_metadata, userdata, false);
+        break;
+
+    case ACTION_OPCODE_SCTP_ABORT:
+        pinctrl_handle_sctp_abort(swconn, &headers, &packet,
+                                  &pin->flow_metadata, userdata, false);
+        break;
+
+    case ACTION_OPCODE_REJECT:
+        pinctrl_handle_reject(swconn, &headers, &packet, &pin->flow_metadata,
+                              userdata);
+        break;
+
+    case ACTION_OPCODE_EVENT:
+        ovs_mutex_lock(&pinctrl_mutex);
+        pinctrl_handle_event(userdata);
         ovs_mutex_unlock(&pinctrl_mutex);
         break;
 
     case ACTION_OPCODE_BIND_VPORT:
         ovs_mutex_lock(&pinctrl_mutex);
-        pinctrl_handle_bind_vport(&pin.flow_metadata.flow, &userdata);
+        pinctrl_handle_bind_vport(&pin->flow_metadata.flow, userdata);
         ovs_mutex_unlock(&pinctrl_mutex);
         break;
     case ACTION_OPCODE_DHCP6_SERVER:
         ovs_mutex_lock(&pinctrl_mutex);
         pinctrl_handle_dhcp6_server(swconn, &headers, &packet,
-                                    &pin.flow_metadata);
+                                    &pin->flow_metadata);
         ovs_mutex_unlock(&pinctrl_mutex);
         break;
 
     case ACTION_OPCODE_HANDLE_SVC_CHECK:
         ovs_mutex_lock(&pinctrl_mutex);
         pinctrl_handle_svc_check(swconn, &headers, &packet,
-                                 &pin.flow_metadata);
+                                 &pin->flow_metadata);
         ovs_mutex_unlock(&pinctrl_mutex);
         break;
 
@@ -3836,24 +4511,24 @@ process_packet_in(struct rconn *swconn, const struct ofp_header *msg)
 
     case ACTION_OPCODE_ACTIVATION_STRATEGY:
         ovs_mutex_lock(&pinctrl_mutex);
-        pinctrl_activation_strategy_handler(&pin.flow_metadata);
+        pinctrl_activation_strategy_handler(&pin->flow_metadata);
         ovs_mutex_unlock(&pinctrl_mutex);
         break;
 
     /* Deprecated actions. */
     case ACTION_OPCODE_SPLIT_BUF_ACTION: {
-        char *opc_str = ovnact_op_to_string(ntohl(ah->opcode));
+        char *opc_str = ovnact_op_to_string(ppin->opcode);
         VLOG_WARN_RL(&rl, "pinctrl received deprecated packet-in | opcode=%s",
                      opc_str);
         free(opc_str);
-        pinctrl_split_buf_action_handler(swconn, &packet, &pin.flow_metadata,
-                                         &userdata);
+        pinctrl_split_buf_action_handler(swconn, &packet, &pin->flow_metadata,
+                                         userdata);
         break;
     }
 
     case ACTION_OPCODE_PUT_ICMP4_FRAG_MTU:
     case ACTION_OPCODE_PUT_ICMP6_FRAG_MTU: {
-        char *opc_str = ovnact_op_to_string(ntohl(ah->opcode));
+        char *opc_str = ovnact_op_to_string(ppin->opcode);
         VLOG_WARN_RL(&rl, "pinctrl received deprecated packet-in | opcode=%s",
                      opc_str);
         free(opc_str);
@@ -3862,25 +4537,27 @@ process_packet_in(struct rconn *swconn, const struct ofp_header *msg)
 
     default:
         VLOG_WARN_RL(&rl, "unrecognized packet-in opcode %"PRIu32,
-                     ntohl(ah->opcode));
+                     ppin->opcode);
         break;
     }
 
+    OVS_USDT_PROBE(pinctrl_handle_packet_in, end, ppin->opcode,
+                   ntohll(pin->flow_metadata.flow.metadata));
 
     if (VLOG_IS_DBG_ENABLED()) {
         struct ds pin_str = DS_EMPTY_INITIALIZER;
-        char * opc_str = ovnact_op_to_string(ntohl(ah->opcode));
+        char * opc_str = ovnact_op_to_string(ppin->opcode);
 
         ds_put_format(&pin_str, "pinctrl received  packet-in | opcode=%s",
                       opc_str);
 
-        ds_put_format(&pin_str, "| OF_Table_ID=%u", pin.table_id);
+        ds_put_format(&pin_str, "| OF_Table_ID=%u", pin->table_id);
         ds_put_format(&pin_str, "| OF_Cookie_ID=0x%"PRIx64,
-                      ntohll(pin.cookie));
+                      ntohll(pin->cookie));
 
-        if (pin.flow_metadata.flow.in_port.ofp_port) {
+        if (pin->flow_metadata.flow.in_port.ofp_port) {
             ds_put_format(&pin_str, "| in-port=%u",
-                          pin.flow_metadata.flow.in_port.ofp_port);
+                          pin->flow_metadata.flow.in_port.ofp_port);
         }
 
         ds_put_format(&pin_str, "| src-mac="ETH_ADDR_FMT",",
@@ -3898,13 +4575,24 @@ process_packet_in(struct rconn *swconn, const struct ofp_header *msg)
         ds_destroy(&pin_str);
         free(opc_str);
     }
+
+    struct pinctrl_pin_stats *stats = &pin_stats[ppin->type];
+    uint64_t latency = time_usec() - ppin->recv_usec;
+    uint64_t orig;
+
+    atomic_add_relaxed(&stats->n_packets, 1, &orig);
+    atomic_add_relaxed(&stats->total_latency, latency, &orig);
+    pinctrl_pin_stats_update_max(&stats->max_latency, latency);
 }
 
-/* Called with in the pinctrl_handler thread context. */
+
+/* Called within the pinctrl_handler thread context.  Takes ownership of
+ * 'msg'. */
 static void
-pinctrl_recv(struct rconn *swconn, const struct ofp_header *oh,
-             enum ofptype type)
+pinctrl_recv(struct rconn *swconn, struct ofpbuf *msg, enum ofptype type)
 {
+    const struct ofp_header *oh = msg->data;
+
     if (type == OFPTYPE_ECHO_REQUEST) {
         queue_msg(swconn, ofputil_encode_echo_reply(oh));
     } else if (type == OFPTYPE_GET_CONFIG_REPLY) {
@@ -3916,7 +4604,8 @@ pinctrl_recv(struct rconn *swconn, const struct ofp_header *oh,
         set_switch_config(swconn, &config);
     } else if (type == OFPTYPE_PACKET_IN) {
         COVERAGE_INC(pinctrl_total_pin_pkts);
-        process_packet_in(swconn, oh);
+        process_packet_in(swconn, msg);
+        return;
     } else {
         if (VLOG_IS_DBG_ENABLED()) {
             static struct vlog_rate_limit rl = VLOG_RATE_LIMIT_INIT(30, 300);
@@ -3927,6 +4616,7 @@ pinctrl_recv(struct rconn *swconn, const struct ofp_header *oh,
             free(s);
         }
     }
+    ofpbuf_delete(msg);
 }
 
 /* Called with in the main ovn-controller thread context. */
@@ -3972,6 +4662,10 @@ pinctrl_handler(void *arg_)
 
         long long int bfd_time = LLONG_MAX;
         bool lock_failed = false;
+        unsigned int n_workers;
+
+        atomic_read_relaxed(&pin_workers_requested, &n_workers);
+        pinctrl_pin_workers_set(swconn, n_workers);
 
         if (!ovs_mutex_trylock(&pinctrl_mutex)) {
             ip_mcast_snoop_run();
@@ -3998,14 +4692,14 @@ pinctrl_handler(void *arg_)
                 enum ofptype type;
 
                 ofptype_decode(&type, oh);
-                pinctrl_recv(swconn, oh, type);
-                ofpbuf_delete(msg);
+                pinctrl_recv(swconn, msg, type);
             }
+            pinctrl_pin_workers_notify();
 
             if (may_inject_pkts()) {
+                send_ipv6_ras(swconn, &send_ipv6_ra_time);
                 if (!ovs_mutex_trylock(&pinctrl_mutex)) {
                     send_arp_nd_run(swconn, &send_arp_nd_time);
-                    send_ipv6_ras(swconn, &send_ipv6_ra_time);
                     send_ipv6_prefixd(swconn, &send_prefixd_time);
                     send_mac_binding_buffered_pkts(swconn);
                     bfd_monitor_send_msg(swconn, &bfd_time);
@@ -4049,6 +4743,9 @@ pinctrl_handler(void *arg_)
         poll_block();
     }
 
+    ovsrcu_quiesce_end();
+    pinctrl_pin_workers_set(swconn, 0);
+
     return NULL;
 }
 
@@ -4130,17 +4827,22 @@ pinctrl_run(struct ovsdb_idl_txn *ovnsb_idl_txn,
             const struct ovsrec_open_vswitch_table *ovs_table,
             int64_t cur_cfg)
 {
+    /* The IPv6 RA configurations are published with RCU, no need to hold
+     * 'pinctrl_mutex' while building them. */
+    prepare_ipv6_ras(local_active_ports_ras, sbrec_port_binding_by_name);
+
     ovs_mutex_lock(&pinctrl_mutex);
 
     main_seq = seq_read(pinctrl_main_seq);
 
+    size_t learn_budget = learned_entries_configure(ovs_table);
     run_put_mac_bindings(ovnsb_idl_txn, sbrec_datapath_binding_by_key,
                          sbrec_port_binding_by_key,
-                         sbrec_mac_binding_by_lport_ip);
+                         sbrec_mac_binding_by_lport_ip, &learn_budget);
     run_put_vport_bindings(ovnsb_idl_txn, sbrec_datapath_binding_by_key,
                            sbrec_port_binding_by_key, chassis, cur_cfg);
     send_garp_rarp_prepare(ecmp_nh_table, chassis, ovs_table);
-    prepare_ipv6_ras(local_active_ports_ras, sbrec_port_binding_by_name);
+    pinctrl_pin_workers_configure(ovs_table);
     prepare_ipv6_prefixd(ovnsb_idl_txn, sbrec_port_binding_by_name,
                          local_active_ports_ipv6_pd, chassis,
                          local_datapaths);
@@ -4155,21 +4857,23 @@ pinctrl_run(struct ovsdb_idl_txn *ovnsb_idl_txn,
                          sbrec_datapath_binding_by_key,
                          sbrec_port_binding_by_name,
                          sbrec_mac_binding_by_lport_ip);
+    svc_monitors_configure(ovs_table);
     sync_svc_monitors(ovnsb_idl_txn, svc_mon_table, sbrec_port_binding_by_name,
                       chassis);
     bfd_monitor_run(ovnsb_idl_txn, bfd_table, sbrec_port_binding_by_name,
                     chassis);
     run_put_fdbs(ovnsb_idl_txn, sbrec_port_binding_by_key,
                  sbrec_datapath_binding_by_key, sbrec_fdb_by_dp_key_mac,
-                 cur_cfg);
+                 cur_cfg, &learn_budget);
     run_activated_ports(ovnsb_idl_txn, sbrec_datapath_binding_by_key,
                         sbrec_port_binding_by_key, chassis);
     ovs_mutex_unlock(&pinctrl_mutex);
 }
 
-/* Table of ipv6_ra_state structures, keyed on logical port name.
- * Protected by pinctrl_mutex. */
-static struct shash ipv6_ras;
+/* Table of ipv6_ra_state structures, hashed by logical port name.  Only
+ * modified by the main thread, the pinctrl_handler thread reads it without
+ * taking 'pinctrl_mutex'. */
+static struct cmap ipv6_ras;
 
 struct ipv6_ra_config {
     time_t min_interval;
@@ -4186,21 +4890,26 @@ struct ipv6_ra_config {
     bool has_rdnss;
     struct ds dnssl;
     struct ds route_info;
-};
 
-struct ipv6_ra_state {
-    long long int next_announce;
-    struct ipv6_ra_config *config;
+    /* Logical switch port the RA is injected into. */
     int64_t port_key;
     int64_t metadata;
     bool preserved;
-    bool delete_me;
+};
+
+struct ipv6_ra_state {
+    struct cmap_node cmap_node;     /* In 'ipv6_ras'. */
+    char *logical_port;
+    /* Never modified once published, replaced with RCU instead. */
+    OVSRCU_TYPE(struct ipv6_ra_config *) config;
+    atomic_llong next_announce;
+    bool delete_me;                 /* Only used by the main thread. */
 };
 
 static void
 init_ipv6_ras(void)
 {
-    shash_init(&ipv6_ras);
+    cmap_init(&ipv6_ras);
 }
 
 static void
@@ -4214,25 +4923,76 @@ ipv6_ra_config_delete(struct ipv6_ra_config *config)
     }
 }
 
+static bool
+ipv6_ra_config_equals(const struct ipv6_ra_config *a,
+                      const struct ipv6_ra_config *b)
+{
+    if (a->min_interval != b->min_interval
+        || a->max_interval != b->max_interval
+        || !eth_addr_equals(a->eth_src, b->eth_src)
+        || !eth_addr_equals(a->eth_dst, b->eth_dst)
+        || !ipv6_addr_equals(&a->ipv6_src, &b->ipv6_src)
+        || !ipv6_addr_equals(&a->ipv6_dst, &b->ipv6_dst)
+        || a->mtu != b->mtu
+        || a->mo_flags != b->mo_flags
+        || a->la_flags != b->la_flags
+        || a->has_rdnss != b->has_rdnss
+        || (a->has_rdnss && !ipv6_addr_equals(&a->rdnss, &b->rdnss))
+        || strcmp(ds_cstr_ro(&a->dnssl), ds_cstr_ro(&b->dnssl))
+        || strcmp(ds_cstr_ro(&a->route_info), ds_cstr_ro(&b->route_info))
+        || a->port_key != b->port_key
+        || a->metadata != b->metadata
+        || a->preserved != b->preserved
+        || a->prefixes.n_ipv6_addrs != b->prefixes.n_ipv6_addrs) {
+        return false;
+    }
+
+    for (size_t i = 0; i < a->prefixes.n_ipv6_addrs; i++) {
+        const struct ipv6_netaddr *pa = &a->prefixes.ipv6_addrs[i];
+        const struct ipv6_netaddr *pb = &b->prefixes.ipv6_addrs[i];
+
+        if (pa->plen != pb->plen || !ipv6_addr_equals(&pa->addr, &pb->addr)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 static void
 ipv6_ra_delete(struct ipv6_ra_state *ra)
 {
     if (ra) {
-        ipv6_ra_config_delete(ra->config);
+        ipv6_ra_config_delete(ovsrcu_get_protected(struct ipv6_ra_config *,
+                                                   &ra->config));
+        free(ra->logical_port);
         free(ra);
     }
 }
 
+static struct ipv6_ra_state *
+ipv6_ra_find(const char *logical_port)
+{
+    struct ipv6_ra_state *ra;
+
+    CMAP_FOR_EACH_WITH_HASH (ra, cmap_node, hash_string(logical_port, 0),
+                             &ipv6_ras) {
+        if (!strcmp(ra->logical_port, logical_port)) {
+            return ra;
+        }
+    }
+    return NULL;
+}
+
 static void
 destroy_ipv6_ras(void)
 {
-    struct shash_node *iter;
-    SHASH_FOR_EACH_SAFE (iter, &ipv6_ras) {
-        struct ipv6_ra_state *ra = iter->data;
+    struct ipv6_ra_state *ra;
+    CMAP_FOR_EACH (ra, cmap_node, &ipv6_ras) {
+        cmap_remove(&ipv6_ras, &ra->cmap_node,
+                    hash_string(ra->logical_port, 0));
         ipv6_ra_delete(ra);
-        shash_delete(&ipv6_ras, iter);
     }
-    shash_destroy(&ipv6_ras);
+    cmap_destroy(&ipv6_ras);
 }
 
 static struct ipv6_ra_config *
@@ -4464,50 +5224,56 @@ out:
 static long long int
 ipv6_ra_send(struct rconn *swconn, struct ipv6_ra_state *ra)
 {
-    if (time_msec() < ra->next_announce) {
-        return ra->next_announce;
+    long long int next_announce;
+
+    atomic_read_relaxed(&ra->next_announce, &next_announce);
+    if (time_msec() < next_announce) {
+        return next_announce;
     }
 
+    const struct ipv6_ra_config *config =
+        ovsrcu_get(struct ipv6_ra_config *, &ra->config);
+
     uint64_t packet_stub[128 / 8];
     struct dp_packet packet;
 
     dp_packet_use_stub(&packet, packet_stub, sizeof packet_stub);
-    compose_nd_ra(&packet, ra->config->eth_src, ra->config->eth_dst,
-            &ra->config->ipv6_src, &ra->config->ipv6_dst,
-            255, ra->config->mo_flags, htons(IPV6_ND_RA_LIFETIME), 0, 0,
-            ra->config->mtu);
+    compose_nd_ra(&packet, config->eth_src, config->eth_dst,
+            &config->ipv6_src, &config->ipv6_dst,
+            255, config->mo_flags, htons(IPV6_ND_RA_LIFETIME), 0, 0,
+            config->mtu);
 
-    for (int i = 0; i < ra->config->prefixes.n_ipv6_addrs; i++) {
+    for (int i = 0; i < config->prefixes.n_ipv6_addrs; i++) {
         ovs_be128 addr;
-        memcpy(&addr, &ra->config->prefixes.ipv6_addrs[i].addr, sizeof addr);
+        memcpy(&addr, &config->prefixes.ipv6_addrs[i].addr, sizeof addr);
         packet_put_ra_prefix_opt(&packet,
-            ra->config->prefixes.ipv6_addrs[i].plen,
-            ra->config->la_flags, htonl(IPV6_ND_RA_OPT_PREFIX_VALID_LIFETIME),
+            config->prefixes.ipv6_addrs[i].plen,
+            config->la_flags, htonl(IPV6_ND_RA_OPT_PREFIX_VALID_LIFETIME),
             htonl(IPV6_ND_RA_OPT_PREFIX_PREFERRED_LIFETIME), addr);
     }
-    if (ra->config->has_rdnss) {
+    if (config->has_rdnss) {
         packet_put_ra_rdnss_opt(&packet, 1, htonl(0xffffffff),
-                                &ra->config->rdnss);
+                                &config->rdnss);
     }
-    if (ra->config->dnssl.length) {
+    if (config->dnssl.length) {
         packet_put_ra_dnssl_opt(&packet, htonl(0xffffffff),
-                                ds_cstr(&ra->config->dnssl));
+                                ds_cstr(&config->dnssl));
     }
-    if (ra->config->route_info.length) {
+    if (config->route_info.length) {
         packet_put_ra_route_info_opt(&packet, htonl(0xffffffff),
-                                     ds_cstr(&ra->config->route_info));
+                                     ds_cstr(&config->route_info));
     }
 
     uint64_t ofpacts_stub[4096 / 8];
     struct ofpbuf ofpacts = OFPBUF_STUB_INITIALIZER(ofpacts_stub);
 
     /* Set MFF_LOG_DATAPATH and MFF_LOG_INPORT. */
-    uint32_t dp_key = ra->metadata;
-    uint32_t port_key = ra->port_key;
+    uint32_t dp_key = config->metadata;
+    uint32_t port_key = config->port_key;
     put_load(dp_key, MFF_LOG_DATAPATH, 0, 64, &ofpacts);
     put_load(port_key, MFF_LOG_INPORT, 0, 32, &ofpacts);
     put_load(1, MFF_LOG_FLAGS, MLF_LOCAL_ONLY_BIT, 1, &ofpacts);
-    if (ra->preserved) {
+    if (config->preserved) {
         put_load(1, MFF_LOG_FLAGS, MLF_OVERRIDE_LOCAL_ONLY_BIT, 1, &ofpacts);
     }
     struct ofpact_resubmit *resubmit = ofpact_put_RESUBMIT(&ofpacts);
@@ -4525,14 +5291,15 @@ ipv6_ra_send(struct rconn *swconn, struct ipv6_ra_state *ra)
     match_set_in_port(&po.flow_metadata, OFPP_CONTROLLER);
     enum ofp_version version = rconn_get_version(swconn);
     enum ofputil_protocol proto = ofputil_protocol_from_ofp_version(version);
-    queue_msg(swconn, ofputil_encode_packet_out(&po, proto));
+    queue_packet_out(swconn, ofputil_encode_packet_out(&po, proto));
     dp_packet_uninit(&packet);
     ofpbuf_uninit(&ofpacts);
 
-    ra->next_announce = ipv6_ra_calc_next_announce(ra->config->min_interval,
-            ra->config->max_interval);
+    next_announce = ipv6_ra_calc_next_announce(config->min_interval,
+                                               config->max_interval);
+    atomic_store_relaxed(&ra->next_announce, next_announce);
 
-    return ra->next_announce;
+    return next_announce;
 }
 
 /* Called with in the pinctrl_handler thread context. */
@@ -4541,7 +5308,7 @@ ipv6_ra_wait(long long int send_ipv6_ra_time)
 {
     /* Set the poll timer for next IPv6 RA only if IPv6 RAs needs to
      * be sent. */
-    if (!shash_is_empty(&ipv6_ras)) {
+    if (!cmap_is_empty(&ipv6_ras)) {
         poll_timer_wait_until(send_ipv6_ra_time);
     }
 }
@@ -4549,12 +5316,10 @@ ipv6_ra_wait(long long int send_ipv6_ra_time)
 /* Called with in the pinctrl_handler thread context. */
 static void
 send_ipv6_ras(struct rconn *swconn, long long int *send_ipv6_ra_time)
-    OVS_REQUIRES(pinctrl_mutex)
 {
     *send_ipv6_ra_time = LLONG_MAX;
-    struct shash_node *iter;
-    SHASH_FOR_EACH (iter, &ipv6_ras) {
-        struct ipv6_ra_state *ra = iter->data;
+    struct ipv6_ra_state *ra;
+    CMAP_FOR_EACH (ra, cmap_node, &ipv6_ras) {
         long long int next_ra = ipv6_ra_send(swconn, ra);
         if (*send_ipv6_ra_time > next_ra) {
             *send_ipv6_ra_time = next_ra;
@@ -4567,16 +5332,15 @@ send_ipv6_ras(struct rconn *swconn, long long int *send_ipv6_ra_time)
 static void
 prepare_ipv6_ras(const struct shash *local_active_ports_ras,
                  struct ovsdb_idl_index *sbrec_port_binding_by_name)
-    OVS_REQUIRES(pinctrl_mutex)
 {
-    struct shash_node *iter;
+    struct ipv6_ra_state *ra;
 
-    SHASH_FOR_EACH (iter, &ipv6_ras) {
-        struct ipv6_ra_state *ra = iter->data;
+    CMAP_FOR_EACH (ra, cmap_node, &ipv6_ras) {
         ra->delete_me = true;
     }
 
     bool changed = false;
+    struct shash_node *iter;
     SHASH_FOR_EACH (iter, local_active_ports_ras) {
         const struct sbrec_port_binding *pb = iter->data;
 
@@ -4596,46 +5360,56 @@ prepare_ipv6_ras(const struct shash *local_active_ports_ras,
             continue;
         }
 
-        struct ipv6_ra_state *ra
-            = shash_find_data(&ipv6_ras, pb->logical_port);
+        /* Peer is the logical switch port that the logical
+         * router port is connected to. The RA is injected
+         * into that logical switch port.
+         */
+        config->port_key  = peer->tunnel_key;
+        config->metadata  = peer->datapath->tunnel_key;
+        config->preserved = (!strcmp(pb->type,"l2gateway") ||
+                             !strcmp(pb->type,"l3gateway") ||
+                             !strcmp(pb->type,"chassisredirect"));
+
+        ra = ipv6_ra_find(pb->logical_port);
         if (!ra) {
             ra = xzalloc(sizeof *ra);
-            ra->config = config;
-            ra->next_announce = ipv6_ra_calc_next_announce(
-                ra->config->min_interval,
-                ra->config->max_interval);
-            shash_add(&ipv6_ras, pb->logical_port, ra);
+            ra->logical_port = xstrdup(pb->logical_port);
+            ovsrcu_set_hidden(&ra->config, config);
+            atomic_init(&ra->next_announce,
+                        ipv6_ra_calc_next_announce(config->min_interval,
+                                                   config->max_interval));
+            cmap_insert(&ipv6_ras, &ra->cmap_node,
+                        hash_string(ra->logical_port, 0));
             changed = true;
         } else {
-            if (config->min_interval != ra->config->min_interval ||
-                config->max_interval != ra->config->max_interval)
-                ra->next_announce = ipv6_ra_calc_next_announce(
-                    config->min_interval,
-                    config->max_interval);
-            ipv6_ra_config_delete(ra->config);
-            ra->config = config;
-        }
+            struct ipv6_ra_config *old_config =
+                ovsrcu_get_protected(struct ipv6_ra_config *, &ra->config);
 
-        /* Peer is the logical switch port that the logical
-         * router port is connected to. The RA is injected
-         * into that logical switch port.
-         */
-        ra->port_key  = peer->tunnel_key;
-        ra->metadata  = peer->datapath->tunnel_key;
-        ra->preserved = (!strcmp(pb->type,"l2gateway") ||
-                        !strcmp(pb->type,"l3gateway") ||
-                        !strcmp(pb->type,"chassisredirect"));
+            if (ipv6_ra_config_equals(old_config, config)) {
+                ipv6_ra_config_delete(config);
+            } else {
+                if (config->min_interval != old_config->min_interval ||
+                    config->max_interval != old_config->max_interval) {
+                    atomic_store_relaxed(
+                        &ra->next_announce,
+                        ipv6_ra_calc_next_announce(config->min_interval,
+                                                   config->max_interval));
+                }
+                ovsrcu_set(&ra->config, config);
+                ovsrcu_postpone(ipv6_ra_config_delete, old_config);
+            }
+        }
         ra->delete_me = false;
 
         /* pinctrl_handler thread will send the IPv6 RAs. */
     }
 
     /* Remove those that are no longer in the SB database */
-    SHASH_FOR_EACH_SAFE (iter, &ipv6_ras) {
-        struct ipv6_ra_state *ra = iter->data;
+    CMAP_FOR_EACH (ra, cmap_node, &ipv6_ras) {
         if (ra->delete_me) {
-            shash_delete(&ipv6_ras, iter);
-            ipv6_ra_delete(ra);
+            cmap_remove(&ipv6_ras, &ra->cmap_node,
+                        hash_string(ra->logical_port, 0));
+            ovsrcu_postpone(ipv6_ra_delete, ra);
         }
     }
 
@@ -4671,6 +5445,17 @@ pinctrl_is_sb_commited(int64_t commit_cfg, int64_t cur_cfg)
             cur_cfg < PINCTRL_CFG_INTERVAL) || cur_cfg > commit_cfg;
 }
 
+/* Called by ovn-controller when the last southbound transaction failed, so
+ * that the changes it carried are written again. */
+void
+pinctrl_ovnsb_commit_failed(void)
+{
+    ovs_mutex_lock(&pinctrl_mutex);
+    ip_mcast_sync_failed();
+    put_fdbs_commit_failed();
+    ovs_mutex_unlock(&pinctrl_mutex);
+}
+
 /* Called by ovn-controller. */
 void
 pinctrl_destroy(void)
@@ -4682,6 +5467,7 @@ pinctrl_destroy(void)
     destroy_send_arps_nds();
     destroy_ipv6_ras();
     destroy_ipv6_prefixd();
+    dhcp_reply_cache_destroy();
     destroy_buffered_packets_ctx();
     destroy_activated_ports();
     event_table_destroy();
@@ -4715,10 +5501,33 @@ pinctrl_destroy(void)
 /* Contains "struct mac_binding"s. */
 static struct hmap put_mac_bindings;
 
+/* Coalescing of the learned MAC_Binding and FDB entries.
+ *
+ * Learning an entry again while it is waiting to be written to the SB only
+ * updates the pending entry ("coalesced"), without delaying it.  Once
+ * written, the entry is remembered for 'learn_dedup_window' ms, and learning
+ * it again with the same MAC address (or port, for FDB entries) during that
+ * time is ignored ("suppressed").
+ *
+ * At most 'learn_sb_write_budget' entries are written to the SB per
+ * transaction, taking one entry of each datapath in turn so that a single
+ * busy datapath can't starve the other ones.  The entries over the budget
+ * are written by the next transactions ("deferred"). */
+#define MAX_RECENT_LEARNED_ENTRIES 10000
+
+static long long int learn_dedup_window;
+static size_t learn_sb_write_budget;
+
+/* Recently written "struct mac_binding"s and "struct fdb"s, the timestamp
+ * is the time of the write. */
+static struct hmap recent_put_mac_bindings;
+static struct hmap recent_put_fdbs;
+
 static void
 init_put_mac_bindings(void)
 {
     hmap_init(&put_mac_bindings);
+    hmap_init(&recent_put_mac_bindings);
 }
 
 static void
@@ -4726,20 +5535,132 @@ destroy_put_mac_bindings(void)
 {
     mac_bindings_clear(&put_mac_bindings);
     hmap_destroy(&put_mac_bindings);
+    mac_bindings_clear(&recent_put_mac_bindings);
+    hmap_destroy(&recent_put_mac_bindings);
 }
 
-/* Called with in the pinctrl_handler thread context. */
+/* Called by pinctrl_run(). Runs with in the main ovn-controller
+ * thread context.  Returns the number of learned entries that can be
+ * written to the SB by the current transaction. */
+static size_t
+learned_entries_configure(const struct ovsrec_open_vswitch_table *ovs_table)
+    OVS_REQUIRES(pinctrl_mutex)
+{
+    const struct ovsrec_open_vswitch *cfg =
+        ovsrec_open_vswitch_table_first(ovs_table);
+
+    learn_dedup_window = 0;
+    learn_sb_write_budget = 0;
+    if (cfg) {
+        learn_dedup_window = smap_get_ullong(&cfg->external_ids,
+                                             "ovn-learn-dedup-window", 0);
+        learn_sb_write_budget = smap_get_uint(&cfg->external_ids,
+                                              "ovn-learn-sb-write-budget", 0);
+    }
+
+    /* Forget the entries written before the window. */
+    long long int now = time_msec();
+
+    struct mac_binding *mb;
+    HMAP_FOR_EACH_SAFE (mb, hmap_node, &recent_put_mac_bindings) {
+        if (now - mb->timestamp >= learn_dedup_window) {
+            mac_binding_remove(&recent_put_mac_bindings, mb);
+        }
+    }
+
+    struct fdb *fdb;
+    HMAP_FOR_EACH_SAFE (fdb, hmap_node, &recent_put_fdbs) {
+        if (now - fdb->timestamp >= learn_dedup_window) {
+            fdb_remove(&recent_put_fdbs, fdb);
+        }
+    }
+
+    return learn_sb_write_budget ? learn_sb_write_budget : SIZE_MAX;
+}
+
+/* Learned entries of a datapath that are due to be written to the SB. */
+struct learn_dp_batch {
+    struct hmap_node hmap_node;
+    uint32_t dp_key;
+    struct vector entries;      /* Pointers to the learned entries. */
+};
+
+static void
+learn_batches_add(struct hmap *batches, uint32_t dp_key, void *entry)
+{
+    uint32_t hash = hash_int(dp_key, 0);
+    struct learn_dp_batch *batch = NULL;
+    struct learn_dp_batch *iter;
+
+    HMAP_FOR_EACH_WITH_HASH (iter, hmap_node, hash, batches) {
+        if (iter->dp_key == dp_key) {
+            batch = iter;
+            break;
+        }
+    }
+    if (!batch) {
+        batch = xmalloc(sizeof *batch);
+        batch->dp_key = dp_key;
+        batch->entries = VECTOR_EMPTY_INITIALIZER(void *);
+        hmap_insert(batches, &batch->hmap_node, hash);
+    }
+    vector_push(&batch->entries, &entry);
+}
+
+/* Moves the entries of 'batches' to 'ordered', taking one entry of each
+ * datapath in turn, until '*budget' entries are moved, and decreases
+ * '*budget' accordingly.  Returns the number of entries that didn't fit in
+ * the budget.  Empties 'batches'. */
+static size_t
+learn_batches_order(struct hmap *batches, size_t *budget,
+                    struct vector *ordered)
+{
+    size_t n_batches = hmap_count(batches);
+    struct learn_dp_batch **array = xmalloc(n_batches * sizeof *array);
+    size_t n_left = 0;
+    size_t i = 0;
+
+    struct learn_dp_batch *batch;
+    HMAP_FOR_EACH_POP (batch, hmap_node, batches) {
+        n_left += vector_len(&batch->entries);
+        array[i++] = batch;
+    }
+
+    for (size_t round = 0; n_batches && *budget; round++) {
+        for (i = 0; i < n_batches && *budget;) {
+            batch = array[i];
+            if (round >= vector_len(&batch->entries)) {
+                /* This datapath has no entry left. */
+                vector_destroy(&batch->entries);
+                free(batch);
+                array[i] = array[--n_batches];
+                continue;
+            }
+
+            void *entry = vector_get(&batch->entries, round, void *);
+            vector_push(ordered, &entry);
+            (*budget)--;
+            n_left--;
+            i++;
+        }
+    }
+
+    for (i = 0; i < n_batches; i++) {
+        vector_destroy(&array[i]->entries);
+        free(array[i]);
+    }
+    free(array);
+
+    return n_left;
+}
+
+/* Called within a packet-in worker or the pinctrl_handler thread context. */
 static void
 pinctrl_handle_put_mac_binding(const struct flow *md,
                                const struct flow *headers,
                                bool is_arp)
     OVS_REQUIRES(pinctrl_mutex)
 {
-    if (hmap_count(&put_mac_bindings) >= MAX_MAC_BINDINGS) {
-        COVERAGE_INC(pinctrl_drop_put_mac_binding);
-        return;
-    }
-
     struct mac_binding_data mb_data = (struct mac_binding_data) {
             .dp_key =  ntohll(md->metadata),
             .port_key =  md->regs[MFF_LOG_INPORT - MFF_REG0],
@@ -4753,12 +5674,32 @@ pinctrl_handle_put_mac_binding(const struct flow *md,
         memcpy(&mb_data.ip, &ip6, sizeof mb_data.ip);
     }
 
+    long long now = time_msec();
+    const struct mac_binding *recent =
+        mac_binding_find(&recent_put_mac_bindings, &mb_data);
+    if (recent && eth_addr_equals(recent->data.mac, mb_data.mac)
+        && now - recent->timestamp < learn_dedup_window) {
+        COVERAGE_INC(pinctrl_mac_binding_suppressed);
+        return;
+    }
+
     /* If the ARP reply was unicast we should not delay it,
      * there won't be any race. */
     uint32_t delay = eth_addr_is_multicast(headers->dl_dst)
                      ? random_range(MAX_MAC_BINDING_DELAY_MSEC) + 1
                      : 0;
-    long long timestamp = time_msec() + delay;
+    long long timestamp = now + delay;
+
+    const struct mac_binding *pending =
+        mac_binding_find(&put_mac_bindings, &mb_data);
+    if (pending) {
+        /* Don't postpone the pending write. */
+        COVERAGE_INC(pinctrl_mac_binding_coalesced);
+        timestamp = MIN(timestamp, pending->timestamp);
+    } else if (hmap_count(&put_mac_bindings) >= MAX_MAC_BINDINGS) {
+        COVERAGE_INC(pinctrl_drop_put_mac_binding);
+        return;
+    }
     mac_binding_add(&put_mac_bindings, mb_data, NULL, timestamp);
 
     /* We can send the buffered packet once the main ovn-controller
@@ -4780,9 +5721,9 @@ send_mac_binding_buffered_pkts(struct rconn *swconn)
 
     struct bp_packet_data *pd;
     VECTOR_FOR_EACH_PTR (rpd, pd) {
-        queue_msg(swconn, ofputil_encode_resume(&pd->pin, pd->continuation,
+        queue_msg(swconn, ofputil_encode_resume(&pd->pin, &pd->continuation,
                                                 proto));
-        bp_packet_data_destroy(pd);
+        bp_packet_data_destroy(&buffered_packets_ctx, pd);
     }
 
     vector_clear(rpd);
@@ -4831,7 +5772,8 @@ static void
 run_put_mac_bindings(struct ovsdb_idl_txn *ovnsb_idl_txn,
                      struct ovsdb_idl_index *sbrec_datapath_binding_by_key,
                      struct ovsdb_idl_index *sbrec_port_binding_by_key,
-                     struct ovsdb_idl_index *sbrec_mac_binding_by_lport_ip)
+                     struct ovsdb_idl_index *sbrec_mac_binding_by_lport_ip,
+                     size_t *budget)
     OVS_REQUIRES(pinctrl_mutex)
 {
     if (!ovnsb_idl_txn) {
@@ -4839,17 +5781,33 @@ run_put_mac_bindings(struct ovsdb_idl_txn *ovnsb_idl_txn,
     }
 
     long long now = time_msec();
+    struct hmap batches = HMAP_INITIALIZER(&batches);
 
     struct mac_binding *mb;
-    HMAP_FOR_EACH_SAFE (mb, hmap_node, &put_mac_bindings) {
+    HMAP_FOR_EACH (mb, hmap_node, &put_mac_bindings) {
         if (now >= mb->timestamp) {
-            run_put_mac_binding(ovnsb_idl_txn,
-                                sbrec_datapath_binding_by_key,
-                                sbrec_port_binding_by_key,
-                                sbrec_mac_binding_by_lport_ip, mb);
-            mac_binding_remove(&put_mac_bindings, mb);
+            learn_batches_add(&batches, mb->data.dp_key, mb);
+        }
+    }
+
+    struct vector ordered = VECTOR_EMPTY_INITIALIZER(struct mac_binding *);
+    size_t n_deferred = learn_batches_order(&batches, budget, &ordered);
+    hmap_destroy(&batches);
+
+    VECTOR_FOR_EACH (&ordered, mb) {
+        run_put_mac_binding(ovnsb_idl_txn,
+                            sbrec_datapath_binding_by_key,
+                            sbrec_port_binding_by_key,
+                            sbrec_mac_binding_by_lport_ip, mb);
+        if (learn_dedup_window && hmap_count(&recent_put_mac_bindings)
+                                  < MAX_RECENT_LEARNED_ENTRIES) {
+            mac_binding_add(&recent_put_mac_bindings, mb->data, NULL, now);
         }
+        mac_binding_remove(&put_mac_bindings, mb);
     }
+    COVERAGE_ADD(pinctrl_mac_binding_committed, vector_len(&ordered));
+    COVERAGE_ADD(pinctrl_mac_binding_deferred, n_deferred);
+    vector_destroy(&ordered);
 }
 
 static void
@@ -5129,7 +6087,7 @@ send_self_originated_neigh_packet(struct rconn *swconn,
     };
     match_set_in_port(&po.flow_metadata, OFPP_CONTROLLER);
     enum ofputil_protocol proto = ofputil_protocol_from_ofp_version(version);
-    queue_msg(swconn, ofputil_encode_packet_out(&po, proto));
+    queue_packet_out(swconn, ofputil_encode_packet_out(&po, proto));
     dp_packet_uninit(&packet);
     ofpbuf_uninit(&ofpacts);
 }
@@ -5267,6 +6225,36 @@ struct ip_mcast_snoop_cfg {
     struct in6_addr query_ipv6_dst; /* Dsc IPv6 address used for queries. */
 };
 
+/*
+ * Per-datapath multicast snooping counters.
+ */
+struct ip_mcast_snoop_stats {
+    uint64_t n_reports;         /* Membership reports and leaves received. */
+    uint64_t n_queries_rx;      /* Queries received. */
+    uint64_t n_queries_tx;      /* Queries sent by the local querier. */
+    uint64_t n_expired;         /* Group members that timed out. */
+};
+
+/*
+ * A group address whose IGMP_Group record has to be written to the
+ * southbound database.
+ */
+struct ip_mcast_dirty_group {
+    struct hmap_node hmap_node;
+    struct in6_addr addr;
+};
+
+/*
+ * A port that joined a multicast group, scheduled to be checked for
+ * expiration once its membership has timed out.
+ */
+struct ip_mcast_member {
+    struct hmap_node hmap_node;           /* In 'members'. */
+    struct timer_wheel_node expiry_node;  /* In 'member_expiry'. */
+    struct in6_addr addr;
+    uint32_t port_key;
+};
+
 /*
  * Holds per-datapath information about multicast snooping. Maintained by
  * pinctrl_handler().
@@ -5278,43 +6266,356 @@ struct ip_mcast_snoop {
     struct mcast_snooping *ms;     /* Multicast group state. */
     int64_t dp_key;                /* Datapath running the snooping. */
 
-    long long int query_time_ms;   /* Next query time in ms. */
-};
+    long long int query_time_ms;   /* Next query time in ms. */
+
+    /* Changes not yet written to the southbound database, filled by the
+     * packet handlers and ip_mcast_snoop_run() and consumed by
+     * ip_mcast_sync(). */
+    struct ovs_mutex track_mutex;
+    struct hmap dirty_groups OVS_GUARDED;  /* Of ip_mcast_dirty_group. */
+    bool full_sync OVS_GUARDED;            /* All groups must be synced. */
+    bool mrouters_dirty OVS_GUARDED;       /* Mrouters must be synced. */
+
+    /* Group members ordered by expiration time. */
+    struct hmap members OVS_GUARDED;       /* Of ip_mcast_member. */
+    struct timer_wheel member_expiry OVS_GUARDED;
+    bool members_overflow OVS_GUARDED;     /* Some members not tracked. */
+
+    struct ip_mcast_snoop_stats stats OVS_GUARDED;
+
+    /* Only accessed by the pinctrl main thread.  The groups written by the
+     * last ip_mcast_sync(), marked for sync again if its transaction
+     * fails. */
+    bool sync_full;
+    bool synced_mrouters;
+    struct hmap synced_groups;             /* Of ip_mcast_dirty_group. */
+};
+
+/*
+ * Holds the per-datapath multicast configuration state. Maintained by
+ * pinctrl_run().
+ */
+struct ip_mcast_snoop_state {
+    struct hmap_node hmap_node;
+    int64_t dp_key;
+    struct ip_mcast_snoop_cfg cfg;
+};
+
+/* Only default vlan supported for now. */
+#define IP_MCAST_VLAN 1
+
+/* Time given to the snooping instance to expire a group member on its own
+ * before ip_mcast_snoop_run() checks it, in ms. */
+#define IP_MCAST_EXPIRY_MARGIN_MS 1000
+
+/* Maximum number of group members tracked per datapath.  Past that, group
+ * expirations are only detected by full syncs. */
+#define IP_MCAST_MAX_MEMBERS 262144
+
+/* Interval between two syncs of all the IGMP_Groups, in ms.  Recovers from
+ * southbound transactions that failed after their changes were consumed. */
+#define IP_MCAST_FULL_SYNC_INTERVAL_MS 60000
+
+/* MLD router-alert IPv6 extension header value. */
+static const uint8_t mld_router_alert[4] = {0x05, 0x02, 0x00, 0x00};
+
+/* Multicast snooping information stored independently by datapath key.
+ * Protected by pinctrl_mutex. pinctrl_handler has RW access and pinctrl_main
+ * has RO access.
+ */
+static struct hmap mcast_snoop_map OVS_GUARDED_BY(pinctrl_mutex);
+
+/* Contains multicast queries to be sent. Only used by pinctrl_handler so no
+ * locking needed.
+ */
+static struct ovs_list mcast_query_list;
+
+/* Set by pinctrl_handler when it adds, reconfigures or removes a snooping
+ * instance, so that the next ip_mcast_sync() syncs all the IGMP_Groups.
+ * Protected by pinctrl_mutex. */
+static bool ip_mcast_cfg_changed OVS_GUARDED_BY(pinctrl_mutex);
+
+/* Multicast config information stored independently by datapath key.
+ * Protected by pinctrl_mutex. pinctrl_handler has RO access and pinctrl_main
+ * has RW access. Read accesses from pinctrl_ip_mcast_handle() can be
+ * performed without taking the lock as they are executed in the pinctrl_main
+ * thread.
+ */
+static struct hmap mcast_cfg_map OVS_GUARDED_BY(pinctrl_mutex);
+
+static uint32_t
+ip_mcast_group_hash(const struct in6_addr *addr)
+{
+    return hash_bytes(addr, sizeof *addr, 0);
+}
+
+static void
+ip_mcast_dirty_groups_clear(struct hmap *dirty_groups)
+{
+    struct ip_mcast_dirty_group *dg;
+
+    HMAP_FOR_EACH_POP (dg, hmap_node, dirty_groups) {
+        free(dg);
+    }
+}
+
+static void
+ip_mcast_snoop_set_full_sync(struct ip_mcast_snoop *ip_ms)
+    OVS_REQUIRES(ip_ms->track_mutex)
+{
+    ip_ms->full_sync = true;
+    ip_mcast_dirty_groups_clear(&ip_ms->dirty_groups);
+}
+
+/* Records that the IGMP_Group of 'addr' has to be synced. */
+static void
+ip_mcast_snoop_mark_dirty(struct ip_mcast_snoop *ip_ms,
+                          const struct in6_addr *addr)
+    OVS_REQUIRES(ip_ms->track_mutex)
+{
+    if (ip_ms->full_sync) {
+        return;
+    }
+
+    if (hmap_count(&ip_ms->dirty_groups) >= ip_ms->cfg.table_size) {
+        /* Walking all the groups is cheaper at this point. */
+        ip_mcast_snoop_set_full_sync(ip_ms);
+        return;
+    }
+
+    uint32_t hash = ip_mcast_group_hash(addr);
+    struct ip_mcast_dirty_group *dg;
+
+    HMAP_FOR_EACH_WITH_HASH (dg, hmap_node, hash, &ip_ms->dirty_groups) {
+        if (ipv6_addr_equals(&dg->addr, addr)) {
+            return;
+        }
+    }
+
+    dg = xmalloc(sizeof *dg);
+    dg->addr = *addr;
+    hmap_insert(&ip_ms->dirty_groups, &dg->hmap_node, hash);
+}
+
+/* Schedules the check of the membership of 'port_key' to 'addr' at
+ * 'expires'. */
+static void
+ip_mcast_member_refresh(struct ip_mcast_snoop *ip_ms,
+                        const struct in6_addr *addr, uint32_t port_key,
+                        long long int expires)
+    OVS_REQUIRES(ip_ms->track_mutex)
+{
+    uint32_t hash = hash_int(port_key, ip_mcast_group_hash(addr));
+    struct ip_mcast_member *member;
+
+    HMAP_FOR_EACH_WITH_HASH (member, hmap_node, hash, &ip_ms->members) {
+        if (member->port_key == port_key &&
+                ipv6_addr_equals(&member->addr, addr)) {
+            goto schedule;
+        }
+    }
+
+    if (hmap_count(&ip_ms->members) >= IP_MCAST_MAX_MEMBERS) {
+        ip_ms->members_overflow = true;
+        return;
+    }
+
+    member = xmalloc(sizeof *member);
+    member->addr = *addr;
+    member->port_key = port_key;
+    timer_wheel_node_init(&member->expiry_node);
+    hmap_insert(&ip_ms->members, &member->hmap_node, hash);
+
+schedule:
+    timer_wheel_schedule(&ip_ms->member_expiry, &member->expiry_node,
+                         expires);
+}
+
+/* Stops tracking the membership of 'port_key' to 'addr'. */
+static void
+ip_mcast_member_remove(struct ip_mcast_snoop *ip_ms,
+                       const struct in6_addr *addr, uint32_t port_key)
+    OVS_REQUIRES(ip_ms->track_mutex)
+{
+    uint32_t hash = hash_int(port_key, ip_mcast_group_hash(addr));
+    struct ip_mcast_member *member;
+
+    HMAP_FOR_EACH_WITH_HASH (member, hmap_node, hash, &ip_ms->members) {
+        if (member->port_key == port_key &&
+                ipv6_addr_equals(&member->addr, addr)) {
+            timer_wheel_cancel(&ip_ms->member_expiry, &member->expiry_node);
+            hmap_remove(&ip_ms->members, &member->hmap_node);
+            free(member);
+            return;
+        }
+    }
+}
+
+static void
+ip_mcast_members_clear(struct ip_mcast_snoop *ip_ms)
+    OVS_REQUIRES(ip_ms->track_mutex)
+{
+    struct ip_mcast_member *member;
+
+    HMAP_FOR_EACH_POP (member, hmap_node, &ip_ms->members) {
+        timer_wheel_cancel(&ip_ms->member_expiry, &member->expiry_node);
+        free(member);
+    }
+    ip_ms->members_overflow = false;
+}
+
+static void
+ip_mcast_snoop_track_init(struct ip_mcast_snoop *ip_ms)
+    OVS_NO_THREAD_SAFETY_ANALYSIS
+{
+    ovs_mutex_init(&ip_ms->track_mutex);
+    hmap_init(&ip_ms->dirty_groups);
+    ip_ms->full_sync = true;
+    ip_ms->mrouters_dirty = true;
+    hmap_init(&ip_ms->members);
+    timer_wheel_init(&ip_ms->member_expiry, time_msec());
+    ip_ms->members_overflow = false;
+    memset(&ip_ms->stats, 0, sizeof ip_ms->stats);
+    hmap_init(&ip_ms->synced_groups);
+}
+
+static void
+ip_mcast_snoop_track_destroy(struct ip_mcast_snoop *ip_ms)
+    OVS_NO_THREAD_SAFETY_ANALYSIS
+{
+    ip_mcast_members_clear(ip_ms);
+    hmap_destroy(&ip_ms->members);
+    timer_wheel_destroy(&ip_ms->member_expiry);
+    ip_mcast_dirty_groups_clear(&ip_ms->dirty_groups);
+    hmap_destroy(&ip_ms->dirty_groups);
+    ip_mcast_dirty_groups_clear(&ip_ms->synced_groups);
+    hmap_destroy(&ip_ms->synced_groups);
+    ovs_mutex_destroy(&ip_ms->track_mutex);
+}
+
+static struct mcast_group_bundle *
+ip_mcast_group_find_bundle(const struct mcast_group *grp, void *port)
+{
+    struct mcast_group_bundle *b;
+
+    LIST_FOR_EACH (b, bundle_node, &grp->bundle_lru) {
+        if (b->port == port) {
+            return b;
+        }
+    }
+    return NULL;
+}
+
+/* Called by the packet handlers after a membership report or leave from
+ * 'port_key' for the groups in 'addrs'.  'group_change' tells whether the
+ * snooping instance updated any of the groups.  The memberships the port
+ * left are not tracked anymore, so that only timeouts are counted as
+ * expired. */
+static void
+ip_mcast_snoop_track_report(struct ip_mcast_snoop *ip_ms,
+                            const struct vector *addrs, uint32_t port_key,
+                            bool group_change)
+{
+    long long int expires = time_msec() + ip_ms->cfg.idle_time_s * 1000LL
+                            + IP_MCAST_EXPIRY_MARGIN_MS;
+    void *port = (void *) (uintptr_t) port_key;
+    const struct in6_addr *addr;
+
+    ovs_rwlock_rdlock(&ip_ms->ms->rwlock);
+    ovs_mutex_lock(&ip_ms->track_mutex);
+    ip_ms->stats.n_reports++;
+    VECTOR_FOR_EACH_PTR (addrs, addr) {
+        struct mcast_group *grp =
+            mcast_snooping_lookup(ip_ms->ms, addr, IP_MCAST_VLAN);
+
+        if (grp && ip_mcast_group_find_bundle(grp, port)) {
+            ip_mcast_member_refresh(ip_ms, addr, port_key, expires);
+        } else {
+            ip_mcast_member_remove(ip_ms, addr, port_key);
+        }
+        if (group_change) {
+            ip_mcast_snoop_mark_dirty(ip_ms, addr);
+        }
+    }
+    ovs_mutex_unlock(&ip_ms->track_mutex);
+    ovs_rwlock_unlock(&ip_ms->ms->rwlock);
+}
+
+static void
+ip_mcast_snoop_track_query(struct ip_mcast_snoop *ip_ms, bool mrouter_change)
+{
+    ovs_mutex_lock(&ip_ms->track_mutex);
+    ip_ms->stats.n_queries_rx++;
+    if (mrouter_change) {
+        ip_ms->mrouters_dirty = true;
+    }
+    ovs_mutex_unlock(&ip_ms->track_mutex);
+}
 
-/*
- * Holds the per-datapath multicast configuration state. Maintained by
- * pinctrl_run().
- */
-struct ip_mcast_snoop_state {
-    struct hmap_node hmap_node;
-    int64_t dp_key;
-    struct ip_mcast_snoop_cfg cfg;
-};
+/* Checks the group members whose membership timed out.  The ones still
+ * known by the snooping instance are removed from it, unless they were
+ * refreshed in the meantime, and their groups are marked for sync.
+ * Returns true if any group was marked. */
+static bool
+ip_mcast_snoop_expire_members(struct ip_mcast_snoop *ip_ms)
+{
+    long long int now = time_msec();
+    bool changed = false;
 
-/* Only default vlan supported for now. */
-#define IP_MCAST_VLAN 1
+    ovs_mutex_lock(&ip_ms->track_mutex);
+    bool expired = timer_wheel_next_expiry(&ip_ms->member_expiry) <= now;
+    ovs_mutex_unlock(&ip_ms->track_mutex);
+    if (!expired) {
+        return false;
+    }
 
-/* MLD router-alert IPv6 extension header value. */
-static const uint8_t mld_router_alert[4] = {0x05, 0x02, 0x00, 0x00};
+    ovs_rwlock_wrlock(&ip_ms->ms->rwlock);
+    ovs_mutex_lock(&ip_ms->track_mutex);
+
+    struct timer_wheel_node *node;
+    while ((node = timer_wheel_pop(&ip_ms->member_expiry, now))) {
+        struct ip_mcast_member *member =
+            CONTAINER_OF(node, struct ip_mcast_member, expiry_node);
+        void *port = (void *) (uintptr_t) member->port_key;
+        struct mcast_group *grp =
+            mcast_snooping_lookup(ip_ms->ms, &member->addr, IP_MCAST_VLAN);
+        struct mcast_group_bundle *b =
+            grp ? ip_mcast_group_find_bundle(grp, port) : NULL;
+
+        if (b && b->expires > time_now()) {
+            timer_wheel_schedule(&ip_ms->member_expiry, node,
+                                 b->expires * 1000LL
+                                 + IP_MCAST_EXPIRY_MARGIN_MS);
+            continue;
+        }
+        if (b) {
+            mcast_snooping_leave_group(ip_ms->ms, &member->addr,
+                                       IP_MCAST_VLAN, port);
+        }
 
-/* Multicast snooping information stored independently by datapath key.
- * Protected by pinctrl_mutex. pinctrl_handler has RW access and pinctrl_main
- * has RO access.
- */
-static struct hmap mcast_snoop_map OVS_GUARDED_BY(pinctrl_mutex);
+        ip_ms->stats.n_expired++;
+        ip_mcast_snoop_mark_dirty(ip_ms, &member->addr);
+        hmap_remove(&ip_ms->members, &member->hmap_node);
+        free(member);
+        changed = true;
+    }
 
-/* Contains multicast queries to be sent. Only used by pinctrl_handler so no
- * locking needed.
- */
-static struct ovs_list mcast_query_list;
+    ovs_mutex_unlock(&ip_ms->track_mutex);
+    ovs_rwlock_unlock(&ip_ms->ms->rwlock);
+    return changed;
+}
 
-/* Multicast config information stored independently by datapath key.
- * Protected by pinctrl_mutex. pinctrl_handler has RO access and pinctrl_main
- * has RW access. Read accesses from pinctrl_ip_mcast_handle() can be
- * performed without taking the lock as they are executed in the pinctrl_main
- * thread.
- */
-static struct hmap mcast_cfg_map OVS_GUARDED_BY(pinctrl_mutex);
+static void
+ip_mcast_snoop_expire_wait(struct ip_mcast_snoop *ip_ms)
+{
+    ovs_mutex_lock(&ip_ms->track_mutex);
+    long long int next = timer_wheel_next_expiry(&ip_ms->member_expiry);
+    ovs_mutex_unlock(&ip_ms->track_mutex);
+
+    if (next != LLONG_MAX) {
+        poll_timer_wait_until(next);
+    }
+}
 
 static void
 ip_mcast_snoop_cfg_load(struct ip_mcast_snoop_cfg *cfg,
@@ -5570,6 +6871,14 @@ ip_mcast_snoop_configure(struct ip_mcast_snoop *ip_ms,
 
 set_fields:
     memcpy(&ip_ms->cfg, cfg, sizeof ip_ms->cfg);
+
+    /* The groups may have been flushed or disabled, resync all of them. */
+    ovs_mutex_lock(&ip_ms->track_mutex);
+    ip_mcast_snoop_set_full_sync(ip_ms);
+    if (!cfg->enabled) {
+        ip_mcast_members_clear(ip_ms);
+    }
+    ovs_mutex_unlock(&ip_ms->track_mutex);
     return true;
 }
 
@@ -5580,7 +6889,9 @@ ip_mcast_snoop_add(int64_t dp_key, const struct ip_mcast_snoop_cfg *cfg)
     struct ip_mcast_snoop *ip_ms = xzalloc(sizeof *ip_ms);
 
     ip_ms->dp_key = dp_key;
+    ip_mcast_snoop_track_init(ip_ms);
     if (!ip_mcast_snoop_configure(ip_ms, cfg)) {
+        ip_mcast_snoop_track_destroy(ip_ms);
         free(ip_ms);
         return NULL;
     }
@@ -5616,6 +6927,7 @@ ip_mcast_snoop_remove(struct ip_mcast_snoop *ip_ms)
     }
 
     ip_mcast_snoop_disable(ip_ms);
+    ip_mcast_snoop_track_destroy(ip_ms);
     free(ip_ms);
 }
 
@@ -5656,15 +6968,18 @@ ip_mcast_snoop_run(void)
      * updated config then apply it.
      */
     struct ip_mcast_snoop_state *ip_ms_state;
+    bool cfg_changed = false;
 
     HMAP_FOR_EACH (ip_ms_state, hmap_node, &mcast_cfg_map) {
         ip_ms = ip_mcast_snoop_find(ip_ms_state->dp_key);
 
         if (!ip_ms) {
             ip_mcast_snoop_add(ip_ms_state->dp_key, &ip_ms_state->cfg);
+            cfg_changed = true;
         } else if (memcmp(&ip_ms_state->cfg, &ip_ms->cfg,
                           sizeof ip_ms_state->cfg)) {
             ip_mcast_snoop_configure(ip_ms, &ip_ms_state->cfg);
+            cfg_changed = true;
         }
     }
 
@@ -5676,24 +6991,89 @@ ip_mcast_snoop_run(void)
         /* Delete the stale ones. */
         if (!ip_mcast_snoop_state_find(ip_ms->dp_key)) {
             ip_mcast_snoop_remove(ip_ms);
+            cfg_changed = true;
             continue;
         }
 
         /* If enabled run the snooping instance to timeout old groups. */
         if (ip_ms->cfg.enabled) {
             if (mcast_snooping_run(ip_ms->ms)) {
+                /* Mrouters may have expired.  The expired groups are
+                 * found through their members, if all are tracked. */
+                ovs_mutex_lock(&ip_ms->track_mutex);
+                ip_ms->mrouters_dirty = true;
+                if (ip_ms->members_overflow) {
+                    ip_mcast_snoop_set_full_sync(ip_ms);
+                }
+                ovs_mutex_unlock(&ip_ms->track_mutex);
+                notify = true;
+            }
+            if (ip_mcast_snoop_expire_members(ip_ms)) {
                 notify = true;
             }
 
             mcast_snooping_wait(ip_ms->ms);
+            ip_mcast_snoop_expire_wait(ip_ms);
         }
     }
 
+    if (cfg_changed) {
+        ip_mcast_cfg_changed = true;
+        notify = true;
+    }
+
     if (notify) {
         notify_pinctrl_main();
     }
 }
 
+static int
+compare_ip_mcast_snoop_dp_key(const void *a_, const void *b_)
+{
+    const struct ip_mcast_snoop *const *a = a_;
+    const struct ip_mcast_snoop *const *b = b_;
+
+    return (*a)->dp_key < (*b)->dp_key ? -1 : (*a)->dp_key > (*b)->dp_key;
+}
+
+void
+pinctrl_get_mcast_snoop_stats(struct ds *output)
+{
+    struct vector snoops =
+        VECTOR_EMPTY_INITIALIZER(struct ip_mcast_snoop *);
+    struct ip_mcast_snoop *ip_ms;
+
+    ovs_mutex_lock(&pinctrl_mutex);
+    HMAP_FOR_EACH (ip_ms, hmap_node, &mcast_snoop_map) {
+        vector_push(&snoops, &ip_ms);
+    }
+    vector_qsort(&snoops, compare_ip_mcast_snoop_dp_key);
+
+    VECTOR_FOR_EACH (&snoops, ip_ms) {
+        if (!ip_ms->cfg.enabled) {
+            continue;
+        }
+
+        ovs_rwlock_rdlock(&ip_ms->ms->rwlock);
+        size_t n_groups = hmap_count(&ip_ms->ms->table);
+        ovs_rwlock_unlock(&ip_ms->ms->rwlock);
+
+        ovs_mutex_lock(&ip_ms->track_mutex);
+        ds_put_format(output, "datapath %"PRId64": groups %"PRIuSIZE", "
+                      "members %"PRIuSIZE"%s, reports %"PRIu64", "
+                      "queries-received %"PRIu64", "
+                      "queries-sent %"PRIu64", expired %"PRIu64"\n",
+                      ip_ms->dp_key, n_groups, hmap_count(&ip_ms->members),
+                      ip_ms->members_overflow ? " (overflow)" : "",
+                      ip_ms->stats.n_reports, ip_ms->stats.n_queries_rx,
+                      ip_ms->stats.n_queries_tx, ip_ms->stats.n_expired);
+        ovs_mutex_unlock(&ip_ms->track_mutex);
+    }
+    ovs_mutex_unlock(&pinctrl_mutex);
+
+    vector_destroy(&snoops);
+}
+
 /* Flushes all IGMP_Groups installed by the local chassis for the logical
  * datapath specified by 'dp_key'.
  */
@@ -5713,11 +7093,52 @@ ip_mcast_flush_groups(int64_t dp_key, const struct sbrec_chassis *chassis,
     }
 }
 
+/* Next time all the IGMP_Groups are synced by ip_mcast_sync(), in ms, and
+ * whether the last ip_mcast_sync() synced all of them. */
+static long long int ip_mcast_next_full_sync;
+static bool ip_mcast_synced_all;
+
+/* Writes the IGMP_Group of 'addr' to the southbound database, 'mc_group'
+ * being its state in the snooping instance or NULL if it was removed. */
+static void
+ip_mcast_sync_group(struct ovsdb_idl_txn *ovnsb_idl_txn,
+                    const struct sbrec_chassis *chassis,
+                    const struct local_datapath *local_dp,
+                    struct ovsdb_idl_index *sbrec_datapath_binding_by_key,
+                    struct ovsdb_idl_index *sbrec_port_binding_by_key,
+                    struct ovsdb_idl_index *sbrec_igmp_groups,
+                    const struct ip_mcast_snoop *ip_ms,
+                    const struct mcast_group *mc_group,
+                    const struct in6_addr *addr)
+    OVS_REQ_RDLOCK(ip_ms->ms->rwlock)
+{
+    const struct sbrec_igmp_group *sbrec_igmp =
+        igmp_group_lookup(sbrec_igmp_groups, addr, local_dp->datapath,
+                          chassis);
+
+    if (!mc_group || ovs_list_is_empty(&mc_group->bundle_lru)) {
+        if (sbrec_igmp) {
+            igmp_group_delete(sbrec_igmp);
+        }
+        return;
+    }
+
+    if (!sbrec_igmp) {
+        sbrec_igmp = igmp_group_create(ovnsb_idl_txn, addr,
+                                       local_dp->datapath, chassis,
+                                       pinctrl.igmp_group_has_chassis_name);
+    }
+    igmp_group_update(sbrec_igmp, sbrec_datapath_binding_by_key,
+                      sbrec_port_binding_by_key, ip_ms->ms, mc_group,
+                      pinctrl.igmp_support_protocol);
+}
+
 /*
  * This runs in the pinctrl main thread, so it has access to the southbound
  * database. It reads the IP_Multicast table and updates the local multicast
- * configuration. Then writes to the southbound database the updated
- * IGMP_Groups.
+ * configuration. Then writes to the southbound database the IGMP_Groups
+ * that changed since the last sync, as tracked by the pinctrl_handler
+ * thread, or all of them when the changes couldn't be tracked.
  */
 static void
 ip_mcast_sync(struct ovsdb_idl_txn *ovnsb_idl_txn,
@@ -5764,6 +7185,32 @@ ip_mcast_sync(struct ovsdb_idl_txn *ovnsb_idl_txn,
         }
     }
 
+    /* Then collect the datapaths whose groups all have to be synced:
+     * - either a snooping instance was added, reconfigured or removed
+     * - or their changes could not be tracked
+     * - or it's time for the periodic full sync.
+     */
+    long long int now = time_msec();
+    bool sync_all = now >= ip_mcast_next_full_sync || ip_mcast_cfg_changed;
+    bool any_full_sync = false;
+    struct ip_mcast_snoop *ip_ms;
+
+    if (sync_all) {
+        ip_mcast_next_full_sync = now + IP_MCAST_FULL_SYNC_INTERVAL_MS;
+        ip_mcast_cfg_changed = false;
+    }
+    ip_mcast_synced_all = sync_all;
+    HMAP_FOR_EACH (ip_ms, hmap_node, &mcast_snoop_map) {
+        ovs_mutex_lock(&ip_ms->track_mutex);
+        ip_ms->sync_full = sync_all || ip_ms->full_sync;
+        if (ip_ms->sync_full) {
+            ip_ms->full_sync = false;
+            ip_mcast_dirty_groups_clear(&ip_ms->dirty_groups);
+            any_full_sync = true;
+        }
+        ovs_mutex_unlock(&ip_ms->track_mutex);
+    }
+
     const struct sbrec_igmp_group *sbrec_ip_mrouter;
     const struct sbrec_igmp_group *sbrec_igmp;
 
@@ -5774,6 +7221,11 @@ ip_mcast_sync(struct ovsdb_idl_txn *ovnsb_idl_txn,
     SBREC_IGMP_GROUP_FOR_EACH_BYINDEX (sbrec_igmp, sbrec_igmp_groups) {
         struct in6_addr group_addr;
 
+        /* Nothing to flush if all the datapaths sync incrementally. */
+        if (!any_full_sync) {
+            break;
+        }
+
         if (!sbrec_igmp->datapath) {
             continue;
         }
@@ -5789,7 +7241,7 @@ ip_mcast_sync(struct ovsdb_idl_txn *ovnsb_idl_txn,
             continue;
         }
 
-        struct ip_mcast_snoop *ip_ms = ip_mcast_snoop_find(dp_key);
+        ip_ms = ip_mcast_snoop_find(dp_key);
 
         /* If the datapath doesn't exist anymore or IGMP snooping was disabled
          * on it then delete the IGMP_Group entry.
@@ -5799,6 +7251,11 @@ ip_mcast_sync(struct ovsdb_idl_txn *ovnsb_idl_txn,
             continue;
         }
 
+        /* The groups of the other datapaths are synced incrementally. */
+        if (!ip_ms->sync_full) {
+            continue;
+        }
+
         if (!strcmp(sbrec_igmp->address, OVN_IGMP_GROUP_MROUTERS)) {
             continue;
         } else if (!ip46_parse(sbrec_igmp->address, &group_addr)) {
@@ -5815,23 +7272,32 @@ ip_mcast_sync(struct ovsdb_idl_txn *ovnsb_idl_txn,
         ovs_rwlock_unlock(&ip_ms->ms->rwlock);
     }
 
-    struct ip_mcast_snoop *ip_ms;
-
     /* Last: write new IGMP_Groups to the southbound DB and update existing
-     * ones (if needed). We also flush any old per-datapath multicast snoop
-     * structures.
+     * ones (if needed), either all of them or only the ones that changed
+     * since the last sync.
      */
-    HMAP_FOR_EACH_SAFE (ip_ms, hmap_node, &mcast_snoop_map) {
+    HMAP_FOR_EACH (ip_ms, hmap_node, &mcast_snoop_map) {
+        bool sync_mrouters;
+
+        /* Keep the groups written by this sync until the next one, in case
+         * the transaction fails. */
+        ip_mcast_dirty_groups_clear(&ip_ms->synced_groups);
+
+        ovs_mutex_lock(&ip_ms->track_mutex);
+        hmap_swap(&ip_ms->synced_groups, &ip_ms->dirty_groups);
+        sync_mrouters = ip_ms->mrouters_dirty || ip_ms->sync_full;
+        ip_ms->mrouters_dirty = false;
+        ovs_mutex_unlock(&ip_ms->track_mutex);
+        ip_ms->synced_mrouters = sync_mrouters;
+
         /* Flush any non-local snooping datapaths (e.g., stale). */
         struct local_datapath *local_dp =
             get_local_datapath(local_datapaths, ip_ms->dp_key);
 
-        if (!local_dp || !local_dp->is_switch) {
-            continue;
-        }
-
         /* Skip datapaths on which snooping is disabled. */
-        if (!ip_ms->cfg.enabled) {
+        if (!local_dp || !local_dp->is_switch || !ip_ms->cfg.enabled) {
+            ip_mcast_dirty_groups_clear(&ip_ms->synced_groups);
+            ip_ms->synced_mrouters = false;
             continue;
         }
 
@@ -5840,36 +7306,42 @@ ip_mcast_sync(struct ovsdb_idl_txn *ovnsb_idl_txn,
         ovs_rwlock_rdlock(&ip_ms->ms->rwlock);
 
         /* Groups. */
-        LIST_FOR_EACH (mc_group, group_node, &ip_ms->ms->group_lru) {
-            if (ovs_list_is_empty(&mc_group->bundle_lru)) {
-                continue;
+        if (ip_ms->sync_full) {
+            LIST_FOR_EACH (mc_group, group_node, &ip_ms->ms->group_lru) {
+                ip_mcast_sync_group(ovnsb_idl_txn, chassis, local_dp,
+                                    sbrec_datapath_binding_by_key,
+                                    sbrec_port_binding_by_key,
+                                    sbrec_igmp_groups, ip_ms, mc_group,
+                                    &mc_group->addr);
             }
-            sbrec_igmp = igmp_group_lookup(sbrec_igmp_groups, &mc_group->addr,
-                                           local_dp->datapath, chassis);
-            if (!sbrec_igmp) {
-                sbrec_igmp = igmp_group_create(
-                    ovnsb_idl_txn, &mc_group->addr, local_dp->datapath,
-                    chassis, pinctrl.igmp_group_has_chassis_name);
+        } else {
+            struct ip_mcast_dirty_group *dg;
+
+            HMAP_FOR_EACH (dg, hmap_node, &ip_ms->synced_groups) {
+                mc_group = mcast_snooping_lookup(ip_ms->ms, &dg->addr,
+                                                 IP_MCAST_VLAN);
+                ip_mcast_sync_group(ovnsb_idl_txn, chassis, local_dp,
+                                    sbrec_datapath_binding_by_key,
+                                    sbrec_port_binding_by_key,
+                                    sbrec_igmp_groups, ip_ms, mc_group,
+                                    &dg->addr);
             }
-
-            igmp_group_update(sbrec_igmp, sbrec_datapath_binding_by_key,
-                                    sbrec_port_binding_by_key, ip_ms->ms,
-                                    mc_group, pinctrl.igmp_support_protocol);
         }
 
         /* Mrouters. */
-        sbrec_ip_mrouter = igmp_mrouter_lookup(sbrec_igmp_groups,
-                                               local_dp->datapath,
-                                               chassis);
-        if (!sbrec_ip_mrouter) {
-            sbrec_ip_mrouter = igmp_mrouter_create(ovnsb_idl_txn,
+        if (sync_mrouters) {
+            sbrec_ip_mrouter = igmp_mrouter_lookup(sbrec_igmp_groups,
                                                    local_dp->datapath,
-                                                   chassis,
-                                                   pinctrl.igmp_group_has_chassis_name);
+                                                   chassis);
+            if (!sbrec_ip_mrouter) {
+                sbrec_ip_mrouter = igmp_mrouter_create(
+                    ovnsb_idl_txn, local_dp->datapath, chassis,
+                    pinctrl.igmp_group_has_chassis_name);
+            }
+            igmp_mrouter_update_ports(sbrec_ip_mrouter,
+                                      sbrec_datapath_binding_by_key,
+                                      sbrec_port_binding_by_key, ip_ms->ms);
         }
-        igmp_mrouter_update_ports(sbrec_ip_mrouter,
-                                  sbrec_datapath_binding_by_key,
-                                  sbrec_port_binding_by_key, ip_ms->ms);
 
         ovs_rwlock_unlock(&ip_ms->ms->rwlock);
     }
@@ -5879,6 +7351,39 @@ ip_mcast_sync(struct ovsdb_idl_txn *ovnsb_idl_txn,
     }
 }
 
+/* Marks the IGMP_Groups written by the last ip_mcast_sync() for sync again,
+ * its transaction failed. */
+static void
+ip_mcast_sync_failed(void)
+    OVS_REQUIRES(pinctrl_mutex)
+{
+    struct ip_mcast_snoop *ip_ms;
+
+    if (ip_mcast_synced_all) {
+        ip_mcast_next_full_sync = 0;
+    }
+
+    HMAP_FOR_EACH (ip_ms, hmap_node, &mcast_snoop_map) {
+        struct ip_mcast_dirty_group *dg;
+
+        ovs_mutex_lock(&ip_ms->track_mutex);
+        if (ip_ms->sync_full) {
+            ip_mcast_snoop_set_full_sync(ip_ms);
+        } else {
+            HMAP_FOR_EACH (dg, hmap_node, &ip_ms->synced_groups) {
+                ip_mcast_snoop_mark_dirty(ip_ms, &dg->addr);
+            }
+        }
+        if (ip_ms->synced_mrouters) {
+            ip_ms->mrouters_dirty = true;
+        }
+        ovs_mutex_unlock(&ip_ms->track_mutex);
+
+        ip_mcast_dirty_groups_clear(&ip_ms->synced_groups);
+        ip_ms->synced_mrouters = false;
+    }
+}
+
 /* Reinject the packet and flood it to all registered mrouters (also those
  * who are not local to this chassis). */
 static void
@@ -5900,6 +7405,83 @@ ip_mcast_forward_query(struct rconn *swconn, struct ip_mcast_snoop *ip_ms,
                         OVN_MCAST_FLOOD_L2_TUNNEL_KEY, query);
 }
 
+/* Stores in 'addrs' the groups of the IGMP membership report or leave
+ * message 'pkt'. */
+static void
+ip_mcast_igmp_report_groups(const struct flow *ip_flow,
+                            const struct dp_packet *pkt,
+                            struct vector *addrs)
+{
+    struct in6_addr addr;
+
+    if (ntohs(ip_flow->tp_src) != IGMPV3_HOST_MEMBERSHIP_REPORT) {
+        in6_addr_set_mapped_ipv4(&addr, ip_flow->igmp_group_ip4);
+        vector_push(addrs, &addr);
+        return;
+    }
+
+    size_t offset = (char *) dp_packet_l4(pkt) - (char *) dp_packet_data(pkt);
+    const struct igmpv3_header *igmpv3 =
+        dp_packet_at(pkt, offset, IGMPV3_HEADER_LEN);
+    if (!igmpv3) {
+        return;
+    }
+
+    offset += IGMPV3_HEADER_LEN;
+    for (int ngrp = ntohs(igmpv3->ngrp); ngrp > 0; ngrp--) {
+        const struct igmpv3_record *record =
+            dp_packet_at(pkt, offset, IGMPV3_RECORD_LEN);
+        if (!record) {
+            break;
+        }
+
+        in6_addr_set_mapped_ipv4(&addr, get_16aligned_be32(&record->maddr));
+        vector_push(addrs, &addr);
+        offset += IGMPV3_RECORD_LEN + ntohs(record->nsrcs) * sizeof(ovs_be32)
+                  + record->aux_len * 4;
+    }
+}
+
+/* Stores in 'addrs' the groups of the MLD report or done message 'pkt'. */
+static void
+ip_mcast_mld_report_groups(const struct flow *ip_flow,
+                           const struct dp_packet *pkt,
+                           struct vector *addrs)
+{
+    size_t offset = (char *) dp_packet_l4(pkt) - (char *) dp_packet_data(pkt);
+    struct in6_addr addr;
+
+    if (ntohs(ip_flow->tp_src) != MLD2_REPORT) {
+        const void *maddr = dp_packet_at(pkt, offset + MLD_HEADER_LEN,
+                                         sizeof addr);
+        if (maddr) {
+            memcpy(&addr, maddr, sizeof addr);
+            vector_push(addrs, &addr);
+        }
+        return;
+    }
+
+    const struct mld_header *mld = dp_packet_at(pkt, offset, MLD_HEADER_LEN);
+    if (!mld) {
+        return;
+    }
+
+    offset += MLD_HEADER_LEN;
+    for (int ngrp = ntohs(mld->ngrp); ngrp > 0; ngrp--) {
+        const struct mld2_record *record =
+            dp_packet_at(pkt, offset, MLD2_RECORD_LEN);
+        if (!record) {
+            break;
+        }
+
+        memcpy(&addr, &record->maddr, sizeof addr);
+        vector_push(addrs, &addr);
+        offset += MLD2_RECORD_LEN
+                  + ntohs(record->nsrcs) * sizeof(struct in6_addr)
+                  + record->aux_len * 4;
+    }
+}
+
 static bool
 pinctrl_ip_mcast_handle_igmp(struct rconn *swconn,
                              struct ip_mcast_snoop *ip_ms,
@@ -5920,8 +7502,13 @@ pinctrl_ip_mcast_handle_igmp(struct rconn *swconn,
     }
 
     ovs_be32 ip4 = ip_flow->igmp_group_ip4;
+    struct vector addrs = VECTOR_EMPTY_INITIALIZER(struct in6_addr);
     bool group_change = false;
 
+    if (mcast_snooping_is_membership(ip_flow->tp_src)) {
+        ip_mcast_igmp_report_groups(ip_flow, pkt_in, &addrs);
+    }
+
     /* Only default VLAN is supported for now. */
     ovs_rwlock_wrlock(&ip_ms->ms->rwlock);
     switch (ntohs(ip_flow->tp_src)) {
@@ -5957,10 +7544,13 @@ pinctrl_ip_mcast_handle_igmp(struct rconn *swconn,
      * the whole L2 domain.
      */
     if (mcast_snooping_is_membership(ip_flow->tp_src)) {
+        ip_mcast_snoop_track_report(ip_ms, &addrs, in_port_key, group_change);
         ip_mcast_forward_report(swconn, ip_ms, in_port_key, pkt_in);
     } else if (mcast_snooping_is_query(ip_flow->tp_src)) {
+        ip_mcast_snoop_track_query(ip_ms, group_change);
         ip_mcast_forward_query(swconn, ip_ms, in_port_key, pkt_in);
     }
+    vector_destroy(&addrs);
     return group_change;
 }
 
@@ -5987,8 +7577,16 @@ pinctrl_ip_mcast_handle_mld(struct rconn *swconn,
         return false;
     }
 
+    struct vector addrs = VECTOR_EMPTY_INITIALIZER(struct in6_addr);
+    uint16_t type = ntohs(ip_flow->tp_src);
+    bool is_report = (type == MLD_REPORT || type == MLD_DONE ||
+                      type == MLD2_REPORT);
     bool group_change = false;
 
+    if (is_report) {
+        ip_mcast_mld_report_groups(ip_flow, pkt_in, &addrs);
+    }
+
     /* Only default VLAN is supported for now. */
     ovs_rwlock_wrlock(&ip_ms->ms->rwlock);
     switch (ntohs(ip_flow->tp_src)) {
@@ -6012,6 +7610,13 @@ pinctrl_ip_mcast_handle_mld(struct rconn *swconn,
     }
     ovs_rwlock_unlock(&ip_ms->ms->rwlock);
 
+    if (is_report) {
+        ip_mcast_snoop_track_report(ip_ms, &addrs, in_port_key, group_change);
+    } else if (type == MLD_QUERY) {
+        ip_mcast_snoop_track_query(ip_ms, group_change);
+    }
+    vector_destroy(&addrs);
+
     /* Forward reports to all registered mrouters and flood queries to
      * the whole L2 domain.
      */
@@ -6112,7 +7717,7 @@ ip_mcast_querier_send_igmp(struct rconn *swconn, struct ip_mcast_snoop *ip_ms)
     };
     match_set_in_port(&po.flow_metadata, OFPP_CONTROLLER);
     enum ofputil_protocol proto = ofputil_protocol_from_ofp_version(version);
-    queue_msg(swconn, ofputil_encode_packet_out(&po, proto));
+    queue_packet_out(swconn, ofputil_encode_packet_out(&po, proto));
     dp_packet_uninit(&packet);
     ofpbuf_uninit(&ofpacts);
 }
@@ -6162,7 +7767,7 @@ ip_mcast_querier_send_mld(struct rconn *swconn, struct ip_mcast_snoop *ip_ms)
     };
     match_set_in_port(&po.flow_metadata, OFPP_CONTROLLER);
     enum ofputil_protocol proto = ofputil_protocol_from_ofp_version(version);
-    queue_msg(swconn, ofputil_encode_packet_out(&po, proto));
+    queue_packet_out(swconn, ofputil_encode_packet_out(&po, proto));
     dp_packet_uninit(&packet);
     ofpbuf_uninit(&ofpacts);
 }
@@ -6183,6 +7788,11 @@ ip_mcast_querier_send(struct rconn *swconn, struct ip_mcast_snoop *ip_ms,
         ip_mcast_querier_send_mld(swconn, ip_ms);
     }
 
+    ovs_mutex_lock(&ip_ms->track_mutex);
+    ip_ms->stats.n_queries_tx += ip_ms->cfg.querier_v4_enabled
+                                 + ip_ms->cfg.querier_v6_enabled;
+    ovs_mutex_unlock(&ip_ms->track_mutex);
+
     /* Set the next query time. */
     ip_ms->query_time_ms = current_time + ip_ms->cfg.query_interval_s * 1000;
     return ip_ms->query_time_ms;
@@ -6355,7 +7965,7 @@ send_garp_rarp_prepare(const struct sbrec_ecmp_nexthop_table *ecmp_nh_table,
 static bool
 may_inject_pkts(void)
 {
-    return (!shash_is_empty(&ipv6_ras) ||
+    return (!cmap_is_empty(&ipv6_ras) ||
             !cmap_is_empty(&garp_rarp_get_data()->data) ||
             ipv6_prefixd_should_inject() ||
             !ovs_list_is_empty(&mcast_query_list) ||
@@ -6399,7 +8009,7 @@ reload_metadata(struct ofpbuf *ofpacts, const struct match *md)
     }
 }
 
-/* Called with in the pinctrl_handler thread context. */
+/* Called within a packet-in worker or the pinctrl_handler thread context. */
 static void
 pinctrl_handle_nd_na(struct rconn *swconn, const struct flow *ip_flow,
                      const struct match *md,
@@ -6432,7 +8042,7 @@ pinctrl_handle_nd_na(struct rconn *swconn, const struct flow *ip_flow,
     dp_packet_uninit(&packet);
 }
 
-/* Called with in the pinctrl_handler thread context. */
+/* Called within a packet-in worker or the pinctrl_handler thread context. */
 static void
 pinctrl_handle_nd_ns(struct rconn *swconn, const struct flow *ip_flow,
                      const struct ofputil_packet_in *pin,
@@ -6483,7 +8093,7 @@ pinctrl_handle_nd_ns(struct rconn *swconn, const struct flow *ip_flow,
     dp_packet_uninit(&packet);
 }
 
-/* Called with in the pinctrl_handler thread context. */
+/* Called within a packet-in worker or the pinctrl_handler thread context. */
 static void
 pinctrl_handle_put_nd_ra_opts(
     struct rconn *swconn,
@@ -6848,7 +8458,7 @@ run_put_vport_bindings(struct ovsdb_idl_txn *ovnsb_idl_txn,
     }
 }
 
-/* Called with in the pinctrl_handler thread context. */
+/* Called within a packet-in worker or the pinctrl_handler thread context. */
 static void
 pinctrl_handle_bind_vport(
     const struct flow *md, struct ofpbuf *userdata)
@@ -6941,6 +8551,10 @@ struct svc_monitor {
     long long int wait_time;
     long long int next_send_time;
 
+    /* In 'svc_monitors_timers', expires when the monitor needs to be
+     * processed by svc_monitors_run(). */
+    struct timer_wheel_node timer_node;
+
     struct smap options;
     /* The interval, in milli seconds, between service monitor checks. */
     int interval;
@@ -6977,11 +8591,21 @@ struct svc_monitor {
 static struct hmap svc_monitors_map;
 static struct ovs_list svc_monitors;
 
+/* Service monitors scheduled by the time they need to be processed at, so
+ * that svc_monitors_run() only visits the ones that are due. */
+static struct timer_wheel svc_monitors_timers;
+
+/* Percentage of the interval of a service monitor by which its health
+ * checks are randomly advanced ('external_ids:svc-monitor-jitter'). */
+#define SVC_MONITOR_MAX_JITTER 50
+static unsigned int svc_monitor_jitter;
+
 static void
 init_svc_monitors(void)
 {
     hmap_init(&svc_monitors_map);
     ovs_list_init(&svc_monitors);
+    timer_wheel_init(&svc_monitors_timers, time_msec());
 }
 
 static void
@@ -6993,6 +8617,7 @@ destroy_svc_monitors(void)
     }
 
     hmap_destroy(&svc_monitors_map);
+    timer_wheel_destroy(&svc_monitors_timers);
 
     LIST_FOR_EACH_POP (svc, list_node, &svc_monitors) {
         smap_destroy(&svc->options);
@@ -7020,6 +8645,65 @@ pinctrl_find_svc_monitor(uint32_t dp_key, uint32_t port_key,
     return NULL;
 }
 
+/* Returns a random delay, in milliseconds, within the jitter allowed for
+ * 'svc_mon'. */
+static long long int
+svc_monitor_get_jitter(const struct svc_monitor *svc_mon)
+    OVS_REQUIRES(pinctrl_mutex)
+{
+    long long int max_jitter =
+        (long long int) svc_mon->interval * svc_monitor_jitter / 100;
+
+    return max_jitter > 0 ? random_range(max_jitter + 1) : 0;
+}
+
+/* Returns the time at which the health check following the one that
+ * completed at 'now' must be sent. */
+static long long int
+svc_monitor_next_send_time(const struct svc_monitor *svc_mon,
+                           long long int now)
+    OVS_REQUIRES(pinctrl_mutex)
+{
+    return now + svc_mon->interval - svc_monitor_get_jitter(svc_mon);
+}
+
+/* Schedules 'svc_mon' to be processed by svc_monitors_run() at 'when'. */
+static void
+svc_monitor_schedule(struct svc_monitor *svc_mon, long long int when)
+    OVS_REQUIRES(pinctrl_mutex)
+{
+    timer_wheel_schedule(&svc_monitors_timers, &svc_mon->timer_node, when);
+}
+
+/* Schedules 'svc_mon' to be processed by svc_monitors_run() as soon as
+ * possible, e.g. after its state was changed by a reply to a health check.
+ * The reply may be handled by a packet-in worker thread, hence the
+ * notification. */
+static void
+svc_monitor_schedule_now(struct svc_monitor *svc_mon)
+    OVS_REQUIRES(pinctrl_mutex)
+{
+    svc_monitor_schedule(svc_mon, time_msec());
+    notify_pinctrl_handler();
+}
+
+/* Called by pinctrl_run(). Runs with in the main ovn-controller
+ * thread context. */
+static void
+svc_monitors_configure(const struct ovsrec_open_vswitch_table *ovs_table)
+    OVS_REQUIRES(pinctrl_mutex)
+{
+    const struct ovsrec_open_vswitch *cfg =
+        ovsrec_open_vswitch_table_first(ovs_table);
+
+    svc_monitor_jitter = 0;
+    if (cfg) {
+        svc_monitor_jitter = MIN(smap_get_uint(&cfg->external_ids,
+                                               "svc-monitor-jitter", 0),
+                                 SVC_MONITOR_MAX_JITTER);
+    }
+}
+
 static enum svc_monitor_type
 svc_monitor_type_from_sb(const struct sbrec_service_monitor *sb)
 {
@@ -7224,6 +8908,7 @@ sync_svc_monitors(struct ovsdb_idl_txn *ovnsb_idl_txn,
 
             hmap_insert(&svc_monitors_map, &svc_mon->hmap_node, hash);
             ovs_list_push_back(&svc_monitors, &svc_mon->list_node);
+            timer_wheel_node_init(&svc_mon->timer_node);
             changed = true;
         }
 
@@ -7243,6 +8928,13 @@ sync_svc_monitors(struct ovsdb_idl_txn *ovnsb_idl_txn,
             changed = true;
         }
 
+        if (!timer_wheel_node_is_scheduled(&svc_mon->timer_node)) {
+            /* Spread the first health checks of the new monitors. */
+            long long int first_check =
+                time_msec() + svc_monitor_get_jitter(svc_mon);
+            svc_monitor_schedule(svc_mon, first_check);
+        }
+
         svc_mon->delete = false;
     }
 
@@ -7250,6 +8942,7 @@ sync_svc_monitors(struct ovsdb_idl_txn *ovnsb_idl_txn,
         if (svc_mon->delete) {
             hmap_remove(&svc_monitors_map, &svc_mon->hmap_node);
             ovs_list_remove(&svc_mon->list_node);
+            timer_wheel_cancel(&svc_monitors_timers, &svc_mon->timer_node);
             smap_destroy(&svc_mon->options);
             free(svc_mon);
             changed = true;
@@ -7503,7 +9196,7 @@ pinctrl_send_bfd_tx_msg(struct rconn *swconn, struct bfd_entry *entry,
     enum ofp_version version = rconn_get_version(swconn);
     enum ofputil_protocol proto =
         ofputil_protocol_from_ofp_version(version);
-    queue_msg(swconn, ofputil_encode_packet_out(&po, proto));
+    queue_packet_out(swconn, ofputil_encode_packet_out(&po, proto));
     dp_packet_uninit(&packet);
     ofpbuf_uninit(&ofpacts);
 }
@@ -8031,7 +9724,7 @@ svc_monitor_send_tcp_health_check__(struct rconn *swconn,
     };
     match_set_in_port(&po.flow_metadata, OFPP_CONTROLLER);
     enum ofputil_protocol proto = ofputil_protocol_from_ofp_version(version);
-    queue_msg(swconn, ofputil_encode_packet_out(&po, proto));
+    queue_packet_out(swconn, ofputil_encode_packet_out(&po, proto));
     dp_packet_uninit(&packet);
     ofpbuf_uninit(&ofpacts);
 }
@@ -8092,7 +9785,7 @@ svc_monitor_send_udp_health_check(struct rconn *swconn,
     };
     match_set_in_port(&po.flow_metadata, OFPP_CONTROLLER);
     enum ofputil_protocol proto = ofputil_protocol_from_ofp_version(version);
-    queue_msg(swconn, ofputil_encode_packet_out(&po, proto));
+    queue_packet_out(swconn, ofputil_encode_packet_out(&po, proto));
     dp_packet_uninit(&packet);
     ofpbuf_uninit(&ofpacts);
 }
@@ -8164,7 +9857,7 @@ svc_monitor_send_icmp_health_check__(struct rconn *swconn,
     };
     match_set_in_port(&po.flow_metadata, OFPP_CONTROLLER);
     enum ofputil_protocol proto = ofputil_protocol_from_ofp_version(version);
-    queue_msg(swconn, ofputil_encode_packet_out(&po, proto));
+    queue_packet_out(swconn, ofputil_encode_packet_out(&po, proto));
     dp_packet_uninit(&packet);
     ofpbuf_uninit(&ofpacts);
 }
@@ -8200,9 +9893,10 @@ svc_monitors_run(struct rconn *swconn,
                  long long int *svc_monitors_next_run_time)
     OVS_REQUIRES(pinctrl_mutex)
 {
-    *svc_monitors_next_run_time = LLONG_MAX;
-    struct svc_monitor *svc_mon;
-    LIST_FOR_EACH (svc_mon, list_node, &svc_monitors) {
+    struct timer_wheel_node *node;
+    while ((node = timer_wheel_pop(&svc_monitors_timers, time_msec()))) {
+        struct svc_monitor *svc_mon =
+            CONTAINER_OF(node, struct svc_monitor, timer_node);
         char ip_[INET6_ADDRSTRLEN + 1];
         memset(ip_, 0, INET6_ADDRSTRLEN + 1);
         ipv6_string_mapped(ip_, &svc_mon->ip);
@@ -8218,7 +9912,8 @@ svc_monitors_run(struct rconn *swconn,
 
         case SVC_MON_S_WAITING:
             if (current_time >= svc_mon->wait_time) {
-                svc_mon->next_send_time = current_time + svc_mon->interval;
+                svc_mon->next_send_time =
+                    svc_monitor_next_send_time(svc_mon, current_time);
                 next_run_time = svc_mon->next_send_time;
                 if (svc_mon->protocol ==  SVC_MON_PROTO_UDP) {
                     svc_mon->n_success++;
@@ -8270,15 +9965,18 @@ svc_monitors_run(struct rconn *swconn,
             OVS_NOT_REACHED();
         }
 
-        if (*svc_monitors_next_run_time > next_run_time) {
-            *svc_monitors_next_run_time = next_run_time;
-        }
+        /* Never reschedule for the current millisecond, that would process
+         * the monitor again in this loop. */
+        svc_monitor_schedule(svc_mon, MAX(next_run_time, current_time + 1));
 
         if (old_status != svc_mon->status) {
             /* Notify the main thread to update the status in the SB DB. */
             notify_pinctrl_main();
         }
     }
+
+    *svc_monitors_next_run_time =
+        timer_wheel_next_expiry(&svc_monitors_timers);
 }
 
 static void
@@ -8322,7 +10020,8 @@ pinctrl_handle_icmp_svc_check(struct dp_packet *pkt_in,
 
     svc_mon->n_success++;
     svc_mon->state = SVC_MON_S_ONLINE;
-    svc_mon->next_send_time = time_msec() + svc_mon->interval;
+    svc_mon->next_send_time = svc_monitor_next_send_time(svc_mon, time_msec());
+    svc_monitor_schedule_now(svc_mon);
 }
 
 static bool
@@ -8357,7 +10056,9 @@ pinctrl_handle_tcp_svc_check(struct rconn *swconn,
                                             htonl(tcp_ack),
                                             htonl(0), th->tcp_dst);
         /* Calculate next_send_time. */
-        svc_mon->next_send_time = time_msec() + svc_mon->interval;
+        svc_mon->next_send_time =
+            svc_monitor_next_send_time(svc_mon, time_msec());
+        svc_monitor_schedule_now(svc_mon);
         return true;
     }
 
@@ -8367,7 +10068,9 @@ pinctrl_handle_tcp_svc_check(struct rconn *swconn,
         svc_mon->state = SVC_MON_S_OFFLINE;
 
         /* Calculate next_send_time. */
-        svc_mon->next_send_time = time_msec() + svc_mon->interval;
+        svc_mon->next_send_time =
+            svc_monitor_next_send_time(svc_mon, time_msec());
+        svc_monitor_schedule_now(svc_mon);
         return false;
     }
 
@@ -8588,7 +10291,9 @@ pinctrl_handle_svc_check(struct rconn *swconn, const struct flow *ip_flow,
         svc_mon->state = SVC_MON_S_OFFLINE;
 
         /* Calculate next_send_time. */
-        svc_mon->next_send_time = time_msec() + svc_mon->interval;
+        svc_mon->next_send_time =
+            svc_monitor_next_send_time(svc_mon, time_msec());
+        svc_monitor_schedule_now(svc_mon);
     }
 }
 
@@ -8791,7 +10496,7 @@ pinctrl_split_buf_action_handler(struct rconn *swconn, struct dp_packet *pkt,
     match_set_in_port(&po.flow_metadata, OFPP_CONTROLLER);
     enum ofp_version version = rconn_get_version(swconn);
     enum ofputil_protocol proto = ofputil_protocol_from_ofp_version(version);
-    queue_msg(swconn, ofputil_encode_packet_out(&po, proto));
+    queue_packet_out(swconn, ofputil_encode_packet_out(&po, proto));
 
     ofpbuf_uninit(&ofpacts);
 }
@@ -8807,6 +10512,7 @@ static void
 init_fdb_entries(void)
 {
     hmap_init(&put_fdbs);
+    hmap_init(&recent_put_fdbs);
 }
 
 static void
@@ -8814,6 +10520,8 @@ destroy_fdb_entries(void)
 {
     fdbs_clear(&put_fdbs);
     hmap_destroy(&put_fdbs);
+    fdbs_clear(&recent_put_fdbs);
+    hmap_destroy(&recent_put_fdbs);
 }
 
 static const struct sbrec_fdb *
@@ -8882,6 +10590,10 @@ run_put_fdb(struct ovsdb_idl_txn *ovnsb_idl_txn,
         if (pinctrl.fdb_can_timestamp) {
             sbrec_fdb_set_timestamp(sb_fdb, time_wall_msec());
         }
+        if (learn_dedup_window && hmap_count(&recent_put_fdbs)
+                                  < MAX_RECENT_LEARNED_ENTRIES) {
+            fdb_add(&recent_put_fdbs, fdb->data, time_msec());
+        }
     } else {
         fdb_remove(&put_fdbs, fdb);
     }
@@ -8892,7 +10604,8 @@ static void
 run_put_fdbs(struct ovsdb_idl_txn *ovnsb_idl_txn,
              struct ovsdb_idl_index *sbrec_port_binding_by_key,
              struct ovsdb_idl_index *sbrec_datapath_binding_by_key,
-             struct ovsdb_idl_index *sbrec_fdb_by_dp_key_mac, uint64_t cur_cfg)
+             struct ovsdb_idl_index *sbrec_fdb_by_dp_key_mac, uint64_t cur_cfg,
+             size_t *budget)
              OVS_REQUIRES(pinctrl_mutex)
 {
     if (!ovnsb_idl_txn) {
@@ -8900,16 +10613,32 @@ run_put_fdbs(struct ovsdb_idl_txn *ovnsb_idl_txn,
     }
 
     long long now = time_msec();
+    struct hmap batches = HMAP_INITIALIZER(&batches);
     struct fdb *fdb;
     HMAP_FOR_EACH_SAFE (fdb, hmap_node, &put_fdbs) {
-        if (fdb->cfg >= 0 && pinctrl_is_sb_commited(fdb->cfg, cur_cfg)) {
-            fdb_remove(&put_fdbs, fdb);
+        if (fdb->cfg >= 0) {
+            /* Already written, wait for the transaction to be committed.
+             * put_fdbs_commit_failed() resets 'cfg' if it fails. */
+            if (pinctrl_is_sb_commited(fdb->cfg, cur_cfg)) {
+                fdb_remove(&put_fdbs, fdb);
+            }
         } else if (now >= fdb->timestamp) {
-            run_put_fdb(ovnsb_idl_txn, sbrec_fdb_by_dp_key_mac,
-                        sbrec_port_binding_by_key,
-                        sbrec_datapath_binding_by_key, fdb, cur_cfg);
+            learn_batches_add(&batches, fdb->data.dp_key, fdb);
         }
     }
+
+    struct vector ordered = VECTOR_EMPTY_INITIALIZER(struct fdb *);
+    size_t n_deferred = learn_batches_order(&batches, budget, &ordered);
+    hmap_destroy(&batches);
+
+    VECTOR_FOR_EACH (&ordered, fdb) {
+        run_put_fdb(ovnsb_idl_txn, sbrec_fdb_by_dp_key_mac,
+                    sbrec_port_binding_by_key,
+                    sbrec_datapath_binding_by_key, fdb, cur_cfg);
+    }
+    COVERAGE_ADD(pinctrl_fdb_committed, vector_len(&ordered));
+    COVERAGE_ADD(pinctrl_fdb_deferred, n_deferred);
+    vector_destroy(&ordered);
 }
 
 
@@ -8923,24 +10652,49 @@ wait_put_fdbs(void)
     }
 }
 
-/* Called with in the pinctrl_handler thread context. */
+/* Called when the southbound transaction that carried the written entries
+ * failed, so that they are written again. */
 static void
-pinctrl_handle_put_fdb(const struct flow *md, const struct flow *headers)
-                       OVS_REQUIRES(pinctrl_mutex)
+put_fdbs_commit_failed(void)
+    OVS_REQUIRES(pinctrl_mutex)
 {
-    if (hmap_count(&put_fdbs) >= MAX_FDB_ENTRIES) {
-        COVERAGE_INC(pinctrl_drop_put_fdb);
-        return;
+    struct fdb *fdb;
+    HMAP_FOR_EACH (fdb, hmap_node, &put_fdbs) {
+        fdb->cfg = -1;
     }
+}
 
+/* Called within a packet-in worker or the pinctrl_handler thread context. */
+static void
+pinctrl_handle_put_fdb(const struct flow *md, const struct flow *headers)
+                       OVS_REQUIRES(pinctrl_mutex)
+{
     struct fdb_data fdb_data = (struct fdb_data) {
             .dp_key =  ntohll(md->metadata),
             .port_key =  md->regs[MFF_LOG_INPORT - MFF_REG0],
             .mac = headers->dl_src,
     };
 
+    long long now = time_msec();
+    const struct fdb *recent = fdb_find(&recent_put_fdbs, &fdb_data);
+    if (recent && recent->data.port_key == fdb_data.port_key
+        && now - recent->timestamp < learn_dedup_window) {
+        COVERAGE_INC(pinctrl_fdb_suppressed);
+        return;
+    }
+
     uint32_t delay = random_range(MAX_FDB_DELAY_MSEC) + 1;
-    long long timestamp = time_msec() + delay;
+    long long timestamp = now + delay;
+
+    const struct fdb *pending = fdb_find(&put_fdbs, &fdb_data);
+    if (pending) {
+        /* Don't postpone the pending write. */
+        COVERAGE_INC(pinctrl_fdb_coalesced);
+        timestamp = MIN(timestamp, pending->timestamp);
+    } else if (hmap_count(&put_fdbs) >= MAX_FDB_ENTRIES) {
+        COVERAGE_INC(pinctrl_drop_put_fdb);
+        return;
+    }
     fdb_add(&put_fdbs, fdb_data, timestamp);
     notify_pinctrl_main();
 }
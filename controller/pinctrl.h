@@ -23,6 +23,7 @@
 #include "openvswitch/list.h"
 #include "openvswitch/meta-flow.h"
 
+struct ds;
 struct hmap;
 struct shash;
 struct lport_index;
@@ -62,11 +63,15 @@ void pinctrl_run(struct ovsdb_idl_txn *ovnsb_idl_txn,
                  const struct ovsrec_open_vswitch_table *ovs_table,
                  int64_t cur_cfg);
 void pinctrl_wait(struct ovsdb_idl_txn *ovnsb_idl_txn);
+void pinctrl_ovnsb_commit_failed(void);
 void pinctrl_destroy(void);
 
 void pinctrl_update_swconn(const char *target, int probe_interval);
 
 void pinctrl_update(const struct ovsdb_idl *idl);
+void pinctrl_get_packet_in_stats(struct ds *output);
+void pinctrl_get_packet_in_metrics(struct ds *output);
+void pinctrl_get_mcast_snoop_stats(struct ds *output);
 
 struct activated_port {
     uint32_t dp_key;
@@ -16,9 +16,11 @@
 #include <config.h>
 
 #include "byte-order.h"
+#include "coverage.h"
 #include "dirs.h"
 #include "latch.h"
 #include "lflow.h"
+#include "lflow-profile.h"
 #include "lib/vec.h"
 #include "mac-cache.h"
 #include "openvswitch/ofp-errors.h"
@@ -38,20 +40,34 @@
 
 VLOG_DEFINE_THIS_MODULE(statctrl);
 
+COVERAGE_DEFINE(statctrl_cookie_request);
+COVERAGE_DEFINE(statctrl_table_request);
+
 #define STATS_VEC_CAPACITY_THRESHOLD 1024
 
+/* The statistics of the entries that need them are requested one cookie at
+ * a time, OVS looks up the flows by exact cookie without walking the table.
+ * The requests of a polling cycle are sent in at most STATS_MAX_BATCHES
+ * batches, spread over the cycle, and share the same xid. */
+#define STATS_MAX_BATCHES            1024
+#define STATS_NODE_N_XIDS            8
+
 enum stat_type {
     STATS_MAC_BINDING = 0,
     STATS_FDB,
     STATS_MAC_BINDING_PROBE,
+    STATS_LFLOW_PROFILE,
     STATS_MAX,
 };
 
 struct stats_node {
     /* The statistics request. */
     struct  ofputil_flow_stats_request request;
-    /* xid of the last statistics request. */
-    ovs_be32 xid;
+    /* xids of the last polling cycles, the replies to a request might
+     * arrive after the next cycle started. */
+    ovs_be32 xids[STATS_NODE_N_XIDS];
+    size_t next_xid;
+    bool cycle_has_xid;
     /* Timestamp when the next request should happen. */
     int64_t next_request_timestamp;
     /* Request delay in ms. */
@@ -65,20 +81,38 @@ struct stats_node {
     /* Function to process the parsed stats.
      * This function runs in main thread locked behind mutex. */
     void (*run)(struct vector *stats, uint64_t *req_delay, void *data);
+    /* Function to get the cookies of the entries that need statistics.
+     * This function runs in main thread locked behind mutex.  If NULL, the
+     * statistics of the whole table are requested. */
+    void (*collect_cookies)(struct vector *cookies, void *data);
+    /* Cookies collected by the main thread for the next polling cycle. */
+    struct vector cookies;
+    bool cookies_valid;
+    bool need_cookies;
+    /* Cookies of the current polling cycle, if requested one by one. */
+    struct vector cycle_cookies;
+    /* Number of request batches of the current polling cycle, number of
+     * cookies per batch and index of the next batch. */
+    size_t n_batches;
+    size_t batch_size;
+    size_t next_batch;
     /* Name of the stats node. */
     const char *name;
 };
 
-#define STATS_NODE(NAME, REQUEST, STAT_TYPE, PROCESS, RUN)                 \
+#define STATS_NODE(NAME, REQUEST, STAT_TYPE, PROCESS, RUN, COOKIES)        \
     do {                                                                   \
         statctrl_ctx.nodes[STATS_##NAME] = (struct stats_node) {           \
             .request = REQUEST,                                            \
-            .xid = 0,                                                      \
             .next_request_timestamp = INT64_MAX,                           \
             .request_delay = 0,                                            \
             .stats = VECTOR_EMPTY_INITIALIZER(STAT_TYPE),                  \
             .process_flow_stats = PROCESS,                                 \
             .run = RUN,                                                    \
+            .collect_cookies = COOKIES,                                    \
+            .cookies = VECTOR_EMPTY_INITIALIZER(uint64_t),                 \
+            .cycle_cookies = VECTOR_EMPTY_INITIALIZER(uint64_t),           \
+            .need_cookies = true,                                          \
             .name = OVS_STRINGIZE(stats_##NAME),                 \
         };                                                                 \
         stopwatch_create(OVS_STRINGIZE(stats_##NAME), SW_MS);              \
@@ -140,7 +174,8 @@ statctrl_init(void)
             .table_id = OFTABLE_MAC_CACHE_USE,
     };
     STATS_NODE(MAC_BINDING, mac_binding_request, struct mac_cache_stats,
-               mac_binding_stats_process_flow_stats, mac_binding_stats_run);
+               mac_binding_stats_process_flow_stats, mac_binding_stats_run,
+               mac_binding_stats_collect_cookies);
 
     struct ofputil_flow_stats_request fdb_request = {
             .cookie = htonll(0),
@@ -150,7 +185,8 @@ statctrl_init(void)
             .table_id = OFTABLE_LOOKUP_FDB,
     };
     STATS_NODE(FDB, fdb_request, struct mac_cache_stats,
-               fdb_stats_process_flow_stats, fdb_stats_run);
+               fdb_stats_process_flow_stats, fdb_stats_run,
+               fdb_stats_collect_cookies);
 
     struct ofputil_flow_stats_request mac_binding_probe_request = {
             .cookie = htonll(0),
@@ -162,7 +198,20 @@ statctrl_init(void)
     STATS_NODE(MAC_BINDING_PROBE, mac_binding_probe_request,
                struct mac_cache_stats,
                mac_binding_probe_stats_process_flow_stats,
-               mac_binding_probe_stats_run);
+               mac_binding_probe_stats_run,
+               mac_binding_probe_stats_collect_cookies);
+
+    struct ofputil_flow_stats_request lflow_profile_request = {
+            .cookie = htonll(0),
+            .cookie_mask = htonll(0),
+            .out_port = OFPP_ANY,
+            .out_group = OFPG_ANY,
+            .table_id = OFPTT_ALL,
+    };
+    STATS_NODE(LFLOW_PROFILE, lflow_profile_request,
+               struct lflow_profile_flow_stats,
+               lflow_profile_process_flow_stats, lflow_profile_stats_run,
+               NULL);
 
     statctrl_ctx.thread = ovs_thread_create("ovn_statctrl",
                                             statctrl_thread_handler,
@@ -190,6 +239,7 @@ statctrl_run(struct ovsdb_idl_txn *ovnsb_idl_txn,
         [STATS_MAC_BINDING] = mac_cache_data,
         [STATS_FDB] = mac_cache_data,
         [STATS_MAC_BINDING_PROBE] = &mac_binding_probe_data,
+        [STATS_LFLOW_PROFILE] = NULL,
     };
 
     bool schedule_updated = false;
@@ -210,6 +260,14 @@ statctrl_run(struct ovsdb_idl_txn *ovnsb_idl_txn,
                      vector_capacity(&node->stats));
             vector_shrink_to_fit(&node->stats);
         }
+        if (node->need_cookies) {
+            vector_clear(&node->cookies);
+            if (node->collect_cookies) {
+                node->collect_cookies(&node->cookies, node_data[i]);
+                node->cookies_valid = true;
+            }
+            node->need_cookies = false;
+        }
         stopwatch_stop(node->name, time_msec());
 
         schedule_updated |=
@@ -264,6 +322,8 @@ statctrl_destroy(void)
     for (size_t i = 0; i < STATS_MAX; i++) {
         struct stats_node *node = &statctrl_ctx.nodes[i];
         vector_destroy(&node->stats);
+        vector_destroy(&node->cookies);
+        vector_destroy(&node->cycle_cookies);
     }
 }
 
@@ -348,8 +408,10 @@ static enum stat_type
 statctrl_get_stat_type(struct statctrl_ctx *ctx, const struct ofp_header *oh)
 {
     for (size_t i = 0; i < STATS_MAX; i++) {
-        if (ctx->nodes[i].xid == oh->xid) {
-            return i;
+        for (size_t j = 0; j < STATS_NODE_N_XIDS; j++) {
+            if (ctx->nodes[i].xids[j] == oh->xid) {
+                return i;
+            }
         }
     }
     return STATS_MAX;
@@ -379,6 +441,86 @@ statctrl_decode_statistics_reply(struct stats_node *node, struct ofpbuf *msg)
     ofpbuf_uninit(&ofpacts);
 }
 
+/* Plans the requests of a new polling cycle of 'node', based on the cookies
+ * collected by the main thread.  The whole table is requested at once if
+ * they are not known yet. */
+static void
+statctrl_start_cycle(struct stats_node *node)
+    OVS_REQUIRES(mutex)
+{
+    vector_clear(&node->cycle_cookies);
+    node->n_batches = 1;
+    node->batch_size = 1;
+    node->next_batch = 0;
+    node->cycle_has_xid = false;
+
+    if (!node->cookies_valid) {
+        return;
+    }
+
+    struct vector tmp = node->cycle_cookies;
+    node->cycle_cookies = node->cookies;
+    node->cookies = tmp;
+    node->cookies_valid = false;
+
+    /* At most one batch per ms of the request delay. */
+    size_t n_cookies = vector_len(&node->cycle_cookies);
+    size_t max_batches = MIN(STATS_MAX_BATCHES, MAX(node->request_delay, 1));
+    node->n_batches = MIN(n_cookies, max_batches);
+    if (node->n_batches) {
+        node->batch_size = DIV_ROUND_UP(n_cookies, node->n_batches);
+        node->n_batches = DIV_ROUND_UP(n_cookies, node->batch_size);
+    }
+}
+
+static void
+statctrl_send_node_request(struct rconn *swconn, struct stats_node *node,
+                           const struct ofputil_flow_stats_request *request,
+                           enum ofputil_protocol proto)
+    OVS_REQUIRES(mutex)
+{
+    struct ofpbuf *msg = ofputil_encode_flow_stats_request(request, proto);
+    struct ofp_header *oh = msg->data;
+
+    /* All the requests of a polling cycle use the xid of the first one. */
+    if (!node->cycle_has_xid) {
+        node->xids[node->next_xid++ % STATS_NODE_N_XIDS] = oh->xid;
+        node->cycle_has_xid = true;
+    } else {
+        oh->xid = node->xids[(node->next_xid - 1) % STATS_NODE_N_XIDS];
+    }
+
+    rconn_send(swconn, msg, NULL);
+}
+
+/* Sends the next batch of requests of the current polling cycle of
+ * 'node'. */
+static void
+statctrl_send_node_batch(struct rconn *swconn, struct stats_node *node,
+                         enum ofputil_protocol proto)
+    OVS_REQUIRES(mutex)
+{
+    size_t n_cookies = vector_len(&node->cycle_cookies);
+
+    if (!n_cookies) {
+        COVERAGE_INC(statctrl_table_request);
+        statctrl_send_node_request(swconn, node, &node->request, proto);
+        return;
+    }
+
+    size_t start = node->next_batch * node->batch_size;
+    size_t end = MIN(start + node->batch_size, n_cookies);
+    for (size_t i = start; i < end; i++) {
+        struct ofputil_flow_stats_request request = node->request;
+
+        request.cookie = htonll(vector_get(&node->cycle_cookies, i,
+                                           uint64_t));
+        request.cookie_mask = OVS_BE64_MAX;
+        COVERAGE_INC(statctrl_cookie_request);
+        statctrl_send_node_request(swconn, node, &request, proto);
+    }
+}
+
 static void
 statctrl_send_request(struct rconn *swconn, struct statctrl_ctx *ctx)
     OVS_REQUIRES(mutex)
@@ -394,13 +536,21 @@ statctrl_send_request(struct rconn *swconn, struct statctrl_ctx *ctx)
             continue;
         }
 
-        struct ofpbuf *msg =
-                ofputil_encode_flow_stats_request(&node->request, proto);
-        node->xid = ((struct ofp_header *) msg->data)->xid;
+        if (!node->next_batch) {
+            statctrl_start_cycle(node);
+        }
+        if (node->next_batch < node->n_batches) {
+            statctrl_send_node_batch(swconn, node, proto);
+        }
 
-        statctrl_update_next_request_timestamp(node, now, 0);
+        if (++node->next_batch >= node->n_batches) {
+            /* Last batch of the cycle, let the main thread collect the
+             * cookies for the next one. */
+            node->next_batch = 0;
+            node->need_cookies = true;
+        }
 
-        rconn_send(swconn, msg, NULL);
+        statctrl_update_next_request_timestamp(node, now, 0);
     }
 }
 
@@ -408,7 +558,8 @@ static void
 statctrl_notify_main_thread(struct statctrl_ctx *ctx)
 {
     for (size_t i = 0; i < STATS_MAX; i++) {
-        if (!vector_is_empty(&ctx->nodes[i].stats)) {
+        if (!vector_is_empty(&ctx->nodes[i].stats)
+            || ctx->nodes[i].need_cookies) {
             seq_change(ctx->main_seq);
             return;
         }
@@ -436,9 +587,16 @@ statctrl_update_next_request_timestamp(struct stats_node *node,
         return false;
     }
 
+    /* Spread the batches of a polling cycle over the request delay, at
+     * least 1 ms apart. */
+    int64_t n_batches = MAX(node->n_batches, 1);
     int64_t timestamp = prev_delay ? node->next_request_timestamp : now;
-    node->next_request_timestamp =
-            timestamp + node->request_delay - prev_delay;
+    int64_t delay_diff = (int64_t) node->request_delay - (int64_t) prev_delay;
+    int64_t step = delay_diff / n_batches;
+    if (delay_diff > 0) {
+        step = MAX(step, 1);
+    }
+    node->next_request_timestamp = timestamp + step;
 
     return timestamp != node->next_request_timestamp;
 }
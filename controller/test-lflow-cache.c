@@ -40,6 +40,7 @@ test_lflow_cache_add__(struct lflow_cache *lc, const char *op_type,
                        const struct uuid *lflow_uuid,
                        unsigned int conj_id_ofs,
                        unsigned int n_conjs,
+                       unsigned int cost,
                        struct expr *e)
 {
     printf("ADD %s:\n", op_type);
@@ -48,14 +49,14 @@ test_lflow_cache_add__(struct lflow_cache *lc, const char *op_type,
 
     if (!strcmp(op_type, "expr")) {
         lflow_cache_add_expr(lc, lflow_uuid, expr_clone(e),
-                             TEST_LFLOW_CACHE_VALUE_SIZE);
+                             TEST_LFLOW_CACHE_VALUE_SIZE, cost);
     } else if (!strcmp(op_type, "matches")) {
         struct hmap *matches = xmalloc(sizeof *matches);
         ovs_assert(expr_to_matches(e, NULL, NULL, matches) == 0);
         ovs_assert(hmap_count(matches) == 1);
         lflow_cache_add_matches(lc, lflow_uuid,
                                 conj_id_ofs, n_conjs, matches,
-                                TEST_LFLOW_CACHE_VALUE_SIZE);
+                                TEST_LFLOW_CACHE_VALUE_SIZE, cost);
     } else {
         OVS_NOT_REACHED();
     }
@@ -151,12 +152,20 @@ test_lflow_cache_operations(struct ovs_cmdl_context *ctx)
                 goto done;
             }
 
+            unsigned int cost = 0;
+            if (shift < ctx->argc && !strcmp(ctx->argv[shift], "cost")) {
+                shift++;
+                if (!test_read_uint_value(ctx, shift++, "cost", &cost)) {
+                    goto done;
+                }
+            }
+
             struct uuid lflow_uuid;
             uuid_generate(&lflow_uuid);
             vector_push(&lflow_uuids, &lflow_uuid);
 
             test_lflow_cache_add__(lc, op_type, &lflow_uuid, conj_id_ofs,
-                                   n_conjs, e);
+                                   n_conjs, cost, e);
             test_lflow_cache_lookup__(lc, &lflow_uuid);
         } else if (!strcmp(op, "add-del")) {
             const char *op_type = test_read_value(ctx, shift++, "op_type");
@@ -179,10 +188,17 @@ test_lflow_cache_operations(struct ovs_cmdl_context *ctx)
             struct uuid lflow_uuid;
             uuid_generate(&lflow_uuid);
             test_lflow_cache_add__(lc, op_type, &lflow_uuid, conj_id_ofs,
-                                   n_conjs, e);
+                                   n_conjs, 0, e);
             test_lflow_cache_lookup__(lc, &lflow_uuid);
             test_lflow_cache_delete__(lc, &lflow_uuid);
             test_lflow_cache_lookup__(lc, &lflow_uuid);
+        } else if (!strcmp(op, "lookup")) {
+            unsigned int idx;
+            if (!test_read_uint_value(ctx, shift++, "index", &idx)) {
+                goto done;
+            }
+            ovs_assert(idx < vector_len(&lflow_uuids));
+            test_lflow_cache_lookup__(lc, vector_get_ptr(&lflow_uuids, idx));
         } else if (!strcmp(op, "del")) {
             ovs_assert(!vector_is_empty(&lflow_uuids));
             struct uuid lflow_uuid;
@@ -266,11 +282,11 @@ test_lflow_cache_negative(struct ovs_cmdl_context *ctx OVS_UNUSED)
         ovs_assert(expr_to_matches(e, NULL, NULL, matches) == 0);
         ovs_assert(hmap_count(matches) == 1);
 
-        lflow_cache_add_expr(lcs[i], NULL, NULL, 0);
-        lflow_cache_add_expr(lcs[i], NULL, e, expr_size(e));
-        lflow_cache_add_matches(lcs[i], NULL, 0, 0, NULL, 0);
+        lflow_cache_add_expr(lcs[i], NULL, NULL, 0, 0);
+        lflow_cache_add_expr(lcs[i], NULL, e, expr_size(e), 0);
+        lflow_cache_add_matches(lcs[i], NULL, 0, 0, NULL, 0, 0);
         lflow_cache_add_matches(lcs[i], NULL, 0, 0, matches,
-                                TEST_LFLOW_CACHE_VALUE_SIZE);
+                                TEST_LFLOW_CACHE_VALUE_SIZE, 0);
         lflow_cache_destroy(lcs[i]);
     }
 }
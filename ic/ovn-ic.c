@@ -31,6 +31,7 @@
 #include "lib/ovn-ic-nb-idl.h"
 #include "lib/ovn-ic-sb-idl.h"
 #include "lib/ovn-nb-idl.h"
+#include "lib/ovn-metrics.h"
 #include "lib/ovn-sb-idl.h"
 #include "lib/ovn-util.h"
 #include "memory.h"
@@ -3354,6 +3355,25 @@ update_idl_probe_interval(struct ovsdb_idl *ovn_sb_idl,
     set_idl_probe_interval(ovn_icnb_idl, ovn_ic_nb_db, ic_interval);
 }
 
+/* Auxiliary data of ic_put_metrics(). */
+struct ic_metrics_aux {
+    struct ovsdb_idl_loop *idl_loops[4];
+};
+
+/* Implements ovn_metrics_cb. */
+static void
+ic_put_metrics(struct ds *ds, void *aux_)
+{
+    const struct ic_metrics_aux *aux = aux_;
+    struct simap usage = SIMAP_INITIALIZER(&usage);
+
+    for (size_t i = 0; i < ARRAY_SIZE(aux->idl_loops); i++) {
+        ovsdb_idl_get_memory_usage(aux->idl_loops[i]->idl, &usage);
+    }
+    ovn_metrics_put_memory(ds, &usage);
+    simap_destroy(&usage);
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -3663,6 +3683,15 @@ main(int argc, char *argv[])
     unixctl_command_register("ic-sb-connection-status", "", 0, 0,
                              ovn_conn_show, ovnisb_idl_loop.idl);
 
+    struct ic_metrics_aux metrics_aux = {
+        .idl_loops = {
+            &ovnnb_idl_loop, &ovnsb_idl_loop,
+            &ovninb_idl_loop, &ovnisb_idl_loop,
+        },
+    };
+    ovn_metrics_init();
+    ovn_metrics_register(ic_put_metrics, &metrics_aux);
+
     /* Initialize incremental processing engine for ovn-northd */
     inc_proc_ic_init(&ovnnb_idl_loop, &ovnsb_idl_loop,
                      &ovninb_idl_loop, &ovnisb_idl_loop);
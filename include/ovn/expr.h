@@ -369,8 +369,9 @@ bool expr_relop_from_token(enum lex_type type, enum expr_relop *relop);
 struct expr {
     struct ovs_list node;       /* In parent EXPR_T_AND or EXPR_T_OR if any. */
     enum expr_type type;        /* Expression type. */
-    const char *as_name;        /* Address set name. Null if it is not an
-                                   address set. */
+    const char *as_name;        /* Address set or port group name. Null if
+                                   it is not from an address set or a port
+                                   group. */
 
     union {
         /* EXPR_T_CMP.
@@ -423,13 +424,13 @@ struct expr *expr_parse(struct lexer *, const struct shash *symtab,
                         const struct shash *addr_sets,
                         const struct shash *port_groups,
                         struct shash *addr_sets_ref,
-                        struct sset *port_groups_ref,
+                        struct shash *port_groups_ref,
                         int64_t dp_id);
 struct expr *expr_parse_string(const char *, const struct shash *symtab,
                                const struct shash *addr_sets,
                                const struct shash *port_groups,
                                struct shash *addr_sets_ref,
-                               struct sset *port_groups_ref,
+                               struct shash *port_groups_ref,
                                int64_t dp_id,
                                char **errorp);
 
@@ -474,12 +475,17 @@ struct expr_match {
     struct match match;
     struct vector conjunctions; /* Vector of struct cls_conjunction. */
 
-    /* Tracked address set information. */
+    /* Tracked address set information.  For a port group member 'as_ip' and
+     * 'as_mask' are built by expr_port_key_to_as_ip() from the tunnel key of
+     * the logical port. */
     char *as_name;
     struct in6_addr as_ip;
     struct in6_addr as_mask;
 };
 
+void expr_port_key_to_as_ip(unsigned int port, struct in6_addr *ip,
+                            struct in6_addr *mask);
+
 uint32_t expr_to_matches(const struct expr *,
                          bool (*lookup_port)(const void *aux,
                                              const char *port_name,
@@ -552,6 +558,11 @@ void expr_constant_set_integers_diff(
                                 struct expr_constant_set *new,
                                 struct expr_constant_set **p_diff_added,
                                 struct expr_constant_set **p_diff_deleted);
+void expr_constant_set_strings_diff(
+                                const struct expr_constant_set *old,
+                                const struct expr_constant_set *new,
+                                struct expr_constant_set **p_diff_added,
+                                struct expr_constant_set **p_diff_deleted);
 
 
 /* Constant sets.
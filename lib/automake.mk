@@ -41,6 +41,8 @@ lib_libovn_la_SOURCES = \
 	lib/ofctrl-seqno.h \
 	lib/ovn-l7.h \
 	lib/ovn-l7.c \
+	lib/ovn-metrics.c \
+	lib/ovn-metrics.h \
 	lib/ovn-util.c \
 	lib/ovn-util.h \
 	lib/logical-fields.c \
@@ -51,6 +53,8 @@ lib_libovn_la_SOURCES = \
 	lib/sparse-array.c \
 	lib/sparse-array.h \
 	lib/stopwatch-names.h \
+	lib/timer-wheel.c \
+	lib/timer-wheel.h \
 	lib/vec.c \
 	lib/vec.h \
 	lib/vif-plug-provider.h \
@@ -0,0 +1,206 @@
+/* Copyright (c) 2026, Red Hat, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bench-ovsdb.h"
+#include "jsonrpc.h"
+#include "lib/ovn-dirs.h"
+#include "lib/vec.h"
+#include "openvswitch/json.h"
+#include "openvswitch/poll-loop.h"
+#include "openvswitch/shash.h"
+#include "openvswitch/vlog.h"
+#include "ovsdb/file.h"
+#include "ovsdb/jsonrpc-server.h"
+#include "ovsdb/ovsdb.h"
+#include "ovsdb/storage.h"
+#include "ovsdb/transaction.h"
+#include "ovsdb/trigger.h"
+#include "socket-util.h"
+#include "stream.h"
+#include "timeval.h"
+#include "util.h"
+
+VLOG_DEFINE_THIS_MODULE(bench_ovsdb);
+
+struct bench_ovsdb {
+    struct ovsdb_jsonrpc_server *server;
+    struct vector dbs;          /* Vector of 'struct ovsdb *'. */
+    char *socket_path;
+    char *remote;               /* For the IDLs. */
+    struct jsonrpc *rpc;        /* For bench_ovsdb_transact(). */
+};
+
+struct bench_ovsdb *
+bench_ovsdb_create(const char *program_name)
+{
+    struct bench_ovsdb *b = xzalloc(sizeof *b);
+
+    b->server = ovsdb_jsonrpc_server_create(false);
+    b->dbs = VECTOR_EMPTY_INITIALIZER(struct ovsdb *);
+    b->socket_path = xasprintf("%s/%s-bench.%ld.sock", ovn_rundir(),
+                               program_name, (long int) getpid());
+    b->remote = xasprintf("unix:%s", b->socket_path);
+
+    struct shash remotes = SHASH_INITIALIZER(&remotes);
+    char *premote = xasprintf("punix:%s", b->socket_path);
+    shash_add(&remotes, premote, ovsdb_jsonrpc_default_options(premote));
+    ovsdb_jsonrpc_server_set_remotes(b->server, &remotes);
+    shash_destroy_free_data(&remotes);
+    free(premote);
+
+    return b;
+}
+
+void
+bench_ovsdb_destroy(struct bench_ovsdb *b)
+{
+    if (!b) {
+        return;
+    }
+
+    jsonrpc_close(b->rpc);
+    ovsdb_jsonrpc_server_destroy(b->server);
+
+    struct ovsdb *db;
+    VECTOR_FOR_EACH (&b->dbs, db) {
+        ovsdb_destroy(db);
+    }
+    vector_destroy(&b->dbs);
+    free(b->socket_path);
+    free(b->remote);
+    free(b);
+}
+
+/* Loads the database file 'file_name' into an in-memory database and
+ * serves it. */
+void
+bench_ovsdb_add_db(struct bench_ovsdb *b, const char *file_name)
+{
+    struct ovsdb *file_db = ovsdb_file_read(file_name, false);
+    struct ovsdb *db =
+        ovsdb_create(ovsdb_schema_clone(file_db->schema),
+                     ovsdb_storage_create_unbacked(file_db->name));
+
+    struct json *txn_json = ovsdb_to_txn_json(file_db, "benchmark", true);
+    struct ovsdb_txn *txn;
+    struct ovsdb_error *error =
+        ovsdb_file_txn_from_json(db, txn_json, false, &txn);
+    if (!error) {
+        error = ovsdb_txn_replay_commit(txn);
+    }
+    if (error) {
+        char *s = ovsdb_error_to_string_free(error);
+        ovs_fatal(0, "%s: failed to load database (%s)", file_name, s);
+    }
+
+    json_destroy(txn_json);
+    ovsdb_destroy(file_db);
+
+    ovsdb_jsonrpc_server_add_db(b->server, db);
+    vector_push(&b->dbs, &db);
+}
+
+const char *
+bench_ovsdb_remote(const struct bench_ovsdb *b)
+{
+    return b->remote;
+}
+
+/* Lets the server make progress and arranges for the next poll_block() to
+ * wake up when it has something to do. */
+void
+bench_ovsdb_run(struct bench_ovsdb *b)
+{
+    long long int now = time_msec();
+    struct ovsdb *db;
+
+    ovsdb_jsonrpc_server_run(b->server);
+    VECTOR_FOR_EACH (&b->dbs, db) {
+        ovsdb_trigger_run(db, now);
+    }
+
+    ovsdb_jsonrpc_server_wait(b->server);
+    VECTOR_FOR_EACH (&b->dbs, db) {
+        ovsdb_trigger_wait(db, now);
+    }
+}
+
+/* Sends a "transact" request with 'params' to the server and waits for its
+ * reply.  Takes ownership of 'params'.  Exits if the request fails, logs a
+ * warning if one of its operations fails.  'where' identifies the request
+ * in the error messages. */
+void
+bench_ovsdb_transact(struct bench_ovsdb *b, struct json *params,
+                     const char *where)
+{
+    if (!b->rpc) {
+        struct stream *stream;
+        int error = stream_open_block(jsonrpc_stream_open(b->remote, &stream,
+                                                          DSCP_DEFAULT),
+                                      -1, &stream);
+        if (error) {
+            ovs_fatal(error, "%s: failed to connect", b->remote);
+        }
+        b->rpc = jsonrpc_open(stream);
+    }
+
+    struct json *id;
+    struct jsonrpc_msg *request = jsonrpc_create_request("transact", params,
+                                                         &id);
+    int error = jsonrpc_send(b->rpc, request);
+    if (error) {
+        ovs_fatal(error, "%s: failed to send the transaction", where);
+    }
+
+    for (;;) {
+        struct jsonrpc_msg *reply = NULL;
+
+        bench_ovsdb_run(b);
+        jsonrpc_run(b->rpc);
+        error = jsonrpc_recv(b->rpc, &reply);
+        if (error && error != EAGAIN) {
+            ovs_fatal(error, "%s: failed to receive the reply", where);
+        }
+
+        if (reply && json_equal(reply->id, id)) {
+            if (reply->type == JSONRPC_ERROR) {
+                char *s = json_to_string(reply->error, 0);
+                ovs_fatal(0, "%s: transaction failed: %s", where, s);
+            }
+
+            char *s = json_to_string(reply->result, 0);
+            if (strstr(s, "\"error\"")) {
+                VLOG_WARN("%s: transaction failed: %s", where, s);
+            }
+            free(s);
+            jsonrpc_msg_destroy(reply);
+            break;
+        } else if (reply) {
+            jsonrpc_msg_destroy(reply);
+            continue;
+        }
+
+        jsonrpc_wait(b->rpc);
+        jsonrpc_recv_wait(b->rpc);
+        poll_block();
+    }
+    json_destroy(id);
+}
@@ -0,0 +1,44 @@
+/* Copyright (c) 2026, Red Hat, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BENCH_OVSDB_H
+#define BENCH_OVSDB_H 1
+
+/* In-process OVSDB server for the offline benchmark modes.
+ *
+ * Database files, e.g., snapshots of production databases, are loaded into
+ * unbacked in-memory databases and served on a unix socket by an OVSDB
+ * server running in the calling process, so that the regular IDLs can
+ * connect to them.  The files are never modified.
+ *
+ * The server only makes progress in bench_ovsdb_run(), which must be called
+ * in every iteration of the caller's loop.
+ *
+ * This module depends on libovsdb, so it isn't part of libovn and is built
+ * directly into the programs that use it. */
+
+struct json;
+
+struct bench_ovsdb *bench_ovsdb_create(const char *program_name);
+void bench_ovsdb_destroy(struct bench_ovsdb *);
+
+void bench_ovsdb_add_db(struct bench_ovsdb *, const char *file_name);
+const char *bench_ovsdb_remote(const struct bench_ovsdb *);
+
+void bench_ovsdb_run(struct bench_ovsdb *);
+void bench_ovsdb_transact(struct bench_ovsdb *, struct json *params,
+                          const char *where);
+
+#endif /* lib/bench-ovsdb.h */
@@ -504,7 +504,7 @@ struct expr_context {
     const struct shash *addr_sets; /* Address set table. */
     const struct shash *port_groups; /* Port group table. */
     struct shash *addr_sets_ref;      /* The set of address set referenced. */
-    struct sset *port_groups_ref;    /* The set of port groups referenced. */
+    struct shash *port_groups_ref;   /* The set of port groups referenced. */
     int64_t dp_id;                   /* The tunnel_key of the datapath for
                                         which we're parsing the current
                                         expression. */
@@ -826,17 +826,23 @@ parse_port_group(struct expr_context *ctx, struct expr_constant_set *cs)
 
     get_sb_port_group_name(ctx->lexer->token.s, ctx->dp_id, &sb_name);
     if (ctx->port_groups_ref) {
-        sset_add(ctx->port_groups_ref, ds_cstr(&sb_name));
+        size_t *ref_count = shash_find_data(ctx->port_groups_ref,
+                                            ds_cstr(&sb_name));
+        if (!ref_count) {
+            ref_count = xmalloc(sizeof *ref_count);
+            *ref_count = 1;
+            shash_add(ctx->port_groups_ref, ds_cstr(&sb_name), ref_count);
+        } else {
+            (*ref_count)++;
+        }
     }
 
-    struct expr_constant_set *port_group = NULL;
-
-    if (ctx->port_groups) {
-        port_group = shash_find_data(ctx->port_groups, ds_cstr(&sb_name));
-    }
+    struct shash_node *node = ctx->port_groups
+                              ? shash_find(ctx->port_groups, ds_cstr(&sb_name))
+                              : NULL;
     ds_destroy(&sb_name);
 
-    if (!port_group) {
+    if (!node) {
         lexer_syntax_error(ctx->lexer, "expecting port group name");
         return false;
     }
@@ -845,13 +851,15 @@ parse_port_group(struct expr_context *ctx, struct expr_constant_set *cs)
         return false;
     }
 
-
+    struct expr_constant_set *port_group = node->data;
     vector_reserve(&cs->values, vector_len(&port_group->values));
 
+    /* Port group members are tracked the same way as address set entries,
+     * so that membership changes can be processed incrementally. */
     struct expr_constant c;
     VECTOR_FOR_EACH (&port_group->values, c) {
         c.string = xstrdup(c.string);
-        c.as_name = NULL;
+        c.as_name = node->name;
         vector_push(&cs->values, &c);
     }
 
@@ -1188,6 +1196,55 @@ expr_constant_set_integers_diff(struct expr_constant_set *old,
     *p_diff_deleted = diff_deleted;
 }
 
+/* Find the differences between old and new. Both old and new must be string
+ * type, e.g. generated by expr_const_sets_add_strings(), but they don't need
+ * to be sorted.
+ *
+ * The differences, added and deleted elements, are stored in p_diff_added and
+ * p_diff_deleted respectively. Caller takes the ownership of these.
+ *
+ * *p_diff_added and *p_diff_deleted can be NULL, if no such elements found. */
+void
+expr_constant_set_strings_diff(const struct expr_constant_set *old,
+                               const struct expr_constant_set *new,
+                               struct expr_constant_set **p_diff_added,
+                               struct expr_constant_set **p_diff_deleted)
+{
+    struct expr_constant_set *diff_added = NULL;
+    struct expr_constant_set *diff_deleted = NULL;
+    struct sset old_strings = SSET_INITIALIZER(&old_strings);
+    struct sset new_strings = SSET_INITIALIZER(&new_strings);
+    struct expr_constant c;
+
+    VECTOR_FOR_EACH (&old->values, c) {
+        sset_add(&old_strings, c.string);
+    }
+    VECTOR_FOR_EACH (&new->values, c) {
+        sset_add(&new_strings, c.string);
+    }
+
+    VECTOR_FOR_EACH (&old->values, c) {
+        if (!sset_contains(&new_strings, c.string)) {
+            c.string = xstrdup(c.string);
+            expr_constant_set_add_value(&diff_deleted, &c);
+            diff_deleted->type = EXPR_C_STRING;
+        }
+    }
+    VECTOR_FOR_EACH (&new->values, c) {
+        if (!sset_contains(&old_strings, c.string)) {
+            c.string = xstrdup(c.string);
+            expr_constant_set_add_value(&diff_added, &c);
+            diff_added->type = EXPR_C_STRING;
+        }
+    }
+
+    sset_destroy(&old_strings);
+    sset_destroy(&new_strings);
+
+    *p_diff_added = diff_added;
+    *p_diff_deleted = diff_deleted;
+}
+
 
 /* Adds an constant set named 'name' to 'const_sets', replacing any existing
  * constant set entry with the given name. */
@@ -1494,7 +1551,7 @@ expr_parse(struct lexer *lexer, const struct shash *symtab,
            const struct shash *addr_sets,
            const struct shash *port_groups,
            struct shash *addr_sets_ref,
-           struct sset *port_groups_ref,
+           struct shash *port_groups_ref,
            int64_t dp_id)
 {
     struct expr_context ctx = { .lexer = lexer,
@@ -1518,7 +1575,7 @@ expr_parse_string(const char *s, const struct shash *symtab,
                   const struct shash *addr_sets,
                   const struct shash *port_groups,
                   struct shash *addr_sets_ref,
-                  struct sset *port_groups_ref,
+                  struct shash *port_groups_ref,
                   int64_t dp_id,
                   char **errorp)
 {
@@ -3211,7 +3268,7 @@ constrain_match(const struct expr *expr,
                 bool (*lookup_port)(const void *aux,
                                     const char *port_name,
                                     unsigned int *portp),
-                const void *aux, struct match *m)
+                const void *aux, struct match *m, unsigned int *portp)
 {
     ovs_assert(expr->type == EXPR_T_CMP);
     if (expr->cmp.symbol->width) {
@@ -3233,10 +3290,25 @@ constrain_match(const struct expr *expr,
         x.integer = htonll(port);
 
         mf_write_subfield(&sf, &x, m);
+        if (portp) {
+            *portp = port;
+        }
     }
     return true;
 }
 
+/* Stores the tunnel key 'port' of a logical port, matched through a port
+ * group, as an exact match address in '*ip' and '*mask', so that flows
+ * generated for port group members can be tracked like address set
+ * entries. */
+void
+expr_port_key_to_as_ip(unsigned int port, struct in6_addr *ip,
+                       struct in6_addr *mask)
+{
+    in6_addr_set_mapped_ipv4(ip, htonl(port));
+    *mask = in6addr_exact;
+}
+
 static bool
 add_disjunction(const struct expr *or,
                 bool (*lookup_port)(const void *aux, const char *port_name,
@@ -3252,14 +3324,18 @@ add_disjunction(const struct expr *or,
     LIST_FOR_EACH (sub, node, &or->andor) {
         struct expr_match *match = expr_match_new(m, clause, n_clauses,
                                                   conj_id);
+        unsigned int port = 0;
         if (sub->as_name) {
             ovs_assert(sub->type == EXPR_T_CMP);
-            ovs_assert(sub->cmp.symbol->width);
             match->as_name = xstrdup(sub->as_name);
             match->as_ip = sub->cmp.value.ipv6;
             match->as_mask = sub->cmp.mask.ipv6;
         }
-        if (constrain_match(sub, lookup_port, aux, &match->match)) {
+        if (constrain_match(sub, lookup_port, aux, &match->match, &port)) {
+            if (match->as_name && !sub->cmp.symbol->width) {
+                /* Port group member, track it by the port's tunnel key. */
+                expr_port_key_to_as_ip(port, &match->as_ip, &match->as_mask);
+            }
             expr_match_add(matches, match);
             n++;
         } else {
@@ -3288,7 +3364,7 @@ add_conjunction(const struct expr *and,
     LIST_FOR_EACH (sub, node, &and->andor) {
         switch (sub->type) {
         case EXPR_T_CMP:
-            if (!constrain_match(sub, lookup_port, aux, &match)) {
+            if (!constrain_match(sub, lookup_port, aux, &match, NULL)) {
                 return;
             }
             break;
@@ -3343,7 +3419,7 @@ add_cmp_flow(const struct expr *cmp,
              const void *aux, struct hmap *matches)
 {
     struct expr_match *m = expr_match_new(NULL, 0, 0, 0);
-    if (constrain_match(cmp, lookup_port, aux, &m->match)) {
+    if (constrain_match(cmp, lookup_port, aux, &m->match, NULL)) {
         expr_match_add(matches, m);
     } else {
         expr_match_destroy(m);
@@ -3794,14 +3870,14 @@ expr_parse_microflow__(struct lexer *lexer,
         break;
 
     case EXPR_T_CMP:
-        constrain_match(e, lookup_port, aux, &m);
+        constrain_match(e, lookup_port, aux, &m, NULL);
         break;
 
     case EXPR_T_AND: {
         struct expr *sub;
         LIST_FOR_EACH (sub, node, &e->andor) {
             if (sub->type == EXPR_T_CMP) {
-                constrain_match(sub, lookup_port, aux, &m);
+                constrain_match(sub, lookup_port, aux, &m, NULL);
             } else {
                 ovs_assert(sub->type == EXPR_T_OR);
                 lexer_error(lexer, "Constraints are ambiguous: %s.",
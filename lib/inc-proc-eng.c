@@ -19,16 +19,20 @@
 #include <errno.h>
 #include <getopt.h>
 #include <signal.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "lib/util.h"
 #include "openvswitch/dynamic-string.h"
 #include "openvswitch/hmap.h"
+#include "openvswitch/json.h"
 #include "openvswitch/poll-loop.h"
 #include "openvswitch/vlog.h"
+#include "ovs-usdt.h"
 #include "ovsdb-idl.h"
 #include "inc-proc-eng.h"
+#include "ovn-metrics.h"
 #include "timeval.h"
 #include "unixctl.h"
 #include "vec.h"
@@ -117,14 +121,91 @@ engine_topo_sort(struct engine_node *node, struct vector *sorted_nodes)
     vector_push(sorted_nodes, &node);
 }
 
-static void
-engine_clear_stats(struct unixctl_conn *conn, int argc OVS_UNUSED,
-                   const char *argv[] OVS_UNUSED, void *arg OVS_UNUSED)
+void
+engine_clear_all_stats(void)
 {
     struct engine_node *node;
     VECTOR_FOR_EACH (&engine_nodes, node) {
         memset(&node->stats, 0, sizeof node->stats);
     }
+}
+
+struct json *
+engine_get_stats_json(void)
+{
+    struct json *stats = json_object_create();
+
+    struct engine_node *node;
+    VECTOR_FOR_EACH (&engine_nodes, node) {
+        struct json *node_stats = json_object_create();
+
+        json_object_put(node_stats, "recompute",
+                        json_integer_create(node->stats.recompute));
+        json_object_put(node_stats, "compute",
+                        json_integer_create(node->stats.compute));
+        json_object_put(node_stats, "cancel",
+                        json_integer_create(node->stats.cancel));
+        json_object_put(node_stats, "recompute-usec",
+                        json_integer_create(node->stats.recompute_usec));
+        json_object_put(node_stats, "compute-usec",
+                        json_integer_create(node->stats.compute_usec));
+        json_object_put(stats, node->name, node_stats);
+    }
+    return stats;
+}
+
+/* Implements ovn_metrics_cb. */
+static void
+engine_put_metrics(struct ds *ds, void *aux OVS_UNUSED)
+{
+    static const struct {
+        const char *name;
+        size_t offset;          /* In 'struct engine_stats'. */
+        bool usec;              /* Exported in seconds. */
+        const char *help;
+    } families[] = {
+        { "ovn_engine_recompute", offsetof(struct engine_stats, recompute),
+          false, "Number of full recomputes of the engine node." },
+        { "ovn_engine_compute", offsetof(struct engine_stats, compute),
+          false, "Number of incremental computes of the engine node." },
+        { "ovn_engine_cancel", offsetof(struct engine_stats, cancel),
+          false, "Number of canceled runs of the engine node." },
+        { "ovn_engine_recompute_seconds",
+          offsetof(struct engine_stats, recompute_usec),
+          true, "Time spent in full recomputes of the engine node." },
+        { "ovn_engine_compute_seconds",
+          offsetof(struct engine_stats, compute_usec),
+          true, "Time spent in the change handlers of the engine node." },
+    };
+
+    for (size_t i = 0; i < ARRAY_SIZE(families); i++) {
+        char *total = xasprintf("%s_total", families[i].name);
+
+        ovn_metrics_put_family(ds, families[i].name, "counter",
+                               families[i].usec ? "seconds" : NULL,
+                               families[i].help);
+
+        struct engine_node *node;
+        VECTOR_FOR_EACH (&engine_nodes, node) {
+            const uint64_t *value = (const uint64_t *)
+                ((const char *) &node->stats + families[i].offset);
+
+            if (families[i].usec) {
+                ovn_metrics_put_double(ds, total, "node", node->name,
+                                       *value / 1e6);
+            } else {
+                ovn_metrics_put_uint(ds, total, "node", node->name, *value);
+            }
+        }
+        free(total);
+    }
+}
+
+static void
+engine_clear_stats(struct unixctl_conn *conn, int argc OVS_UNUSED,
+                   const char *argv[] OVS_UNUSED, void *arg OVS_UNUSED)
+{
+    engine_clear_all_stats();
     unixctl_command_reply(conn, NULL);
 }
 
@@ -244,7 +325,9 @@ engine_init(struct engine_node *node, struct engine_arg *arg)
                 engine_get_compute_failure_info;
         }
         stopwatch_create(sorted_node->name, SW_MS);
+        ovn_metrics_add_stopwatch(sorted_node->name);
     }
+    ovn_metrics_register(engine_put_metrics, NULL);
 
     unixctl_command_register("inc-engine/show-stats", "", 0, 2,
                              engine_dump_stats, NULL);
@@ -455,9 +538,11 @@ static enum engine_node_state
 run_recompute_callback(struct engine_node *node)
 {
     enum engine_node_state ret;
+    long long int start = time_usec();
     stopwatch_start(node->name, time_msec());
     ret = node->run(node, node->data);
     stopwatch_stop(node->name, time_msec());
+    node->stats.recompute_usec += time_usec() - start;
     return ret;
 }
 
@@ -465,9 +550,11 @@ static enum engine_input_handler_result
 run_change_handler(struct engine_node *node, struct engine_node_input *input)
 {
     enum engine_input_handler_result ret;
+    long long int start = time_usec();
     stopwatch_start(input->change_handler_name, time_msec());
     ret = input->change_handler(node, node->data);
     stopwatch_stop(input->change_handler_name, time_msec());
+    node->stats.compute_usec += time_usec() - start;
     return ret;
 }
 
@@ -629,9 +716,13 @@ engine_run(bool recompute_allowed)
     engine_run_canceled = false;
     struct engine_node *node;
     VECTOR_FOR_EACH (&engine_nodes, node) {
+        OVS_USDT_PROBE(engine_run, node_start, node->name);
         ovsdb_idl_txn_assert_read_only(sb_txn, !node->sb_write);
         engine_run_node(node, recompute_allowed);
         ovsdb_idl_txn_assert_read_only(sb_txn, false);
+        OVS_USDT_PROBE(engine_run, node_end, node->name,
+                       engine_node_state_name[node->state],
+                       node->stats.recompute, node->stats.compute);
 
         if (node->state == EN_CANCELED) {
             node->stats.cancel++;
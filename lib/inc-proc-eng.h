@@ -222,6 +222,8 @@ struct engine_stats {
     uint64_t recompute;
     uint64_t compute;
     uint64_t cancel;
+    uint64_t recompute_usec;    /* Time spent in run(). */
+    uint64_t compute_usec;      /* Time spent in change handlers. */
 };
 
 struct engine_node {
@@ -345,6 +347,13 @@ void engine_add_input_with_compute_debug_impl(
  * iteration, and the change can't be tracked across iterations. */
 void engine_set_force_recompute(void);
 
+/* Clears the statistics of all the engine nodes. */
+void engine_clear_all_stats(void);
+
+/* Returns the statistics of all the engine nodes as a JSON object, indexed
+ * by node name.  The caller must free it with json_destroy(). */
+struct json *engine_get_stats_json(void);
+
 void engine_dump_graph(const char *node_name);
 
 /* Same as "engine_set_force_recompute()", but the poll_loop is woken up
@@ -0,0 +1,329 @@
+/* Copyright (c) 2026, Red Hat, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include "ovn-metrics.h"
+
+#include "coverage.h"
+#include "openvswitch/dynamic-string.h"
+#include "simap.h"
+#include "sset.h"
+#include "stopwatch.h"
+#include "unixctl.h"
+#include "util.h"
+#include "vec.h"
+
+struct ovn_metrics_provider {
+    ovn_metrics_cb *cb;
+    void *aux;
+};
+
+/* Contains 'struct ovn_metrics_provider'. */
+static struct vector providers =
+    VECTOR_EMPTY_INITIALIZER(struct ovn_metrics_provider);
+
+/* Names of the stopwatches to export. */
+static struct sset stopwatches = SSET_INITIALIZER(&stopwatches);
+
+/* Coverage counters to export.  OVS doesn't provide a way to iterate over
+ * all the coverage counters, so they are listed here.  The ones that aren't
+ * part of a daemon are skipped. */
+static const char *coverage_counters[] = {
+    /* controller/lflow.c, controller/physical.c, controller/ofctrl.c. */
+    "lflow_run",
+    "consider_logical_flow",
+    "physical_run",
+    "ofctrl_msg_too_long",
+
+    /* controller/lflow-cache.c. */
+    "lflow_cache_flush",
+    "lflow_cache_add_expr",
+    "lflow_cache_add_matches",
+    "lflow_cache_free_expr",
+    "lflow_cache_free_matches",
+    "lflow_cache_add",
+    "lflow_cache_hit",
+    "lflow_cache_miss",
+    "lflow_cache_delete",
+    "lflow_cache_full",
+    "lflow_cache_mem_full",
+    "lflow_cache_made_room",
+    "lflow_cache_evict",
+    "lflow_cache_trim",
+
+    /* controller/pinctrl.c. */
+    "pinctrl_drop_put_mac_binding",
+    "pinctrl_drop_put_fdb",
+    "pinctrl_mac_binding_coalesced",
+    "pinctrl_mac_binding_suppressed",
+    "pinctrl_mac_binding_committed",
+    "pinctrl_mac_binding_deferred",
+    "pinctrl_fdb_coalesced",
+    "pinctrl_fdb_suppressed",
+    "pinctrl_fdb_committed",
+    "pinctrl_fdb_deferred",
+    "pinctrl_drop_buffered_packets_map",
+    "pinctrl_drop_controller_event",
+    "pinctrl_drop_put_vport_binding",
+    "pinctrl_notify_main_thread",
+    "pinctrl_total_pin_pkts",
+    "pinctrl_packet_out",
+    "pinctrl_dhcp_reply_cache_hit",
+    "pinctrl_dhcp_reply_cache_miss",
+    "dns_query_total",
+    "dns_cache_hit",
+    "dns_cache_miss",
+    "dns_answer_cache_hit",
+    "dns_answer_cache_miss",
+    "dns_response_sent",
+
+    /* controller/mac-cache.c. */
+    "buffered_packets_drop_queue_full",
+    "buffered_packets_drop_lru",
+    "buffered_packets_drop_no_memory",
+    "buffered_packets_drop_expired",
+
+    /* lib/lflow-conj-ids.c. */
+    "lflow_conj_conflict",
+    "lflow_conj_alloc",
+    "lflow_conj_alloc_specified",
+    "lflow_conj_free",
+    "lflow_conj_free_unexpected",
+
+    /* northd/en-northd.c. */
+    "northd_run",
+
+    /* OVS. */
+    "poll_create_node",
+    "poll_zero_timeout",
+    "seq_change",
+    "util_xalloc",
+    "hmap_expand",
+    "hmap_pathological",
+    "rconn_queued",
+    "rconn_sent",
+    "rconn_overflow",
+    "txn_success",
+    "txn_try_again",
+    "txn_error",
+};
+
+static void
+ovn_metrics_put_label_value(struct ds *ds, const char *value)
+{
+    for (const char *p = value; *p; p++) {
+        switch (*p) {
+        case '\\':
+            ds_put_cstr(ds, "\\\\");
+            break;
+        case '"':
+            ds_put_cstr(ds, "\\\"");
+            break;
+        case '\n':
+            ds_put_cstr(ds, "\\n");
+            break;
+        default:
+            ds_put_char(ds, *p);
+            break;
+        }
+    }
+}
+
+static void
+ovn_metrics_put_sample_name(struct ds *ds, const char *name,
+                            const char *label, const char *label_value)
+{
+    ds_put_cstr(ds, name);
+    if (label) {
+        ds_put_format(ds, "{%s=\"", label);
+        ovn_metrics_put_label_value(ds, label_value);
+        ds_put_cstr(ds, "\"}");
+    }
+    ds_put_char(ds, ' ');
+}
+
+void
+ovn_metrics_put_family(struct ds *ds, const char *name, const char *type,
+                       const char *unit, const char *help)
+{
+    ds_put_format(ds, "# TYPE %s %s\n", name, type);
+    if (unit) {
+        ds_put_format(ds, "# UNIT %s %s\n", name, unit);
+    }
+    ds_put_format(ds, "# HELP %s %s\n", name, help);
+}
+
+void
+ovn_metrics_put_uint(struct ds *ds, const char *name, const char *label,
+                     const char *label_value, uint64_t value)
+{
+    ovn_metrics_put_sample_name(ds, name, label, label_value);
+    ds_put_format(ds, "%"PRIu64"\n", value);
+}
+
+void
+ovn_metrics_put_double(struct ds *ds, const char *name, const char *label,
+                       const char *label_value, double value)
+{
+    ovn_metrics_put_sample_name(ds, name, label, label_value);
+    ds_put_format(ds, "%.9g\n", value);
+}
+
+void
+ovn_metrics_put_memory(struct ds *ds, const struct simap *usage)
+{
+    ovn_metrics_put_family(ds, "ovn_memory_usage", "gauge", NULL,
+                           "Memory usage of the daemon, as reported by "
+                           "memory/show.");
+
+    const struct simap_node **nodes = simap_sort(usage);
+    for (size_t i = 0; i < simap_count(usage); i++) {
+        ovn_metrics_put_uint(ds, "ovn_memory_usage", "item", nodes[i]->name,
+                             nodes[i]->data);
+    }
+    free(nodes);
+}
+
+void
+ovn_metrics_register(ovn_metrics_cb *cb, void *aux)
+{
+    struct ovn_metrics_provider provider = {
+        .cb = cb,
+        .aux = aux,
+    };
+    vector_push(&providers, &provider);
+}
+
+void
+ovn_metrics_add_stopwatch(const char *name)
+{
+    sset_add(&stopwatches, name);
+}
+
+static double
+stopwatch_to_seconds(const struct stopwatch_stats *stats, double value)
+{
+    switch (stats->unit) {
+    case SW_MS:
+        return value / 1e3;
+    case SW_US:
+        return value / 1e6;
+    case SW_NS:
+        return value / 1e9;
+    default:
+        OVS_NOT_REACHED();
+    }
+}
+
+static void
+ovn_metrics_put_stopwatches(struct ds *ds)
+{
+    const char **names = sset_sort(&stopwatches);
+    size_t n = sset_count(&stopwatches);
+    struct stopwatch_stats *stats = xcalloc(n, sizeof *stats);
+    bool *valid = xcalloc(n, sizeof *valid);
+
+    for (size_t i = 0; i < n; i++) {
+        valid[i] = stopwatch_get_stats(names[i], &stats[i]);
+    }
+
+    ovn_metrics_put_family(ds, "ovn_stopwatch_samples", "counter", NULL,
+                           "Number of samples of the stopwatch.");
+    for (size_t i = 0; i < n; i++) {
+        if (valid[i]) {
+            ovn_metrics_put_uint(ds, "ovn_stopwatch_samples_total",
+                                 "stopwatch", names[i], stats[i].count);
+        }
+    }
+
+    static const struct {
+        const char *name;
+        const char *help;
+    } families[] = {
+        { "ovn_stopwatch_min_seconds", "Shortest sample of the stopwatch." },
+        { "ovn_stopwatch_max_seconds", "Longest sample of the stopwatch." },
+        { "ovn_stopwatch_p95_seconds",
+          "95th percentile of the samples of the stopwatch." },
+        { "ovn_stopwatch_ewma_50_seconds",
+          "Exponentially weighted moving average of the samples of the "
+          "stopwatch, with alpha 0.5." },
+        { "ovn_stopwatch_ewma_1_seconds",
+          "Exponentially weighted moving average of the samples of the "
+          "stopwatch, with alpha 0.01." },
+    };
+    for (size_t f = 0; f < ARRAY_SIZE(families); f++) {
+        ovn_metrics_put_family(ds, families[f].name, "gauge", "seconds",
+                               families[f].help);
+        for (size_t i = 0; i < n; i++) {
+            if (!valid[i]) {
+                continue;
+            }
+
+            const double values[] = {
+                stats[i].min, stats[i].max, stats[i].pctl_95,
+                stats[i].ewma_50, stats[i].ewma_1,
+            };
+            ovn_metrics_put_double(ds, families[f].name, "stopwatch",
+                                   names[i],
+                                   stopwatch_to_seconds(&stats[i],
+                                                        values[f]));
+        }
+    }
+
+    free(valid);
+    free(stats);
+    free(names);
+}
+
+static void
+ovn_metrics_put_coverage(struct ds *ds)
+{
+    ovn_metrics_put_family(ds, "ovn_coverage", "counter", NULL,
+                           "Coverage counter, as reported by coverage/show.");
+    for (size_t i = 0; i < ARRAY_SIZE(coverage_counters); i++) {
+        unsigned long long int count;
+
+        if (!coverage_read_counter(coverage_counters[i], &count)) {
+            ovn_metrics_put_uint(ds, "ovn_coverage_total", "counter",
+                                 coverage_counters[i], count);
+        }
+    }
+}
+
+static void
+ovn_metrics_show(struct unixctl_conn *conn, int argc OVS_UNUSED,
+                 const char *argv[] OVS_UNUSED, void *arg OVS_UNUSED)
+{
+    struct ds ds = DS_EMPTY_INITIALIZER;
+
+    struct ovn_metrics_provider *provider;
+    VECTOR_FOR_EACH_PTR (&providers, provider) {
+        provider->cb(&ds, provider->aux);
+    }
+    ovn_metrics_put_stopwatches(&ds);
+    ovn_metrics_put_coverage(&ds);
+    ds_put_cstr(&ds, "# EOF\n");
+
+    unixctl_command_reply(conn, ds_cstr(&ds));
+    ds_destroy(&ds);
+}
+
+void
+ovn_metrics_init(void)
+{
+    unixctl_command_register("metrics/show", "", 0, 0, ovn_metrics_show,
+                             NULL);
+}
@@ -0,0 +1,64 @@
+/* Copyright (c) 2026, Red Hat, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OVN_METRICS_H
+#define OVN_METRICS_H 1
+
+#include <stdint.h>
+
+/* Performance counters of the OVN daemons in the OpenMetrics text format.
+ *
+ * ovn_metrics_init() registers the "metrics/show" unixctl command, which
+ * prints, in this order:
+ *
+ *   - the metrics of the providers registered with ovn_metrics_register(),
+ *     e.g., the incremental processing engine, which registers itself in
+ *     engine_init(), and the memory usage of the daemon.
+ *
+ *   - the stopwatches added with ovn_metrics_add_stopwatch().
+ *
+ *   - the coverage counters of OVN, and a few of OVS.
+ *
+ * All the metric names start with "ovn_" and are the same in all the
+ * daemons, a scraper is expected to label them with the daemon they come
+ * from.  Each provider must print whole metric families, with
+ * ovn_metrics_put_family() followed by all the samples of the family. */
+
+struct ds;
+struct simap;
+
+typedef void ovn_metrics_cb(struct ds *, void *aux);
+
+void ovn_metrics_init(void);
+void ovn_metrics_register(ovn_metrics_cb *, void *aux);
+void ovn_metrics_add_stopwatch(const char *name);
+
+/* 'type' is an OpenMetrics type, e.g., "counter" or "gauge".  'unit' may be
+ * NULL, otherwise 'name' must end with it. */
+void ovn_metrics_put_family(struct ds *, const char *name, const char *type,
+                            const char *unit, const char *help);
+
+/* Samples.  'label' and 'label_value' may be NULL for metrics without
+ * labels.  The name of the samples of counters ends with "_total". */
+void ovn_metrics_put_uint(struct ds *, const char *name, const char *label,
+                          const char *label_value, uint64_t value);
+void ovn_metrics_put_double(struct ds *, const char *name, const char *label,
+                            const char *label_value, double value);
+
+/* Prints 'usage', as filled by the *_memory_usage() functions for
+ * memory_report(), as the "ovn_memory_usage" family. */
+void ovn_metrics_put_memory(struct ds *, const struct simap *usage);
+
+#endif /* lib/ovn-metrics.h */
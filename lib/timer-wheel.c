@@ -0,0 +1,256 @@
+/* Copyright (c) 2026, Red Hat, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include <limits.h>
+
+#include "timer-wheel.h"
+#include "util.h"
+
+#define TIMER_WHEEL_SLOT_MASK (TIMER_WHEEL_SLOTS - 1)
+
+/* Number of milliseconds covered by a slot of 'level'. */
+static long long int
+timer_wheel_span(int level)
+{
+    return 1LL << (TIMER_WHEEL_LEVEL_BITS * level);
+}
+
+static size_t
+timer_wheel_slot(long long int time, int level)
+{
+    return (time >> (TIMER_WHEEL_LEVEL_BITS * level)) & TIMER_WHEEL_SLOT_MASK;
+}
+
+void
+timer_wheel_init(struct timer_wheel *tw, long long int now)
+{
+    for (size_t level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        for (size_t slot = 0; slot < TIMER_WHEEL_SLOTS; slot++) {
+            ovs_list_init(&tw->slots[level][slot]);
+        }
+        tw->n_level_nodes[level] = 0;
+    }
+    ovs_list_init(&tw->expired);
+    tw->now = now;
+    tw->n_nodes = 0;
+}
+
+/* The nodes still scheduled are not freed, they are owned by the caller. */
+void
+timer_wheel_destroy(struct timer_wheel *tw)
+{
+    timer_wheel_init(tw, tw->now);
+}
+
+void
+timer_wheel_node_init(struct timer_wheel_node *node)
+{
+    ovs_list_init(&node->list_node);
+    node->expires = LLONG_MAX;
+    node->level = -1;
+}
+
+bool
+timer_wheel_node_is_scheduled(const struct timer_wheel_node *node)
+{
+    return !ovs_list_is_empty(&node->list_node);
+}
+
+/* Adds 'node' to the slot matching its expiration time. */
+static void
+timer_wheel_insert__(struct timer_wheel *tw, struct timer_wheel_node *node)
+{
+    if (node->expires < tw->now) {
+        node->level = -1;
+        ovs_list_push_back(&tw->expired, &node->list_node);
+        return;
+    }
+
+    long long int delta = node->expires - tw->now;
+    long long int expires = node->expires;
+    int level;
+
+    for (level = 0; level < TIMER_WHEEL_LEVELS - 1; level++) {
+        if (delta < timer_wheel_span(level + 1)) {
+            break;
+        }
+    }
+    if (delta >= timer_wheel_span(TIMER_WHEEL_LEVELS)) {
+        /* Out of range, it will be cascaded again until it gets close
+         * enough. */
+        expires = tw->now + timer_wheel_span(TIMER_WHEEL_LEVELS) - 1;
+    }
+
+    node->level = level;
+    tw->n_level_nodes[level]++;
+    ovs_list_push_back(&tw->slots[level][timer_wheel_slot(expires, level)],
+                       &node->list_node);
+}
+
+static void
+timer_wheel_remove__(struct timer_wheel *tw, struct timer_wheel_node *node)
+{
+    if (node->level >= 0) {
+        tw->n_level_nodes[node->level]--;
+    }
+    ovs_list_remove(&node->list_node);
+    ovs_list_init(&node->list_node);
+    node->level = -1;
+}
+
+/* Schedules 'node' to expire at 'expires', in milliseconds.  'node' is
+ * rescheduled if it was already scheduled. */
+void
+timer_wheel_schedule(struct timer_wheel *tw, struct timer_wheel_node *node,
+                     long long int expires)
+{
+    if (timer_wheel_node_is_scheduled(node)) {
+        timer_wheel_remove__(tw, node);
+    } else {
+        tw->n_nodes++;
+    }
+    node->expires = expires;
+    timer_wheel_insert__(tw, node);
+}
+
+void
+timer_wheel_cancel(struct timer_wheel *tw, struct timer_wheel_node *node)
+{
+    if (timer_wheel_node_is_scheduled(node)) {
+        timer_wheel_remove__(tw, node);
+        tw->n_nodes--;
+    }
+}
+
+/* Moves the nodes of a slot of 'level' to the lower levels. */
+static void
+timer_wheel_cascade(struct timer_wheel *tw, int level, size_t slot)
+{
+    struct ovs_list nodes;
+
+    ovs_list_init(&nodes);
+    ovs_list_push_back_all(&nodes, &tw->slots[level][slot]);
+
+    struct timer_wheel_node *node;
+    LIST_FOR_EACH_POP (node, list_node, &nodes) {
+        tw->n_level_nodes[level]--;
+        timer_wheel_insert__(tw, node);
+    }
+}
+
+/* Returns the number of nodes that are in the slots of 'tw'. */
+static size_t
+timer_wheel_n_pending(const struct timer_wheel *tw)
+{
+    size_t n = 0;
+
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        n += tw->n_level_nodes[level];
+    }
+    return n;
+}
+
+/* Processes all the milliseconds up to 'now' included, moving the nodes
+ * that expired to the expired list. */
+static void
+timer_wheel_advance(struct timer_wheel *tw, long long int now)
+{
+    while (tw->now <= now) {
+        if (!timer_wheel_n_pending(tw)) {
+            /* Nothing left in the slots. */
+            tw->now = now + 1;
+            break;
+        }
+
+        long long int t = tw->now;
+        for (int level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+            if (t & (timer_wheel_span(level) - 1)) {
+                break;
+            }
+            timer_wheel_cascade(tw, level, timer_wheel_slot(t, level));
+        }
+
+        if (!tw->n_level_nodes[0]) {
+            /* Skip to the next cascade. */
+            tw->now = MIN(now, t | TIMER_WHEEL_SLOT_MASK) + 1;
+            continue;
+        }
+
+        struct ovs_list *slot = &tw->slots[0][timer_wheel_slot(t, 0)];
+        struct timer_wheel_node *node;
+        LIST_FOR_EACH (node, list_node, slot) {
+            node->level = -1;
+            tw->n_level_nodes[0]--;
+        }
+        ovs_list_push_back_all(&tw->expired, slot);
+        tw->now++;
+    }
+}
+
+/* Returns a node that expired at or before 'now' and unschedules it, or
+ * NULL if there is no such node.  Nodes are returned in expiration order,
+ * up to the millisecond. */
+struct timer_wheel_node *
+timer_wheel_pop(struct timer_wheel *tw, long long int now)
+{
+    if (ovs_list_is_empty(&tw->expired)) {
+        timer_wheel_advance(tw, now);
+        if (ovs_list_is_empty(&tw->expired)) {
+            return NULL;
+        }
+    }
+
+    struct timer_wheel_node *node =
+        CONTAINER_OF(ovs_list_pop_front(&tw->expired),
+                     struct timer_wheel_node, list_node);
+    ovs_list_init(&node->list_node);
+    tw->n_nodes--;
+    return node;
+}
+
+/* Returns the time at which timer_wheel_pop() should be called next, in
+ * milliseconds, or LLONG_MAX if no node is scheduled.  The returned time
+ * may be earlier than the actual expiration of the first node, when nodes
+ * have to be cascaded, but never later. */
+long long int
+timer_wheel_next_expiry(const struct timer_wheel *tw)
+{
+    if (!ovs_list_is_empty(&tw->expired)) {
+        return tw->now - 1;
+    }
+
+    long long int next = LLONG_MAX;
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        if (!tw->n_level_nodes[level]) {
+            continue;
+        }
+
+        /* Nodes of this level are moved when 'tw->now' reaches the first
+         * millisecond of their slot. */
+        long long int span = timer_wheel_span(level);
+        long long int t = ROUND_UP(tw->now, span);
+        for (size_t i = 0; i < TIMER_WHEEL_SLOTS; i++, t += span) {
+            const struct ovs_list *slot =
+                &tw->slots[level][timer_wheel_slot(t, level)];
+            if (!ovs_list_is_empty(slot)) {
+                next = MIN(next, t);
+                break;
+            }
+        }
+    }
+    return next;
+}
@@ -0,0 +1,82 @@
+/* Copyright (c) 2026, Red Hat, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H 1
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "openvswitch/list.h"
+
+/* Hierarchical timer wheel.
+ *
+ * Schedules a large number of timers, with a millisecond resolution, so
+ * that finding the expired ones only touches the timers that are due and
+ * a few empty slots, instead of all the scheduled timers.
+ *
+ * The wheel has TIMER_WHEEL_LEVELS levels of TIMER_WHEEL_SLOTS slots each.
+ * A slot of level 'n' covers TIMER_WHEEL_SLOTS^n milliseconds.  Timers are
+ * added to the lowest level that covers their expiration time and moved
+ * ("cascaded") to the lower levels as the time advances.  Timers expiring
+ * further than the range of the wheel (about 4.6 hours) wait in the last
+ * slot of the highest level until they get in range.
+ *
+ * The wheel doesn't own the nodes and isn't thread-safe. */
+
+#define TIMER_WHEEL_LEVEL_BITS 6
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_LEVEL_BITS)
+#define TIMER_WHEEL_LEVELS 4
+
+struct timer_wheel_node {
+    struct ovs_list list_node;  /* In a slot or in the expired list. */
+    long long int expires;      /* Expiration time, in milliseconds. */
+    int level;                  /* Level of the slot, -1 if expired. */
+};
+
+struct timer_wheel {
+    struct ovs_list slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+    size_t n_level_nodes[TIMER_WHEEL_LEVELS];
+    struct ovs_list expired;    /* Expired nodes, not yet popped. */
+    long long int now;          /* Next millisecond to process. */
+    size_t n_nodes;
+};
+
+void timer_wheel_init(struct timer_wheel *, long long int now);
+void timer_wheel_destroy(struct timer_wheel *);
+
+void timer_wheel_node_init(struct timer_wheel_node *);
+bool timer_wheel_node_is_scheduled(const struct timer_wheel_node *);
+
+void timer_wheel_schedule(struct timer_wheel *, struct timer_wheel_node *,
+                          long long int expires);
+void timer_wheel_cancel(struct timer_wheel *, struct timer_wheel_node *);
+
+struct timer_wheel_node *timer_wheel_pop(struct timer_wheel *,
+                                         long long int now);
+long long int timer_wheel_next_expiry(const struct timer_wheel *);
+
+static inline size_t
+timer_wheel_count(const struct timer_wheel *tw)
+{
+    return tw->n_nodes;
+}
+
+static inline bool
+timer_wheel_is_empty(const struct timer_wheel *tw)
+{
+    return !tw->n_nodes;
+}
+
+#endif /* lib/timer-wheel.h */
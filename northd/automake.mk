@@ -60,10 +60,18 @@ northd_ovn_northd_SOURCES = \
 	northd/inc-proc-northd.h \
 	northd/ipam.c \
 	northd/ipam.h \
+	northd/lflow-build-profile.c \
+	northd/lflow-build-profile.h \
 	northd/lflow-mgr.c \
 	northd/lflow-mgr.h \
 	northd/lb.c \
-	northd/lb.h
+	northd/lb.h \
+	northd/nb-cfg-latency.c \
+	northd/nb-cfg-latency.h \
+	northd/northd-bench.c \
+	northd/northd-bench.h \
+	lib/bench-ovsdb.c \
+	lib/bench-ovsdb.h
 northd_ovn_northd_LDADD = \
 	lib/libovn.la \
 	$(OVSDB_LIBDIR)/libovsdb.la \
@@ -29,6 +29,8 @@ VLOG_DEFINE_THIS_MODULE(en_group_ecmp_route);
 
 static void
 unique_routes_destroy(struct hmap *unique_routes);
+static void
+unique_routes_node_free(struct unique_routes_node *ur);
 
 static void
 ecmp_groups_node_free(struct ecmp_groups_node *eg)
@@ -71,12 +73,18 @@ group_ecmp_route_clear_tracked(struct group_ecmp_route_data *data)
 {
     data->tracked = false;
     hmapx_clear(&data->trk_data.crupdated_datapath_routes);
+    hmapx_clear(&data->trk_data.crupdated_unique_routes);
 
     struct hmapx_node *hmapx_node;
     HMAPX_FOR_EACH (hmapx_node, &data->trk_data.deleted_datapath_routes) {
         group_node_free(hmapx_node->data);
     }
     hmapx_clear(&data->trk_data.deleted_datapath_routes);
+
+    HMAPX_FOR_EACH (hmapx_node, &data->trk_data.deleted_unique_routes) {
+        unique_routes_node_free(hmapx_node->data);
+    }
+    hmapx_clear(&data->trk_data.deleted_unique_routes);
 }
 
 static void
@@ -95,6 +103,8 @@ group_ecmp_route_init(struct group_ecmp_route_data *data)
     hmap_init(&data->datapaths);
     hmapx_init(&data->trk_data.crupdated_datapath_routes);
     hmapx_init(&data->trk_data.deleted_datapath_routes);
+    hmapx_init(&data->trk_data.crupdated_unique_routes);
+    hmapx_init(&data->trk_data.deleted_unique_routes);
 }
 
 void *en_group_ecmp_route_init(struct engine_node *node OVS_UNUSED,
@@ -112,6 +122,8 @@ void en_group_ecmp_route_cleanup(void *_data)
     hmap_destroy(&data->datapaths);
     hmapx_destroy(&data->trk_data.crupdated_datapath_routes);
     hmapx_destroy(&data->trk_data.deleted_datapath_routes);
+    hmapx_destroy(&data->trk_data.crupdated_unique_routes);
+    hmapx_destroy(&data->trk_data.deleted_unique_routes);
 }
 
 void
@@ -161,12 +173,25 @@ group_ecmp_datapath_lookup_or_add(struct group_ecmp_route_data *data,
 }
 
 static void
-unique_routes_add(struct group_ecmp_datapath *gn,
+unique_routes_add(struct group_ecmp_route_data *data,
+                  struct group_ecmp_datapath *gn,
                   const struct parsed_route *route)
 {
     struct unique_routes_node *ur = xmalloc(sizeof *ur);
     ur->route = route;
+    ur->lflow_ref = lflow_ref_create();
     hmap_insert(&gn->unique_routes, &ur->hmap_node, route->hash);
+
+    if (data->tracked) {
+        hmapx_add(&data->trk_data.crupdated_unique_routes, ur);
+    }
+}
+
+static void
+unique_routes_node_free(struct unique_routes_node *ur)
+{
+    lflow_ref_destroy(ur->lflow_ref);
+    free(ur);
 }
 
 static void
@@ -175,16 +200,14 @@ unique_routes_destroy(struct hmap *unique_routes)
     struct unique_routes_node *ur;
     HMAP_FOR_EACH_SAFE (ur, hmap_node, unique_routes) {
         hmap_remove(unique_routes, &ur->hmap_node);
-        free(ur);
+        unique_routes_node_free(ur);
     }
     hmap_destroy(unique_routes);
 }
 
-/* Remove the unique_routes_node from the group, and return the parsed_route
- * pointed by the removed node. */
-static const struct parsed_route *
-unique_routes_remove(struct group_ecmp_datapath *gn,
-                     const struct parsed_route *route)
+static struct unique_routes_node *
+unique_routes_find(const struct group_ecmp_datapath *gn,
+                   const struct parsed_route *route)
 {
     struct unique_routes_node *ur;
     HMAP_FOR_EACH_WITH_HASH (ur, hmap_node, route->hash, &gn->unique_routes) {
@@ -193,15 +216,37 @@ unique_routes_remove(struct group_ecmp_datapath *gn,
             route->is_src_route == ur->route->is_src_route &&
             route->source == ur->route->source &&
             route->route_table_id == ur->route->route_table_id) {
-            hmap_remove(&gn->unique_routes, &ur->hmap_node);
-            const struct parsed_route *existed_route = ur->route;
-            free(ur);
-            return existed_route;
+            return ur;
         }
     }
     return NULL;
 }
 
+/* Remove the unique_routes_node from the group, and return the parsed_route
+ * pointed by the removed node.  If 'data' is tracked the removed node is
+ * kept in the tracked data until its logical flows are cleared, unless it
+ * was only added during the same run. */
+static const struct parsed_route *
+unique_routes_remove(struct group_ecmp_route_data *data,
+                     struct group_ecmp_datapath *gn,
+                     const struct parsed_route *route)
+{
+    struct unique_routes_node *ur = unique_routes_find(gn, route);
+    if (!ur) {
+        return NULL;
+    }
+
+    hmap_remove(&gn->unique_routes, &ur->hmap_node);
+    const struct parsed_route *existed_route = ur->route;
+    if (data->tracked &&
+        !hmapx_find_and_delete(&data->trk_data.crupdated_unique_routes, ur)) {
+        hmapx_add(&data->trk_data.deleted_unique_routes, ur);
+    } else {
+        unique_routes_node_free(ur);
+    }
+    return existed_route;
+}
+
 static void
 ecmp_groups_add_route(struct ecmp_groups_node *group,
                       const struct parsed_route *route)
@@ -314,12 +359,15 @@ ecmp_group_has_symmetric_reply(struct ecmp_groups_node *eg)
     return false;
 }
 
-static void
-add_route(struct group_ecmp_datapath *gn, const struct parsed_route *pr)
+/* Adds 'pr' to 'gn'.  Returns true if the ecmp groups of 'gn' changed,
+ * false if the route was added as a unique route. */
+static bool
+add_route(struct group_ecmp_route_data *data, struct group_ecmp_datapath *gn,
+          const struct parsed_route *pr)
 {
     if (pr->source == ROUTE_SOURCE_CONNECTED) {
-        unique_routes_add(gn, pr);
-        return;
+        unique_routes_add(data, gn, pr);
+        return false;
     }
 
     struct ecmp_groups_node *group = ecmp_groups_find(gn, pr);
@@ -327,7 +375,7 @@ add_route(struct group_ecmp_datapath *gn, const struct parsed_route *pr)
         ecmp_groups_add_route(group, pr);
     } else {
         const struct parsed_route *existed_route =
-            unique_routes_remove(gn, pr);
+            unique_routes_remove(data, gn, pr);
         if (existed_route) {
             group = ecmp_groups_add(gn, existed_route);
             if (group) {
@@ -339,9 +387,11 @@ add_route(struct group_ecmp_datapath *gn, const struct parsed_route *pr)
              * is added later. */
             ecmp_groups_add(gn, pr);
         } else {
-            unique_routes_add(gn, pr);
+            unique_routes_add(data, gn, pr);
+            return false;
         }
     }
+    return true;
 }
 
 static void
@@ -353,12 +403,12 @@ group_ecmp_route(struct group_ecmp_route_data *data,
     const struct parsed_route *pr;
     HMAP_FOR_EACH (pr, key_node, &routes_data->parsed_routes) {
         gn = group_ecmp_datapath_lookup_or_add(data, pr->od);
-        add_route(gn, pr);
+        add_route(data, gn, pr);
     }
 
     HMAP_FOR_EACH (pr, key_node, &learned_route_data->parsed_routes) {
         gn = group_ecmp_datapath_lookup_or_add(data, pr->od);
-        add_route(gn, pr);
+        add_route(data, gn, pr);
     }
 }
 
@@ -378,10 +428,13 @@ en_group_ecmp_route_run(struct engine_node *node, void *_data)
     return EN_UPDATED;
 }
 
+/* Adds 'pr' to its datapath node.  The node is added to 'updated_routes'
+ * and, if its ecmp groups changed, to 'updated_ecmp'. */
 static void
 handle_added_route(struct group_ecmp_route_data *data,
                    const struct parsed_route *pr,
-                   struct hmapx *updated_routes)
+                   struct hmapx *updated_routes,
+                   struct hmapx *updated_ecmp)
 {
     struct group_ecmp_datapath *node = group_ecmp_datapath_lookup(data,
                                                                   pr->od);
@@ -391,13 +444,16 @@ handle_added_route(struct group_ecmp_route_data *data,
     }
 
     hmapx_add(updated_routes, node);
-    add_route(node, pr);
+    if (add_route(data, node, pr)) {
+        hmapx_add(updated_ecmp, node);
+    }
 }
 
 static bool
 handle_deleted_route(struct group_ecmp_route_data *data,
                      const struct parsed_route *pr,
-                     struct hmapx *updated_routes)
+                     struct hmapx *updated_routes,
+                     struct hmapx *updated_ecmp)
 {
     struct group_ecmp_datapath *node = group_ecmp_datapath_lookup(data,
                                                                   pr->od);
@@ -406,7 +462,8 @@ handle_deleted_route(struct group_ecmp_route_data *data,
         return false;
     }
 
-    const struct parsed_route *existing = unique_routes_remove(node, pr);
+    const struct parsed_route *existing = unique_routes_remove(data, node,
+                                                               pr);
     if (!existing) {
         /* The route must be part of an ecmp group. */
         if (pr->source == ROUTE_SOURCE_CONNECTED) {
@@ -438,7 +495,7 @@ handle_deleted_route(struct group_ecmp_route_data *data,
             } else {
                 const struct ecmp_route_list_node *er =
                     vector_get_ptr(&eg->route_list, 0);
-                unique_routes_add(node, er->route);
+                unique_routes_add(data, node, er->route);
                 hmap_remove(&node->ecmp_groups, &eg->hmap_node);
                 ecmp_groups_node_free(eg);
             }
@@ -449,12 +506,47 @@ handle_deleted_route(struct group_ecmp_route_data *data,
             ecmp_groups_remove_route(eg, pr);
             ecmp_group_update_ids(eg);
         }
+        hmapx_add(updated_ecmp, node);
     }
 
     hmapx_add(updated_routes, node);
     return true;
 }
 
+/* Moves the datapath nodes in 'updated_routes' to the tracked data.  Nodes
+ * without any route left are removed, the others are only tracked if their
+ * ecmp groups changed, i.e. if they are part of 'updated_ecmp'. */
+static void
+group_ecmp_route_track_datapaths(struct group_ecmp_route_data *data,
+                                 const struct hmapx *updated_routes,
+                                 const struct hmapx *updated_ecmp)
+{
+    const struct hmapx_node *hmapx_node;
+    HMAPX_FOR_EACH (hmapx_node, updated_routes) {
+        struct group_ecmp_datapath *node = hmapx_node->data;
+        if (hmap_is_empty(&node->unique_routes) &&
+                hmap_is_empty(&node->ecmp_groups)) {
+            hmapx_add(&data->trk_data.deleted_datapath_routes, node);
+            hmap_remove(&data->datapaths, &node->hmap_node);
+        } else if (hmapx_contains(updated_ecmp, node)) {
+            hmapx_add(&data->trk_data.crupdated_datapath_routes, node);
+        }
+    }
+}
+
+static enum engine_input_handler_result
+group_ecmp_route_tracked_result(const struct group_ecmp_route_data *data)
+{
+    const struct group_ecmp_route_tracked_data *trk_data = &data->trk_data;
+    if (!(hmapx_is_empty(&trk_data->crupdated_datapath_routes) &&
+          hmapx_is_empty(&trk_data->deleted_datapath_routes) &&
+          hmapx_is_empty(&trk_data->crupdated_unique_routes) &&
+          hmapx_is_empty(&trk_data->deleted_unique_routes))) {
+        return EN_HANDLED_UPDATED;
+    }
+    return EN_HANDLED_UNCHANGED;
+}
+
 enum engine_input_handler_result
 group_ecmp_route_learned_route_change_handler(struct engine_node *eng_node,
                                               void *_data)
@@ -471,14 +563,17 @@ group_ecmp_route_learned_route_change_handler(struct engine_node *eng_node,
     data->tracked = true;
 
     struct hmapx updated_routes = HMAPX_INITIALIZER(&updated_routes);
+    struct hmapx updated_ecmp = HMAPX_INITIALIZER(&updated_ecmp);
 
     const struct hmapx_node *hmapx_node;
     const struct parsed_route *pr;
     HMAPX_FOR_EACH (hmapx_node,
                     &learned_route_data->trk_data.trk_deleted_parsed_route) {
         pr = hmapx_node->data;
-        if (!handle_deleted_route(data, pr, &updated_routes)) {
+        if (!handle_deleted_route(data, pr, &updated_routes,
+                                  &updated_ecmp)) {
             hmapx_destroy(&updated_routes);
+            hmapx_destroy(&updated_ecmp);
             return EN_UNHANDLED;
         }
     }
@@ -486,27 +581,69 @@ group_ecmp_route_learned_route_change_handler(struct engine_node *eng_node,
     HMAPX_FOR_EACH (hmapx_node,
                     &learned_route_data->trk_data.trk_created_parsed_route) {
         pr = hmapx_node->data;
-        handle_added_route(data, pr, &updated_routes);
+        handle_added_route(data, pr, &updated_routes, &updated_ecmp);
     }
 
     /* Now we need to group the route_nodes based on if there are any routes
      * left. */
-    HMAPX_FOR_EACH (hmapx_node, &updated_routes) {
-        struct group_ecmp_datapath *node = hmapx_node->data;
-        if (hmap_is_empty(&node->unique_routes) &&
-                hmap_is_empty(&node->ecmp_groups)) {
-            hmapx_add(&data->trk_data.deleted_datapath_routes, node);
-            hmap_remove(&data->datapaths, &node->hmap_node);
-        } else {
-            hmapx_add(&data->trk_data.crupdated_datapath_routes, node);
+    group_ecmp_route_track_datapaths(data, &updated_routes, &updated_ecmp);
+
+    hmapx_destroy(&updated_routes);
+    hmapx_destroy(&updated_ecmp);
+
+    return group_ecmp_route_tracked_result(data);
+}
+
+enum engine_input_handler_result
+group_ecmp_route_routes_change_handler(struct engine_node *eng_node,
+                                       void *_data)
+{
+    struct group_ecmp_route_data *data = _data;
+    struct routes_data *routes_data
+        = engine_get_input_data("routes", eng_node);
+
+    if (!routes_data->tracked) {
+        data->tracked = false;
+        return EN_UNHANDLED;
+    }
+
+    data->tracked = true;
+
+    struct hmapx updated_routes = HMAPX_INITIALIZER(&updated_routes);
+    struct hmapx updated_ecmp = HMAPX_INITIALIZER(&updated_ecmp);
+
+    const struct hmapx_node *hmapx_node;
+    const struct parsed_route *pr;
+    HMAPX_FOR_EACH (hmapx_node,
+                    &routes_data->trk_data.trk_deleted_parsed_route) {
+        pr = hmapx_node->data;
+        if (!handle_deleted_route(data, pr, &updated_routes,
+                                  &updated_ecmp)) {
+            hmapx_destroy(&updated_routes);
+            hmapx_destroy(&updated_ecmp);
+            return EN_UNHANDLED;
         }
     }
 
-    hmapx_destroy(&updated_routes);
+    HMAPX_FOR_EACH (hmapx_node,
+                    &routes_data->trk_data.trk_created_parsed_route) {
+        pr = hmapx_node->data;
+        handle_added_route(data, pr, &updated_routes, &updated_ecmp);
+    }
 
-    if (!(hmapx_is_empty(&data->trk_data.crupdated_datapath_routes) &&
-          hmapx_is_empty(&data->trk_data.deleted_datapath_routes))) {
-        return EN_HANDLED_UPDATED;
+    /* The ids of the ecmp groups depend on their insertion order, so static
+     * routes that create, change or remove an ecmp group are handled by a
+     * recompute. */
+    if (!hmapx_is_empty(&updated_ecmp)) {
+        hmapx_destroy(&updated_routes);
+        hmapx_destroy(&updated_ecmp);
+        return EN_UNHANDLED;
     }
-    return EN_HANDLED_UNCHANGED;
+
+    group_ecmp_route_track_datapaths(data, &updated_routes, &updated_ecmp);
+
+    hmapx_destroy(&updated_routes);
+    hmapx_destroy(&updated_ecmp);
+
+    return group_ecmp_route_tracked_result(data);
 }
@@ -44,6 +44,9 @@ struct ecmp_groups_node {
 struct unique_routes_node {
     struct hmap_node hmap_node;
     const struct parsed_route *route;
+
+    /* The lflow ref for the logical flows of this route. */
+    struct lflow_ref *lflow_ref;
 };
 
 /* Each 'group_ecmp_datapath' represents all routes relevant for that single
@@ -54,7 +57,8 @@ struct group_ecmp_datapath {
     /* The datapath for which this node is relevant. */
     const struct ovn_datapath *od;
 
-    /* The lflow ref for all routes of this datapath. */
+    /* The lflow ref for all ecmp groups of this datapath.  Routes in
+     * 'unique_routes' have their own lflow ref. */
     struct lflow_ref *lflow_ref;
 
     /* Contains all routes that are part of an ecmp group.
@@ -68,13 +72,21 @@ struct group_ecmp_datapath {
 
 struct group_ecmp_route_tracked_data {
     /* Contains references to group_ecmp_route_node. Each of the referenced
-     * datapaths contains at least one route. */
+     * datapaths contains at least one route and its ecmp groups have
+     * changed. */
     struct hmapx crupdated_datapath_routes;
 
     /* Contains references to group_ecmp_route_node. Each of the referenced
      * datapath previously had some routes. The datapath now no longer
      * contains any route.*/
     struct hmapx deleted_datapath_routes;
+
+    /* Contains references to unique_routes_node added to a datapath. */
+    struct hmapx crupdated_unique_routes;
+
+    /* Contains references to unique_routes_node removed from a datapath.
+     * They are freed when the tracked data is cleared. */
+    struct hmapx deleted_unique_routes;
 };
 
 struct group_ecmp_route_data {
@@ -96,6 +108,8 @@ enum engine_node_state en_group_ecmp_route_run(struct engine_node *,
 enum engine_input_handler_result
 group_ecmp_route_learned_route_change_handler(struct engine_node *,
                                               void *data);
+enum engine_input_handler_result
+group_ecmp_route_routes_change_handler(struct engine_node *, void *data);
 
 struct group_ecmp_datapath *group_ecmp_datapath_lookup(
     const struct group_ecmp_route_data *data,
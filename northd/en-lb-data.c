@@ -20,6 +20,7 @@
 
 /* OVS includes */
 #include "include/openvswitch/hmap.h"
+#include "openvswitch/shash.h"
 #include "openvswitch/util.h"
 #include "openvswitch/vlog.h"
 
@@ -75,6 +76,13 @@ static struct crupdated_lbgrp *
                                            struct tracked_lb_data *);
 static void add_deleted_lbgrp_to_tracked_data(
     struct ovn_lb_group *, struct tracked_lb_data *);
+static bool is_lb_update_backends_only(const struct nbrec_load_balancer *,
+                                       const struct ovn_northd_lb *);
+static void lb_vips_backends_get(const struct ovn_northd_lb *,
+                                 struct shash *vips_backends);
+static bool lb_vips_backends_diff(const struct ovn_northd_lb *,
+                                  struct shash *old_vips_backends,
+                                  struct sset *updated_vips);
 static bool is_ls_lbs_changed(const struct nbrec_logical_switch *nbs,
                               bool is_new);
 static bool is_ls_lbgrps_changed(const struct nbrec_logical_switch *nbs,
@@ -192,10 +200,26 @@ lb_data_load_balancer_handler(struct engine_node *node, void *data)
             enum lb_neighbor_responder_mode neigh_mode = lb->neigh_mode;
             bool routable = lb->routable;
             bool distributed_mode = lb->is_distributed;
+
+            /* Remember the backends of each VIP so that an update which
+             * only touches the backends can be handled per VIP. */
+            struct shash old_vips_backends =
+                SHASH_INITIALIZER(&old_vips_backends);
+            bool backends_only = is_lb_update_backends_only(tracked_lb, lb);
+            if (backends_only) {
+                lb_vips_backends_get(lb, &old_vips_backends);
+            }
+
             ovn_northd_lb_reinit(lb, tracked_lb);
             health_checks |= lb->health_checks;
             struct crupdated_lb *clb = add_crupdated_lb_to_tracked_data(
                 lb, trk_lb_data, health_checks);
+            if (backends_only && !lb->health_checks) {
+                clb->backends_only =
+                    lb_vips_backends_diff(lb, &old_vips_backends,
+                                          &clb->updated_vips);
+            }
+            shash_destroy_free_data(&old_vips_backends);
             trk_lb_data->has_routable_lb |= lb->routable;
             trk_lb_data->has_distributed_lb |= lb->is_distributed;
 
@@ -775,6 +799,7 @@ destroy_tracked_data(struct ed_type_lb_data *lb_data)
         sset_destroy(&clb->inserted_vips_v6);
         sset_destroy(&clb->deleted_vips_v4);
         sset_destroy(&clb->deleted_vips_v6);
+        sset_destroy(&clb->updated_vips);
         free(clb);
     }
 
@@ -821,6 +846,7 @@ add_crupdated_lb_to_tracked_data(struct ovn_northd_lb *lb,
     sset_init(&clb->inserted_vips_v6);
     sset_init(&clb->deleted_vips_v4);
     sset_init(&clb->deleted_vips_v6);
+    sset_init(&clb->updated_vips);
     if (health_checks) {
         tracked_lb_data->has_health_checks = true;
     }
@@ -858,6 +884,85 @@ add_deleted_lbgrp_to_tracked_data(struct ovn_lb_group *lbg,
     hmapx_add(&tracked_lb_data->deleted_lbgrps, lbg);
 }
 
+/* Returns true if the update of 'nbrec_lb' can only have changed the
+ * backends of the VIPs of 'lb', i.e., none of the columns affecting the
+ * load balancer as a whole was updated and the load balancer doesn't use
+ * health checks or distributed mode, which derive state from the backends
+ * outside of the per VIP logical flows. */
+static bool
+is_lb_update_backends_only(const struct nbrec_load_balancer *nbrec_lb,
+                           const struct ovn_northd_lb *lb)
+{
+    if (lb->health_checks || lb->is_distributed) {
+        return false;
+    }
+
+    return !nbrec_load_balancer_is_updated(nbrec_lb,
+                                           NBREC_LOAD_BALANCER_COL_PROTOCOL)
+        && !nbrec_load_balancer_is_updated(nbrec_lb,
+                                       NBREC_LOAD_BALANCER_COL_HEALTH_CHECK)
+        && !nbrec_load_balancer_is_updated(nbrec_lb,
+                                   NBREC_LOAD_BALANCER_COL_IP_PORT_MAPPINGS)
+        && !nbrec_load_balancer_is_updated(nbrec_lb,
+                                   NBREC_LOAD_BALANCER_COL_SELECTION_FIELDS)
+        && !nbrec_load_balancer_is_updated(nbrec_lb,
+                                           NBREC_LOAD_BALANCER_COL_OPTIONS);
+}
+
+/* Fills 'vips_backends' with the backends of each VIP of 'lb', keyed by the
+ * VIP key. */
+static void
+lb_vips_backends_get(const struct ovn_northd_lb *lb,
+                     struct shash *vips_backends)
+{
+    for (size_t i = 0; i < lb->n_vips; i++) {
+        char *vip_key = ovn_northd_lb_vip_key(lb, &lb->vips[i]);
+        if (shash_find(vips_backends, vip_key)) {
+            /* Ambiguous VIP key, fall back to processing all VIPs. */
+            shash_destroy_free_data(vips_backends);
+            shash_init(vips_backends);
+            free(vip_key);
+            return;
+        }
+        shash_add_nocopy(vips_backends, vip_key,
+                         xstrdup(lb->vips_nb[i].backend_ips));
+    }
+}
+
+/* Compares the VIPs of 'lb' with 'old_vips_backends', which is consumed.
+ * Returns true if the set of VIPs didn't change, in which case the keys of
+ * the VIPs whose backends changed are added to 'updated_vips'.  Returns
+ * false if any VIP was added or removed. */
+static bool
+lb_vips_backends_diff(const struct ovn_northd_lb *lb,
+                      struct shash *old_vips_backends,
+                      struct sset *updated_vips)
+{
+    if (shash_count(old_vips_backends) != lb->n_vips) {
+        return false;
+    }
+
+    for (size_t i = 0; i < lb->n_vips; i++) {
+        char *vip_key = ovn_northd_lb_vip_key(lb, &lb->vips[i]);
+        char *old_backends = shash_find_and_delete(old_vips_backends,
+                                                   vip_key);
+        if (!old_backends) {
+            free(vip_key);
+            sset_clear(updated_vips);
+            return false;
+        }
+
+        if (strcmp(old_backends, lb->vips_nb[i].backend_ips)) {
+            sset_add_and_free(updated_vips, vip_key);
+        } else {
+            free(vip_key);
+        }
+        free(old_backends);
+    }
+
+    return true;
+}
+
 static bool
 is_ls_lbs_changed(const struct nbrec_logical_switch *nbs, bool is_new) {
     return ((is_new && nbs->n_load_balancer)
@@ -22,6 +22,12 @@ struct crupdated_lb {
     struct sset inserted_vips_v6;
     struct sset deleted_vips_v4;
     struct sset deleted_vips_v6;
+
+    /* Set if the update only changed the backends of some of the existing
+     * VIPs of the load balancer.  In that case 'updated_vips' holds the keys
+     * (see ovn_northd_lb_vip_key()) of these VIPs. */
+    bool backends_only;
+    struct sset updated_vips;
 };
 
 struct crupdated_lbgrp {
@@ -297,6 +297,45 @@ lflow_multicast_igmp_handler(struct engine_node *node, void *data)
     return EN_HANDLED_UPDATED;
 }
 
+enum engine_input_handler_result
+lflow_route_policies_handler(struct engine_node *node, void *data)
+{
+    struct route_policies_data *route_policies_data =
+        engine_get_input_data("route_policies", node);
+
+    /* If we do not have tracked data we need to recompute. */
+    if (!route_policies_data->tracked) {
+        return EN_UNHANDLED;
+    }
+
+    const struct engine_context *eng_ctx = engine_get_context();
+    struct lflow_data *lflow_data = data;
+    struct lflow_input lflow_input;
+    lflow_get_input_data(node, &lflow_input);
+
+    if (!lflow_handle_route_policies_changes(eng_ctx->ovnsb_idl_txn,
+                                             &route_policies_data->trk_data,
+                                             &lflow_input,
+                                             lflow_data->lflow_table)) {
+        return EN_UNHANDLED;
+    }
+
+    return EN_HANDLED_UPDATED;
+}
+
+enum engine_input_handler_result
+lflow_routes_handler(struct engine_node *node, void *data OVS_UNUSED)
+{
+    struct routes_data *routes_data = engine_get_input_data("routes", node);
+
+    /* The logical flows of the parsed routes are built from the
+     * group_ecmp_route data, see lflow_group_ecmp_route_change_handler(). */
+    if (!routes_data->tracked) {
+        return EN_UNHANDLED;
+    }
+    return EN_HANDLED_UNCHANGED;
+}
+
 enum engine_input_handler_result
 lflow_group_ecmp_route_change_handler(struct engine_node *node,
                                       void *data OVS_UNUSED)
@@ -315,17 +354,30 @@ lflow_group_ecmp_route_change_handler(struct engine_node *node,
     struct lflow_input lflow_input;
     lflow_get_input_data(node, &lflow_input);
 
+    struct group_ecmp_route_tracked_data *trk_data =
+        &group_ecmp_route_data->trk_data;
     struct group_ecmp_datapath *route_node;
+    struct unique_routes_node *ur;
     struct hmapx_node *hmapx_node;
 
     /* We need to handle deletions before additions as they could potentially
      * overlap. */
-    HMAPX_FOR_EACH (hmapx_node,
-                    &group_ecmp_route_data->trk_data.deleted_datapath_routes) {
-        route_node = hmapx_node->data;
-        lflow_ref_unlink_lflows(route_node->lflow_ref);
+    HMAPX_FOR_EACH (hmapx_node, &trk_data->deleted_unique_routes) {
+        ur = hmapx_node->data;
+        bool handled = lflow_ref_resync_flows(
+            ur->lflow_ref, lflow_data->lflow_table,
+            eng_ctx->ovnsb_idl_txn, lflow_input.dps,
+            lflow_input.ovn_internal_version_changed,
+            lflow_input.sbrec_logical_flow_table,
+            lflow_input.sbrec_logical_dp_group_table);
+        if (!handled) {
+            return EN_UNHANDLED;
+        }
+    }
 
-        bool handled = lflow_ref_sync_lflows(
+    HMAPX_FOR_EACH (hmapx_node, &trk_data->deleted_datapath_routes) {
+        route_node = hmapx_node->data;
+        bool handled = lflow_ref_resync_flows(
             route_node->lflow_ref, lflow_data->lflow_table,
             eng_ctx->ovnsb_idl_txn, lflow_input.dps,
             lflow_input.ovn_internal_version_changed,
@@ -336,15 +388,12 @@ lflow_group_ecmp_route_change_handler(struct engine_node *node,
         }
     }
 
-    /* Now we handle created or updated route nodes. */
-    struct hmapx *crupdated_datapath_routes =
-        &group_ecmp_route_data->trk_data.crupdated_datapath_routes;
-    HMAPX_FOR_EACH (hmapx_node, crupdated_datapath_routes) {
+    /* Now we handle the route nodes whose ecmp groups changed. */
+    HMAPX_FOR_EACH (hmapx_node, &trk_data->crupdated_datapath_routes) {
         route_node = hmapx_node->data;
         lflow_ref_unlink_lflows(route_node->lflow_ref);
-        build_route_data_flows_for_lrouter(
-            route_node->od, lflow_data->lflow_table,
-            route_node, lflow_input.bfd_ports);
+        build_ecmp_route_data_flows_for_lrouter(
+            route_node->od, lflow_data->lflow_table, route_node);
 
         bool handled = lflow_ref_sync_lflows(
             route_node->lflow_ref, lflow_data->lflow_table,
@@ -357,6 +406,23 @@ lflow_group_ecmp_route_change_handler(struct engine_node *node,
         }
     }
 
+    /* And finally the added unique routes. */
+    HMAPX_FOR_EACH (hmapx_node, &trk_data->crupdated_unique_routes) {
+        ur = hmapx_node->data;
+        build_unique_route_data_flows(lflow_data->lflow_table, ur,
+                                      lflow_input.bfd_ports);
+
+        bool handled = lflow_ref_sync_lflows(
+            ur->lflow_ref, lflow_data->lflow_table,
+            eng_ctx->ovnsb_idl_txn, lflow_input.dps,
+            lflow_input.ovn_internal_version_changed,
+            lflow_input.sbrec_logical_flow_table,
+            lflow_input.sbrec_logical_dp_group_table);
+        if (!handled) {
+            return EN_UNHANDLED;
+        }
+    }
+
     return EN_HANDLED_UPDATED;
 }
 
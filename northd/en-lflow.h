@@ -29,6 +29,10 @@ lflow_ls_arp_handler(struct engine_node *, void *);
 enum engine_input_handler_result
 lflow_multicast_igmp_handler(struct engine_node *node, void *data);
 enum engine_input_handler_result
+lflow_route_policies_handler(struct engine_node *node, void *data);
+enum engine_input_handler_result
+lflow_routes_handler(struct engine_node *node, void *data);
+enum engine_input_handler_result
 lflow_group_ecmp_route_change_handler(struct engine_node *node, void *data);
 enum engine_input_handler_result
 lflow_ic_learned_svc_mons_handler(struct engine_node *node, void *data);
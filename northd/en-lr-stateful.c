@@ -239,6 +239,12 @@ lr_stateful_lb_data_handler(struct engine_node *node, void *data_)
 
     const struct crupdated_lb *clb;
     HMAP_FOR_EACH (clb, hmap_node, &trk_lb_data->crupdated_lbs) {
+        if (clb->backends_only) {
+            /* Only the backends changed, the load balancer IPs tracked by
+             * the lr_stateful records are the same. */
+            continue;
+        }
+
         const struct uuid *lb_uuid = &clb->lb->nlb->header_.uuid;
         const struct ovn_northd_lb *lb = clb->lb;
 
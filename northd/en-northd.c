@@ -203,6 +203,8 @@ northd_nb_logical_router_handler(struct engine_node *node,
     }
 
     if (northd_has_lr_nats_in_tracked_data(&nd->trk_data) ||
+        northd_has_lr_routes_in_tracked_data(&nd->trk_data) ||
+        northd_has_lr_policies_in_tracked_data(&nd->trk_data) ||
         northd_has_lrouters_in_tracked_data(&nd->trk_data)) {
         return EN_HANDLED_UPDATED;
     }
@@ -273,8 +275,7 @@ northd_nb_port_group_handler(struct engine_node *node, void *data)
 
 
 enum engine_input_handler_result
-route_policies_northd_change_handler(struct engine_node *node,
-                                     void *data OVS_UNUSED)
+route_policies_northd_change_handler(struct engine_node *node, void *data)
 {
     struct northd_data *northd_data = engine_get_input_data("northd", node);
     if (!northd_has_tracked_data(&northd_data->trk_data)) {
@@ -293,11 +294,32 @@ route_policies_northd_change_handler(struct engine_node *node,
      *      logical router ports, we need to revisit this handler.
      *
      *      This node also accesses the route policies of the logical router.
-     *      When these route policies get updated, en_northd engine recomputes
-     *      and so does this node.
-     *      Note: When we add I-P to handle route policies changes, we need
-     *      to revisit this handler.
+     *      Added and deleted policies are handled incrementally, the routers
+     *      they belong to are tracked in 'trk_policy_lrs'.  Updated policies
+     *      and policies with chains, ecmp nexthops or BFD sessions are not
+     *      handled and this node recomputes.
      */
+    if (!northd_has_lr_policies_in_tracked_data(&northd_data->trk_data)) {
+        return EN_HANDLED_UNCHANGED;
+    }
+
+    struct route_policies_data *route_policies_data = data;
+    const struct nbrec_logical_router_policy_table *nb_policy_table =
+        EN_OVSDB_GET(engine_get_input("NB_logical_router_policy", node));
+    struct bfd_data *bfd_data = engine_get_input_data("bfd", node);
+
+    if (!route_policies_handle_changes(nb_policy_table,
+                                       &northd_data->trk_data.trk_policy_lrs,
+                                       &northd_data->lr_ports,
+                                       &bfd_data->bfd_connections,
+                                       route_policies_data)) {
+        return EN_UNHANDLED;
+    }
+
+    if (!hmapx_is_empty(&route_policies_data->trk_data.crupdated) ||
+        !hmapx_is_empty(&route_policies_data->trk_data.deleted)) {
+        return EN_HANDLED_UPDATED;
+    }
     return EN_HANDLED_UNCHANGED;
 }
 
@@ -324,8 +346,7 @@ en_route_policies_run(struct engine_node *node, void *data)
 }
 
 enum engine_input_handler_result
-routes_northd_change_handler(struct engine_node *node,
-                                    void *data OVS_UNUSED)
+routes_northd_change_handler(struct engine_node *node, void *data)
 {
     struct northd_data *northd_data = engine_get_input_data("northd", node);
     if (!northd_has_tracked_data(&northd_data->trk_data)) {
@@ -344,11 +365,32 @@ routes_northd_change_handler(struct engine_node *node,
      *      logical router ports, we need to revisit this handler.
      *
      *      This node also accesses the static routes of the logical router.
-     *      When these static routes gets updated, en_northd engine recomputes
-     *      and so does this node.
-     *      Note: When we add I-P to handle static routes changes, we need
-     *      to revisit this handler.
+     *      Added and deleted static routes are handled incrementally, the
+     *      routers they belong to are tracked in 'trk_route_lrs'.  Updated
+     *      routes and routes with a route table, BFD or an IPv6 nexthop are
+     *      not handled and this node recomputes.
      */
+    if (!northd_has_lr_routes_in_tracked_data(&northd_data->trk_data)) {
+        return EN_HANDLED_UNCHANGED;
+    }
+
+    struct routes_data *routes_data = data;
+    const struct nbrec_logical_router_static_route_table *nb_route_table =
+        EN_OVSDB_GET(engine_get_input("NB_logical_router_static_route",
+                                      node));
+    struct bfd_data *bfd_data = engine_get_input_data("bfd", node);
+
+    if (!routes_handle_static_route_changes(
+            nb_route_table, &northd_data->trk_data.trk_route_lrs,
+            &northd_data->lr_ports, &bfd_data->bfd_connections,
+            routes_data)) {
+        return EN_UNHANDLED;
+    }
+
+    if (!hmapx_is_empty(&routes_data->trk_data.trk_created_parsed_route) ||
+        !hmapx_is_empty(&routes_data->trk_data.trk_deleted_parsed_route)) {
+        return EN_HANDLED_UPDATED;
+    }
     return EN_HANDLED_UNCHANGED;
 }
 
@@ -417,6 +459,35 @@ bfd_sync_northd_change_handler(struct engine_node *node, void *data OVS_UNUSED)
     return EN_HANDLED_UNCHANGED;
 }
 
+enum engine_input_handler_result
+bfd_sync_routes_change_handler(struct engine_node *node,
+                               void *data OVS_UNUSED)
+{
+    struct routes_data *routes_data = engine_get_input_data("routes", node);
+
+    /* Static routes with BFD are never handled incrementally, so the
+     * BFD sessions used by the routes did not change. */
+    if (!routes_data->tracked) {
+        return EN_UNHANDLED;
+    }
+    return EN_HANDLED_UNCHANGED;
+}
+
+enum engine_input_handler_result
+bfd_sync_route_policies_change_handler(struct engine_node *node,
+                                       void *data OVS_UNUSED)
+{
+    struct route_policies_data *route_policies_data
+        = engine_get_input_data("route_policies", node);
+
+    /* Route policies with BFD sessions are never handled incrementally, so
+     * the BFD sessions used by the policies did not change. */
+    if (!route_policies_data->tracked) {
+        return EN_UNHANDLED;
+    }
+    return EN_HANDLED_UNCHANGED;
+}
+
 enum engine_node_state
 en_bfd_sync_run(struct engine_node *node, void *data)
 {
@@ -580,12 +651,24 @@ en_route_policies_cleanup(void *data)
     route_policies_destroy(data);
 }
 
+void
+en_route_policies_clear_tracked_data(void *data)
+{
+    route_policies_clear_tracked_data(data);
+}
+
 void
 en_routes_cleanup(void *data)
 {
     routes_destroy(data);
 }
 
+void
+en_routes_clear_tracked_data(void *data)
+{
+    routes_clear_tracked_data(data);
+}
+
 void
 en_bfd_cleanup(void *data)
 {
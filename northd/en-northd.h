@@ -32,16 +32,17 @@ northd_sb_fdb_change_handler(struct engine_node *node, void *data);
 void *en_routes_init(struct engine_node *node OVS_UNUSED,
                             struct engine_arg *arg OVS_UNUSED);
 void en_route_policies_cleanup(void *data);
+void en_route_policies_clear_tracked_data(void *data);
 enum engine_input_handler_result
-route_policies_northd_change_handler(struct engine_node *node,
-                                     void *data OVS_UNUSED);
+route_policies_northd_change_handler(struct engine_node *node, void *data);
 enum engine_node_state en_route_policies_run(struct engine_node *node,
                                              void *data);
 void *en_route_policies_init(struct engine_node *node OVS_UNUSED,
                              struct engine_arg *arg OVS_UNUSED);
 void en_routes_cleanup(void *data);
+void en_routes_clear_tracked_data(void *data);
 enum engine_input_handler_result
-routes_northd_change_handler(struct engine_node *node, void *data OVS_UNUSED);
+routes_northd_change_handler(struct engine_node *node, void *data);
 enum engine_node_state en_routes_run(struct engine_node *node, void *data);
 void *en_bfd_init(struct engine_node *node OVS_UNUSED,
                   struct engine_arg *arg OVS_UNUSED);
@@ -52,6 +53,12 @@ void *en_bfd_sync_init(struct engine_node *node OVS_UNUSED,
 enum engine_input_handler_result
 bfd_sync_northd_change_handler(struct engine_node *node,
                                void *data OVS_UNUSED);
+enum engine_input_handler_result
+bfd_sync_routes_change_handler(struct engine_node *node,
+                               void *data OVS_UNUSED);
+enum engine_input_handler_result
+bfd_sync_route_policies_change_handler(struct engine_node *node,
+                                       void *data OVS_UNUSED);
 enum engine_node_state en_bfd_sync_run(struct engine_node *node, void *data);
 void en_bfd_sync_cleanup(void *data OVS_UNUSED);
 void *en_ic_learned_svc_monitors_init(struct engine_node *node OVS_UNUSED,
@@ -67,6 +67,8 @@ static unixctl_cb_func chassis_features_list;
     NB_NODE(load_balancer_group) \
     NB_NODE(acl) \
     NB_NODE(logical_router) \
+    NB_NODE(logical_router_static_route) \
+    NB_NODE(logical_router_policy) \
     NB_NODE(mirror) \
     NB_NODE(mirror_rule) \
     NB_NODE(meter) \
@@ -177,8 +179,8 @@ static ENGINE_NODE(lr_nat, CLEAR_TRACKED_DATA);
 static ENGINE_NODE(lr_stateful, CLEAR_TRACKED_DATA);
 static ENGINE_NODE(ls_stateful, CLEAR_TRACKED_DATA);
 static ENGINE_NODE(ls_arp, CLEAR_TRACKED_DATA);
-static ENGINE_NODE(route_policies);
-static ENGINE_NODE(routes);
+static ENGINE_NODE(route_policies, CLEAR_TRACKED_DATA);
+static ENGINE_NODE(routes, CLEAR_TRACKED_DATA);
 static ENGINE_NODE(bfd);
 static ENGINE_NODE(bfd_sync, SB_WRITE);
 static ENGINE_NODE(ecmp_nexthop, SB_WRITE);
@@ -331,15 +333,27 @@ void inc_proc_northd_init(struct ovsdb_idl_loop *nb,
     engine_add_input(&en_route_policies, &en_bfd, NULL);
     engine_add_input(&en_route_policies, &en_northd,
                      route_policies_northd_change_handler);
+    /* No need for an explicit handler for policy changes.  They are
+     * reported by en_northd in 'trk_policy_lrs', we only need to access
+     * the tracked rows of the table. */
+    engine_add_input(&en_route_policies, &en_nb_logical_router_policy,
+                     engine_noop_handler);
 
     engine_add_input(&en_routes, &en_bfd, NULL);
     engine_add_input(&en_routes, &en_northd,
                      routes_northd_change_handler);
+    /* No need for an explicit handler for static route changes.  They are
+     * reported by en_northd in 'trk_route_lrs', we only need to access
+     * the tracked rows of the table. */
+    engine_add_input(&en_routes, &en_nb_logical_router_static_route,
+                     engine_noop_handler);
 
     engine_add_input(&en_bfd_sync, &en_bfd, NULL);
     engine_add_input(&en_bfd_sync, &en_nb_bfd, NULL);
-    engine_add_input(&en_bfd_sync, &en_routes, NULL);
-    engine_add_input(&en_bfd_sync, &en_route_policies, NULL);
+    engine_add_input(&en_bfd_sync, &en_routes,
+                     bfd_sync_routes_change_handler);
+    engine_add_input(&en_bfd_sync, &en_route_policies,
+                     bfd_sync_route_policies_change_handler);
     engine_add_input(&en_bfd_sync, &en_northd, bfd_sync_northd_change_handler);
 
     engine_add_input(&en_ecmp_nexthop, &en_global_config, NULL);
@@ -374,7 +388,8 @@ void inc_proc_northd_init(struct ovsdb_idl_loop *nb,
     engine_add_input(&en_learned_route_sync, &en_northd,
                      learned_route_sync_northd_change_handler);
 
-    engine_add_input(&en_group_ecmp_route, &en_routes, NULL);
+    engine_add_input(&en_group_ecmp_route, &en_routes,
+                     group_ecmp_route_routes_change_handler);
     engine_add_input(&en_group_ecmp_route, &en_learned_route_sync,
                      group_ecmp_route_learned_route_change_handler);
 
@@ -392,10 +407,15 @@ void inc_proc_northd_init(struct ovsdb_idl_loop *nb,
     engine_add_input(&en_lflow, &en_sb_multicast_group, NULL);
     engine_add_input(&en_lflow, &en_sb_logical_dp_group, NULL);
     engine_add_input(&en_lflow, &en_bfd_sync, NULL);
-    engine_add_input(&en_lflow, &en_route_policies, NULL);
-    engine_add_input(&en_lflow, &en_routes, NULL);
-    /* XXX: The incremental processing only supports changes to learned routes.
-     * All other changes trigger a full recompute. */
+    engine_add_input(&en_lflow, &en_route_policies,
+                     lflow_route_policies_handler);
+    /* The logical flows of static routes are generated from the
+     * en_group_ecmp_route data, so lflow_routes_handler only checks that
+     * the changes of en_routes were processed incrementally. */
+    engine_add_input(&en_lflow, &en_routes, lflow_routes_handler);
+    /* XXX: The incremental processing only supports addition and deletion of
+     * learned and static routes which are not part of an ecmp group.  All
+     * other changes trigger a full recompute. */
     engine_add_input(&en_lflow, &en_group_ecmp_route,
                      lflow_group_ecmp_route_change_handler);
     engine_add_input(&en_lflow, &en_global_config,
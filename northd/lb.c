@@ -18,6 +18,7 @@
 
 /* OVS includes */
 #include "lib/bitmap.h"
+#include "hash.h"
 #include "openvswitch/vlog.h"
 #include "socket-util.h"
 
@@ -551,6 +552,17 @@ ovn_northd_lb_reinit(struct ovn_northd_lb *lb,
     ovn_northd_lb_init(lb, nbrec_lb);
 }
 
+/* Returns the key identifying 'lb_vip' within 'lb', i.e., the VIP and, if
+ * set, the VIP port.  The caller must free the returned string. */
+char *
+ovn_northd_lb_vip_key(const struct ovn_northd_lb *lb,
+                      const struct ovn_lb_vip *lb_vip)
+{
+    struct ds key = DS_EMPTY_INITIALIZER;
+    ovn_lb_vip_format(lb_vip, &key, lb->template);
+    return ds_steal_cstr(&key);
+}
+
 static void
 ovn_lb_group_init(struct ovn_lb_group *lb_group,
                   const struct nbrec_load_balancer_group *nbrec_lb_group,
@@ -685,6 +697,7 @@ ovn_lb_datapaths_create(const struct ovn_northd_lb *lb, size_t n_ls_datapaths,
     dynamic_bitmap_alloc(&lb_dps->nb_ls_map, n_ls_datapaths);
     dynamic_bitmap_alloc(&lb_dps->nb_lr_map, n_lr_datapaths);
     lb_dps->lflow_ref = lflow_ref_create();
+    hmap_init(&lb_dps->vip_lflow_refs);
     hmapx_init(&lb_dps->ls_lb_with_stateless_mode);
     return lb_dps;
 }
@@ -695,10 +708,76 @@ ovn_lb_datapaths_destroy(struct ovn_lb_datapaths *lb_dps)
     dynamic_bitmap_free(&lb_dps->nb_lr_map);
     dynamic_bitmap_free(&lb_dps->nb_ls_map);
     lflow_ref_destroy(lb_dps->lflow_ref);
+    ovn_lb_datapaths_clear_vip_lflow_refs(lb_dps);
+    hmap_destroy(&lb_dps->vip_lflow_refs);
     hmapx_destroy(&lb_dps->ls_lb_with_stateless_mode);
     free(lb_dps);
 }
 
+static struct ovn_lb_vip_lflow_ref *
+ovn_lb_datapaths_find_vip_lflow_ref__(const struct ovn_lb_datapaths *lb_dps,
+                                      const char *vip_key, uint32_t hash)
+{
+    struct ovn_lb_vip_lflow_ref *vip_ref;
+    HMAP_FOR_EACH_WITH_HASH (vip_ref, hmap_node, hash,
+                             &lb_dps->vip_lflow_refs) {
+        if (!strcmp(vip_ref->vip_key, vip_key)) {
+            return vip_ref;
+        }
+    }
+    return NULL;
+}
+
+struct ovn_lb_vip_lflow_ref *
+ovn_lb_datapaths_find_vip_lflow_ref(const struct ovn_lb_datapaths *lb_dps,
+                                    const char *vip_key)
+{
+    return ovn_lb_datapaths_find_vip_lflow_ref__(lb_dps, vip_key,
+                                                 hash_string(vip_key, 0));
+}
+
+/* Returns the lflow_ref of the VIP 'lb_vip' of 'lb_dps', creating it if it
+ * doesn't exist yet. */
+struct lflow_ref *
+ovn_lb_datapaths_get_vip_lflow_ref(struct ovn_lb_datapaths *lb_dps,
+                                   const struct ovn_lb_vip *lb_vip)
+{
+    char *vip_key = ovn_northd_lb_vip_key(lb_dps->lb, lb_vip);
+    uint32_t hash = hash_string(vip_key, 0);
+
+    struct ovn_lb_vip_lflow_ref *vip_ref =
+        ovn_lb_datapaths_find_vip_lflow_ref__(lb_dps, vip_key, hash);
+    if (vip_ref) {
+        free(vip_key);
+        return vip_ref->lflow_ref;
+    }
+
+    vip_ref = xmalloc(sizeof *vip_ref);
+    vip_ref->vip_key = vip_key;
+    vip_ref->lflow_ref = lflow_ref_create();
+    hmap_insert(&lb_dps->vip_lflow_refs, &vip_ref->hmap_node, hash);
+    return vip_ref->lflow_ref;
+}
+
+void
+ovn_lb_datapaths_remove_vip_lflow_ref(struct ovn_lb_datapaths *lb_dps,
+                                      struct ovn_lb_vip_lflow_ref *vip_ref)
+{
+    hmap_remove(&lb_dps->vip_lflow_refs, &vip_ref->hmap_node);
+    lflow_ref_destroy(vip_ref->lflow_ref);
+    free(vip_ref->vip_key);
+    free(vip_ref);
+}
+
+void
+ovn_lb_datapaths_clear_vip_lflow_refs(struct ovn_lb_datapaths *lb_dps)
+{
+    struct ovn_lb_vip_lflow_ref *vip_ref;
+    HMAP_FOR_EACH_SAFE (vip_ref, hmap_node, &lb_dps->vip_lflow_refs) {
+        ovn_lb_datapaths_remove_vip_lflow_ref(lb_dps, vip_ref);
+    }
+}
+
 void
 ovn_lb_datapaths_add_lr(struct ovn_lb_datapaths *lb_dps, size_t n,
                         struct ovn_datapath **ods,
@@ -118,6 +118,8 @@ const struct smap *ovn_northd_lb_get_vips(const struct ovn_northd_lb *);
 void ovn_northd_lb_destroy(struct ovn_northd_lb *);
 void ovn_northd_lb_reinit(struct ovn_northd_lb *,
                           const struct nbrec_load_balancer *);
+char *ovn_northd_lb_vip_key(const struct ovn_northd_lb *,
+                            const struct ovn_lb_vip *);
 
 void build_lrouter_lb_ips(struct ovn_lb_ip_set *,
                           const struct ovn_northd_lb *);
@@ -187,6 +189,22 @@ struct ovn_lb_datapaths {
      * access ovn_lb_datapaths->lflow_ref at any given time.
      */
     struct lflow_ref *lflow_ref;
+
+    /* References of the lflows generated for each individual VIP of the
+     * load balancer, so that a change of the backends of a VIP only needs
+     * to regenerate the lflows of that VIP.  'lflow_ref' above references
+     * the lflows that don't depend on any specific VIP.
+     *
+     * hmap node is 'struct ovn_lb_vip_lflow_ref', hashed by the VIP key
+     * (see ovn_northd_lb_vip_key()).  The same ownership and thread safety
+     * rules as for 'lflow_ref' apply. */
+    struct hmap vip_lflow_refs;
+};
+
+struct ovn_lb_vip_lflow_ref {
+    struct hmap_node hmap_node;
+    char *vip_key;
+    struct lflow_ref *lflow_ref;
 };
 
 struct ovn_lb_datapaths *ovn_lb_datapaths_create(const struct ovn_northd_lb *,
@@ -196,6 +214,14 @@ struct ovn_lb_datapaths *ovn_lb_datapaths_find(const struct hmap *,
                                                const struct uuid *);
 void ovn_lb_datapaths_destroy(struct ovn_lb_datapaths *);
 
+struct lflow_ref *ovn_lb_datapaths_get_vip_lflow_ref(
+    struct ovn_lb_datapaths *, const struct ovn_lb_vip *);
+struct ovn_lb_vip_lflow_ref *ovn_lb_datapaths_find_vip_lflow_ref(
+    const struct ovn_lb_datapaths *, const char *vip_key);
+void ovn_lb_datapaths_remove_vip_lflow_ref(struct ovn_lb_datapaths *,
+                                           struct ovn_lb_vip_lflow_ref *);
+void ovn_lb_datapaths_clear_vip_lflow_refs(struct ovn_lb_datapaths *);
+
 void ovn_lb_datapaths_add_lr(struct ovn_lb_datapaths *, size_t n,
                              struct ovn_datapath **,
                              size_t n_lr_datapaths);
@@ -0,0 +1,380 @@
+/* Copyright (c) 2026, Red Hat, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include <string.h>
+#include <time.h>
+
+#include "lflow-build-profile.h"
+
+#include "hash.h"
+#include "openvswitch/dynamic-string.h"
+#include "openvswitch/hmap.h"
+#include "openvswitch/list.h"
+#include "openvswitch/vlog.h"
+#include "ovs-atomic.h"
+#include "ovs-thread.h"
+#include "util.h"
+
+VLOG_DEFINE_THIS_MODULE(lflow_build_profile);
+
+/* Logical flows accounted to a source location or to a build function. */
+struct lflow_build_profile_entry {
+    struct hmap_node hmap_node;
+    const char *where;          /* NULL for the entries of functions. */
+    const char *func;
+    uint64_t n_lflows;
+    uint64_t match_bytes;
+    uint64_t actions_bytes;
+    uint64_t build_nsec;        /* CPU time preparing the logical flows. */
+    uint64_t add_nsec;          /* CPU time in lflow_table_add_lflow(). */
+};
+
+/* Profile of a thread that added logical flows. */
+struct lflow_build_profile_thread {
+    struct ovs_list list_node;  /* In 'profile_threads'. */
+
+    /* Contains 'struct lflow_build_profile_entry', by 'where'.  Only
+     * updated by the thread, the mutex protects it from the readers. */
+    struct ovs_mutex mutex;
+    struct hmap entries OVS_GUARDED;
+
+    /* Pass and CPU time of the last logical flow added by the thread. */
+    unsigned int pass;
+    uint64_t last_nsec;
+};
+
+static atomic_bool profile_enabled = false;
+static bool profile_started;
+static atomic_count profile_pass = ATOMIC_COUNT_INIT(0);
+
+static struct ovs_mutex profile_threads_mutex = OVS_MUTEX_INITIALIZER;
+static struct ovs_list profile_threads OVS_GUARDED_BY(profile_threads_mutex)
+    = OVS_LIST_INITIALIZER(&profile_threads);
+
+DEFINE_STATIC_PER_THREAD_DATA(struct lflow_build_profile_thread *,
+                              profile_thread, NULL);
+
+static uint64_t
+thread_cpu_nsec(void)
+{
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts)) {
+        return 0;
+    }
+    return ts.tv_sec * UINT64_C(1000000000) + ts.tv_nsec;
+}
+
+static struct lflow_build_profile_thread *
+lflow_build_profile_thread_get(void)
+{
+    struct lflow_build_profile_thread **thread = profile_thread_get();
+
+    if (!*thread) {
+        struct lflow_build_profile_thread *t = xzalloc(sizeof *t);
+
+        ovs_mutex_init(&t->mutex);
+        hmap_init(&t->entries);
+        t->pass = UINT_MAX;
+
+        ovs_mutex_lock(&profile_threads_mutex);
+        ovs_list_push_back(&profile_threads, &t->list_node);
+        ovs_mutex_unlock(&profile_threads_mutex);
+        *thread = t;
+    }
+    return *thread;
+}
+
+static void
+lflow_build_profile_entries_clear(struct hmap *entries)
+{
+    struct lflow_build_profile_entry *e;
+    HMAP_FOR_EACH_POP (e, hmap_node, entries) {
+        free(e);
+    }
+}
+
+/* Discards the previous profile and starts a new one. */
+void
+lflow_build_profile_start(void)
+{
+    struct lflow_build_profile_thread *t;
+
+    ovs_mutex_lock(&profile_threads_mutex);
+    LIST_FOR_EACH (t, list_node, &profile_threads) {
+        ovs_mutex_lock(&t->mutex);
+        lflow_build_profile_entries_clear(&t->entries);
+        ovs_mutex_unlock(&t->mutex);
+    }
+    ovs_mutex_unlock(&profile_threads_mutex);
+
+    lflow_build_profile_new_pass();
+    atomic_store_relaxed(&profile_enabled, true);
+    profile_started = true;
+    VLOG_INFO("Started logical flow generation profiling.");
+}
+
+void
+lflow_build_profile_stop(void)
+{
+    if (!lflow_build_profile_is_enabled()) {
+        return;
+    }
+
+    atomic_store_relaxed(&profile_enabled, false);
+    VLOG_INFO("Stopped logical flow generation profiling.");
+}
+
+bool
+lflow_build_profile_is_enabled(void)
+{
+    bool enabled;
+
+    atomic_read_relaxed(&profile_enabled, &enabled);
+    return enabled;
+}
+
+void
+lflow_build_profile_destroy(void)
+{
+    struct lflow_build_profile_thread *t;
+
+    ovs_mutex_lock(&profile_threads_mutex);
+    LIST_FOR_EACH_POP (t, list_node, &profile_threads) {
+        ovs_mutex_lock(&t->mutex);
+        lflow_build_profile_entries_clear(&t->entries);
+        hmap_destroy(&t->entries);
+        ovs_mutex_unlock(&t->mutex);
+        ovs_mutex_destroy(&t->mutex);
+        free(t);
+    }
+    ovs_mutex_unlock(&profile_threads_mutex);
+
+    struct lflow_build_profile_thread **thread = profile_thread_get();
+    *thread = NULL;
+}
+
+/* Marks the end of a pass of logical flow generation, e.g., the table was
+ * cleared or synced to the SB.  The time until the next logical flow of
+ * each thread isn't accounted to the build functions. */
+void
+lflow_build_profile_new_pass(void)
+{
+    atomic_count_inc(&profile_pass);
+}
+
+/* Returns the CPU time of the thread to pass to lflow_build_profile_end()
+ * once the logical flow is added. */
+uint64_t
+lflow_build_profile_begin(void)
+{
+    return thread_cpu_nsec();
+}
+
+static struct lflow_build_profile_entry *
+lflow_build_profile_site_get(struct hmap *entries, const char *where,
+                             const char *func)
+{
+    struct lflow_build_profile_entry *e;
+    uint32_t hash = hash_pointer(where, 0);
+
+    HMAP_FOR_EACH_WITH_HASH (e, hmap_node, hash, entries) {
+        if (e->where == where) {
+            return e;
+        }
+    }
+
+    e = xzalloc(sizeof *e);
+    e->where = where;
+    e->func = func;
+    hmap_insert(entries, &e->hmap_node, hash);
+    return e;
+}
+
+static struct lflow_build_profile_entry *
+lflow_build_profile_func_get(struct hmap *entries, const char *func)
+{
+    struct lflow_build_profile_entry *e;
+    uint32_t hash = hash_string(func, 0);
+
+    HMAP_FOR_EACH_WITH_HASH (e, hmap_node, hash, entries) {
+        if (!strcmp(e->func, func)) {
+            return e;
+        }
+    }
+
+    e = xzalloc(sizeof *e);
+    e->func = func;
+    hmap_insert(entries, &e->hmap_node, hash);
+    return e;
+}
+
+/* Accounts a logical flow added at 'where' in 'func' with 'match' and
+ * 'actions', 'begin_nsec' must be the value returned by
+ * lflow_build_profile_begin() before adding it. */
+void
+lflow_build_profile_end(uint64_t begin_nsec, const char *where,
+                        const char *func, const char *match,
+                        const char *actions)
+{
+    struct lflow_build_profile_thread *t = lflow_build_profile_thread_get();
+    unsigned int pass = atomic_count_get(&profile_pass);
+    uint64_t end_nsec = thread_cpu_nsec();
+    uint64_t build_nsec = 0;
+
+    if (t->pass == pass && begin_nsec > t->last_nsec) {
+        build_nsec = begin_nsec - t->last_nsec;
+    }
+
+    ovs_mutex_lock(&t->mutex);
+    struct lflow_build_profile_entry *e =
+        lflow_build_profile_site_get(&t->entries,
+                                     where ? where : "unknown",
+                                     func ? func : "unknown");
+    e->n_lflows++;
+    e->match_bytes += match ? strlen(match) : 0;
+    e->actions_bytes += actions ? strlen(actions) : 0;
+    e->build_nsec += build_nsec;
+    e->add_nsec += end_nsec > begin_nsec ? end_nsec - begin_nsec : 0;
+    ovs_mutex_unlock(&t->mutex);
+
+    t->pass = pass;
+    t->last_nsec = end_nsec;
+}
+
+static void
+lflow_build_profile_entry_add(struct lflow_build_profile_entry *dst,
+                              const struct lflow_build_profile_entry *src)
+{
+    dst->n_lflows += src->n_lflows;
+    dst->match_bytes += src->match_bytes;
+    dst->actions_bytes += src->actions_bytes;
+    dst->build_nsec += src->build_nsec;
+    dst->add_nsec += src->add_nsec;
+}
+
+/* Sorts by decreasing CPU time, then by name. */
+static int
+lflow_build_profile_compare(const void *a_, const void *b_)
+{
+    const struct lflow_build_profile_entry *const *a = a_;
+    const struct lflow_build_profile_entry *const *b = b_;
+    uint64_t a_nsec = (*a)->build_nsec + (*a)->add_nsec;
+    uint64_t b_nsec = (*b)->build_nsec + (*b)->add_nsec;
+
+    if (a_nsec != b_nsec) {
+        return a_nsec < b_nsec ? 1 : -1;
+    }
+
+    int cmp = strcmp((*a)->func, (*b)->func);
+    if (cmp || !(*a)->where) {
+        return cmp;
+    }
+    return strcmp((*a)->where, (*b)->where);
+}
+
+/* Trims the source locator 'where', which looks something like
+ * "ovn/northd/northd.c:1234", down to just the part following the last
+ * slash, e.g. "northd.c:1234". */
+static const char *
+lflow_build_profile_trim_where(const char *where)
+{
+    const char *slash = strrchr(where, '/');
+#if _WIN32
+    const char *backslash = strrchr(where, '\\');
+    if (!slash || backslash > slash) {
+        slash = backslash;
+    }
+#endif
+    return slash ? slash + 1 : where;
+}
+
+static void
+lflow_build_profile_put_entries(struct ds *ds, const struct hmap *entries,
+                                size_t top_n)
+{
+    size_t n = hmap_count(entries);
+    const struct lflow_build_profile_entry **sorted =
+        xmalloc(n * sizeof *sorted);
+    const struct lflow_build_profile_entry *e;
+    size_t i = 0;
+
+    HMAP_FOR_EACH (e, hmap_node, entries) {
+        sorted[i++] = e;
+    }
+    qsort(sorted, n, sizeof *sorted, lflow_build_profile_compare);
+
+    for (i = 0; i < n && (!top_n || i < top_n); i++) {
+        e = sorted[i];
+        if (e->where) {
+            ds_put_format(ds, "  %s (%s)",
+                          lflow_build_profile_trim_where(e->where), e->func);
+        } else {
+            ds_put_format(ds, "  %s", e->func);
+        }
+        ds_put_format(ds, ": lflows %"PRIu64", match bytes %"PRIu64
+                      ", actions bytes %"PRIu64", build time %.3f ms"
+                      ", add time %.3f ms\n",
+                      e->n_lflows, e->match_bytes, e->actions_bytes,
+                      e->build_nsec / 1e6, e->add_nsec / 1e6);
+    }
+    free(sorted);
+}
+
+/* Prints the profile, per build function and per source location, sorted
+ * by decreasing CPU time.  Only the first 'top_n' of each are printed,
+ * unless 'top_n' is 0. */
+void
+lflow_build_profile_show(struct ds *ds, size_t top_n)
+{
+    if (!profile_started) {
+        ds_put_cstr(ds, "Logical flow generation profiling was never "
+                        "started.\n");
+        return;
+    }
+
+    struct hmap sites = HMAP_INITIALIZER(&sites);
+    struct hmap funcs = HMAP_INITIALIZER(&funcs);
+    struct lflow_build_profile_thread *t;
+
+    ovs_mutex_lock(&profile_threads_mutex);
+    LIST_FOR_EACH (t, list_node, &profile_threads) {
+        const struct lflow_build_profile_entry *e;
+
+        ovs_mutex_lock(&t->mutex);
+        HMAP_FOR_EACH (e, hmap_node, &t->entries) {
+            lflow_build_profile_entry_add(
+                lflow_build_profile_site_get(&sites, e->where, e->func), e);
+            lflow_build_profile_entry_add(
+                lflow_build_profile_func_get(&funcs, e->func), e);
+        }
+        ovs_mutex_unlock(&t->mutex);
+    }
+    ovs_mutex_unlock(&profile_threads_mutex);
+
+    ds_put_format(ds, "Status: %s\n",
+                  lflow_build_profile_is_enabled() ? "active" : "stopped");
+    ds_put_cstr(ds, "Build functions:\n");
+    lflow_build_profile_put_entries(ds, &funcs, top_n);
+    ds_put_cstr(ds, "Source locations:\n");
+    lflow_build_profile_put_entries(ds, &sites, top_n);
+
+    lflow_build_profile_entries_clear(&sites);
+    hmap_destroy(&sites);
+    lflow_build_profile_entries_clear(&funcs);
+    hmap_destroy(&funcs);
+}
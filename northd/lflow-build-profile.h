@@ -0,0 +1,55 @@
+/* Copyright (c) 2026, Red Hat, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LFLOW_BUILD_PROFILE_H
+#define LFLOW_BUILD_PROFILE_H 1
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Profiling of the logical flow generation, per source location and per
+ * build function.
+ *
+ * While enabled, lflow_table_add_lflow() accounts each logical flow to the
+ * source location ('where') and the function that added it, with the size
+ * of its match and actions and two CPU times of the calling thread:
+ *
+ *   - the time spent in lflow_table_add_lflow() itself.
+ *
+ *   - the time since the previous logical flow added by the same thread,
+ *     i.e., the time spent by the build function preparing the flow.  It
+ *     isn't accounted to the first logical flow after the table is cleared
+ *     or synced to the SB, see lflow_build_profile_new_pass(), so that the
+ *     time spent outside of the build functions isn't accounted to them.
+ *
+ * The profile is safe to update from the parallel build threads. */
+
+struct ds;
+
+void lflow_build_profile_start(void);
+void lflow_build_profile_stop(void);
+bool lflow_build_profile_is_enabled(void);
+void lflow_build_profile_destroy(void);
+
+uint64_t lflow_build_profile_begin(void);
+void lflow_build_profile_end(uint64_t begin_nsec, const char *where,
+                             const char *func, const char *match,
+                             const char *actions);
+void lflow_build_profile_new_pass(void);
+
+void lflow_build_profile_show(struct ds *, size_t top_n);
+
+#endif /* northd/lflow-build-profile.h */
@@ -20,9 +20,11 @@
 #include "include/openvswitch/thread.h"
 #include "lib/bitmap.h"
 #include "openvswitch/vlog.h"
+#include "ovs-usdt.h"
 
 /* OVN includes */
 #include "debug.h"
+#include "lflow-build-profile.h"
 #include "lflow-mgr.h"
 #include "lib/ovn-parallel-hmap.h"
 #include "lib/ovn-util.h"
@@ -219,6 +221,8 @@ lflow_table_init(struct lflow_table *lflow_table)
 void
 lflow_table_clear(struct lflow_table *lflow_table, bool destroy_all)
 {
+    lflow_build_profile_new_pass();
+
     struct ovn_lflow *lflow;
     HMAP_FOR_EACH_SAFE (lflow, hmap_node, &lflow_table->entries) {
         if (!destroy_all) {
@@ -277,6 +281,8 @@ lflow_table_sync_to_sb(struct lflow_table *lflow_table,
 
     fast_hmap_size_for(&lflows_temp,
                        lflow_table->max_seen_lflow_size);
+    OVS_USDT_PROBE(lflow_table_sync_to_sb, start, hmap_count(lflows));
+    lflow_build_profile_new_pass();
 
     HMAP_FOR_EACH_SAFE (lflow, hmap_node, lflows) {
         if (search_mode != LFLOW_TABLE_SEARCH_SBUUID) {
@@ -410,6 +416,7 @@ lflow_table_sync_to_sb(struct lflow_table *lflow_table,
     uuidset_destroy(&sb_uuid_set);
     hmap_swap(lflows, &lflows_temp);
     hmap_destroy(&lflows_temp);
+    OVS_USDT_PROBE(lflow_table_sync_to_sb, end, hmap_count(lflows));
 }
 
 /* Logical flow sync using 'struct lflow_ref'
@@ -764,6 +771,8 @@ lflow_table_add_lflow__(struct lflow_table *lflow_table,
                          hash, stage, priority, match, actions,
                          io_port, ctrl_meter, stage_hint, where, flow_desc,
                          acl_ct_translation);
+    OVS_USDT_PROBE(lflow_table_add_lflow, add, ovn_stage_to_str(stage),
+                   priority, match, actions, where, hash);
 
     if (lflow_ref) {
         struct lflow_ref_node *lrn =
@@ -819,12 +828,20 @@ lflow_table_add_lflow(struct lflow_table_add_args *args)
         args->sdp = NULL;
     }
 
+    bool profile = lflow_build_profile_is_enabled();
+    uint64_t profile_nsec = profile ? lflow_build_profile_begin() : 0;
+
     lflow_table_add_lflow__(args->table, args->sdp, args->dp_bitmap,
                             args->dp_bitmap_len, args->stage, args->priority,
                             args->match, args->actions, args->io_port,
                             args->ctrl_meter, args->acl_ct_translation,
                             args->stage_hint, args->where, args->flow_desc,
                             args->lflow_ref);
+
+    if (profile) {
+        lflow_build_profile_end(profile_nsec, args->where, args->func,
+                                args->match, args->actions);
+    }
 }
 
 struct ovn_dp_group *
@@ -1279,6 +1296,8 @@ sync_lflow_to_sb(struct ovn_lflow *lflow,
     }
 
     lflow->sync_state = LFLOW_SYNCED;
+    OVS_USDT_PROBE(sync_lflow_to_sb, synced, &lflow->sb_uuid,
+                   ovn_stage_to_str(lflow->stage), n_ods);
     return true;
 }
 
@@ -1382,6 +1401,8 @@ lflow_ref_sync_lflows__(struct lflow_ref  *lflow_ref,
                         const struct sbrec_logical_flow_table *sbflow_table,
                         const struct sbrec_logical_dp_group_table *dpgrp_table)
 {
+    lflow_build_profile_new_pass();
+
     struct lflow_ref_node *lrn;
     struct ovn_lflow *lflow;
     HMAP_FOR_EACH_SAFE (lrn, ref_node, &lflow_ref->lflow_ref_nodes) {
@@ -88,6 +88,7 @@ struct lflow_table_add_args {
     const char *flow_desc;
     struct lflow_ref *lflow_ref;
     const char *where;
+    const char *func;
     bool acl_ct_translation;
 };
 
@@ -126,6 +127,7 @@ void lflow_table_add_lflow(struct lflow_table_add_args *args);
             .actions = ACTIONS, \
             .lflow_ref = LFLOW_REF, \
             .where = OVS_SOURCE_LOCATOR, \
+            .func = __func__, \
             __VA_ARGS__ \
         } \
     )
@@ -144,6 +146,7 @@ void lflow_table_add_lflow(struct lflow_table_add_args *args);
             .actions = ACTIONS, \
             .lflow_ref = LFLOW_REF, \
             .where = OVS_SOURCE_LOCATOR, \
+            .func = __func__, \
             __VA_ARGS__ \
         } \
     )
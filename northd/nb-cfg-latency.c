@@ -0,0 +1,326 @@
+/* Copyright (c) 2026, Red Hat, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "nb-cfg-latency.h"
+
+#include "lib/ovn-nb-idl.h"
+#include "lib/ovn-sb-idl.h"
+#include "openvswitch/dynamic-string.h"
+#include "smap.h"
+#include "timeval.h"
+#include "util.h"
+
+/* Number of chassis listed in the NB_Global external_ids summary. */
+#define NB_CFG_LATENCY_N_SLOWEST 5
+
+/* Propagation of the current nb_cfg to a chassis. */
+struct chassis_latency {
+    char *name;
+    int64_t nb_cfg;             /* nb_cfg processed by the chassis. */
+    int64_t msec;               /* Latency, if 'nb_cfg' is the current one. */
+};
+
+/* Current nb_cfg, 0 if none, and its NB_Global nb_cfg_timestamp. */
+static int64_t cur_nb_cfg;
+static int64_t cur_start;
+
+/* Chassis, as of the SB IDL seqno 'chassis_seqno', 'n_pending' of them
+ * didn't process the current nb_cfg yet. */
+static struct chassis_latency *chassis;
+static size_t n_chassis;
+static size_t n_pending;
+static unsigned int chassis_seqno;
+
+/* Whether the current nb_cfg is summarized. */
+static bool summarized;
+
+/* NB_Global external_ids keys of the summary. */
+static const char *summary_keys[] = {
+    "nb_cfg_latency_nb_cfg",
+    "nb_cfg_latency_chassis",
+    "nb_cfg_latency_pending",
+    "nb_cfg_latency_p50",
+    "nb_cfg_latency_p90",
+    "nb_cfg_latency_p99",
+    "nb_cfg_latency_slowest",
+};
+
+/* Last summary, until it is read back from the NB_Global external_ids, so
+ * that it is written again if its transaction failed.  The keys of
+ * 'summary_keys' missing from it are removed from the external_ids. */
+static struct smap summary = SMAP_INITIALIZER(&summary);
+
+static bool
+chassis_latency_is_pending(const struct chassis_latency *cl)
+{
+    return cl->nb_cfg != cur_nb_cfg;
+}
+
+static void
+chassis_latency_clear(void)
+{
+    for (size_t i = 0; i < n_chassis; i++) {
+        free(chassis[i].name);
+    }
+    free(chassis);
+    chassis = NULL;
+    n_chassis = 0;
+    n_pending = 0;
+}
+
+/* Orders the pending chassis first, then by decreasing latency. */
+static int
+chassis_latency_compare(const void *a_, const void *b_)
+{
+    const struct chassis_latency *const *a = a_;
+    const struct chassis_latency *const *b = b_;
+    bool a_pending = chassis_latency_is_pending(*a);
+    bool b_pending = chassis_latency_is_pending(*b);
+
+    if (a_pending != b_pending) {
+        return a_pending ? -1 : 1;
+    }
+    if (!a_pending && (*a)->msec != (*b)->msec) {
+        return (*a)->msec > (*b)->msec ? -1 : 1;
+    }
+    return strcmp((*a)->name, (*b)->name);
+}
+
+/* Returns the chassis sorted by chassis_latency_compare(). */
+static const struct chassis_latency **
+chassis_latency_sort(void)
+{
+    const struct chassis_latency **sorted =
+        xmalloc(MAX(n_chassis, 1) * sizeof *sorted);
+
+    for (size_t i = 0; i < n_chassis; i++) {
+        sorted[i] = &chassis[i];
+    }
+    qsort(sorted, n_chassis, sizeof *sorted, chassis_latency_compare);
+    return sorted;
+}
+
+/* Returns the 'pct' percentile of the latencies of the chassis that
+ * processed the current nb_cfg, using the nearest-rank method.  'sorted'
+ * must be sorted by chassis_latency_compare() and at least one chassis must
+ * have processed the current nb_cfg. */
+static int64_t
+chassis_latency_percentile(const struct chassis_latency **sorted,
+                           unsigned int pct)
+{
+    size_t n = n_chassis - n_pending;
+    size_t rank = DIV_ROUND_UP(n * pct, 100);
+
+    /* The latencies are in decreasing order, after the pending chassis. */
+    return sorted[n_chassis - MAX(rank, 1)]->msec;
+}
+
+/* Returns true if the external_ids of 'nb' contain 'summary'. */
+static bool
+nb_global_has_summary(const struct nbrec_nb_global *nb)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(summary_keys); i++) {
+        const char *value = smap_get(&summary, summary_keys[i]);
+        const char *old = smap_get(&nb->external_ids, summary_keys[i]);
+
+        if (!value != !old || (value && strcmp(value, old))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void
+nb_global_write_summary(const struct nbrec_nb_global *nb)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(summary_keys); i++) {
+        const char *key = summary_keys[i];
+        const char *value = smap_get(&summary, key);
+        const char *old = smap_get(&nb->external_ids, key);
+
+        if (!value) {
+            if (old) {
+                nbrec_nb_global_update_external_ids_delkey(nb, key);
+            }
+        } else if (!old || strcmp(old, value)) {
+            nbrec_nb_global_update_external_ids_setkey(nb, key, value);
+        }
+    }
+}
+
+/* Summarizes the propagation of the current nb_cfg in the NB_Global
+ * external_ids. */
+static void
+nb_cfg_latency_summarize(const struct nbrec_nb_global *nb)
+{
+    const struct chassis_latency **sorted = chassis_latency_sort();
+    static const unsigned int pcts[] = { 50, 90, 99 };
+
+    smap_clear(&summary);
+    smap_add_format(&summary, "nb_cfg_latency_nb_cfg", "%"PRId64,
+                    cur_nb_cfg);
+    smap_add_format(&summary, "nb_cfg_latency_chassis", "%"PRIuSIZE,
+                    n_chassis);
+    smap_add_format(&summary, "nb_cfg_latency_pending", "%"PRIuSIZE,
+                    n_pending);
+
+    if (n_chassis > n_pending) {
+        for (size_t i = 0; i < ARRAY_SIZE(pcts); i++) {
+            char *key = xasprintf("nb_cfg_latency_p%u", pcts[i]);
+
+            smap_add_format(&summary, key, "%"PRId64,
+                            chassis_latency_percentile(sorted, pcts[i]));
+            free(key);
+        }
+    }
+
+    if (n_chassis) {
+        struct ds ds = DS_EMPTY_INITIALIZER;
+
+        for (size_t i = 0; i < MIN(n_chassis, NB_CFG_LATENCY_N_SLOWEST);
+             i++) {
+            const struct chassis_latency *cl = sorted[i];
+
+            if (chassis_latency_is_pending(cl)) {
+                ds_put_format(&ds, "%s=pending,", cl->name);
+            } else {
+                ds_put_format(&ds, "%s=%"PRId64",", cl->name, cl->msec);
+            }
+        }
+        ds_chomp(&ds, ',');
+        smap_add(&summary, "nb_cfg_latency_slowest", ds_cstr(&ds));
+        ds_destroy(&ds);
+    }
+    free(sorted);
+
+    nb_global_write_summary(nb);
+    summarized = true;
+}
+
+/* Updates the latency of the chassis that processed the current nb_cfg,
+ * summarizing it in 'nb' once all of them did, or the latency of the
+ * previous nb_cfg if it was superseded. */
+void
+nb_cfg_latency_run(const struct nbrec_nb_global *nb,
+                   struct ovsdb_idl *ovnsb_idl)
+{
+    /* The previous NB transaction completed, retry the summary until it is
+     * read back. */
+    if (!smap_is_empty(&summary)) {
+        if (nb_global_has_summary(nb)) {
+            smap_clear(&summary);
+        } else {
+            nb_global_write_summary(nb);
+        }
+    }
+
+    if (nb->nb_cfg != cur_nb_cfg) {
+        if (cur_nb_cfg && !summarized) {
+            nb_cfg_latency_summarize(nb);
+        }
+        chassis_latency_clear();
+        cur_nb_cfg = nb->nb_cfg;
+        cur_start = 0;
+        summarized = false;
+    }
+    if (!cur_nb_cfg || !nb->nb_cfg_timestamp || summarized) {
+        return;
+    }
+
+    unsigned int seqno = ovsdb_idl_get_seqno(ovnsb_idl);
+    if (nb->nb_cfg_timestamp == cur_start && seqno == chassis_seqno) {
+        return;
+    }
+    cur_start = nb->nb_cfg_timestamp;
+    chassis_seqno = seqno;
+
+    chassis_latency_clear();
+    size_t allocated = 0;
+    const struct sbrec_chassis_private *chassis_priv;
+    SBREC_CHASSIS_PRIVATE_FOR_EACH (chassis_priv, ovnsb_idl) {
+        /* Skip remote chassises, as for hv_cfg. */
+        if (chassis_priv->chassis &&
+            smap_get_bool(&chassis_priv->chassis->other_config,
+                          "is-remote", false)) {
+            continue;
+        }
+
+        if (n_chassis >= allocated) {
+            chassis = x2nrealloc(chassis, &allocated, sizeof *chassis);
+        }
+        struct chassis_latency *cl = &chassis[n_chassis++];
+        cl->name = xstrdup(chassis_priv->name);
+        cl->nb_cfg = chassis_priv->nb_cfg;
+        cl->msec = MAX(chassis_priv->nb_cfg_timestamp - cur_start, 0);
+        if (chassis_latency_is_pending(cl)) {
+            n_pending++;
+        }
+    }
+
+    if (n_chassis && !n_pending) {
+        nb_cfg_latency_summarize(nb);
+    }
+}
+
+/* Prints the propagation of the current nb_cfg, including the 'top_n'
+ * slowest chassis. */
+void
+nb_cfg_latency_show(struct ds *ds, size_t top_n)
+{
+    if (!cur_nb_cfg || !cur_start) {
+        ds_put_cstr(ds, "No nb_cfg propagated.\n");
+        return;
+    }
+
+    ds_put_format(ds, "nb_cfg: %"PRId64"\n", cur_nb_cfg);
+    ds_put_format(ds, "Chassis: %"PRIuSIZE", pending: %"PRIuSIZE"\n",
+                  n_chassis, n_pending);
+
+    const struct chassis_latency **sorted = chassis_latency_sort();
+    if (n_chassis > n_pending) {
+        ds_put_format(ds, "Latency: p50 %"PRId64" ms, p90 %"PRId64" ms, "
+                      "p99 %"PRId64" ms, max %"PRId64" ms\n",
+                      chassis_latency_percentile(sorted, 50),
+                      chassis_latency_percentile(sorted, 90),
+                      chassis_latency_percentile(sorted, 99),
+                      chassis_latency_percentile(sorted, 100));
+    }
+
+    int64_t pending_msec = MAX(time_wall_msec() - cur_start, 0);
+    ds_put_cstr(ds, "Slowest chassis:\n");
+    for (size_t i = 0; i < MIN(n_chassis, top_n); i++) {
+        const struct chassis_latency *cl = sorted[i];
+
+        if (chassis_latency_is_pending(cl)) {
+            ds_put_format(ds, "  %s: pending for %"PRId64" ms (nb_cfg %"
+                          PRId64")\n", cl->name, pending_msec, cl->nb_cfg);
+        } else {
+            ds_put_format(ds, "  %s: %"PRId64" ms\n", cl->name, cl->msec);
+        }
+    }
+    free(sorted);
+}
+
+void
+nb_cfg_latency_destroy(void)
+{
+    chassis_latency_clear();
+    smap_destroy(&summary);
+}
@@ -0,0 +1,43 @@
+/* Copyright (c) 2026, Red Hat, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef NB_CFG_LATENCY_H
+#define NB_CFG_LATENCY_H 1
+
+#include <stddef.h>
+
+/* Latency of the propagation of the NB_Global nb_cfg to the chassis.
+ *
+ * The latency of a chassis is the difference between the nb_cfg_timestamp
+ * of its Chassis_Private record, i.e., when it processed nb_cfg, and the
+ * NB_Global nb_cfg_timestamp, i.e., when ovn-northd copied nb_cfg to the
+ * SB.  Both are wall clock times, of different hosts, negative latencies
+ * are accounted as 0.
+ *
+ * The distribution of the latencies of the current nb_cfg is summarized in
+ * the NB_Global external_ids once all the chassis processed it, or when
+ * it is superseded by a new nb_cfg.  The summary is written again until it
+ * is read back, e.g., if its transaction failed. */
+
+struct ds;
+struct nbrec_nb_global;
+struct ovsdb_idl;
+
+void nb_cfg_latency_run(const struct nbrec_nb_global *,
+                        struct ovsdb_idl *ovnsb_idl);
+void nb_cfg_latency_show(struct ds *, size_t top_n);
+void nb_cfg_latency_destroy(void);
+
+#endif /* northd/nb-cfg-latency.h */
@@ -0,0 +1,317 @@
+/* Copyright (c) 2026, Red Hat, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+
+#include "northd-bench.h"
+#include "inc-proc-northd.h"
+#include "lib/bench-ovsdb.h"
+#include "lib/inc-proc-eng.h"
+#include "lib/stopwatch-names.h"
+#include "openvswitch/dynamic-string.h"
+#include "openvswitch/json.h"
+#include "openvswitch/poll-loop.h"
+#include "openvswitch/vlog.h"
+#include "ovsdb-idl.h"
+#include "stopwatch.h"
+#include "timeval.h"
+#include "util.h"
+
+VLOG_DEFINE_THIS_MODULE(northd_bench);
+
+/* Maximum time to wait for a change to reach the NB IDL, in ms.  Changes
+ * that don't modify any row are never sent to the IDL. */
+#define NORTHD_BENCH_UPDATE_TIMEOUT_MS 1000
+
+struct northd_bench {
+    struct bench_ovsdb *server; /* Serves the NB and SB databases. */
+    char *changes_file;
+    struct northd_engine_context eng_ctx;
+};
+
+/* Timings of a recompute or of the processing of a change. */
+struct northd_bench_sample {
+    long long int wall_usec;    /* Until ovn-northd committed everything. */
+    long long int engine_usec;  /* Spent in the incremental engine. */
+    unsigned int n_runs;        /* Engine runs. */
+};
+
+struct northd_bench *
+northd_bench_create(const char *nb_file, const char *sb_file,
+                    const char *changes_file)
+{
+    if (!nb_file || !sb_file) {
+        ovs_fatal(0, "--benchmark-nb and --benchmark-sb must be used "
+                  "together");
+    }
+
+    struct northd_bench *b = xzalloc(sizeof *b);
+
+    b->server = bench_ovsdb_create("ovn-northd");
+    bench_ovsdb_add_db(b->server, nb_file);
+    bench_ovsdb_add_db(b->server, sb_file);
+    b->changes_file = nullable_xstrdup(changes_file);
+
+    return b;
+}
+
+void
+northd_bench_destroy(struct northd_bench *b)
+{
+    if (!b) {
+        return;
+    }
+
+    bench_ovsdb_destroy(b->server);
+    free(b->changes_file);
+    free(b);
+}
+
+const char *
+northd_bench_remote(const struct northd_bench *b)
+{
+    return bench_ovsdb_remote(b->server);
+}
+
+/* Runs the northd engine, the way the main loop does when ovn-northd is
+ * active, until it has processed all the updates and all its transactions
+ * are committed.  If 'nb_seqno' is nonzero, also waits for the NB IDL to
+ * move past it. */
+static void
+northd_bench_settle(struct northd_bench *b, struct ovsdb_idl_loop *nb,
+                    struct ovsdb_idl_loop *sb, unsigned int nb_seqno,
+                    struct northd_bench_sample *sample)
+{
+    long long int start = time_usec();
+    long long int deadline = time_msec() + NORTHD_BENCH_UPDATE_TIMEOUT_MS;
+
+    for (;;) {
+        struct ovsdb_idl_txn *nb_txn = ovsdb_idl_loop_run(nb);
+        struct ovsdb_idl_txn *sb_txn = ovsdb_idl_loop_run(sb);
+        bool activity = false;
+
+        if (nb_txn && sb_txn) {
+            long long int engine_start = time_usec();
+
+            activity = inc_proc_northd_run(nb_txn, sb_txn, &b->eng_ctx);
+            sample->engine_usec += time_usec() - engine_start;
+            sample->n_runs++;
+        }
+
+        if (!ovsdb_idl_loop_commit_and_wait(nb)) {
+            VLOG_WARN("OVNNB commit failed, force recompute next time.");
+            inc_proc_northd_force_recompute_immediate();
+        }
+        if (!ovsdb_idl_loop_commit_and_wait(sb)) {
+            VLOG_WARN("OVNSB commit failed, force recompute next time.");
+            inc_proc_northd_force_recompute_immediate();
+        }
+        if (nb_txn && sb_txn) {
+            ovsdb_idl_track_clear(nb->idl);
+            ovsdb_idl_track_clear(sb->idl);
+        }
+
+        bool updated = !nb_seqno || ovsdb_idl_get_seqno(nb->idl) != nb_seqno;
+        if (!updated && time_msec() >= deadline) {
+            VLOG_WARN("benchmark change not seen by the NB IDL after %d ms",
+                      NORTHD_BENCH_UPDATE_TIMEOUT_MS);
+            updated = true;
+        }
+        if (updated && !activity && nb_txn && sb_txn &&
+            !nb->committing_txn && !sb->committing_txn &&
+            !inc_proc_northd_get_force_recompute()) {
+            break;
+        }
+
+        bench_ovsdb_run(b->server);
+        if (!updated) {
+            poll_timer_wait_until(deadline);
+        }
+        poll_block();
+    }
+
+    sample->wall_usec = time_usec() - start;
+}
+
+static struct json *
+northd_bench_sample_to_json(const struct northd_bench_sample *sample)
+{
+    struct json *json = json_object_create();
+
+    json_object_put(json, "wall-usec",
+                    json_integer_create(sample->wall_usec));
+    json_object_put(json, "engine-usec",
+                    json_integer_create(sample->engine_usec));
+    json_object_put(json, "engine-runs",
+                    json_integer_create(sample->n_runs));
+    return json;
+}
+
+/* Applies the changes of 'changes_file' one by one.  Each line is the
+ * "params" of an OVSDB "transact" request, e.g.:
+ *
+ *     ["OVN_Northbound", {"op": "insert", "table": "Logical_Switch",
+ *                         "row": {"name": "ls1"}}]
+ *
+ * Empty lines and lines starting with '#' are ignored. */
+static struct json *
+northd_bench_run_changes(struct northd_bench *b, struct ovsdb_idl_loop *nb,
+                         struct ovsdb_idl_loop *sb)
+{
+    FILE *stream = fopen(b->changes_file, "r");
+    if (!stream) {
+        ovs_fatal(errno, "%s: open failed", b->changes_file);
+    }
+
+    struct json *changes = json_array_create_empty();
+    struct ds line = DS_EMPTY_INITIALIZER;
+    unsigned int line_number = 0;
+
+    while (!ds_get_line(&line, stream)) {
+        line_number++;
+
+        const char *s = ds_cstr(&line);
+        s += strspn(s, " \t");
+        if (!*s || *s == '#') {
+            continue;
+        }
+
+        struct json *params = json_from_string(s);
+        if (params->type != JSON_ARRAY) {
+            ovs_fatal(0, "%s:%u: expecting a JSON array of operations",
+                      b->changes_file, line_number);
+        }
+
+        struct northd_bench_sample sample = {0};
+        unsigned int nb_seqno = ovsdb_idl_get_seqno(nb->idl);
+        long long int start = time_usec();
+
+        char *where = xasprintf("%s:%u", b->changes_file, line_number);
+        bench_ovsdb_transact(b->server, params, where);
+        free(where);
+        northd_bench_settle(b, nb, sb, nb_seqno, &sample);
+        sample.wall_usec = time_usec() - start;
+
+        struct json *change = northd_bench_sample_to_json(&sample);
+        json_object_put(change, "line", json_integer_create(line_number));
+        json_array_add(changes, change);
+    }
+
+    ds_destroy(&line);
+    fclose(stream);
+    return changes;
+}
+
+static struct json *
+northd_bench_stopwatches_to_json(void)
+{
+    static const char *names[] = {
+        BUILD_LFLOWS_CTX_STOPWATCH_NAME,
+        CLEAR_LFLOWS_CTX_STOPWATCH_NAME,
+        LFLOWS_DATAPATHS_STOPWATCH_NAME,
+        LFLOWS_PORTS_STOPWATCH_NAME,
+        LFLOWS_LBS_STOPWATCH_NAME,
+        LFLOWS_LR_STATEFUL_STOPWATCH_NAME,
+        LFLOWS_LS_STATEFUL_STOPWATCH_NAME,
+        LFLOWS_IGMP_STOPWATCH_NAME,
+        LFLOWS_DP_GROUPS_STOPWATCH_NAME,
+        LFLOWS_TO_SB_STOPWATCH_NAME,
+    };
+    struct json *json = json_object_create();
+
+    stopwatch_sync();
+    for (size_t i = 0; i < ARRAY_SIZE(names); i++) {
+        struct stopwatch_stats stats = { .unit = SW_MS };
+
+        if (!stopwatch_get_stats(names[i], &stats)) {
+            continue;
+        }
+
+        struct json *sw = json_object_create();
+        json_object_put(sw, "count", json_integer_create(stats.count));
+        json_object_put(sw, "min-msec", json_integer_create(stats.min));
+        json_object_put(sw, "max-msec", json_integer_create(stats.max));
+        json_object_put(sw, "95th-msec", json_real_create(stats.pctl_95));
+        json_object_put(sw, "ewma-50-msec", json_real_create(stats.ewma_50));
+        json_object_put(json, names[i], sw);
+    }
+    return json;
+}
+
+/* Runs the benchmark using the IDLs 'nb' and 'sb', connected to
+ * northd_bench_remote(), and prints the results.  Returns the exit status
+ * of ovn-northd. */
+int
+northd_bench_run(struct northd_bench *b, struct ovsdb_idl_loop *nb,
+                 struct ovsdb_idl_loop *sb)
+{
+    struct json *result = json_object_create();
+
+    /* Wait for the initial contents of both databases. */
+    while (!ovsdb_idl_has_ever_connected(nb->idl) ||
+           !ovsdb_idl_has_ever_connected(sb->idl)) {
+        ovsdb_idl_run(nb->idl);
+        ovsdb_idl_run(sb->idl);
+        ovsdb_idl_wait(nb->idl);
+        ovsdb_idl_wait(sb->idl);
+        bench_ovsdb_run(b->server);
+        poll_block();
+    }
+
+    /* Full recompute. */
+    struct northd_bench_sample sample = {0};
+
+    engine_clear_all_stats();
+    inc_proc_northd_force_recompute();
+    northd_bench_settle(b, nb, sb, 0, &sample);
+
+    struct json *recompute = northd_bench_sample_to_json(&sample);
+    json_object_put(recompute, "engine-nodes", engine_get_stats_json());
+    json_object_put(result, "recompute", recompute);
+
+    /* Incremental changes. */
+    if (b->changes_file) {
+        engine_clear_all_stats();
+
+        struct json *incremental = json_object_create();
+        json_object_put(incremental, "changes",
+                        northd_bench_run_changes(b, nb, sb));
+        json_object_put(incremental, "engine-nodes",
+                        engine_get_stats_json());
+        json_object_put(result, "incremental", incremental);
+    }
+
+    json_object_put(result, "stopwatches",
+                    northd_bench_stopwatches_to_json());
+
+    struct rusage usage;
+    if (!getrusage(RUSAGE_SELF, &usage)) {
+        json_object_put(result, "peak-rss-kb",
+                        json_integer_create(usage.ru_maxrss));
+    }
+
+    char *s = json_to_string(result, JSSF_PRETTY | JSSF_SORT);
+    puts(s);
+    free(s);
+    json_destroy(result);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,39 @@
+/* Copyright (c) 2026, Red Hat, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef NORTHD_BENCH_H
+#define NORTHD_BENCH_H 1
+
+/* Offline benchmark mode of ovn-northd.
+ *
+ * The NB and SB database files are loaded into in-memory databases served
+ * by an OVSDB server running in the ovn-northd process, so that the regular
+ * IDLs can be used.  The benchmark runs a full recompute and then applies
+ * the NB transactions of a script one by one, waiting for ovn-northd to
+ * process each of them, and prints the timings as JSON to stdout. */
+
+struct northd_bench;
+struct ovsdb_idl_loop;
+
+struct northd_bench *northd_bench_create(const char *nb_file,
+                                         const char *sb_file,
+                                         const char *changes_file);
+void northd_bench_destroy(struct northd_bench *);
+
+const char *northd_bench_remote(const struct northd_bench *);
+int northd_bench_run(struct northd_bench *, struct ovsdb_idl_loop *nb,
+                     struct ovsdb_idl_loop *sb);
+
+#endif /* NORTHD_BENCH_H */
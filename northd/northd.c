@@ -4395,6 +4395,25 @@ destroy_tracked_lbs(struct tracked_lbs *trk_lbs)
     }
 
     hmapx_clear(&trk_lbs->crupdated);
+
+    struct tracked_lb_backends *trk_backends;
+    HMAP_FOR_EACH_POP (trk_backends, hmap_node, &trk_lbs->backends_updated) {
+        free(trk_backends);
+    }
+}
+
+const struct tracked_lb_backends *
+tracked_lbs_find_backends_updated(const struct tracked_lbs *trk_lbs,
+                                  const struct ovn_lb_datapaths *lb_dps)
+{
+    struct tracked_lb_backends *trk_backends;
+    HMAP_FOR_EACH_WITH_HASH (trk_backends, hmap_node, hash_pointer(lb_dps, 0),
+                             &trk_lbs->backends_updated) {
+        if (trk_backends->lb_dps == lb_dps) {
+            return trk_backends;
+        }
+    }
+    return NULL;
 }
 
 static void
@@ -4411,6 +4430,8 @@ destroy_northd_data_tracked_changes(struct northd_data *nd)
     destroy_tracked_ovn_ports(&trk_changes->trk_lsps);
     destroy_tracked_lbs(&trk_changes->trk_lbs);
     hmapx_clear(&trk_changes->trk_nat_lrs);
+    hmapx_clear(&trk_changes->trk_route_lrs);
+    hmapx_clear(&trk_changes->trk_policy_lrs);
     hmapx_clear(&trk_changes->ls_with_changed_lbs);
     hmapx_clear(&trk_changes->ls_with_changed_acls);
     hmapx_clear(&trk_changes->ls_with_changed_ipam);
@@ -4433,7 +4454,10 @@ init_northd_tracked_data(struct northd_data *nd)
     hmapx_init(&trk_data->trk_lsps.deleted);
     hmapx_init(&trk_data->trk_lbs.crupdated);
     hmapx_init(&trk_data->trk_lbs.deleted);
+    hmap_init(&trk_data->trk_lbs.backends_updated);
     hmapx_init(&trk_data->trk_nat_lrs);
+    hmapx_init(&trk_data->trk_route_lrs);
+    hmapx_init(&trk_data->trk_policy_lrs);
     hmapx_init(&trk_data->ls_with_changed_lbs);
     hmapx_init(&trk_data->ls_with_changed_acls);
     hmapx_init(&trk_data->ls_with_changed_ipam);
@@ -4451,7 +4475,10 @@ destroy_northd_tracked_data(struct northd_data *nd)
     hmapx_destroy(&trk_data->trk_lsps.deleted);
     hmapx_destroy(&trk_data->trk_lbs.crupdated);
     hmapx_destroy(&trk_data->trk_lbs.deleted);
+    hmap_destroy(&trk_data->trk_lbs.backends_updated);
     hmapx_destroy(&trk_data->trk_nat_lrs);
+    hmapx_destroy(&trk_data->trk_route_lrs);
+    hmapx_destroy(&trk_data->trk_policy_lrs);
     hmapx_destroy(&trk_data->ls_with_changed_lbs);
     hmapx_destroy(&trk_data->ls_with_changed_acls);
     hmapx_destroy(&trk_data->ls_with_changed_ipam);
@@ -5242,6 +5269,9 @@ bool northd_handle_ipam_changes(struct northd_data *nd)
  * Presently supports i-p for the below changes:
  *    - load balancers and load balancer groups.
  *    - NAT changes
+ *    - static route and routing policy changes.  The en_routes and
+ *      en_route_policies engine nodes fall back to a full recompute if
+ *      the individual route or policy changes can't be handled.
  */
 static bool
 lr_changes_can_be_handled(const struct nbrec_logical_router *lr)
@@ -5257,7 +5287,9 @@ lr_changes_can_be_handled(const struct nbrec_logical_router *lr)
         if (nbrec_logical_router_is_updated(lr, col)) {
             if (col == NBREC_LOGICAL_ROUTER_COL_LOAD_BALANCER
                 || col == NBREC_LOGICAL_ROUTER_COL_LOAD_BALANCER_GROUP
-                || col == NBREC_LOGICAL_ROUTER_COL_NAT) {
+                || col == NBREC_LOGICAL_ROUTER_COL_NAT
+                || col == NBREC_LOGICAL_ROUTER_COL_STATIC_ROUTES
+                || col == NBREC_LOGICAL_ROUTER_COL_POLICIES) {
                 continue;
             }
             return false;
@@ -5276,18 +5308,6 @@ lr_changes_can_be_handled(const struct nbrec_logical_router *lr)
                                 OVSDB_IDL_CHANGE_MODIFY) > 0) {
         return false;
     }
-    for (size_t i = 0; i < lr->n_policies; i++) {
-        if (nbrec_logical_router_policy_row_get_seqno(lr->policies[i],
-                                OVSDB_IDL_CHANGE_MODIFY) > 0) {
-            return false;
-        }
-    }
-    for (size_t i = 0; i < lr->n_static_routes; i++) {
-        if (nbrec_logical_router_static_route_row_get_seqno(
-            lr->static_routes[i], OVSDB_IDL_CHANGE_MODIFY) > 0) {
-            return false;
-        }
-    }
     return true;
 }
 
@@ -5313,6 +5333,42 @@ is_lr_nats_changed(const struct nbrec_logical_router *nbr) {
             || is_lr_nats_seqno_changed(nbr));
 }
 
+static bool
+is_lr_static_routes_changed(const struct nbrec_logical_router *nbr)
+{
+    if (nbrec_logical_router_is_updated(
+            nbr, NBREC_LOGICAL_ROUTER_COL_STATIC_ROUTES)) {
+        return true;
+    }
+
+    for (size_t i = 0; i < nbr->n_static_routes; i++) {
+        if (nbrec_logical_router_static_route_row_get_seqno(
+            nbr->static_routes[i], OVSDB_IDL_CHANGE_MODIFY) > 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool
+is_lr_policies_changed(const struct nbrec_logical_router *nbr)
+{
+    if (nbrec_logical_router_is_updated(nbr,
+                                        NBREC_LOGICAL_ROUTER_COL_POLICIES)) {
+        return true;
+    }
+
+    for (size_t i = 0; i < nbr->n_policies; i++) {
+        if (nbrec_logical_router_policy_row_get_seqno(nbr->policies[i],
+                                OVSDB_IDL_CHANGE_MODIFY) > 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 /* Return true if changes are handled incrementally, false otherwise.
  *
  * Note: Changes to load balancer and load balancer groups associated with
@@ -5354,6 +5410,12 @@ northd_handle_lr_changes(const struct northd_input *ni,
                                                od->nbr->name);
         hmapx_add(&nd->trk_data.trk_nat_lrs,od);
         hmapx_add(&nd->trk_data.trk_routers.crupdated, od);
+        if (new_lr->n_static_routes) {
+            hmapx_add(&nd->trk_data.trk_route_lrs, od);
+        }
+        if (new_lr->n_policies) {
+            hmapx_add(&nd->trk_data.trk_policy_lrs, od);
+        }
     }
 
     HMAPX_FOR_EACH (node, &ni->synced_lrs->updated) {
@@ -5361,26 +5423,40 @@ northd_handle_lr_changes(const struct northd_input *ni,
         changed_lr = synced->nb;
 
         /* Presently only able to handle load balancer,
-         * load balancer group changes and NAT changes. */
+         * load balancer group changes, NAT changes and static route and
+         * routing policy changes. */
         if (!lr_changes_can_be_handled(changed_lr)) {
             goto fail;
         }
 
-        if (is_lr_nats_changed(changed_lr)) {
-            struct ovn_datapath *od = ovn_datapath_find_(
-                                    &nd->lr_datapaths.datapaths,
-                                    &changed_lr->header_.uuid);
+        bool nats_changed = is_lr_nats_changed(changed_lr);
+        bool routes_changed = is_lr_static_routes_changed(changed_lr);
+        bool policies_changed = is_lr_policies_changed(changed_lr);
+        if (!nats_changed && !routes_changed && !policies_changed) {
+            continue;
+        }
 
-            if (!od) {
-                static struct vlog_rate_limit rl = VLOG_RATE_LIMIT_INIT(1, 1);
-                VLOG_WARN_RL(&rl, "Internal error: a tracked updated LR "
-                            "doesn't exist in lr_datapaths: "UUID_FMT,
-                            UUID_ARGS(&changed_lr->header_.uuid));
-                goto fail;
-            }
+        struct ovn_datapath *od = ovn_datapath_find_(
+                                &nd->lr_datapaths.datapaths,
+                                &changed_lr->header_.uuid);
+
+        if (!od) {
+            static struct vlog_rate_limit rl = VLOG_RATE_LIMIT_INIT(1, 1);
+            VLOG_WARN_RL(&rl, "Internal error: a tracked updated LR "
+                        "doesn't exist in lr_datapaths: "UUID_FMT,
+                        UUID_ARGS(&changed_lr->header_.uuid));
+            goto fail;
+        }
 
+        if (nats_changed) {
             hmapx_add(&nd->trk_data.trk_nat_lrs, od);
         }
+        if (routes_changed) {
+            hmapx_add(&nd->trk_data.trk_route_lrs, od);
+        }
+        if (policies_changed) {
+            hmapx_add(&nd->trk_data.trk_policy_lrs, od);
+        }
     }
 
     HMAPX_FOR_EACH (node, &ni->synced_lrs->deleted) {
@@ -5421,6 +5497,12 @@ northd_handle_lr_changes(const struct northd_input *ni,
     if (!hmapx_is_empty(&nd->trk_data.trk_nat_lrs)) {
         nd->trk_data.type |= NORTHD_TRACKED_LR_NATS;
     }
+    if (!hmapx_is_empty(&nd->trk_data.trk_route_lrs)) {
+        nd->trk_data.type |= NORTHD_TRACKED_LR_ROUTES;
+    }
+    if (!hmapx_is_empty(&nd->trk_data.trk_policy_lrs)) {
+        nd->trk_data.type |= NORTHD_TRACKED_LR_POLICIES;
+    }
     if (!hmapx_is_empty(&nd->trk_data.trk_routers.crupdated) ||
         !hmapx_is_empty(&nd->trk_data.trk_routers.deleted)) {
         nd->trk_data.type |= NORTHD_TRACKED_ROUTERS;
@@ -5584,6 +5666,14 @@ northd_handle_lb_data_changes(struct tracked_lb_data *trk_lb_data,
         hmapx_add(&nd_changes->trk_lbs.deleted, lb_dps);
     }
 
+    /* The lflows of the load balancers whose VIPs' backends changed can be
+     * updated per VIP, unless the datapaths of the load balancers might
+     * have changed too. */
+    bool lb_assoc_changed =
+        !hmap_is_empty(&trk_lb_data->crupdated_lbgrps)
+        || !ovs_list_is_empty(&trk_lb_data->crupdated_ls_lbs)
+        || !ovs_list_is_empty(&trk_lb_data->crupdated_lr_lbs);
+
     /* Create the 'lb_dps' if not already created for each
      * 'lb' in the trk_lb_data->crupdated_lbs. */
     struct crupdated_lb *clb;
@@ -5597,6 +5687,13 @@ northd_handle_lb_data_changes(struct tracked_lb_data *trk_lb_data,
                                              ods_size(lr_datapaths));
             hmap_insert(lb_datapaths_map, &lb_dps->hmap_node,
                         uuid_hash(lb_uuid));
+        } else if (clb->backends_only && !lb_assoc_changed) {
+            struct tracked_lb_backends *trk_backends =
+                xmalloc(sizeof *trk_backends);
+            trk_backends->lb_dps = lb_dps;
+            trk_backends->updated_vips = &clb->updated_vips;
+            hmap_insert(&nd_changes->trk_lbs.backends_updated,
+                        &trk_backends->hmap_node, hash_pointer(lb_dps, 0));
         }
 
         /* Add the updated lb to the northd tracked data. */
@@ -5698,6 +5795,12 @@ northd_handle_lb_data_changes(struct tracked_lb_data *trk_lb_data,
     }
 
     HMAP_FOR_EACH (clb, hmap_node, &trk_lb_data->crupdated_lbs) {
+        if (clb->backends_only) {
+            /* The VIPs didn't change, so the logical switches' LB state
+             * is the same. */
+            continue;
+        }
+
         lb = clb->lb;
         const struct uuid *lb_uuid = &lb->nlb->header_.uuid;
 
@@ -8214,99 +8317,93 @@ build_qos(struct ovn_datapath *od, struct lflow_table *lflows,
 static void
 build_lb_rules_pre_stateful(struct lflow_table *lflows,
                             struct ovn_lb_datapaths *lb_dps,
+                            const struct ovn_lb_vip *lb_vip,
                             const struct ovn_datapaths *ls_datapaths,
-                            struct ds *match, struct ds *action)
+                            struct ds *match, struct ds *action,
+                            struct lflow_ref *lflow_ref)
 {
-    if (dynamic_bitmap_is_empty(&lb_dps->nb_ls_map)) {
-        return;
+    const struct ovn_northd_lb *lb = lb_dps->lb;
+    ds_clear(action);
+    ds_clear(match);
+    const char *ip_match = NULL;
+
+    /* Store the original destination IP to be used when generating
+     * hairpin flows.
+     */
+    if (lb_vip->address_family == AF_INET) {
+        ip_match = "ip4";
+        ds_put_format(action, REG_LB_IPV4 " = %s; ",
+                      lb_vip->vip_str);
+    } else {
+        ip_match = "ip6";
+        ds_put_format(action, REG_LB_IPV6 " = %s; ",
+                      lb_vip->vip_str);
     }
 
-    const struct ovn_northd_lb *lb = lb_dps->lb;
-    for (size_t i = 0; i < lb->n_vips; i++) {
-        struct ovn_lb_vip *lb_vip = &lb->vips[i];
+    if (lb_vip->port_str) {
+        /* Store the original destination port to be used when generating
+         * hairpin flows.
+         */
+        ds_put_format(action, REG_LB_PORT " = %s; ",
+                      lb_vip->port_str);
+    }
+    ds_put_cstr(action, "ct_lb_mark;");
+
+    ds_put_format(match, REGBIT_CONNTRACK_NAT" == 1 && %s.dst == %s",
+                  ip_match, lb_vip->vip_str);
+    if (lb_vip->port_str) {
+        ds_put_format(match, " && %s.dst == %s", lb->proto,
+                      lb_vip->port_str);
+    }
+
+    ovn_lflow_add_with_dp_group(lflows, lb_dps->nb_ls_map.map,
+                                ods_size(ls_datapaths),
+                                S_SWITCH_IN_PRE_STATEFUL, 120,
+                                ds_cstr(match), ds_cstr(action),
+                                lflow_ref,
+                                WITH_HINT(&lb->nlb->header_));
+
+    struct hmapx_node *hmapx_node;
+    struct ovn_datapath *od;
+    HMAPX_FOR_EACH (hmapx_node, &lb_dps->ls_lb_with_stateless_mode) {
+        od = hmapx_node->data;
+
         ds_clear(action);
         ds_clear(match);
-        const char *ip_match = NULL;
 
-        /* Store the original destination IP to be used when generating
-         * hairpin flows.
-         */
-        if (lb->vips[i].address_family == AF_INET) {
-            ip_match = "ip4";
-            ds_put_format(action, REG_LB_IPV4 " = %s; ",
-                          lb_vip->vip_str);
-        } else {
-            ip_match = "ip6";
-            ds_put_format(action, REG_LB_IPV6 " = %s; ",
-                          lb_vip->vip_str);
-        }
+        ds_put_format(match, "%s.dst == %s", ip_match, lb_vip->vip_str);
 
         if (lb_vip->port_str) {
-            /* Store the original destination port to be used when generating
-             * hairpin flows.
-             */
-            ds_put_format(action, REG_LB_PORT " = %s; ",
+            ds_put_format(match, " && %s.dst == %s", lb->proto,
                           lb_vip->port_str);
         }
-        ds_put_cstr(action, "ct_lb_mark;");
 
-        ds_put_format(match, REGBIT_CONNTRACK_NAT" == 1 && %s.dst == %s",
-                      ip_match, lb_vip->vip_str);
+        if (lb_vip->address_family == AF_INET) {
+            ds_put_format(action, REG_LB_IPV4 " = %s; ", lb_vip->vip_str);
+        } else {
+            ds_put_format(action, REG_LB_IPV6 " = %s; ", lb_vip->vip_str);
+        }
         if (lb_vip->port_str) {
-            ds_put_format(match, " && %s.dst == %s", lb->proto,
-                          lb_vip->port_str);
+            ds_put_format(action, REG_LB_PORT " = %s; ", lb_vip->port_str);
         }
 
-        ovn_lflow_add_with_dp_group(lflows, lb_dps->nb_ls_map.map,
-                                    ods_size(ls_datapaths),
-                                    S_SWITCH_IN_PRE_STATEFUL, 120,
-                                    ds_cstr(match), ds_cstr(action),
-                                    lb_dps->lflow_ref,
-                                    WITH_HINT(&lb->nlb->header_));
+        ds_put_cstr(action, "ct_lb_mark;");
 
-        struct lflow_ref *lflow_ref = lb_dps->lflow_ref;
-        struct hmapx_node *hmapx_node;
-        struct ovn_datapath *od;
-        HMAPX_FOR_EACH (hmapx_node, &lb_dps->ls_lb_with_stateless_mode) {
-            od = hmapx_node->data;
+        ovn_lflow_add(lflows, od, S_SWITCH_IN_PRE_STATEFUL, 150,
+                      ds_cstr(match), ds_cstr(action), lflow_ref);
 
+        if (lb->hairpin_snat_ip || lb_vip->port_str) {
             ds_clear(action);
             ds_clear(match);
 
-            ds_put_format(match, "%s.dst == %s", ip_match, lb_vip->vip_str);
-
-            if (lb_vip->port_str) {
-                ds_put_format(match, " && %s.dst == %s", lb->proto,
-                              lb_vip->port_str);
-            }
-
-            if (lb->vips[i].address_family == AF_INET) {
-                ds_put_format(action, REG_LB_IPV4 " = %s; ", lb_vip->vip_str);
-            } else {
-                ds_put_format(action, REG_LB_IPV6 " = %s; ", lb_vip->vip_str);
-            }
-            if (lb_vip->port_str) {
-                ds_put_format(action, REG_LB_PORT " = %s; ", lb_vip->port_str);
-            }
-
+            ds_put_format(match, "%s && %s.dst == %s", lb->proto, ip_match,
+                                 lb->hairpin_snat_ip
+                                 ? lb->hairpin_snat_ip
+                                 : lb_vip->vip_str);
             ds_put_cstr(action, "ct_lb_mark;");
 
-            ovn_lflow_add(lflows, od, S_SWITCH_IN_PRE_STATEFUL, 150,
+            ovn_lflow_add(lflows, od, S_SWITCH_IN_PRE_STATEFUL, 105,
                           ds_cstr(match), ds_cstr(action), lflow_ref);
-
-            if (lb->hairpin_snat_ip || lb_vip->port_str) {
-                ds_clear(action);
-                ds_clear(match);
-
-                ds_put_format(match, "%s && %s.dst == %s", lb->proto, ip_match,
-                                     lb->hairpin_snat_ip
-                                     ? lb->hairpin_snat_ip
-                                     : lb_vip->vip_str);
-                ds_put_cstr(action, "ct_lb_mark;");
-
-                ovn_lflow_add(lflows, od, S_SWITCH_IN_PRE_STATEFUL, 105,
-                              ds_cstr(match), ds_cstr(action), lflow_ref);
-            }
         }
     }
 }
@@ -8717,7 +8814,8 @@ build_lb_health_check_response_lflows(
     const struct ovn_datapaths *lr_datapaths,
     const struct shash *meter_groups,
     struct ds *match,
-    struct ds *action)
+    struct ds *action,
+    struct lflow_ref *lflow_ref)
 {
     /* For each LB backend that is monitored by a source_ip belonging
      * to a real LRP, install rule that punts service check replies to the
@@ -8798,83 +8896,82 @@ build_lb_health_check_response_lflows(
                                                meter_groups);
             ovn_lflow_add(lflows, peer_switch_od, S_SWITCH_IN_L2_LKUP, 110,
                           ds_cstr(match), "handle_svc_check(inport);",
-                          lb_dps->lflow_ref, WITH_CTRL_METER(meter));
+                          lflow_ref, WITH_CTRL_METER(meter));
         }
     }
 }
 
 static void
 build_lb_rules(struct lflow_table *lflows, struct ovn_lb_datapaths *lb_dps,
+               struct ovn_lb_vip *lb_vip,
+               const struct ovn_northd_lb_vip *lb_vip_nb,
                const struct ovn_datapaths *ls_datapaths,
                struct ds *match, struct ds *action,
                const struct shash *meter_groups,
-               const struct svc_monitors_map_data *svc_mons_data)
+               const struct svc_monitors_map_data *svc_mons_data,
+               struct lflow_ref *lflow_ref)
 {
     const struct ovn_northd_lb *lb = lb_dps->lb;
-    for (size_t i = 0; i < lb->n_vips; i++) {
-        struct ovn_lb_vip *lb_vip = &lb->vips[i];
-        struct ovn_northd_lb_vip *lb_vip_nb = &lb->vips_nb[i];
-        const char *ip_match =
-            lb_vip->address_family == AF_INET ? "ip4" : "ip6";
+    const char *ip_match =
+        lb_vip->address_family == AF_INET ? "ip4" : "ip6";
 
-        ds_clear(action);
-        ds_clear(match);
+    ds_clear(action);
+    ds_clear(match);
 
-        /* New connections in Ingress table. */
-        const char *meter = NULL;
-        bool reject = build_lb_vip_actions(lb, lb_vip, lb_vip_nb, action,
-                                           lb->selection_fields,
-                                           NULL, NULL,
-                                           svc_mons_data, true);
+    /* New connections in Ingress table. */
+    const char *meter = NULL;
+    bool reject = build_lb_vip_actions(lb, lb_vip, lb_vip_nb, action,
+                                       lb->selection_fields,
+                                       NULL, NULL,
+                                       svc_mons_data, true);
 
-        ds_put_format(match, "ct.new && %s.dst == %s", ip_match,
-                      lb_vip->vip_str);
-        int priority = 110;
-        if (lb_vip->port_str) {
-            ds_put_format(match, " && "REG_CT_PROTO" == %s && "REG_CT_TP_DST
-                          " == %s", get_protocol_number_str(lb->proto),
-                          lb_vip->port_str);
-            priority = 120;
-        }
+    ds_put_format(match, "ct.new && %s.dst == %s", ip_match,
+                  lb_vip->vip_str);
+    int priority = 110;
+    if (lb_vip->port_str) {
+        ds_put_format(match, " && "REG_CT_PROTO" == %s && "REG_CT_TP_DST
+                      " == %s", get_protocol_number_str(lb->proto),
+                      lb_vip->port_str);
+        priority = 120;
+    }
 
-        build_lb_affinity_ls_flows(lflows, lb_dps, lb_vip, ls_datapaths,
-                                   lb_dps->lflow_ref);
+    build_lb_affinity_ls_flows(lflows, lb_dps, lb_vip, ls_datapaths,
+                               lflow_ref);
 
-        unsigned long *dp_non_meter = NULL;
-        bool build_non_meter = false;
-        if (reject) {
-            size_t index;
+    unsigned long *dp_non_meter = NULL;
+    bool build_non_meter = false;
+    if (reject) {
+        size_t index;
 
-            dp_non_meter = dynamic_bitmap_clone_map(&lb_dps->nb_ls_map);
-            DYNAMIC_BITMAP_FOR_EACH_1 (index, &lb_dps->nb_ls_map) {
-                struct ovn_datapath *od = sparse_array_get(&ls_datapaths->dps,
-                                                           index);
+        dp_non_meter = dynamic_bitmap_clone_map(&lb_dps->nb_ls_map);
+        DYNAMIC_BITMAP_FOR_EACH_1 (index, &lb_dps->nb_ls_map) {
+            struct ovn_datapath *od = sparse_array_get(&ls_datapaths->dps,
+                                                       index);
 
-                meter = copp_meter_get(COPP_REJECT, od->nbs->copp,
-                                       meter_groups);
-                if (!meter) {
-                    build_non_meter = true;
-                    continue;
-                }
-                bitmap_set0(dp_non_meter, index);
-                ovn_lflow_add(lflows, od, S_SWITCH_IN_LB, priority,
-                              ds_cstr(match), ds_cstr(action),
-                              lb_dps->lflow_ref, WITH_CTRL_METER(meter),
-                              WITH_HINT(&lb->nlb->header_));
+            meter = copp_meter_get(COPP_REJECT, od->nbs->copp,
+                                   meter_groups);
+            if (!meter) {
+                build_non_meter = true;
+                continue;
             }
+            bitmap_set0(dp_non_meter, index);
+            ovn_lflow_add(lflows, od, S_SWITCH_IN_LB, priority,
+                          ds_cstr(match), ds_cstr(action),
+                          lflow_ref, WITH_CTRL_METER(meter),
+                          WITH_HINT(&lb->nlb->header_));
         }
-        if (!reject || build_non_meter) {
-            ovn_lflow_add_with_dp_group(lflows,
-                                        dp_non_meter
-                                            ? dp_non_meter
-                                            : lb_dps->nb_ls_map.map,
-                                        ods_size(ls_datapaths), S_SWITCH_IN_LB,
-                                        priority, ds_cstr(match),
-                                        ds_cstr(action), lb_dps->lflow_ref,
-                                        WITH_HINT(&lb->nlb->header_));
-        }
-        bitmap_free(dp_non_meter);
     }
+    if (!reject || build_non_meter) {
+        ovn_lflow_add_with_dp_group(lflows,
+                                    dp_non_meter
+                                        ? dp_non_meter
+                                        : lb_dps->nb_ls_map.map,
+                                    ods_size(ls_datapaths), S_SWITCH_IN_LB,
+                                    priority, ds_cstr(match),
+                                    ds_cstr(action), lflow_ref,
+                                    WITH_HINT(&lb->nlb->header_));
+    }
+    bitmap_free(dp_non_meter);
 }
 
 static void
@@ -12110,7 +12207,7 @@ parsed_route_add(const struct ovn_datapath *od,
     }
 }
 
-static void
+static struct parsed_route *
 parsed_routes_add_static(const struct ovn_datapath *od,
                          const struct hmap *lr_ports,
                          const struct nbrec_logical_router_static_route *route,
@@ -12131,7 +12228,7 @@ parsed_routes_add_static(const struct ovn_datapath *od,
                          UUID_FMT, route->nexthop,
                          UUID_ARGS(&route->header_.uuid));
             free(nexthop);
-            return;
+            return NULL;
         }
         if ((IN6_IS_ADDR_V4MAPPED(nexthop) && plen != 32) ||
             (!IN6_IS_ADDR_V4MAPPED(nexthop) && plen != 128)) {
@@ -12140,7 +12237,7 @@ parsed_routes_add_static(const struct ovn_datapath *od,
                          UUID_FMT, route->nexthop,
                          UUID_ARGS(&route->header_.uuid));
             free(nexthop);
-            return;
+            return NULL;
         }
     }
 
@@ -12152,7 +12249,7 @@ parsed_routes_add_static(const struct ovn_datapath *od,
                      UUID_FMT, route->ip_prefix,
                      UUID_ARGS(&route->header_.uuid));
         free(nexthop);
-        return;
+        return NULL;
     }
 
     /* Verify that ip_prefix and nexthop are on the same network. */
@@ -12163,7 +12260,7 @@ parsed_routes_add_static(const struct ovn_datapath *od,
                                    IN6_IS_ADDR_V4MAPPED(&prefix),
                                    &lrp_addr_s, &out_port)) {
         free(nexthop);
-        return;
+        return NULL;
     }
 
     const struct nbrec_bfd *nb_bt = route->bfd;
@@ -12173,7 +12270,7 @@ parsed_routes_add_static(const struct ovn_datapath *od,
                                                   nb_bt->dst_ip);
         if (!bfd_e) {
             free(nexthop);
-            return;
+            return NULL;
         }
 
         /* This static route is linked to an active bfd session. */
@@ -12193,7 +12290,7 @@ parsed_routes_add_static(const struct ovn_datapath *od,
 
         if (!strcmp(bfd_sr->status, "down")) {
             free(nexthop);
-            return;
+            return NULL;
         }
     }
 
@@ -12230,11 +12327,13 @@ parsed_routes_add_static(const struct ovn_datapath *od,
         source = ROUTE_SOURCE_STATIC;
     }
 
-    parsed_route_add(od, nexthop, &prefix, plen, is_discard_route, lrp_addr_s,
-                     out_port, route_table_id, is_src_route,
-                     ecmp_symmetric_reply, &ecmp_selection_fields, source,
-                     &route->header_, NULL, routes);
+    struct parsed_route *pr =
+        parsed_route_add(od, nexthop, &prefix, plen, is_discard_route,
+                         lrp_addr_s, out_port, route_table_id, is_src_route,
+                         ecmp_symmetric_reply, &ecmp_selection_fields, source,
+                         &route->header_, NULL, routes);
     sset_destroy(&ecmp_selection_fields);
+    return pr;
 }
 
 static void
@@ -12299,6 +12398,120 @@ build_parsed_routes(const struct ovn_datapath *od, const struct hmap *lr_ports,
     }
 }
 
+/* Returns true if adding or deleting the static 'route' can be handled
+ * incrementally. */
+static bool
+static_route_change_can_be_handled(
+    const struct nbrec_logical_router_static_route *route)
+{
+    /* Route table ids depend on the order in which all the routes are
+     * parsed. */
+    if (route->route_table && route->route_table[0]) {
+        return false;
+    }
+
+    /* Routes linked to a BFD session update the active BFD connections. */
+    if (route->bfd) {
+        return false;
+    }
+
+    /* IPv6 next hops are also resolved by router wide ARP request flows,
+     * see build_arp_request_flows_for_lrouter(). */
+    struct in6_addr gw_ip6;
+    unsigned int plen;
+    char *error = ipv6_parse_cidr(route->nexthop, &gw_ip6, &plen);
+    if (!error && plen == 128) {
+        return false;
+    }
+    free(error);
+
+    return true;
+}
+
+/* Incrementally updates 'data' for the static routes added to or deleted
+ * from the logical routers in 'trk_route_lrs'.  The changed routes are
+ * stored in 'data->trk_data'.
+ *
+ * Returns false if the changes can't be handled incrementally. */
+bool
+routes_handle_static_route_changes(
+    const struct nbrec_logical_router_static_route_table *nb_route_table,
+    const struct hmapx *trk_route_lrs, const struct hmap *lr_ports,
+    const struct hmap *bfd_connections, struct routes_data *data)
+{
+    struct hmapx added_routes = HMAPX_INITIALIZER(&added_routes);
+    struct hmapx deleted_routes = HMAPX_INITIALIZER(&deleted_routes);
+    const struct nbrec_logical_router_static_route *route;
+    bool handled = false;
+
+    NBREC_LOGICAL_ROUTER_STATIC_ROUTE_TABLE_FOR_EACH_TRACKED (route,
+                                                              nb_route_table) {
+        bool is_new = nbrec_logical_router_static_route_is_new(route);
+        bool is_deleted = nbrec_logical_router_static_route_is_deleted(route);
+
+        if (is_new && is_deleted) {
+            continue;
+        }
+
+        /* Updates of existing routes are not handled incrementally. */
+        if (!is_new && !is_deleted) {
+            goto out;
+        }
+
+        if (!static_route_change_can_be_handled(route)) {
+            goto out;
+        }
+
+        hmapx_add(is_new ? &added_routes : &deleted_routes,
+                  CONST_CAST(struct ovsdb_idl_row *, &route->header_));
+    }
+
+    data->tracked = true;
+
+    struct hmapx_node *hmapx_node;
+    HMAPX_FOR_EACH (hmapx_node, trk_route_lrs) {
+        const struct ovn_datapath *od = hmapx_node->data;
+        struct parsed_route *pr;
+
+        if (!hmapx_is_empty(&deleted_routes)) {
+            HMAP_FOR_EACH_WITH_HASH (pr, key_node, uuid_hash(&od->key),
+                                     &data->parsed_routes) {
+                if (pr->od == od &&
+                    hmapx_contains(&deleted_routes, pr->source_hint)) {
+                    hmapx_add(&data->trk_data.trk_deleted_parsed_route, pr);
+                }
+            }
+        }
+
+        for (size_t i = 0; i < od->nbr->n_static_routes; i++) {
+            route = od->nbr->static_routes[i];
+            if (!hmapx_contains(&added_routes, &route->header_)) {
+                continue;
+            }
+
+            pr = parsed_routes_add_static(od, lr_ports, route,
+                                          bfd_connections,
+                                          &data->parsed_routes,
+                                          &data->route_tables,
+                                          &data->bfd_active_connections);
+            if (pr) {
+                hmapx_add(&data->trk_data.trk_created_parsed_route, pr);
+            }
+        }
+    }
+
+    HMAPX_FOR_EACH (hmapx_node, &data->trk_data.trk_deleted_parsed_route) {
+        struct parsed_route *pr = hmapx_node->data;
+        hmap_remove(&data->parsed_routes, &pr->key_node);
+    }
+    handled = true;
+
+out:
+    hmapx_destroy(&added_routes);
+    hmapx_destroy(&deleted_routes);
+    return handled;
+}
+
 static char *
 build_route_prefix_s(const struct in6_addr *prefix, unsigned int plen)
 {
@@ -13119,7 +13332,8 @@ build_lrouter_nat_flows_for_lb(
     struct lflow_table *lflows,
     struct ds *match, struct ds *action,
     const struct shash *meter_groups,
-    const struct svc_monitors_map_data *svc_mons_data)
+    const struct svc_monitors_map_data *svc_mons_data,
+    struct lflow_ref *lflow_ref)
 {
     const struct ovn_northd_lb *lb = lb_dps->lb;
     bool ipv4 = lb_vip->address_family == AF_INET;
@@ -13249,7 +13463,7 @@ build_lrouter_nat_flows_for_lb(
             struct ovn_port *dgp;
             VECTOR_FOR_EACH (&od->l3dgw_ports, dgp) {
                 build_distr_lrouter_nat_flows_for_lb(&ctx, type, od,
-                                                     lb_dps->lflow_ref, dgp,
+                                                     lflow_ref, dgp,
                                                      stateless_nat);
             }
         }
@@ -13271,18 +13485,17 @@ build_lrouter_nat_flows_for_lb(
              * it doesn't hit the established state flows in
              * S_ROUTER_IN_DNAT stage. */
             ovn_lflow_add(lflows, od, S_ROUTER_IN_UNSNAT, 120,
-                          ds_cstr(&unsnat_match), "next;", lb_dps->lflow_ref,
+                          ds_cstr(&unsnat_match), "next;", lflow_ref,
                           WITH_HINT(&lb->nlb->header_));
         }
     }
 
     for (size_t type = 0; type < LROUTER_NAT_LB_FLOW_MAX; type++) {
         build_gw_lrouter_nat_flows_for_lb(&ctx, type, lr_datapaths,
-                                          gw_dp_bitmap[type],
-                                          lb_dps->lflow_ref);
+                                          gw_dp_bitmap[type], lflow_ref);
         build_lb_affinity_lr_flows(lflows, lb, lb_vip, ds_cstr(match),
                                    aff_action[type], aff_dp_bitmap[type],
-                                   lr_datapaths, lb_dps->lflow_ref);
+                                   lr_datapaths, lflow_ref);
     }
 
     ds_destroy(&unsnat_match);
@@ -13298,33 +13511,28 @@ build_lrouter_nat_flows_for_lb(
 }
 
 static void
-build_lswitch_flows_for_lb(struct ovn_lb_datapaths *lb_dps,
-                           struct lflow_table *lflows,
-                           const struct shash *meter_groups,
-                           const struct ovn_datapaths *ls_datapaths,
-                           const struct svc_monitors_map_data *svc_mons_data,
-                           struct ds *match, struct ds *action)
+build_lswitch_flows_for_lb_vip(struct ovn_lb_datapaths *lb_dps,
+                               size_t vip_idx,
+                               struct lflow_table *lflows,
+                               const struct shash *meter_groups,
+                               const struct ovn_datapaths *ls_datapaths,
+                               const struct svc_monitors_map_data
+                                   *svc_mons_data,
+                               struct ds *match, struct ds *action,
+                               struct lflow_ref *lflow_ref)
 {
-    if (dynamic_bitmap_is_empty(&lb_dps->nb_ls_map)) {
-        return;
-    }
-
     const struct ovn_northd_lb *lb = lb_dps->lb;
-    for (size_t i = 0; i < lb->n_vips; i++) {
-        struct ovn_lb_vip *lb_vip = &lb->vips[i];
-
-        /* pre-stateful lb */
-        if (!build_empty_lb_event_flow(lb_vip, lb, match, action)) {
-            continue;
-        }
+    struct ovn_lb_vip *lb_vip = &lb->vips[vip_idx];
 
+    /* pre-stateful lb */
+    if (build_empty_lb_event_flow(lb_vip, lb, match, action)) {
         size_t index;
         DYNAMIC_BITMAP_FOR_EACH_1 (index, &lb_dps->nb_ls_map) {
             struct ovn_datapath *od = sparse_array_get(&ls_datapaths->dps,
                                                        index);
 
             ovn_lflow_add(lflows, od, S_SWITCH_IN_PRE_LB, 130, ds_cstr(match),
-                          ds_cstr(action), lb_dps->lflow_ref,
+                          ds_cstr(action), lflow_ref,
                           WITH_CTRL_METER(copp_meter_get(COPP_EVENT_ELB,
                                                          od->nbs->copp,
                                                          meter_groups)),
@@ -13342,20 +13550,45 @@ build_lswitch_flows_for_lb(struct ovn_lb_datapaths *lb_dps,
      * a higher priority rule for load balancing below also commits the
      * connection, so it is okay if we do not hit the above match on
      * REGBIT_CONNTRACK_COMMIT. */
-    build_lb_rules_pre_stateful(lflows, lb_dps, ls_datapaths, match, action);
-    build_lb_rules(lflows, lb_dps, ls_datapaths, match, action,
-                   meter_groups, svc_mons_data);
-    build_lb_rules_for_stateless_acl(lflows, lb_dps);
+    build_lb_rules_pre_stateful(lflows, lb_dps, lb_vip, ls_datapaths,
+                                match, action, lflow_ref);
+    build_lb_rules(lflows, lb_dps, lb_vip, &lb->vips_nb[vip_idx],
+                   ls_datapaths, match, action, meter_groups,
+                   svc_mons_data, lflow_ref);
 }
 
 static void
-build_lrouter_defrag_actions_for_lb_stateless(const struct ovn_northd_lb *lb,
-                                              const struct ovn_lb_vip *lb_vip,
-                                              struct ds *action)
+build_lswitch_flows_for_lb(struct ovn_lb_datapaths *lb_dps,
+                           struct lflow_table *lflows,
+                           const struct shash *meter_groups,
+                           const struct ovn_datapaths *ls_datapaths,
+                           const struct svc_monitors_map_data *svc_mons_data,
+                           struct ds *match, struct ds *action)
 {
-    ovs_assert(lb && lb_vip && action);
+    if (dynamic_bitmap_is_empty(&lb_dps->nb_ls_map)) {
+        return;
+    }
 
-    if (vector_len(&lb_vip->backends) > 1) {
+    const struct ovn_northd_lb *lb = lb_dps->lb;
+    for (size_t i = 0; i < lb->n_vips; i++) {
+        struct lflow_ref *vip_lflow_ref =
+            ovn_lb_datapaths_get_vip_lflow_ref(lb_dps, &lb->vips[i]);
+        build_lswitch_flows_for_lb_vip(lb_dps, i, lflows, meter_groups,
+                                       ls_datapaths, svc_mons_data,
+                                       match, action, vip_lflow_ref);
+    }
+
+    build_lb_rules_for_stateless_acl(lflows, lb_dps);
+}
+
+static void
+build_lrouter_defrag_actions_for_lb_stateless(const struct ovn_northd_lb *lb,
+                                              const struct ovn_lb_vip *lb_vip,
+                                              struct ds *action)
+{
+    ovs_assert(lb && lb_vip && action);
+
+    if (vector_len(&lb_vip->backends) > 1) {
         ds_put_format(action, REG_IDX_LB_STATELESS" = select(");
         if (lb->selection_fields) {
             ds_put_format(action, "values=(");
@@ -13388,6 +13621,40 @@ build_lrouter_defrag_actions_for_lb_stateless(const struct ovn_northd_lb *lb,
  * If load balancer is stateless, conntrack must not be used.
  * A hash is calculated then to select the backend.
  */
+static void
+build_lrouter_defrag_flows_for_lb_vip(struct ovn_lb_datapaths *lb_dps,
+                                      const struct ovn_lb_vip *lb_vip,
+                                      struct lflow_table *lflows,
+                                      const struct ovn_datapaths *lr_datapaths,
+                                      struct ds *match,
+                                      struct lflow_ref *lflow_ref)
+{
+    struct ds action = DS_EMPTY_INITIALIZER;
+    bool ipv6 = lb_vip->address_family == AF_INET6;
+    int prio = 100;
+
+    const struct ovn_stage *stage;
+    ds_clear(match);
+    ds_put_format(match, "ip && ip%c.dst == %s", ipv6 ? '6' : '4',
+                  lb_vip->vip_str);
+    if (lb_dps->lb->use_stateless_nat) {
+        stage = S_ROUTER_IN_CT_EXTRACT;
+        prio = 120;
+        build_lrouter_defrag_actions_for_lb_stateless(lb_dps->lb, lb_vip,
+                                                      &action);
+    } else {
+        stage = S_ROUTER_IN_DEFRAG;
+        ds_put_format(&action, "ct_dnat;");
+    }
+
+    ovn_lflow_add_with_dp_group(lflows, lb_dps->nb_lr_map.map,
+                                ods_size(lr_datapaths), stage,
+                                prio, ds_cstr(match), ds_cstr(&action),
+                                lflow_ref,
+                                WITH_HINT(&lb_dps->lb->nlb->header_));
+    ds_destroy(&action);
+}
+
 static void
 build_lrouter_defrag_flows_for_lb(struct ovn_lb_datapaths *lb_dps,
                                   struct lflow_table *lflows,
@@ -13398,34 +13665,12 @@ build_lrouter_defrag_flows_for_lb(struct ovn_lb_datapaths *lb_dps,
         return;
     }
 
-    struct ds action = DS_EMPTY_INITIALIZER;
     for (size_t i = 0; i < lb_dps->lb->n_vips; i++) {
         struct ovn_lb_vip *lb_vip = &lb_dps->lb->vips[i];
-        bool ipv6 = lb_vip->address_family == AF_INET6;
-        int prio = 100;
-
-        const struct ovn_stage *stage;
-        ds_clear(match);
-        ds_put_format(match, "ip && ip%c.dst == %s", ipv6 ? '6' : '4',
-                      lb_vip->vip_str);
-        if (lb_dps->lb->use_stateless_nat) {
-            stage = S_ROUTER_IN_CT_EXTRACT;
-            prio = 120;
-            build_lrouter_defrag_actions_for_lb_stateless(lb_dps->lb, lb_vip,
-                                                          &action);
-        } else {
-            stage = S_ROUTER_IN_DEFRAG;
-            ds_put_format(&action, "ct_dnat;");
-        }
-
-        ovn_lflow_add_with_dp_group(lflows, lb_dps->nb_lr_map.map,
-                                    ods_size(lr_datapaths), stage,
-                                    prio, ds_cstr(match), ds_cstr(&action),
-                                    lb_dps->lflow_ref,
-                                    WITH_HINT(&lb_dps->lb->nlb->header_));
-        ds_clear(&action);
+        build_lrouter_defrag_flows_for_lb_vip(
+            lb_dps, lb_vip, lflows, lr_datapaths, match,
+            ovn_lb_datapaths_get_vip_lflow_ref(lb_dps, lb_vip));
     }
-    ds_destroy(&action);
 }
 
 static void
@@ -13433,7 +13678,8 @@ build_lrouter_allow_vip_traffic_template(struct lflow_table *lflows,
                                          struct ovn_lb_datapaths *lb_dps,
                                          struct ovn_lb_vip *lb_vip,
                                          const struct ovn_northd_lb *lb,
-                                         const struct ovn_datapaths *lr_dps)
+                                         const struct ovn_datapaths *lr_dps,
+                                         struct lflow_ref *lflow_ref)
 {
     if (!lb_vip->template_vips) {
         return;
@@ -13450,13 +13696,58 @@ build_lrouter_allow_vip_traffic_template(struct lflow_table *lflows,
                       lb_vip->address_family == AF_INET ? 4 : 6,
                       lb_vip->vip_str);
         ovn_lflow_add(lflows, od, S_ROUTER_IN_IP_INPUT, 100, ds_cstr(&match),
-                      "next;", lb_dps->lflow_ref,
+                      "next;", lflow_ref,
                       WITH_HINT(&lb->nlb->header_));
     }
 
     ds_destroy(&match);
 }
 
+static void
+build_lrouter_flows_for_lb_vip(struct ovn_lb_datapaths *lb_dps,
+                               size_t vip_idx,
+                               struct lflow_table *lflows,
+                               const struct shash *meter_groups,
+                               const struct ovn_datapaths *lr_datapaths,
+                               const struct lr_stateful_table
+                                   *lr_stateful_table,
+                               const struct svc_monitors_map_data
+                                   *svc_mons_data,
+                               struct ds *match, struct ds *action,
+                               struct lflow_ref *lflow_ref)
+{
+    const struct ovn_northd_lb *lb = lb_dps->lb;
+    struct ovn_lb_vip *lb_vip = &lb->vips[vip_idx];
+
+    build_lrouter_nat_flows_for_lb(lb_vip, lb_dps, &lb->vips_nb[vip_idx],
+                                   lr_datapaths, lr_stateful_table, lflows,
+                                   match, action, meter_groups,
+                                   svc_mons_data, lflow_ref);
+
+    build_lrouter_allow_vip_traffic_template(lflows, lb_dps, lb_vip, lb,
+                                             lr_datapaths, lflow_ref);
+
+    build_lb_health_check_response_lflows(
+        lflows, lb, lb_vip, &lb->vips_nb[vip_idx], lb_dps, lr_datapaths,
+        meter_groups, match, action, lflow_ref);
+
+    if (!build_empty_lb_event_flow(lb_vip, lb, match, action)) {
+        return;
+    }
+
+    size_t index;
+    DYNAMIC_BITMAP_FOR_EACH_1 (index, &lb_dps->nb_lr_map) {
+        struct ovn_datapath *od = sparse_array_get(&lr_datapaths->dps,
+                                                   index);
+        ovn_lflow_add(lflows, od, S_ROUTER_IN_DNAT, 130, ds_cstr(match),
+                      ds_cstr(action), lflow_ref,
+                      WITH_CTRL_METER(copp_meter_get(COPP_EVENT_ELB,
+                                                     od->nbr->copp,
+                                                     meter_groups)),
+                      WITH_HINT(&lb->nlb->header_));
+    }
+}
+
 static void
 build_lrouter_flows_for_lb(struct ovn_lb_datapaths *lb_dps,
                            struct lflow_table *lflows,
@@ -13474,34 +13765,12 @@ build_lrouter_flows_for_lb(struct ovn_lb_datapaths *lb_dps,
 
     const struct ovn_northd_lb *lb = lb_dps->lb;
     for (size_t i = 0; i < lb->n_vips; i++) {
-        struct ovn_lb_vip *lb_vip = &lb->vips[i];
-
-        build_lrouter_nat_flows_for_lb(lb_vip, lb_dps, &lb->vips_nb[i],
-                                       lr_datapaths, lr_stateful_table, lflows,
-                                       match, action, meter_groups,
-                                       svc_mons_data);
-
-        build_lrouter_allow_vip_traffic_template(lflows, lb_dps, lb_vip, lb,
-                                                 lr_datapaths);
-
-        build_lb_health_check_response_lflows(
-            lflows, lb, lb_vip, &lb->vips_nb[i], lb_dps, lr_datapaths,
-            meter_groups, match, action);
-
-        if (!build_empty_lb_event_flow(lb_vip, lb, match, action)) {
-            continue;
-        }
-
-        DYNAMIC_BITMAP_FOR_EACH_1 (index, &lb_dps->nb_lr_map) {
-            struct ovn_datapath *od = sparse_array_get(&lr_datapaths->dps,
-                                                       index);
-            ovn_lflow_add(lflows, od, S_ROUTER_IN_DNAT, 130, ds_cstr(match),
-                          ds_cstr(action), lb_dps->lflow_ref,
-                          WITH_CTRL_METER(copp_meter_get(COPP_EVENT_ELB,
-                                                         od->nbr->copp,
-                                                         meter_groups)),
-                          WITH_HINT(&lb->nlb->header_));
-        }
+        struct lflow_ref *vip_lflow_ref =
+            ovn_lb_datapaths_get_vip_lflow_ref(lb_dps, &lb->vips[i]);
+        build_lrouter_flows_for_lb_vip(lb_dps, i, lflows, meter_groups,
+                                       lr_datapaths, lr_stateful_table,
+                                       svc_mons_data, match, action,
+                                       vip_lflow_ref);
     }
 
     if (lb->skip_snat) {
@@ -13515,6 +13784,40 @@ build_lrouter_flows_for_lb(struct ovn_lb_datapaths *lb_dps,
     }
 }
 
+/* Builds the logical flows of the 'vip_idx'th VIP of 'lb_dps', referenced by
+ * the VIP's own lflow_ref, on all the datapaths the load balancer is
+ * applied to. */
+static void
+build_lb_vip_flows(struct ovn_lb_datapaths *lb_dps, size_t vip_idx,
+                   struct lflow_table *lflows,
+                   const struct shash *meter_groups,
+                   const struct ovn_datapaths *ls_datapaths,
+                   const struct ovn_datapaths *lr_datapaths,
+                   const struct lr_stateful_table *lr_stateful_table,
+                   const struct svc_monitors_map_data *svc_mons_data,
+                   struct ds *match, struct ds *action)
+{
+    struct ovn_lb_vip *lb_vip = &lb_dps->lb->vips[vip_idx];
+    struct lflow_ref *vip_lflow_ref =
+        ovn_lb_datapaths_get_vip_lflow_ref(lb_dps, lb_vip);
+
+    if (!dynamic_bitmap_is_empty(&lb_dps->nb_lr_map)) {
+        build_lrouter_defrag_flows_for_lb_vip(lb_dps, lb_vip, lflows,
+                                              lr_datapaths, match,
+                                              vip_lflow_ref);
+        build_lrouter_flows_for_lb_vip(lb_dps, vip_idx, lflows, meter_groups,
+                                       lr_datapaths, lr_stateful_table,
+                                       svc_mons_data, match, action,
+                                       vip_lflow_ref);
+    }
+
+    if (!dynamic_bitmap_is_empty(&lb_dps->nb_ls_map)) {
+        build_lswitch_flows_for_lb_vip(lb_dps, vip_idx, lflows, meter_groups,
+                                       ls_datapaths, svc_mons_data,
+                                       match, action, vip_lflow_ref);
+    }
+}
+
 #define ND_RA_MAX_INTERVAL_MAX 1800
 #define ND_RA_MAX_INTERVAL_MIN 4
 
@@ -14829,10 +15132,9 @@ build_default_route_flows_for_lrouter(
 }
 
 void
-build_route_data_flows_for_lrouter(
+build_ecmp_route_data_flows_for_lrouter(
         const struct ovn_datapath *od, struct lflow_table *lflows,
-        const struct group_ecmp_datapath *route_node,
-        const struct sset *bfd_ports)
+        const struct group_ecmp_datapath *route_node)
 {
     struct ecmp_groups_node *group;
     HMAP_FOR_EACH (group, hmap_node, &route_node->ecmp_groups) {
@@ -14852,10 +15154,28 @@ build_route_data_flows_for_lrouter(
                                   route_node->lflow_ref, "sctp");
         }
     }
+}
+
+void
+build_unique_route_data_flows(struct lflow_table *lflows,
+                              const struct unique_routes_node *ur,
+                              const struct sset *bfd_ports)
+{
+    build_route_flow(lflows, ur->route->od, ur->route, bfd_ports,
+                     ur->lflow_ref);
+}
+
+void
+build_route_data_flows_for_lrouter(
+        const struct ovn_datapath *od, struct lflow_table *lflows,
+        const struct group_ecmp_datapath *route_node,
+        const struct sset *bfd_ports)
+{
+    build_ecmp_route_data_flows_for_lrouter(od, lflows, route_node);
+
     const struct unique_routes_node *ur;
     HMAP_FOR_EACH (ur, hmap_node, &route_node->unique_routes) {
-        build_route_flow(lflows, od, ur->route, bfd_ports,
-                         route_node->lflow_ref);
+        build_unique_route_data_flows(lflows, ur, bfd_ports);
     }
 }
 
@@ -15055,6 +15375,129 @@ policy_chain_add(struct simap *chain_ids, const char *chain_name)
     }
 }
 
+static void
+route_policy_free(struct route_policy *rp)
+{
+    if (!rp) {
+        return;
+    }
+
+    if (rp->lflow_ref) {
+        lflow_ref_destroy(rp->lflow_ref);
+    }
+    free(rp->valid_nexthops);
+    free(rp);
+}
+
+/* Parses the logical router policy 'rule' of the router 'od'.  Returns a
+ * newly allocated 'struct route_policy' or NULL if the policy should be
+ * skipped. */
+static struct route_policy *
+route_policy_create(struct ovn_datapath *od, const struct hmap *lr_ports,
+                    const struct nbrec_logical_router_policy *rule,
+                    const struct hmap *bfd_connections,
+                    struct hmap *bfd_active_connections,
+                    struct simap *chain_ids)
+{
+    if (rule->nexthop && rule->nexthop[0]) {
+        static struct vlog_rate_limit rl = VLOG_RATE_LIMIT_INIT(1, 1);
+        VLOG_WARN_RL(&rl, "Logical router: %s, policy uses deprecated"
+                     " column \"nexthop\", this column is ignored. Please"
+                     "use \"nexthops\" column instead.", od->nbr->name);
+        return NULL;
+    }
+
+    size_t n_valid_nexthops = 0;
+    char **valid_nexthops = NULL;
+    uint32_t chain_id = 0;
+    uint32_t jump_chain_id = 0;
+
+    /* Skip policy if chain name is set but id was not created above */
+    if (policy_chain_id(chain_ids, rule->chain, &chain_id)
+        && chain_id == 0) {
+        return NULL;
+    }
+
+    if (!strcmp(rule->action, "jump")) {
+        /* Skip policy if action is 'jump' but no target chain is set */
+        if (!policy_chain_id(chain_ids, rule->jump_chain,
+                             &jump_chain_id)) {
+            static struct vlog_rate_limit rl = VLOG_RATE_LIMIT_INIT(5, 1);
+            VLOG_WARN_RL(&rl,
+                     "Logical router: %s, policy action 'jump'"
+                     " has empty target",
+                     od->nbr->name);
+            return NULL;
+        }
+
+        /* Skip policy if action is 'jump' but target chain name
+           is not resolved to numeric id */
+        if (jump_chain_id == 0) {
+            static struct vlog_rate_limit rl = VLOG_RATE_LIMIT_INIT(5, 1);
+            VLOG_WARN_RL(&rl,
+                     "Logical router: %s, policy action 'jump'"
+                     " follows to non-existent chain %s",
+                     od->nbr->name, rule->jump_chain);
+            return NULL;
+        }
+    }
+
+    if (simap_is_empty(chain_ids)) {
+        chain_id = -1;
+    }
+
+    if (!strcmp(rule->action, "reroute")) {
+        if (rule->output_port && rule->n_nexthops != 1) {
+            static struct vlog_rate_limit rl = VLOG_RATE_LIMIT_INIT(5, 1);
+            VLOG_WARN_RL(&rl,
+                         "Logical router: %s, policy "
+                         "(chain: '%s', match: '%s', priority %"PRId64"): "
+                         "output_port only supported on non-ECMP "
+                         "reroute policies",
+                         od->nbr->name,
+                         rule->chain ? rule->chain : "<Default>",
+                         rule->match, rule->priority);
+            return NULL;
+        }
+
+        valid_nexthops = xcalloc(rule->n_nexthops, sizeof *valid_nexthops);
+        for (size_t j = 0; j < rule->n_nexthops; j++) {
+            char *nexthop = rule->nexthops[j];
+            if (!nexthop || !nexthop[0]) {
+                continue;
+            }
+
+            struct ovn_port *out_port = NULL;
+            bool is_ipv4 = strchr(nexthop, '.') ? true : false;
+
+            if (!find_policy_outport(od, lr_ports, rule, nexthop, is_ipv4,
+                                     NULL, &out_port)) {
+                continue;
+            }
+            if (!check_bfd_state(rule, out_port, nexthop,
+                                 bfd_connections,
+                                 bfd_active_connections)) {
+                continue;
+            }
+            valid_nexthops[n_valid_nexthops++] = nexthop;
+        }
+
+        if (!n_valid_nexthops) {
+            free(valid_nexthops);
+            return NULL;
+        }
+    }
+
+    struct route_policy *new_rp = xzalloc(sizeof *new_rp);
+    new_rp->rule = rule;
+    new_rp->n_valid_nexthops = n_valid_nexthops;
+    new_rp->valid_nexthops = valid_nexthops;
+    new_rp->nbr = od->nbr;
+    new_rp->chain_id = chain_id;
+    new_rp->jump_chain_id = jump_chain_id;
+    return new_rp;
+}
+
 void
 build_route_policies(struct ovn_datapath *od, const struct hmap *lr_ports,
                      const struct hmap *bfd_connections,
@@ -15082,124 +15525,149 @@ build_route_policies(struct ovn_datapath *od, const struct hmap *lr_ports,
 
     for (int i = 0; i < od->nbr->n_policies; i++) {
         const struct nbrec_logical_router_policy *rule = od->nbr->policies[i];
-
-        if (rule->nexthop && rule->nexthop[0]) {
-            static struct vlog_rate_limit rl = VLOG_RATE_LIMIT_INIT(1, 1);
-            VLOG_WARN_RL(&rl, "Logical router: %s, policy uses deprecated"
-                         " column \"nexthop\", this column is ignored. Please"
-                         "use \"nexthops\" column instead.", od->nbr->name);
+        struct route_policy *new_rp =
+            route_policy_create(od, lr_ports, rule, bfd_connections,
+                                bfd_active_connections, chain_ids);
+        if (!new_rp) {
             continue;
         }
 
-        size_t n_valid_nexthops = 0;
-        char **valid_nexthops = NULL;
-        uint32_t chain_id = 0;
-        uint32_t jump_chain_id = 0;
+        size_t hash = uuid_hash(&od->key);
+        rp = route_policies_lookup(route_policies, hash, new_rp);
+        if (!rp) {
+            new_rp->lflow_ref = lflow_ref_create();
+            hmap_insert(route_policies, &new_rp->key_node, hash);
+        } else {
+            rp->stale = false;
+            route_policy_free(new_rp);
+        }
+    }
 
-        /* Skip policy if chain name is set but id was not created above */
-        if (policy_chain_id(chain_ids, rule->chain, &chain_id)
-            && chain_id == 0) {
+    HMAP_FOR_EACH_SAFE (rp, key_node, route_policies) {
+        if (!rp->stale) {
             continue;
         }
 
-        if (!strcmp(rule->action, "jump")) {
-            /* Skip policy if action is 'jump' but no target chain is set */
-            if (!policy_chain_id(chain_ids, rule->jump_chain,
-                                 &jump_chain_id)) {
-                static struct vlog_rate_limit rl = VLOG_RATE_LIMIT_INIT(5, 1);
-                VLOG_WARN_RL(&rl,
-                         "Logical router: %s, policy action 'jump'"
-                         " has empty target",
-                         od->nbr->name);
-                continue;
-            }
+        hmap_remove(route_policies, &rp->key_node);
+        route_policy_free(rp);
+    }
+}
 
-            /* Skip policy if action is 'jump' but target chain name
-               is not resolved to numeric id */
-            if (jump_chain_id == 0) {
-                static struct vlog_rate_limit rl = VLOG_RATE_LIMIT_INIT(5, 1);
-                VLOG_WARN_RL(&rl,
-                         "Logical router: %s, policy action 'jump'"
-                         " follows to non-existent chain %s",
-                         od->nbr->name, rule->jump_chain);
-                continue;
-            }
+/* Returns true if adding or deleting the logical router policy 'rule' can
+ * be handled incrementally. */
+static bool
+route_policy_change_can_be_handled(
+    const struct nbrec_logical_router_policy *rule)
+{
+    /* Policy chain ids depend on the order in which all the policies are
+     * parsed. */
+    if ((rule->chain && rule->chain[0]) ||
+        (rule->jump_chain && rule->jump_chain[0])) {
+        return false;
+    }
+
+    /* Policies linked to BFD sessions update the active BFD connections. */
+    if (rule->n_bfd_sessions) {
+        return false;
+    }
+
+    /* ECMP reroute policies are numbered per logical router. */
+    if (!strcmp(rule->action, "reroute") && rule->n_nexthops > 1) {
+        return false;
+    }
+
+    return true;
+}
+
+/* Incrementally updates 'data' for the logical router policies added to or
+ * deleted from the logical routers in 'trk_policy_lrs'.  The changes are
+ * stored in 'data->trk_data'.
+ *
+ * Returns false if the changes can't be handled incrementally. */
+bool
+route_policies_handle_changes(
+    const struct nbrec_logical_router_policy_table *nb_policy_table,
+    const struct hmapx *trk_policy_lrs, const struct hmap *lr_ports,
+    const struct hmap *bfd_connections, struct route_policies_data *data)
+{
+    struct hmapx added_rules = HMAPX_INITIALIZER(&added_rules);
+    struct hmapx deleted_rules = HMAPX_INITIALIZER(&deleted_rules);
+    const struct nbrec_logical_router_policy *rule;
+    bool handled = false;
+
+    NBREC_LOGICAL_ROUTER_POLICY_TABLE_FOR_EACH_TRACKED (rule,
+                                                        nb_policy_table) {
+        bool is_new = nbrec_logical_router_policy_is_new(rule);
+        bool is_deleted = nbrec_logical_router_policy_is_deleted(rule);
+
+        if (is_new && is_deleted) {
+            continue;
         }
 
-        if (simap_is_empty(chain_ids)) {
-            chain_id = -1;
+        /* Updates of existing policies are not handled incrementally. */
+        if (!is_new && !is_deleted) {
+            goto out;
         }
 
-        if (!strcmp(rule->action, "reroute")) {
-            if (rule->output_port && rule->n_nexthops != 1) {
-                static struct vlog_rate_limit rl = VLOG_RATE_LIMIT_INIT(5, 1);
-                VLOG_WARN_RL(&rl,
-                             "Logical router: %s, policy "
-                             "(chain: '%s', match: '%s', priority %"PRId64"): "
-                             "output_port only supported on non-ECMP "
-                             "reroute policies",
-                             od->nbr->name,
-                             rule->chain ? rule->chain : "<Default>",
-                             rule->match, rule->priority);
-                continue;
-            }
+        if (!route_policy_change_can_be_handled(rule)) {
+            goto out;
+        }
 
-            valid_nexthops = xcalloc(rule->n_nexthops, sizeof *valid_nexthops);
-            for (size_t j = 0; j < rule->n_nexthops; j++) {
-                char *nexthop = rule->nexthops[j];
-                if (!nexthop || !nexthop[0]) {
-                    continue;
-                }
+        hmapx_add(is_new ? &added_rules : &deleted_rules,
+                  CONST_CAST(struct nbrec_logical_router_policy *, rule));
+    }
 
-                struct ovn_port *out_port = NULL;
-                bool is_ipv4 = strchr(nexthop, '.') ? true : false;
+    /* The policy chain ids are shared by all the logical routers, and how
+     * a policy is parsed depends on the ids allocated when its router was
+     * parsed during the last recompute. */
+    if (!simap_is_empty(&data->chain_ids)) {
+        goto out;
+    }
 
-                if (!find_policy_outport(od, lr_ports, rule, nexthop, is_ipv4,
-                                         NULL, &out_port)) {
-                    continue;
-                }
-                if (!check_bfd_state(rule, out_port, nexthop,
-                                     bfd_connections,
-                                     bfd_active_connections)) {
-                    continue;
+    data->tracked = true;
+
+    struct hmapx_node *hmapx_node;
+    HMAPX_FOR_EACH (hmapx_node, trk_policy_lrs) {
+        struct ovn_datapath *od = hmapx_node->data;
+        size_t hash = uuid_hash(&od->key);
+        struct route_policy *rp;
+
+        if (!hmapx_is_empty(&deleted_rules)) {
+            HMAP_FOR_EACH_WITH_HASH (rp, key_node, hash,
+                                     &data->route_policies) {
+                if (hmapx_contains(&deleted_rules, rp->rule)) {
+                    hmapx_add(&data->trk_data.deleted, rp);
                 }
-                valid_nexthops[n_valid_nexthops++] = nexthop;
             }
+        }
 
-            if (!n_valid_nexthops) {
-                free(valid_nexthops);
+        for (size_t i = 0; i < od->nbr->n_policies; i++) {
+            rule = od->nbr->policies[i];
+            if (!hmapx_contains(&added_rules, rule)) {
                 continue;
             }
-        }
 
-        struct route_policy *new_rp = xzalloc(sizeof *new_rp);
-        new_rp->rule = rule;
-        new_rp->n_valid_nexthops = n_valid_nexthops;
-        new_rp->valid_nexthops = valid_nexthops;
-        new_rp->nbr = od->nbr;
-        new_rp->chain_id = chain_id;
-        new_rp->jump_chain_id = jump_chain_id;
-
-        size_t hash = uuid_hash(&od->key);
-        rp = route_policies_lookup(route_policies, hash, new_rp);
-        if (!rp) {
-            hmap_insert(route_policies, &new_rp->key_node, hash);
-        } else {
-            rp->stale = false;
-            free(valid_nexthops);
-            free(new_rp);
+            rp = route_policy_create(od, lr_ports, rule, bfd_connections,
+                                     &data->bfd_active_connections,
+                                     &data->chain_ids);
+            if (rp) {
+                rp->lflow_ref = lflow_ref_create();
+                hmap_insert(&data->route_policies, &rp->key_node, hash);
+                hmapx_add(&data->trk_data.crupdated, rp);
+            }
         }
     }
 
-    HMAP_FOR_EACH_SAFE (rp, key_node, route_policies) {
-        if (!rp->stale) {
-            continue;
-        }
-
-        hmap_remove(route_policies, &rp->key_node);
-        free(rp->valid_nexthops);
-        free(rp);
+    HMAPX_FOR_EACH (hmapx_node, &data->trk_data.deleted) {
+        struct route_policy *rp = hmapx_node->data;
+        hmap_remove(&data->route_policies, &rp->key_node);
     }
+    handled = true;
+
+out:
+    hmapx_destroy(&added_rules);
+    hmapx_destroy(&deleted_rules);
+    return handled;
 }
 
 /* Logical router ingress table POLICY: Policy.
@@ -15230,7 +15698,9 @@ build_ingress_policy_flows_for_lrouter(
     ovn_lflow_add_default_drop(lflows, od, S_ROUTER_IN_POLICY_ECMP,
                                lflow_ref);
 
-    /* Convert routing policies to flows. */
+    /* Convert routing policies to flows.  The flows of each policy are
+     * tracked by the policy's own lflow_ref so that policies can be added
+     * and removed incrementally. */
     uint16_t ecmp_group_id = 1;
     struct route_policy *rp;
     HMAP_FOR_EACH_WITH_HASH (rp, key_node, uuid_hash(&od->key),
@@ -15241,11 +15711,11 @@ build_ingress_policy_flows_for_lrouter(
 
         if (is_ecmp_reroute) {
             build_ecmp_routing_policy_flows(lflows, od, lr_ports, rp,
-                                            ecmp_group_id, lflow_ref);
+                                            ecmp_group_id, rp->lflow_ref);
             ecmp_group_id++;
         } else {
             build_routing_policy_flow(lflows, od, lr_ports, rp,
-                                      &rule->header_, lflow_ref);
+                                      &rule->header_, rp->lflow_ref);
         }
     }
 }
@@ -19417,7 +19887,7 @@ build_lflows_thread(void *arg)
 
     /* Note:  lflow_ref is not thread safe.  Ensure that
      *    - op->lflow_ref
-     *    - lb_dps->lflow_ref
+     *    - lb_dps->lflow_ref and lb_dps->vip_lflow_refs
      *    - lr_stateful_rec->lflow_ref
      *    - ls_stateful_rec->lflow_ref
      * are not accessed by multiple threads at the same time. */
@@ -19967,6 +20437,7 @@ lflow_reset_northd_refs(struct lflow_input *lflow_input)
 
     HMAP_FOR_EACH (lb_dps, hmap_node, lflow_input->lb_datapaths_map) {
         lflow_ref_clear(lb_dps->lflow_ref);
+        ovn_lb_datapaths_clear_vip_lflow_refs(lb_dps);
     }
 
     HMAP_FOR_EACH (od, key_node, &lflow_input->lr_datapaths->datapaths) {
@@ -19976,6 +20447,22 @@ lflow_reset_northd_refs(struct lflow_input *lflow_input)
     HMAP_FOR_EACH (od, key_node, &lflow_input->ls_datapaths->datapaths) {
         lflow_ref_clear(od->datapath_lflows);
     }
+
+    const struct group_ecmp_datapath *route_node;
+    HMAP_FOR_EACH (route_node, hmap_node,
+                   &lflow_input->route_data->datapaths) {
+        lflow_ref_clear(route_node->lflow_ref);
+
+        const struct unique_routes_node *ur;
+        HMAP_FOR_EACH (ur, hmap_node, &route_node->unique_routes) {
+            lflow_ref_clear(ur->lflow_ref);
+        }
+    }
+
+    struct route_policy *rp;
+    HMAP_FOR_EACH (rp, key_node, lflow_input->route_policies) {
+        lflow_ref_clear(rp->lflow_ref);
+    }
 }
 
 bool
@@ -20036,6 +20523,54 @@ lflow_handle_northd_lr_changes(struct ovsdb_idl_txn *ovnsb_txn,
     return handled;
 }
 
+bool
+lflow_handle_route_policies_changes(
+    struct ovsdb_idl_txn *ovnsb_txn,
+    struct route_policies_tracked_data *trk_data,
+    struct lflow_input *lflow_input, struct lflow_table *lflows)
+{
+    struct hmapx_node *hmapx_node;
+    struct route_policy *rp;
+
+    HMAPX_FOR_EACH (hmapx_node, &trk_data->deleted) {
+        rp = hmapx_node->data;
+        if (!lflow_ref_resync_flows(
+                rp->lflow_ref, lflows, ovnsb_txn, lflow_input->dps,
+                lflow_input->ovn_internal_version_changed,
+                lflow_input->sbrec_logical_flow_table,
+                lflow_input->sbrec_logical_dp_group_table)) {
+            return false;
+        }
+    }
+
+    HMAPX_FOR_EACH (hmapx_node, &trk_data->crupdated) {
+        rp = hmapx_node->data;
+
+        struct ovn_datapath *od =
+            ovn_datapath_find_(&lflow_input->lr_datapaths->datapaths,
+                               &rp->nbr->header_.uuid);
+        if (!od) {
+            return false;
+        }
+
+        /* ECMP reroute policies are never handled incrementally, see
+         * route_policy_change_can_be_handled(). */
+        lflow_ref_unlink_lflows(rp->lflow_ref);
+        build_routing_policy_flow(lflows, od, lflow_input->lr_ports, rp,
+                                  &rp->rule->header_, rp->lflow_ref);
+
+        if (!lflow_ref_sync_lflows(
+                rp->lflow_ref, lflows, ovnsb_txn, lflow_input->dps,
+                lflow_input->ovn_internal_version_changed,
+                lflow_input->sbrec_logical_flow_table,
+                lflow_input->sbrec_logical_dp_group_table)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 bool
 lflow_handle_northd_port_changes(struct ovsdb_idl_txn *ovnsb_txn,
                                  struct tracked_ovn_ports *trk_lsps,
@@ -20191,12 +20726,87 @@ lflow_handle_northd_port_changes(struct ovsdb_idl_txn *ovnsb_txn,
     return true;
 }
 
+static bool
+lflow_lb_ref_sync(struct ovsdb_idl_txn *ovnsb_txn, struct lflow_ref *lflow_ref,
+                  struct lflow_input *lflow_input, struct lflow_table *lflows,
+                  bool resync)
+{
+    if (resync) {
+        return lflow_ref_resync_flows(
+            lflow_ref, lflows, ovnsb_txn, lflow_input->dps,
+            lflow_input->ovn_internal_version_changed,
+            lflow_input->sbrec_logical_flow_table,
+            lflow_input->sbrec_logical_dp_group_table);
+    }
+
+    return lflow_ref_sync_lflows(
+        lflow_ref, lflows, ovnsb_txn, lflow_input->dps,
+        lflow_input->ovn_internal_version_changed,
+        lflow_input->sbrec_logical_flow_table,
+        lflow_input->sbrec_logical_dp_group_table);
+}
+
+/* Regenerates the lflows of the VIPs of 'lb_dps' whose keys are in
+ * 'updated_vips' and syncs them to the SB, leaving the lflows of the other
+ * VIPs untouched. */
+static bool
+lflow_handle_lb_backends_changes(struct ovsdb_idl_txn *ovnsb_txn,
+                                 struct ovn_lb_datapaths *lb_dps,
+                                 const struct sset *updated_vips,
+                                 struct lflow_input *lflow_input,
+                                 struct svc_monitors_map_data *svc_mons_data,
+                                 struct lflow_table *lflows)
+{
+    const struct ovn_northd_lb *lb = lb_dps->lb;
+    struct ovn_lb_vip_lflow_ref *vip_ref;
+    const char *vip_key;
+
+    /* Unlink old lflows. */
+    SSET_FOR_EACH (vip_key, updated_vips) {
+        vip_ref = ovn_lb_datapaths_find_vip_lflow_ref(lb_dps, vip_key);
+        if (vip_ref) {
+            lflow_ref_unlink_lflows(vip_ref->lflow_ref);
+        }
+    }
+
+    /* Generate new lflows. */
+    struct ds match = DS_EMPTY_INITIALIZER;
+    struct ds actions = DS_EMPTY_INITIALIZER;
+
+    for (size_t i = 0; i < lb->n_vips; i++) {
+        char *key = ovn_northd_lb_vip_key(lb, &lb->vips[i]);
+        if (sset_contains(updated_vips, key)) {
+            build_lb_vip_flows(lb_dps, i, lflows, lflow_input->meter_groups,
+                               lflow_input->ls_datapaths,
+                               lflow_input->lr_datapaths,
+                               lflow_input->lr_stateful_table,
+                               svc_mons_data, &match, &actions);
+        }
+        free(key);
+    }
+
+    ds_destroy(&match);
+    ds_destroy(&actions);
+
+    /* Sync the new flows to SB. */
+    SSET_FOR_EACH (vip_key, updated_vips) {
+        vip_ref = ovn_lb_datapaths_find_vip_lflow_ref(lb_dps, vip_key);
+        if (vip_ref && !lflow_lb_ref_sync(ovnsb_txn, vip_ref->lflow_ref,
+                                          lflow_input, lflows, false)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 bool
 lflow_handle_northd_lb_changes(struct ovsdb_idl_txn *ovnsb_txn,
                                struct tracked_lbs *trk_lbs,
                                struct lflow_input *lflow_input,
                                struct lflow_table *lflows)
 {
+    struct ovn_lb_vip_lflow_ref *vip_ref;
     struct ovn_lb_datapaths *lb_dps;
     struct hmapx_node *hmapx_node;
 
@@ -20208,18 +20818,34 @@ lflow_handle_northd_lb_changes(struct ovsdb_idl_txn *ovnsb_txn,
     HMAPX_FOR_EACH (hmapx_node, &trk_lbs->deleted) {
         lb_dps = hmapx_node->data;
 
-        lflow_ref_resync_flows(
-            lb_dps->lflow_ref, lflows, ovnsb_txn, lflow_input->dps,
-            lflow_input->ovn_internal_version_changed,
-            lflow_input->sbrec_logical_flow_table,
-            lflow_input->sbrec_logical_dp_group_table);
+        lflow_lb_ref_sync(ovnsb_txn, lb_dps->lflow_ref, lflow_input, lflows,
+                          true);
+        HMAP_FOR_EACH (vip_ref, hmap_node, &lb_dps->vip_lflow_refs) {
+            lflow_lb_ref_sync(ovnsb_txn, vip_ref->lflow_ref, lflow_input,
+                              lflows, true);
+        }
     }
 
     HMAPX_FOR_EACH (hmapx_node, &trk_lbs->crupdated) {
         lb_dps = hmapx_node->data;
 
+        const struct tracked_lb_backends *trk_backends =
+            tracked_lbs_find_backends_updated(trk_lbs, lb_dps);
+        if (trk_backends) {
+            if (!lflow_handle_lb_backends_changes(ovnsb_txn, lb_dps,
+                                                  trk_backends->updated_vips,
+                                                  lflow_input, &svc_mons_data,
+                                                  lflows)) {
+                return false;
+            }
+            continue;
+        }
+
         /* unlink old lflows. */
         lflow_ref_unlink_lflows(lb_dps->lflow_ref);
+        HMAP_FOR_EACH (vip_ref, hmap_node, &lb_dps->vip_lflow_refs) {
+            lflow_ref_unlink_lflows(vip_ref->lflow_ref);
+        }
 
         /* Generate new lflows. */
         struct ds match = DS_EMPTY_INITIALIZER;
@@ -20247,11 +20873,34 @@ lflow_handle_northd_lb_changes(struct ovsdb_idl_txn *ovnsb_txn,
         ds_destroy(&actions);
 
         /* Sync the new flows to SB. */
-        bool handled = lflow_ref_sync_lflows(
-            lb_dps->lflow_ref, lflows, ovnsb_txn, lflow_input->dps,
-            lflow_input->ovn_internal_version_changed,
-            lflow_input->sbrec_logical_flow_table,
-            lflow_input->sbrec_logical_dp_group_table);
+        if (!lflow_lb_ref_sync(ovnsb_txn, lb_dps->lflow_ref, lflow_input,
+                               lflows, false)) {
+            return false;
+        }
+
+        /* The lflows of VIPs that were removed from the load balancer are
+         * all unlinked at this point, drop their references once they are
+         * synced. */
+        struct sset vip_keys = SSET_INITIALIZER(&vip_keys);
+        for (size_t i = 0; i < lb_dps->lb->n_vips; i++) {
+            sset_add_and_free(&vip_keys,
+                              ovn_northd_lb_vip_key(lb_dps->lb,
+                                                    &lb_dps->lb->vips[i]));
+        }
+
+        bool handled = true;
+        HMAP_FOR_EACH_SAFE (vip_ref, hmap_node, &lb_dps->vip_lflow_refs) {
+            if (!lflow_lb_ref_sync(ovnsb_txn, vip_ref->lflow_ref,
+                                   lflow_input, lflows, false)) {
+                handled = false;
+                break;
+            }
+            if (!sset_contains(&vip_keys, vip_ref->vip_key)) {
+                ovn_lb_datapaths_remove_vip_lflow_ref(lb_dps, vip_ref);
+            }
+        }
+        sset_destroy(&vip_keys);
+
         if (!handled) {
             return false;
         }
@@ -20848,6 +21497,22 @@ route_policies_init(struct route_policies_data *data)
     hmap_init(&data->route_policies);
     hmap_init(&data->bfd_active_connections);
     simap_init(&data->chain_ids);
+    data->tracked = false;
+    hmapx_init(&data->trk_data.crupdated);
+    hmapx_init(&data->trk_data.deleted);
+}
+
+void
+route_policies_clear_tracked_data(struct route_policies_data *data)
+{
+    hmapx_clear(&data->trk_data.crupdated);
+
+    struct hmapx_node *hmapx_node;
+    HMAPX_FOR_EACH_SAFE (hmapx_node, &data->trk_data.deleted) {
+        route_policy_free(hmapx_node->data);
+        hmapx_delete(&data->trk_data.deleted, hmapx_node);
+    }
+    data->tracked = false;
 }
 
 void
@@ -20856,6 +21521,23 @@ routes_init(struct routes_data *data)
     hmap_init(&data->parsed_routes);
     simap_init(&data->route_tables);
     hmap_init(&data->bfd_active_connections);
+    data->tracked = false;
+    hmapx_init(&data->trk_data.trk_created_parsed_route);
+    hmapx_init(&data->trk_data.trk_deleted_parsed_route);
+}
+
+void
+routes_clear_tracked_data(struct routes_data *data)
+{
+    hmapx_clear(&data->trk_data.trk_created_parsed_route);
+
+    struct hmapx_node *hmapx_node;
+    HMAPX_FOR_EACH_SAFE (hmapx_node,
+                         &data->trk_data.trk_deleted_parsed_route) {
+        parsed_route_free(hmapx_node->data);
+        hmapx_delete(&data->trk_data.trk_deleted_parsed_route, hmapx_node);
+    }
+    data->tracked = false;
 }
 
 void
@@ -20967,12 +21649,14 @@ route_policies_destroy(struct route_policies_data *data)
 {
     struct route_policy *rp;
     HMAP_FOR_EACH_POP (rp, key_node, &data->route_policies) {
-        free(rp->valid_nexthops);
-        free(rp);
+        route_policy_free(rp);
     };
     hmap_destroy(&data->route_policies);
     __bfd_destroy(&data->bfd_active_connections);
     simap_destroy(&data->chain_ids);
+    route_policies_clear_tracked_data(data);
+    hmapx_destroy(&data->trk_data.crupdated);
+    hmapx_destroy(&data->trk_data.deleted);
 }
 
 void
@@ -20986,6 +21670,9 @@ routes_destroy(struct routes_data *data)
 
     simap_destroy(&data->route_tables);
     __bfd_destroy(&data->bfd_active_connections);
+    routes_clear_tracked_data(data);
+    hmapx_destroy(&data->trk_data.trk_created_parsed_route);
+    hmapx_destroy(&data->trk_data.trk_deleted_parsed_route);
 }
 
 void
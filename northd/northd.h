@@ -148,8 +148,24 @@ struct tracked_lbs {
     /* Tracked deleted lbs.
      * hmapx node data is 'struct ovn_lb_datapaths' */
     struct hmapx deleted;
+
+    /* Subset of 'crupdated' for which only the backends of some VIPs
+     * changed.  hmap node is 'struct tracked_lb_backends'. */
+    struct hmap backends_updated;
+};
+
+struct tracked_lb_backends {
+    struct hmap_node hmap_node;
+    struct ovn_lb_datapaths *lb_dps;
+
+    /* Keys of the VIPs whose backends changed.  Owned by the en_lb_data
+     * tracked data. */
+    const struct sset *updated_vips;
 };
 
+const struct tracked_lb_backends *tracked_lbs_find_backends_updated(
+    const struct tracked_lbs *, const struct ovn_lb_datapaths *);
+
 enum northd_tracked_data_type {
     NORTHD_TRACKED_NONE,
     NORTHD_TRACKED_PORTS    = (1 << 0),
@@ -159,6 +175,8 @@ enum northd_tracked_data_type {
     NORTHD_TRACKED_LS_ACLS  = (1 << 4),
     NORTHD_TRACKED_SWITCHES = (1 << 5),
     NORTHD_TRACKED_ROUTERS  = (1 << 6),
+    NORTHD_TRACKED_LR_ROUTES = (1 << 7),
+    NORTHD_TRACKED_LR_POLICIES = (1 << 8),
 };
 
 /* Track what's changed in the northd engine node.
@@ -176,6 +194,14 @@ struct northd_tracked_data {
      * hmapx node is 'struct ovn_datapath *'. */
     struct hmapx trk_nat_lrs;
 
+    /* Tracked logical routers whose static routes have changed.
+     * hmapx node is 'struct ovn_datapath *'. */
+    struct hmapx trk_route_lrs;
+
+    /* Tracked logical routers whose routing policies have changed.
+     * hmapx node is 'struct ovn_datapath *'. */
+    struct hmapx trk_policy_lrs;
+
     /* Tracked logical switches whose load balancers have changed.
      * hmapx node is 'struct ovn_datapath *'. */
     struct hmapx ls_with_changed_lbs;
@@ -214,18 +240,58 @@ struct route_policy {
     bool stale;
     uint32_t chain_id;
     uint32_t jump_chain_id;
+
+    /* Logical flows generated for this routing policy. */
+    struct lflow_ref *lflow_ref;
+};
+
+/* Track what's changed in the routes engine node.
+ * For now only tracks routes of added or deleted static routes. */
+struct routes_tracked_data {
+    /* Tracked created routes based on new static routes.
+     * hmapx node is 'struct parsed_route *'. */
+    struct hmapx trk_created_parsed_route;
+
+    /* Tracked deleted routes based on deleted static routes.  They are no
+     * longer part of 'parsed_routes' and are freed when the tracked data
+     * is cleared.
+     * hmapx node is 'struct parsed_route *'. */
+    struct hmapx trk_deleted_parsed_route;
 };
 
 struct routes_data {
     struct hmap parsed_routes; /* Stores struct parsed_route. */
     struct simap route_tables;
     struct hmap bfd_active_connections;
+
+    /* 'tracked' is set to true if there is information available for
+     * incremental processing. If true then 'trk_data' is valid. */
+    bool tracked;
+    struct routes_tracked_data trk_data;
+};
+
+/* Track what's changed in the route policies engine node.
+ * For now only tracks added or deleted logical router policies. */
+struct route_policies_tracked_data {
+    /* Tracked created route policies.
+     * hmapx node is 'struct route_policy *'. */
+    struct hmapx crupdated;
+
+    /* Tracked deleted route policies.  They are no longer part of
+     * 'route_policies' and are freed when the tracked data is cleared.
+     * hmapx node is 'struct route_policy *'. */
+    struct hmapx deleted;
 };
 
 struct route_policies_data {
     struct hmap route_policies;
     struct hmap bfd_active_connections;
     struct simap chain_ids;
+
+    /* 'tracked' is set to true if there is information available for
+     * incremental processing. If true then 'trk_data' is valid. */
+    bool tracked;
+    struct route_policies_tracked_data trk_data;
 };
 
 struct bfd_data {
@@ -912,12 +978,22 @@ void northd_indices_create(struct northd_data *data,
 
 void route_policies_init(struct route_policies_data *);
 void route_policies_destroy(struct route_policies_data *);
+void route_policies_clear_tracked_data(struct route_policies_data *);
+bool route_policies_handle_changes(
+    const struct nbrec_logical_router_policy_table *,
+    const struct hmapx *trk_policy_lrs, const struct hmap *lr_ports,
+    const struct hmap *bfd_connections, struct route_policies_data *);
 void build_parsed_routes(const struct ovn_datapath *, const struct hmap *,
                          const struct hmap *, struct hmap *, struct simap *,
                          struct hmap *);
 uint32_t get_route_table_id(struct simap *, const char *);
 void routes_init(struct routes_data *);
 void routes_destroy(struct routes_data *);
+void routes_clear_tracked_data(struct routes_data *);
+bool routes_handle_static_route_changes(
+    const struct nbrec_logical_router_static_route_table *,
+    const struct hmapx *trk_route_lrs, const struct hmap *lr_ports,
+    const struct hmap *bfd_connections, struct routes_data *);
 
 void bfd_init(struct bfd_data *);
 void bfd_destroy(struct bfd_data *);
@@ -935,6 +1011,7 @@ struct lflow_table;
 struct lr_stateful_tracked_data;
 struct ls_stateful_tracked_data;
 struct group_ecmp_datapath;
+struct unique_routes_node;
 
 void build_lflows(struct ovsdb_idl_txn *ovnsb_txn,
                   struct lflow_input *input_data,
@@ -944,6 +1021,12 @@ void build_route_data_flows_for_lrouter(
     const struct ovn_datapath *od, struct lflow_table *lflows,
     const struct group_ecmp_datapath *route_node,
     const struct sset *bfd_ports);
+void build_ecmp_route_data_flows_for_lrouter(
+    const struct ovn_datapath *od, struct lflow_table *lflows,
+    const struct group_ecmp_datapath *route_node);
+void build_unique_route_data_flows(struct lflow_table *lflows,
+                                   const struct unique_routes_node *,
+                                   const struct sset *bfd_ports);
 
 bool lflow_handle_northd_lr_changes(struct ovsdb_idl_txn *ovnsh_txn,
                                      struct tracked_dps *,
@@ -957,6 +1040,9 @@ bool lflow_handle_northd_lb_changes(struct ovsdb_idl_txn *ovnsb_txn,
                                     struct tracked_lbs *,
                                     struct lflow_input *,
                                     struct lflow_table *lflows);
+bool lflow_handle_route_policies_changes(
+    struct ovsdb_idl_txn *ovnsb_txn, struct route_policies_tracked_data *,
+    struct lflow_input *, struct lflow_table *lflows);
 bool lflow_handle_lr_stateful_changes(struct ovsdb_idl_txn *,
                                       struct lr_stateful_tracked_data *,
                                       struct lflow_input *,
@@ -1061,6 +1147,20 @@ northd_has_lrouters_in_tracked_data(
     return trk_nd_changes->type & NORTHD_TRACKED_ROUTERS;
 }
 
+static inline bool
+northd_has_lr_routes_in_tracked_data(
+        struct northd_tracked_data *trk_nd_changes)
+{
+    return trk_nd_changes->type & NORTHD_TRACKED_LR_ROUTES;
+}
+
+static inline bool
+northd_has_lr_policies_in_tracked_data(
+        struct northd_tracked_data *trk_nd_changes)
+{
+    return trk_nd_changes->type & NORTHD_TRACKED_LR_POLICIES;
+}
+
 /* Returns 'true' if the IPv4 'addr' is on the same subnet with one of the
  * IPs configured on the router port.
  */
@@ -24,13 +24,17 @@
 #include "fatal-signal.h"
 #include "inc-proc-northd.h"
 #include "lib/ip-mcast-index.h"
+#include "lflow-build-profile.h"
 #include "lib/mcast-group-index.h"
 #include "lib/memory-trim.h"
 #include "memory.h"
+#include "nb-cfg-latency.h"
 #include "northd.h"
+#include "northd-bench.h"
 #include "ovs-numa.h"
 #include "ovsdb-idl.h"
 #include "lib/ovn-l7.h"
+#include "lib/ovn-metrics.h"
 #include "lib/ovn-nb-idl.h"
 #include "lib/ovn-sb-idl.h"
 #include "lib/ovs-rcu.h"
@@ -56,6 +60,10 @@ static unixctl_cb_func ovn_northd_status;
 static unixctl_cb_func cluster_state_reset_cmd;
 static unixctl_cb_func ovn_northd_set_thread_count_cmd;
 static unixctl_cb_func ovn_northd_get_thread_count_cmd;
+static unixctl_cb_func ovn_northd_lflow_profile_start_cmd;
+static unixctl_cb_func ovn_northd_lflow_profile_stop_cmd;
+static unixctl_cb_func ovn_northd_lflow_profile_show_cmd;
+static unixctl_cb_func ovn_northd_nb_cfg_latency_show_cmd;
 
 struct northd_state {
     bool had_lock;
@@ -68,6 +76,11 @@ static const char *ovnnb_db;
 static const char *ovnsb_db;
 static const char *unixctl_path;
 
+/* Offline benchmark mode, see northd-bench.h. */
+static const char *benchmark_nb_file;
+static const char *benchmark_sb_file;
+static const char *benchmark_changes_file;
+
 /* SSL/TLS options. */
 static const char *ssl_private_key_file;
 static const char *ssl_certificate_file;
@@ -589,6 +602,8 @@ update_sequence_numbers(int64_t loop_start_time,
         nbrec_nb_global_set_hv_cfg(nb, hv_cfg);
         nbrec_nb_global_set_hv_cfg_timestamp(nb, hv_cfg_ts);
     }
+
+    nb_cfg_latency_run(nb, ovnsb_idl);
 }
 
 static void inc_proc_graph_dump(const char *end_node)
@@ -619,6 +634,10 @@ Options:\n\
                             (default: %s)\n\
   --dry-run                 start in paused state (do not commit db changes)\n\
   --n-threads=N             specify number of threads\n\
+  --benchmark-nb=FILE       run the offline benchmark on NB database FILE\n\
+  --benchmark-sb=FILE       run the offline benchmark on SB database FILE\n\
+  --benchmark-changes=FILE  apply the NB transactions in FILE during the\n\
+                            benchmark\n\
   --unixctl=SOCKET          override default control socket name\n\
   -h, --help                display this help message\n\
   -o, --options             list available options\n\
@@ -640,6 +659,9 @@ parse_options(int argc OVS_UNUSED, char *argv[] OVS_UNUSED,
         OPT_DRY_RUN,
         OPT_N_THREADS,
         OPT_DUMP_INC_PROC_GRAPH,
+        OPT_BENCHMARK_NB,
+        OPT_BENCHMARK_SB,
+        OPT_BENCHMARK_CHANGES,
     };
     static const struct option long_options[] = {
         {"ovnsb-db", required_argument, NULL, 'd'},
@@ -652,6 +674,10 @@ parse_options(int argc OVS_UNUSED, char *argv[] OVS_UNUSED,
         {"n-threads", required_argument, NULL, OPT_N_THREADS},
         {"dump-inc-proc-graph", optional_argument, NULL,
          OPT_DUMP_INC_PROC_GRAPH},
+        {"benchmark-nb", required_argument, NULL, OPT_BENCHMARK_NB},
+        {"benchmark-sb", required_argument, NULL, OPT_BENCHMARK_SB},
+        {"benchmark-changes", required_argument, NULL,
+         OPT_BENCHMARK_CHANGES},
         OVN_DAEMON_LONG_OPTIONS,
         VLOG_LONG_OPTIONS,
         STREAM_SSL_LONG_OPTIONS,
@@ -752,6 +778,18 @@ parse_options(int argc OVS_UNUSED, char *argv[] OVS_UNUSED,
             inc_proc_graph_dump(optarg);
             exit(EXIT_SUCCESS);
 
+        case OPT_BENCHMARK_NB:
+            benchmark_nb_file = optarg;
+            break;
+
+        case OPT_BENCHMARK_SB:
+            benchmark_sb_file = optarg;
+            break;
+
+        case OPT_BENCHMARK_CHANGES:
+            benchmark_changes_file = optarg;
+            break;
+
         default:
             break;
         }
@@ -817,6 +855,25 @@ sb_cfg_is_in_sync(struct ovsdb_idl *ovnnb_idl,
     return !(nb && sb_loop->cur_cfg && nb->sb_cfg != sb_loop->cur_cfg);
 }
 
+/* Auxiliary data of northd_put_metrics(). */
+struct northd_metrics_aux {
+    struct ovsdb_idl_loop *ovnnb_idl_loop;
+    struct ovsdb_idl_loop *ovnsb_idl_loop;
+};
+
+/* Implements ovn_metrics_cb. */
+static void
+northd_put_metrics(struct ds *ds, void *aux_)
+{
+    const struct northd_metrics_aux *aux = aux_;
+    struct simap usage = SIMAP_INITIALIZER(&usage);
+
+    ovsdb_idl_get_memory_usage(aux->ovnnb_idl_loop->idl, &usage);
+    ovsdb_idl_get_memory_usage(aux->ovnsb_idl_loop->idl, &usage);
+    ovn_metrics_put_memory(ds, &usage);
+    simap_destroy(&usage);
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -868,10 +925,28 @@ main(int argc, char *argv[])
     unixctl_command_register("parallel-build/get-n-threads", "", 0, 0,
                              ovn_northd_get_thread_count_cmd,
                              NULL);
+    unixctl_command_register("lflow/profile-start", "", 0, 0,
+                             ovn_northd_lflow_profile_start_cmd, NULL);
+    unixctl_command_register("lflow/profile-stop", "", 0, 0,
+                             ovn_northd_lflow_profile_stop_cmd, NULL);
+    unixctl_command_register("lflow/profile-show", "[N]", 0, 1,
+                             ovn_northd_lflow_profile_show_cmd, NULL);
+    unixctl_command_register("nb-cfg/latency-show", "[N]", 0, 1,
+                             ovn_northd_nb_cfg_latency_show_cmd, NULL);
+    ovn_metrics_init();
     ovn_debug_commands_register();
 
     daemonize_complete();
 
+    /* In benchmark mode, connect to the databases served from within the
+     * process. */
+    struct northd_bench *bench = NULL;
+    if (benchmark_nb_file || benchmark_sb_file) {
+        bench = northd_bench_create(benchmark_nb_file, benchmark_sb_file,
+                                    benchmark_changes_file);
+        ovnnb_db = ovnsb_db = northd_bench_remote(bench);
+    }
+
     /* We want to detect (almost) all changes to the ovn-nb db. */
     struct ovsdb_idl_loop ovnnb_idl_loop = OVSDB_IDL_LOOP_INITIALIZER(
         ovsdb_idl_create(ovnnb_db, &nbrec_idl_class, true, true));
@@ -910,7 +985,6 @@ main(int argc, char *argv[])
         &nbrec_meter_band_col_external_ids,
         &nbrec_mirror_col_external_ids,
         &nbrec_nat_col_external_ids,
-        &nbrec_nb_global_col_external_ids,
         &nbrec_port_group_col_external_ids,
         &nbrec_qos_col_external_ids,
         &nbrec_ssl_col_external_ids,
@@ -920,6 +994,10 @@ main(int argc, char *argv[])
     for (size_t i = 0; i < ARRAY_SIZE(external_ids); i++) {
         ovsdb_idl_omit(ovnnb_idl_loop.idl, external_ids[i]);
     }
+    /* NB_Global external_ids are updated with the nb_cfg latency summary,
+     * see nb-cfg-latency.h. */
+    ovsdb_idl_omit_alert(ovnnb_idl_loop.idl,
+                         &nbrec_nb_global_col_external_ids);
 
     unixctl_command_register("nb-connection-status", "", 0, 0,
                              ovn_conn_show, ovnnb_idl_loop.idl);
@@ -989,17 +1067,29 @@ main(int argc, char *argv[])
     VLOG_INFO("OVN internal version is : [%s]", ovn_version);
     free(ovn_version);
 
-    stopwatch_create(NORTHD_LOOP_STOPWATCH_NAME, SW_MS);
-    stopwatch_create(BUILD_LFLOWS_CTX_STOPWATCH_NAME, SW_MS);
-    stopwatch_create(CLEAR_LFLOWS_CTX_STOPWATCH_NAME, SW_MS);
-    stopwatch_create(LFLOWS_DATAPATHS_STOPWATCH_NAME, SW_MS);
-    stopwatch_create(LFLOWS_PORTS_STOPWATCH_NAME, SW_MS);
-    stopwatch_create(LFLOWS_LBS_STOPWATCH_NAME, SW_MS);
-    stopwatch_create(LFLOWS_LR_STATEFUL_STOPWATCH_NAME, SW_MS);
-    stopwatch_create(LFLOWS_LS_STATEFUL_STOPWATCH_NAME, SW_MS);
-    stopwatch_create(LFLOWS_IGMP_STOPWATCH_NAME, SW_MS);
-    stopwatch_create(LFLOWS_DP_GROUPS_STOPWATCH_NAME, SW_MS);
-    stopwatch_create(LFLOWS_TO_SB_STOPWATCH_NAME, SW_MS);
+    static const char *stopwatches[] = {
+        NORTHD_LOOP_STOPWATCH_NAME,
+        BUILD_LFLOWS_CTX_STOPWATCH_NAME,
+        CLEAR_LFLOWS_CTX_STOPWATCH_NAME,
+        LFLOWS_DATAPATHS_STOPWATCH_NAME,
+        LFLOWS_PORTS_STOPWATCH_NAME,
+        LFLOWS_LBS_STOPWATCH_NAME,
+        LFLOWS_LR_STATEFUL_STOPWATCH_NAME,
+        LFLOWS_LS_STATEFUL_STOPWATCH_NAME,
+        LFLOWS_IGMP_STOPWATCH_NAME,
+        LFLOWS_DP_GROUPS_STOPWATCH_NAME,
+        LFLOWS_TO_SB_STOPWATCH_NAME,
+    };
+    for (size_t i = 0; i < ARRAY_SIZE(stopwatches); i++) {
+        stopwatch_create(stopwatches[i], SW_MS);
+        ovn_metrics_add_stopwatch(stopwatches[i]);
+    }
+
+    struct northd_metrics_aux metrics_aux = {
+        .ovnnb_idl_loop = &ovnnb_idl_loop,
+        .ovnsb_idl_loop = &ovnsb_idl_loop,
+    };
+    ovn_metrics_register(northd_put_metrics, &metrics_aux);
 
     /* Initialize incremental processing engine for ovn-northd */
     inc_proc_northd_init(&ovnnb_idl_loop, &ovnsb_idl_loop);
@@ -1009,6 +1099,11 @@ main(int argc, char *argv[])
 
     run_update_worker_pool(n_threads);
 
+    if (bench) {
+        res = northd_bench_run(bench, &ovnnb_idl_loop, &ovnsb_idl_loop);
+        exit_args.exiting = true;
+    }
+
     /* Main loop. */
     struct northd_engine_context eng_ctx = {0};
 
@@ -1213,10 +1308,13 @@ main(int argc, char *argv[])
 
     ovsdb_idl_loop_destroy(&ovnnb_idl_loop);
     ovsdb_idl_loop_destroy(&ovnsb_idl_loop);
+    northd_bench_destroy(bench);
     ovn_exit_args_finish(&exit_args);
     unixctl_server_destroy(unixctl);
     service_stop();
     run_update_worker_pool(0);
+    lflow_build_profile_destroy();
+    nb_cfg_latency_destroy();
     ovsrcu_exit();
 
     exit(res);
@@ -1315,3 +1413,57 @@ ovn_northd_get_thread_count_cmd(struct unixctl_conn *conn, int argc OVS_UNUSED,
     unixctl_command_reply(conn, ds_cstr(&s));
     ds_destroy(&s);
 }
+
+static void
+ovn_northd_lflow_profile_start_cmd(struct unixctl_conn *conn,
+                                   int argc OVS_UNUSED,
+                                   const char *argv[] OVS_UNUSED,
+                                   void *aux OVS_UNUSED)
+{
+    lflow_build_profile_start();
+    unixctl_command_reply(conn, NULL);
+}
+
+static void
+ovn_northd_lflow_profile_stop_cmd(struct unixctl_conn *conn,
+                                  int argc OVS_UNUSED,
+                                  const char *argv[] OVS_UNUSED,
+                                  void *aux OVS_UNUSED)
+{
+    lflow_build_profile_stop();
+    unixctl_command_reply(conn, NULL);
+}
+
+static void
+ovn_northd_lflow_profile_show_cmd(struct unixctl_conn *conn, int argc,
+                                  const char *argv[], void *aux OVS_UNUSED)
+{
+    unsigned int top_n = 0;
+
+    if (argc > 1 && (!str_to_uint(argv[1], 10, &top_n) || !top_n)) {
+        unixctl_command_reply_error(conn, "Invalid number of entries.");
+        return;
+    }
+
+    struct ds s = DS_EMPTY_INITIALIZER;
+    lflow_build_profile_show(&s, top_n);
+    unixctl_command_reply(conn, ds_cstr(&s));
+    ds_destroy(&s);
+}
+
+static void
+ovn_northd_nb_cfg_latency_show_cmd(struct unixctl_conn *conn, int argc,
+                                   const char *argv[], void *aux OVS_UNUSED)
+{
+    unsigned int top_n = 10;
+
+    if (argc > 1 && !str_to_uint(argv[1], 10, &top_n)) {
+        unixctl_command_reply_error(conn, "Invalid number of chassis.");
+        return;
+    }
+
+    struct ds s = DS_EMPTY_INITIALIZER;
+    nb_cfg_latency_show(&s, top_n);
+    unixctl_command_reply(conn, ds_cstr(&s));
+    ds_destroy(&s);
+}
@@ -289,6 +289,7 @@ tests_ovstest_SOURCES = \
 	tests/test-utils.h \
 	tests/test-ovn.c \
 	tests/test-sparse-array.c \
+	tests/test-timer-wheel.c \
 	tests/test-vector.c \
 	controller/test-lflow-cache.c \
 	controller/test-vif-plug.c \
@@ -328,6 +329,11 @@ tests_ovstest_LDADD = $(OVS_LIBDIR)/daemon.lo \
 	controller/vif-plug.$(OBJEXT) \
 	northd/ipam.$(OBJEXT)
 
+noinst_PROGRAMS += tests/ovn-nbgen
+tests_ovn_nbgen_SOURCES = tests/ovn-nbgen.c
+tests_ovn_nbgen_LDADD = lib/libovn.la $(OVSDB_LIBDIR)/libovsdb.la \
+    $(OVS_LIBDIR)/libopenvswitch.la
+
 # Python tests.
 CHECK_PYFILES = \
 	tests/test-l7.py \
@@ -0,0 +1,836 @@
+/* Copyright (c) 2026, Red Hat, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Generates a synthetic OVN_Northbound database file for scale testing.
+ *
+ * The whole topology is built as a single transaction in the format of the
+ * database files, replayed into an in-memory database, which validates it,
+ * and written out, so that very large topologies only take seconds instead
+ * of the hours needed by running ovn-nbctl in a loop.  The row UUIDs and
+ * all the random choices only depend on --seed, so that a given set of
+ * options always produces the same database contents.
+ *
+ * The topology is:
+ *
+ *   - --switches logical switches, each with a /16 subnet and --ports
+ *     logical switch ports with static addresses.
+ *
+ *   - --routers logical routers.  Each switch is connected to a router,
+ *     round-robin, and each router has a distributed gateway port, bound
+ *     to chassis "gw1", on the shared "ext" logical switch, which has a
+ *     localnet port.
+ *
+ *   - --nats dnat_and_snat entries, with distinct logical IPs, and --routes
+ *     static routes per router.
+ *
+ *   - --address-sets address sets of --address-set-size addresses of
+ *     logical ports.
+ *
+ *   - --port-groups port groups, with the logical switch ports distributed
+ *     among them round-robin, and --acls ACLs per port group that refer to
+ *     the address sets.
+ *
+ *   - --lbs load balancers with --vips VIPs of --backends backends each,
+ *     all applied to every switch and router through a load balancer
+ *     group. */
+
+#include <config.h>
+
+#include <getopt.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "command-line.h"
+#include "lib/ovn-dirs.h"
+#include "lib/ovn-util.h"
+#include "lib/vec.h"
+#include "openvswitch/dynamic-string.h"
+#include "openvswitch/json.h"
+#include "openvswitch/shash.h"
+#include "openvswitch/vlog.h"
+#include "ovsdb/file.h"
+#include "ovsdb/log.h"
+#include "ovsdb/ovsdb.h"
+#include "ovsdb/storage.h"
+#include "ovsdb/transaction.h"
+#include "ovsdb-error.h"
+#include "random.h"
+#include "sset.h"
+#include "util.h"
+#include "uuid.h"
+
+#define NBGEN_MAX_SWITCHES (20 * 256)
+
+/* The router IP of each switch subnet is the IP of this port index. */
+#define NBGEN_LR_PORT 65533
+
+struct nbgen_options {
+    unsigned int n_switches;
+    unsigned int n_routers;
+    unsigned int n_ports;           /* Per logical switch. */
+    unsigned int n_port_groups;
+    unsigned int n_acls;            /* Per port group. */
+    unsigned int n_address_sets;
+    unsigned int address_set_size;
+    unsigned int n_lbs;
+    unsigned int n_vips;            /* Per load balancer. */
+    unsigned int n_backends;        /* Per VIP. */
+    unsigned int n_nats;            /* Per logical router. */
+    unsigned int n_routes;          /* Per logical router. */
+    unsigned int seed;
+    const char *schema;
+};
+
+/* The transaction that creates the database contents, in the format of the
+ * database files, i.e., {"<table>": {"<uuid>": {<row>}, ...}, ...}. */
+struct nbgen {
+    struct json *txn;
+    uint32_t n_macs;
+};
+
+static const char *parse_options(int argc, char *argv[],
+                                 struct nbgen_options *);
+OVS_NO_RETURN static void usage(void);
+
+static void nbgen_build(struct nbgen *, const struct nbgen_options *);
+static void nbgen_write(struct json *txn, const char *schema_file,
+                        const char *db_file);
+
+int
+main(int argc, char *argv[])
+{
+    struct nbgen_options options = {
+        .n_switches = 10,
+        .n_routers = 1,
+        .n_ports = 10,
+        .address_set_size = 10,
+        .n_vips = 1,
+        .n_backends = 2,
+    };
+
+    ovn_set_program_name(argv[0]);
+    vlog_set_levels(NULL, VLF_ANY_DESTINATION, VLL_WARN);
+    const char *db_file = parse_options(argc, argv, &options);
+
+    char *default_schema = xasprintf("%s/ovn-nb.ovsschema",
+                                     ovn_pkgdatadir());
+    if (!options.schema) {
+        options.schema = default_schema;
+    }
+
+    struct nbgen gen = { .txn = json_object_create() };
+
+    random_set_seed(options.seed);
+    nbgen_build(&gen, &options);
+    nbgen_write(gen.txn, options.schema, db_file);
+
+    json_destroy(gen.txn);
+    free(default_schema);
+    return 0;
+}
+
+static const char *
+parse_options(int argc, char *argv[], struct nbgen_options *options)
+{
+    enum {
+        OPT_SWITCHES = UCHAR_MAX + 1,
+        OPT_ROUTERS,
+        OPT_PORTS,
+        OPT_PORT_GROUPS,
+        OPT_ACLS,
+        OPT_ADDRESS_SETS,
+        OPT_ADDRESS_SET_SIZE,
+        OPT_LBS,
+        OPT_VIPS,
+        OPT_BACKENDS,
+        OPT_NATS,
+        OPT_ROUTES,
+        OPT_SEED,
+        OPT_SCHEMA,
+        VLOG_OPTION_ENUMS,
+    };
+    static const struct option long_options[] = {
+        {"switches", required_argument, NULL, OPT_SWITCHES},
+        {"routers", required_argument, NULL, OPT_ROUTERS},
+        {"ports", required_argument, NULL, OPT_PORTS},
+        {"port-groups", required_argument, NULL, OPT_PORT_GROUPS},
+        {"acls", required_argument, NULL, OPT_ACLS},
+        {"address-sets", required_argument, NULL, OPT_ADDRESS_SETS},
+        {"address-set-size", required_argument, NULL, OPT_ADDRESS_SET_SIZE},
+        {"lbs", required_argument, NULL, OPT_LBS},
+        {"vips", required_argument, NULL, OPT_VIPS},
+        {"backends", required_argument, NULL, OPT_BACKENDS},
+        {"nats", required_argument, NULL, OPT_NATS},
+        {"routes", required_argument, NULL, OPT_ROUTES},
+        {"seed", required_argument, NULL, OPT_SEED},
+        {"schema", required_argument, NULL, OPT_SCHEMA},
+        {"help", no_argument, NULL, 'h'},
+        {"version", no_argument, NULL, 'V'},
+        VLOG_LONG_OPTIONS,
+        {NULL, 0, NULL, 0},
+    };
+    char *short_options = ovs_cmdl_long_options_to_short_options(long_options);
+
+    for (;;) {
+        unsigned int *value = NULL;
+        int idx;
+        int c;
+
+        c = getopt_long(argc, argv, short_options, long_options, &idx);
+        if (c == -1) {
+            break;
+        }
+
+        switch (c) {
+        case OPT_SWITCHES:
+            value = &options->n_switches;
+            break;
+
+        case OPT_ROUTERS:
+            value = &options->n_routers;
+            break;
+
+        case OPT_PORTS:
+            value = &options->n_ports;
+            break;
+
+        case OPT_PORT_GROUPS:
+            value = &options->n_port_groups;
+            break;
+
+        case OPT_ACLS:
+            value = &options->n_acls;
+            break;
+
+        case OPT_ADDRESS_SETS:
+            value = &options->n_address_sets;
+            break;
+
+        case OPT_ADDRESS_SET_SIZE:
+            value = &options->address_set_size;
+            break;
+
+        case OPT_LBS:
+            value = &options->n_lbs;
+            break;
+
+        case OPT_VIPS:
+            value = &options->n_vips;
+            break;
+
+        case OPT_BACKENDS:
+            value = &options->n_backends;
+            break;
+
+        case OPT_NATS:
+            value = &options->n_nats;
+            break;
+
+        case OPT_ROUTES:
+            value = &options->n_routes;
+            break;
+
+        case OPT_SEED:
+            value = &options->seed;
+            break;
+
+        case OPT_SCHEMA:
+            options->schema = optarg;
+            break;
+
+        case 'h':
+            usage();
+
+        case 'V':
+            ovn_print_version(0, 0);
+            exit(EXIT_SUCCESS);
+
+        VLOG_OPTION_HANDLERS
+
+        case '?':
+            exit(EXIT_FAILURE);
+
+        default:
+            abort();
+        }
+
+        if (value && !str_to_uint(optarg, 10, value)) {
+            ovs_fatal(0, "--%s: %s is not a valid number",
+                      long_options[idx].name, optarg);
+        }
+    }
+    free(short_options);
+
+    if (argc - optind != 1) {
+        ovs_fatal(0, "exactly one non-option argument required "
+                  "(use --help for help)");
+    }
+
+    /* Each switch has a /16 subnet in 10.0.0.0/8 - 29.0.0.0/8, with the
+     * last address of the subnet for its router. */
+    if (options->n_switches > NBGEN_MAX_SWITCHES) {
+        ovs_fatal(0, "at most %d switches are supported", NBGEN_MAX_SWITCHES);
+    }
+    if (options->n_ports > NBGEN_LR_PORT) {
+        ovs_fatal(0, "at most %d ports per switch are supported",
+                  NBGEN_LR_PORT);
+    }
+    if (options->n_switches && !options->n_routers) {
+        ovs_fatal(0, "at least one router is required");
+    }
+    if ((options->n_address_sets || options->n_lbs || options->n_nats)
+        && (!options->n_switches || !options->n_ports)) {
+        ovs_fatal(0, "address sets, load balancers and NAT entries require "
+                  "logical switch ports");
+    }
+
+    return argv[optind];
+}
+
+static void
+usage(void)
+{
+    printf("\
+%s: OVN Northbound database generator for scale testing\n\
+usage: %s [OPTIONS] DB_FILE\n\
+\n\
+Creates DB_FILE, which must not exist, with a synthetic topology.\n\
+\n\
+Topology options:\n\
+  --switches=N            logical switches (default: 10)\n\
+  --routers=N             logical routers (default: 1)\n\
+  --ports=N               logical switch ports per switch (default: 10)\n\
+  --port-groups=N         port groups (default: 0)\n\
+  --acls=N                ACLs per port group (default: 0)\n\
+  --address-sets=N        address sets (default: 0)\n\
+  --address-set-size=N    addresses per address set (default: 10)\n\
+  --lbs=N                 load balancers (default: 0)\n\
+  --vips=N                VIPs per load balancer (default: 1)\n\
+  --backends=N            backends per VIP (default: 2)\n\
+  --nats=N                NAT entries per router (default: 0)\n\
+  --routes=N              static routes per router (default: 0)\n\
+  --seed=N                seed for the random choices (default: 0)\n\
+\n\
+Other options:\n\
+  --schema=FILE           NB schema (default: %s/ovn-nb.ovsschema)\n\
+  -h, --help              display this help message\n\
+  -V, --version           display version information\n",
+           program_name, program_name, ovn_pkgdatadir());
+    vlog_usage();
+    exit(EXIT_SUCCESS);
+}
+
+static struct uuid
+nbgen_uuid(void)
+{
+    struct uuid uuid;
+
+    for (size_t i = 0; i < ARRAY_SIZE(uuid.parts); i++) {
+        uuid.parts[i] = random_uint32();
+    }
+
+    /* Version 4, variant 1, as uuid_generate() does. */
+    uuid.parts[2] &= ~0xc0000000;
+    uuid.parts[2] |= 0x80000000;
+    uuid.parts[1] &= ~0x0000f000;
+    uuid.parts[1] |= 0x00004000;
+
+    return uuid;
+}
+
+/* Adds a row with the columns of 'row' to 'table' and returns its UUID.
+ * Takes ownership of 'row'. */
+static struct uuid
+nbgen_insert(struct nbgen *gen, const char *table, struct json *row)
+{
+    struct json *rows = shash_find_data(json_object(gen->txn), table);
+    if (!rows) {
+        rows = json_object_create();
+        json_object_put(gen->txn, table, rows);
+    }
+
+    struct uuid uuid = nbgen_uuid();
+    json_object_put_nocopy(rows, xasprintf(UUID_FMT, UUID_ARGS(&uuid)), row);
+    return uuid;
+}
+
+static struct json *
+nbgen_ref(const struct uuid *uuid)
+{
+    return json_array_create_2(json_string_create("uuid"),
+                               json_string_create_nocopy(
+                                   xasprintf(UUID_FMT, UUID_ARGS(uuid))));
+}
+
+/* Returns an OVSDB set of the JSON values in 'elems', which must be an
+ * array, and takes ownership of 'elems'. */
+static struct json *
+nbgen_set(struct json *elems)
+{
+    return json_array_create_2(json_string_create("set"), elems);
+}
+
+/* Returns an OVSDB map with the 'n' string key/value pairs in 'kv'. */
+static struct json *
+nbgen_map(const char *kv[][2], size_t n)
+{
+    struct json *pairs = json_array_create_empty();
+
+    for (size_t i = 0; i < n; i++) {
+        json_array_add(pairs, json_array_create_2(
+                                  json_string_create(kv[i][0]),
+                                  json_string_create(kv[i][1])));
+    }
+    return json_array_create_2(json_string_create("map"), pairs);
+}
+
+static void
+nbgen_put_format(struct json *row, const char *column, const char *format,
+                 ...)
+    OVS_PRINTF_FORMAT(3, 4);
+
+static void
+nbgen_put_format(struct json *row, const char *column, const char *format,
+                 ...)
+{
+    va_list args;
+
+    va_start(args, format);
+    json_object_put(row, column,
+                    json_string_create_nocopy(xvasprintf(format, args)));
+    va_end(args);
+}
+
+static char *
+nbgen_mac(struct nbgen *gen)
+{
+    uint32_t n = ++gen->n_macs;
+
+    return xasprintf("0a:00:%02"PRIx32":%02"PRIx32":%02"PRIx32":%02"PRIx32,
+                     n >> 24, (n >> 16) & 0xff, (n >> 8) & 0xff, n & 0xff);
+}
+
+/* Returns the IP of the logical switch port 'port' of switch 'ls', or the
+ * router IP with 'port' == NBGEN_LR_PORT. */
+static char *
+nbgen_port_ip(unsigned int ls, unsigned int port)
+{
+    return xasprintf("%u.%u.%u.%u", 10 + ls / 256, ls % 256,
+                     (port + 1) / 256, (port + 1) % 256);
+}
+
+static char *
+nbgen_random_port_ip(const struct nbgen_options *options)
+{
+    return nbgen_port_ip(random_range(options->n_switches),
+                         random_range(options->n_ports));
+}
+
+/* Returns the address with offset 'n' in the network 'a'.0.0.0/8. */
+static char *
+nbgen_ip(unsigned int a, uint32_t n)
+{
+    return xasprintf("%u.%"PRIu32".%"PRIu32".%"PRIu32,
+                     a, (n >> 16) & 0xff, (n >> 8) & 0xff, n & 0xff);
+}
+
+struct nbgen_router {
+    struct json *ports;             /* Set of LRP references. */
+    struct json *nats;
+    struct json *routes;
+};
+
+/* Adds the load balancers, with VIPs in 30.0.0.0/8 and random logical ports
+ * as backends, and returns a reference to the load balancer group that
+ * contains them, or NULL if there are none. */
+static struct json *
+nbgen_build_lbs(struct nbgen *gen, const struct nbgen_options *options)
+{
+    if (!options->n_lbs) {
+        return NULL;
+    }
+
+    struct json *lbs = json_array_create_empty();
+    uint32_t n_vips = 0;
+
+    for (unsigned int i = 0; i < options->n_lbs; i++) {
+        struct json *vips = json_array_create_empty();
+
+        for (unsigned int j = 0; j < options->n_vips; j++) {
+            struct ds backends = DS_EMPTY_INITIALIZER;
+            char *vip = nbgen_ip(30, n_vips++);
+
+            for (unsigned int k = 0; k < options->n_backends; k++) {
+                char *ip = nbgen_random_port_ip(options);
+
+                ds_put_format(&backends, "%s%s:8080", k ? "," : "", ip);
+                free(ip);
+            }
+            json_array_add(vips, json_array_create_2(
+                                     json_string_create_nocopy(
+                                         xasprintf("%s:80", vip)),
+                                     json_string_create(
+                                         ds_cstr(&backends))));
+
+            ds_destroy(&backends);
+            free(vip);
+        }
+
+        struct json *lb = json_object_create();
+        nbgen_put_format(lb, "name", "lb%u", i);
+        json_object_put_string(lb, "protocol", "tcp");
+        json_object_put(lb, "vips",
+                        json_array_create_2(json_string_create("map"), vips));
+        struct uuid uuid = nbgen_insert(gen, "Load_Balancer", lb);
+        json_array_add(lbs, nbgen_ref(&uuid));
+    }
+
+    struct json *lbg = json_object_create();
+    json_object_put_string(lbg, "name", "lbg");
+    json_object_put(lbg, "load_balancer", nbgen_set(lbs));
+    struct uuid uuid = nbgen_insert(gen, "Load_Balancer_Group", lbg);
+
+    return nbgen_ref(&uuid);
+}
+
+/* Adds the logical switches, connected to 'routers', and their ports.  The
+ * UUIDs of the VIF ports are added to 'vifs'. */
+static void
+nbgen_build_switches(struct nbgen *gen, const struct nbgen_options *options,
+                     const struct json *lbg, struct nbgen_router *routers,
+                     struct vector *vifs)
+{
+    for (unsigned int i = 0; i < options->n_switches; i++) {
+        struct nbgen_router *lr = &routers[i % options->n_routers];
+        struct json *ports = json_array_create_empty();
+        char *lrp_name = xasprintf("lrp-ls%u", i);
+        char *lr_ip = nbgen_port_ip(i, NBGEN_LR_PORT);
+        char *mac = nbgen_mac(gen);
+
+        /* Router port and its peer. */
+        struct json *lrp = json_object_create();
+        json_object_put_string(lrp, "name", lrp_name);
+        json_object_put_string(lrp, "mac", mac);
+        nbgen_put_format(lrp, "networks", "%s/16", lr_ip);
+        struct uuid uuid = nbgen_insert(gen, "Logical_Router_Port", lrp);
+        json_array_add(lr->ports, nbgen_ref(&uuid));
+
+        const char *router_port_options[][2] = {{"router-port", lrp_name}};
+        struct json *lsp = json_object_create();
+        nbgen_put_format(lsp, "name", "ls%u-lr", i);
+        json_object_put_string(lsp, "type", "router");
+        json_object_put_string(lsp, "addresses", "router");
+        json_object_put(lsp, "options", nbgen_map(router_port_options, 1));
+        uuid = nbgen_insert(gen, "Logical_Switch_Port", lsp);
+        json_array_add(ports, nbgen_ref(&uuid));
+
+        /* VIF ports. */
+        for (unsigned int j = 0; j < options->n_ports; j++) {
+            char *port_mac = nbgen_mac(gen);
+            char *ip = nbgen_port_ip(i, j);
+
+            lsp = json_object_create();
+            nbgen_put_format(lsp, "name", "ls%u-p%u", i, j);
+            nbgen_put_format(lsp, "addresses", "%s %s", port_mac, ip);
+            uuid = nbgen_insert(gen, "Logical_Switch_Port", lsp);
+            json_array_add(ports, nbgen_ref(&uuid));
+            vector_push(vifs, &uuid);
+
+            free(port_mac);
+            free(ip);
+        }
+
+        char *subnet = xasprintf("%u.%u.0.0/16", 10 + i / 256, i % 256);
+        const char *other_config[][2] = {
+            {"subnet", subnet},
+            {"exclude_ips", lr_ip},
+        };
+        struct json *ls = json_object_create();
+        nbgen_put_format(ls, "name", "ls%u", i);
+        json_object_put(ls, "ports", nbgen_set(ports));
+        json_object_put(ls, "other_config",
+                        nbgen_map(other_config, ARRAY_SIZE(other_config)));
+        if (lbg) {
+            json_object_put(ls, "load_balancer_group", json_clone(lbg));
+        }
+        nbgen_insert(gen, "Logical_Switch", ls);
+
+        free(subnet);
+        free(lrp_name);
+        free(lr_ip);
+        free(mac);
+    }
+}
+
+/* Adds the "ext" logical switch and, for each router, its distributed
+ * gateway port on it, NAT entries and static routes. */
+static void
+nbgen_build_external(struct nbgen *gen, const struct nbgen_options *options,
+                     struct nbgen_router *routers)
+{
+    struct json *ports = json_array_create_empty();
+    uint32_t n_nats = 0;
+    uint32_t n_routes = 0;
+
+    const char *localnet_options[][2] = {{"network_name", "physnet"}};
+    struct json *lsp = json_object_create();
+    json_object_put_string(lsp, "name", "ext-localnet");
+    json_object_put_string(lsp, "type", "localnet");
+    json_object_put_string(lsp, "addresses", "unknown");
+    json_object_put(lsp, "options", nbgen_map(localnet_options, 1));
+    struct uuid uuid = nbgen_insert(gen, "Logical_Switch_Port", lsp);
+    json_array_add(ports, nbgen_ref(&uuid));
+
+    for (unsigned int i = 0; i < options->n_routers; i++) {
+        struct nbgen_router *lr = &routers[i];
+        char *lrp_name = xasprintf("lr%u-ext", i);
+        char *ext_ip = nbgen_ip(172, (16 << 16) + 2 + i);
+        char *mac = nbgen_mac(gen);
+
+        struct json *gw = json_object_create();
+        nbgen_put_format(gw, "name", "%s-gw1", lrp_name);
+        json_object_put_string(gw, "chassis_name", "gw1");
+        json_object_put(gw, "priority", json_integer_create(1));
+        uuid = nbgen_insert(gen, "Gateway_Chassis", gw);
+
+        struct json *lrp = json_object_create();
+        json_object_put_string(lrp, "name", lrp_name);
+        json_object_put_string(lrp, "mac", mac);
+        nbgen_put_format(lrp, "networks", "%s/12", ext_ip);
+        json_object_put(lrp, "gateway_chassis", nbgen_ref(&uuid));
+        uuid = nbgen_insert(gen, "Logical_Router_Port", lrp);
+        json_array_add(lr->ports, nbgen_ref(&uuid));
+
+        const char *router_port_options[][2] = {{"router-port", lrp_name}};
+        lsp = json_object_create();
+        nbgen_put_format(lsp, "name", "ext-lr%u", i);
+        json_object_put_string(lsp, "type", "router");
+        json_object_put_string(lsp, "addresses", "router");
+        json_object_put(lsp, "options", nbgen_map(router_port_options, 1));
+        uuid = nbgen_insert(gen, "Logical_Switch_Port", lsp);
+        json_array_add(ports, nbgen_ref(&uuid));
+
+        /* NAT entries map addresses of 100.64.0.0/10 to logical ports of
+         * the switches connected to the router, i.e., switches 'i',
+         * 'i + n_routers', and so on.  A router can't have two
+         * dnat_and_snat entries with the same logical IP, so there is at
+         * most one entry per logical port and the random picks of an
+         * already used logical IP are skipped. */
+        unsigned int n_lr_switches = i < options->n_switches
+            ? (options->n_switches - i - 1) / options->n_routers + 1
+            : 0;
+        size_t n_lr_nats = MIN(options->n_nats,
+                               (size_t) n_lr_switches * options->n_ports);
+        struct sset logical_ips = SSET_INITIALIZER(&logical_ips);
+        while (sset_count(&logical_ips) < n_lr_nats) {
+            unsigned int ls = i + random_range(n_lr_switches)
+                                  * options->n_routers;
+            char *logical_ip = nbgen_port_ip(ls,
+                                             random_range(options->n_ports));
+            if (!sset_add(&logical_ips, logical_ip)) {
+                free(logical_ip);
+                continue;
+            }
+            char *external_ip = nbgen_ip(100, (64 << 16) + n_nats++);
+
+            struct json *nat = json_object_create();
+            json_object_put_string(nat, "type", "dnat_and_snat");
+            json_object_put_string(nat, "external_ip", external_ip);
+            json_object_put_string(nat, "logical_ip", logical_ip);
+            uuid = nbgen_insert(gen, "NAT", nat);
+            json_array_add(lr->nats, nbgen_ref(&uuid));
+
+            free(logical_ip);
+            free(external_ip);
+        }
+        sset_destroy(&logical_ips);
+
+        /* Host routes of 200.0.0.0/8 through the external network. */
+        for (unsigned int j = 0; j < options->n_routes; j++) {
+            char *prefix = nbgen_ip(200, n_routes++);
+
+            struct json *route = json_object_create();
+            nbgen_put_format(route, "ip_prefix", "%s/32", prefix);
+            json_object_put_string(route, "nexthop", "172.16.0.1");
+            uuid = nbgen_insert(gen, "Logical_Router_Static_Route", route);
+            json_array_add(lr->routes, nbgen_ref(&uuid));
+
+            free(prefix);
+        }
+
+        free(lrp_name);
+        free(ext_ip);
+        free(mac);
+    }
+
+    struct json *ls = json_object_create();
+    json_object_put_string(ls, "name", "ext");
+    json_object_put(ls, "ports", nbgen_set(ports));
+    nbgen_insert(gen, "Logical_Switch", ls);
+}
+
+/* Adds the address sets and the port groups, with the VIF ports in 'vifs'
+ * and their ACLs. */
+static void
+nbgen_build_acls(struct nbgen *gen, const struct nbgen_options *options,
+                 const struct vector *vifs)
+{
+    for (unsigned int i = 0; i < options->n_address_sets; i++) {
+        struct json *addresses = json_array_create_empty();
+
+        for (unsigned int j = 0; j < options->address_set_size; j++) {
+            json_array_add(addresses, json_string_create_nocopy(
+                                          nbgen_random_port_ip(options)));
+        }
+
+        struct json *as = json_object_create();
+        nbgen_put_format(as, "name", "as%u", i);
+        json_object_put(as, "addresses", nbgen_set(addresses));
+        nbgen_insert(gen, "Address_Set", as);
+    }
+
+    for (unsigned int i = 0; i < options->n_port_groups; i++) {
+        struct json *ports = json_array_create_empty();
+        struct json *acls = json_array_create_empty();
+
+        for (size_t j = i; j < vector_len(vifs);
+             j += options->n_port_groups) {
+            json_array_add(ports, nbgen_ref(vector_get_ptr(vifs, j)));
+        }
+
+        /* Alternate rules allowing TCP connections from and to an address
+         * set, or the whole 10.0.0.0/8 network when there are no address
+         * sets. */
+        for (unsigned int j = 0; j < options->n_acls; j++) {
+            bool to_lport = j % 2;
+            struct ds match = DS_EMPTY_INITIALIZER;
+
+            ds_put_format(&match, "%s == @pg%u && ip4 && ip4.%s == ",
+                          to_lport ? "outport" : "inport", i,
+                          to_lport ? "src" : "dst");
+            if (options->n_address_sets) {
+                ds_put_format(&match, "$as%"PRIu32,
+                              random_range(options->n_address_sets));
+            } else {
+                ds_put_cstr(&match, "10.0.0.0/8");
+            }
+            ds_put_format(&match, " && tcp.dst == %u", 1024 + j);
+
+            struct json *acl = json_object_create();
+            json_object_put(acl, "priority", json_integer_create(1000 + j));
+            json_object_put_string(acl, "direction",
+                                   to_lport ? "to-lport" : "from-lport");
+            json_object_put_string(acl, "match", ds_cstr(&match));
+            json_object_put_string(acl, "action", "allow-related");
+            struct uuid uuid = nbgen_insert(gen, "ACL", acl);
+            json_array_add(acls, nbgen_ref(&uuid));
+
+            ds_destroy(&match);
+        }
+
+        struct json *pg = json_object_create();
+        nbgen_put_format(pg, "name", "pg%u", i);
+        json_object_put(pg, "ports", nbgen_set(ports));
+        json_object_put(pg, "acls", nbgen_set(acls));
+        nbgen_insert(gen, "Port_Group", pg);
+    }
+}
+
+static void
+nbgen_build(struct nbgen *gen, const struct nbgen_options *options)
+{
+    struct nbgen_router *routers = xcalloc(options->n_routers,
+                                           sizeof *routers);
+    struct vector vifs = VECTOR_EMPTY_INITIALIZER(struct uuid);
+
+    nbgen_insert(gen, "NB_Global", json_object_create());
+
+    for (unsigned int i = 0; i < options->n_routers; i++) {
+        routers[i].ports = json_array_create_empty();
+        routers[i].nats = json_array_create_empty();
+        routers[i].routes = json_array_create_empty();
+    }
+
+    struct json *lbg = nbgen_build_lbs(gen, options);
+    nbgen_build_switches(gen, options, lbg, routers, &vifs);
+    nbgen_build_external(gen, options, routers);
+    nbgen_build_acls(gen, options, &vifs);
+
+    for (unsigned int i = 0; i < options->n_routers; i++) {
+        struct nbgen_router *lr = &routers[i];
+        struct json *row = json_object_create();
+
+        nbgen_put_format(row, "name", "lr%u", i);
+        json_object_put(row, "ports", nbgen_set(lr->ports));
+        json_object_put(row, "nat", nbgen_set(lr->nats));
+        json_object_put(row, "static_routes", nbgen_set(lr->routes));
+        if (lbg) {
+            json_object_put(row, "load_balancer_group", json_clone(lbg));
+        }
+        nbgen_insert(gen, "Logical_Router", row);
+    }
+
+    json_destroy(lbg);
+    vector_destroy(&vifs);
+    free(routers);
+}
+
+/* Replays 'txn' into an in-memory database with the schema in
+ * 'schema_file', which validates it, and writes the database to 'db_file',
+ * which must not exist. */
+static void
+nbgen_write(struct json *txn, const char *schema_file, const char *db_file)
+{
+    struct ovsdb_schema *schema;
+    struct ovsdb_error *error = ovsdb_schema_from_file(schema_file, &schema);
+    if (error) {
+        ovs_fatal(0, "%s", ovsdb_error_to_string_free(error));
+    }
+
+    struct ovsdb *db =
+        ovsdb_create(schema, ovsdb_storage_create_unbacked(schema->name));
+    struct ovsdb_txn *db_txn;
+
+    error = ovsdb_file_txn_from_json(db, txn, false, &db_txn);
+    if (!error) {
+        error = ovsdb_txn_replay_commit(db_txn);
+    }
+    if (error) {
+        ovs_fatal(0, "invalid topology: %s",
+                  ovsdb_error_to_string_free(error));
+    }
+
+    struct ovsdb_log *log;
+    error = ovsdb_log_open(db_file, OVSDB_MAGIC, OVSDB_LOG_CREATE_EXCL, -1,
+                           &log);
+    if (!error) {
+        error = ovsdb_log_write_and_free(log,
+                                         ovsdb_schema_to_json(db->schema));
+    }
+    if (!error) {
+        error = ovsdb_log_write_and_free(
+            log, ovsdb_to_txn_json(db, "generated by ovn-nbgen", true));
+    }
+    if (!error) {
+        error = ovsdb_log_commit_block(log);
+    }
+    if (error) {
+        ovs_fatal(0, "%s", ovsdb_error_to_string_free(error));
+    }
+
+    ovsdb_log_close(log);
+    ovsdb_destroy(db);
+}
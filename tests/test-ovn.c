@@ -20,6 +20,7 @@
 #include <sys/wait.h>
 
 #include "command-line.h"
+#include "coverage.h"
 #include "dp-packet.h"
 #include "fatal-signal.h"
 #include "flow.h"
@@ -39,6 +40,7 @@
 #include "ovstest.h"
 #include "openvswitch/shash.h"
 #include "simap.h"
+#include "timeval.h"
 #include "util.h"
 #include "controller/lflow.h"
 
@@ -61,6 +63,14 @@ static enum { OP_CONVERT, OP_SIMPLIFY, OP_NORMALIZE, OP_FLOW } operation
 /* --parallel: Number of parallel processes to use in test. */
 static int test_parallel = 1;
 
+/* --iterations: Number of times each expression is compiled, in
+ * benchmark-expr. */
+static int test_iterations = 100;
+
+/* --outlier-matches: Number of matches from which an expression is reported
+ * as an outlier, in benchmark-expr. */
+static unsigned int test_outlier_matches = 100;
+
 /* -m, --more: Message verbosity */
 static int verbosity;
 
@@ -401,6 +411,310 @@ test_expr_to_flows(struct ovs_cmdl_context *ctx OVS_UNUSED)
     test_parse_expr__(4);
 }
 
+/* Benchmark the expression compiler. */
+
+enum expr_bench_stage {
+    EXPR_BENCH_PARSE,
+    EXPR_BENCH_ANNOTATE,
+    EXPR_BENCH_SIMPLIFY,
+    EXPR_BENCH_NORMALIZE,
+    EXPR_BENCH_TO_MATCHES,
+    EXPR_BENCH_N_STAGES
+};
+
+static const char *expr_bench_stage_names[EXPR_BENCH_N_STAGES] = {
+    [EXPR_BENCH_PARSE] = "parse",
+    [EXPR_BENCH_ANNOTATE] = "annotate",
+    [EXPR_BENCH_SIMPLIFY] = "simplify",
+    [EXPR_BENCH_NORMALIZE] = "normalize",
+    [EXPR_BENCH_TO_MATCHES] = "to-matches",
+};
+
+struct expr_bench_totals {
+    long long int usec;
+    unsigned long long int n_allocs;
+};
+
+/* Results for one expression of the corpus, for all the iterations. */
+struct expr_bench_result {
+    struct expr_bench_totals stages[EXPR_BENCH_N_STAGES];
+    size_t n_matches;
+    char *error;
+};
+
+/* Returns the number of memory allocations done so far through xmalloc()
+ * and friends. */
+static unsigned long long int
+expr_bench_n_allocs(void)
+{
+    unsigned long long int count = 0;
+
+    coverage_read_counter("util_xalloc", &count);
+    return count;
+}
+
+static void
+expr_bench_stage_start(struct expr_bench_totals *totals)
+{
+    totals->n_allocs -= expr_bench_n_allocs();
+    totals->usec -= time_usec();
+}
+
+static void
+expr_bench_stage_stop(struct expr_bench_totals *totals)
+{
+    totals->usec += time_usec();
+    totals->n_allocs += expr_bench_n_allocs();
+}
+
+/* Looks up the port, giving a new number to each new port name, so that
+ * no match is dropped because of an unknown port. */
+static bool
+expr_bench_lookup_port_cb(const void *ports_, const char *port_name,
+                          unsigned int *portp)
+{
+    struct simap *ports = CONST_CAST(struct simap *, ports_);
+
+    *portp = simap_get(ports, port_name);
+    if (!*portp) {
+        *portp = simap_count(ports) + 1;
+        simap_put(ports, port_name, *portp);
+    }
+    return true;
+}
+
+static bool
+expr_bench_is_chassis_resident_cb(const void *aux OVS_UNUSED,
+                                  const char *port_name OVS_UNUSED)
+{
+    return true;
+}
+
+/* Compiles 's' 'test_iterations' times, each stage for all the iterations
+ * at once, so that the stages are timed separately, and accumulates the
+ * results in 'r'. */
+static void
+expr_bench_one(const char *s, const struct shash *symtab,
+               const struct shash *addr_sets, const struct shash *port_groups,
+               struct simap *ports, struct expr_bench_result *r)
+{
+    size_t n = test_iterations;
+    struct expr **exprs = xcalloc(n, sizeof *exprs);
+    struct hmap *matches = xcalloc(n, sizeof *matches);
+    struct expr_bench_totals *totals = r->stages;
+    char *error = NULL;
+
+    expr_bench_stage_start(&totals[EXPR_BENCH_PARSE]);
+    for (size_t i = 0; i < n && !error; i++) {
+        exprs[i] = expr_parse_string(s, symtab, addr_sets, port_groups, NULL,
+                                     NULL, 0, &error);
+    }
+    expr_bench_stage_stop(&totals[EXPR_BENCH_PARSE]);
+
+    expr_bench_stage_start(&totals[EXPR_BENCH_ANNOTATE]);
+    for (size_t i = 0; i < n && !error; i++) {
+        exprs[i] = expr_annotate(exprs[i], symtab, &error);
+    }
+    expr_bench_stage_stop(&totals[EXPR_BENCH_ANNOTATE]);
+
+    if (error) {
+        r->error = error;
+        goto exit;
+    }
+
+    /* Same as consider_logical_flow__() in ovn-controller. */
+    expr_bench_stage_start(&totals[EXPR_BENCH_SIMPLIFY]);
+    for (size_t i = 0; i < n; i++) {
+        exprs[i] = expr_evaluate_condition(expr_simplify(exprs[i]),
+                                           expr_bench_is_chassis_resident_cb,
+                                           NULL);
+    }
+    expr_bench_stage_stop(&totals[EXPR_BENCH_SIMPLIFY]);
+
+    expr_bench_stage_start(&totals[EXPR_BENCH_NORMALIZE]);
+    for (size_t i = 0; i < n; i++) {
+        exprs[i] = expr_normalize(exprs[i]);
+    }
+    expr_bench_stage_stop(&totals[EXPR_BENCH_NORMALIZE]);
+
+    expr_bench_stage_start(&totals[EXPR_BENCH_TO_MATCHES]);
+    for (size_t i = 0; i < n; i++) {
+        expr_to_matches(exprs[i], expr_bench_lookup_port_cb, ports,
+                        &matches[i]);
+    }
+    expr_bench_stage_stop(&totals[EXPR_BENCH_TO_MATCHES]);
+
+    r->n_matches = n ? hmap_count(&matches[0]) : 0;
+    for (size_t i = 0; i < n; i++) {
+        expr_matches_destroy(&matches[i]);
+    }
+
+exit:
+    for (size_t i = 0; i < n; i++) {
+        expr_destroy(exprs[i]);
+    }
+    free(matches);
+    free(exprs);
+}
+
+static void
+expr_bench_print_stage(const char *name, const struct expr_bench_totals *t,
+                       size_t n_ops)
+{
+    printf("%-12s %12.2f %12.0f %12.1f\n", name,
+           (double) t->usec / n_ops, n_ops * 1e6 / MAX(t->usec, 1),
+           (double) t->n_allocs / n_ops);
+}
+
+/* Adds the constant set defined by 'line', which has the form "address-set
+ * NAME VALUE..." or "port-group NAME PORT...", to 'addr_sets' or
+ * 'port_groups'.  Returns false if 'line' isn't a definition. */
+static bool
+expr_bench_parse_set(const char *line, struct shash *addr_sets,
+                     struct shash *port_groups)
+{
+    char *copy = xstrdup(line);
+    char *save_ptr = NULL;
+    const char *keyword = strtok_r(copy, " \t", &save_ptr);
+    bool is_addr_set = keyword && !strcmp(keyword, "address-set");
+    bool is_port_group = keyword && !strcmp(keyword, "port-group");
+
+    if (is_addr_set || is_port_group) {
+        const char *name = strtok_r(NULL, " \t", &save_ptr);
+        const char **values = NULL;
+        size_t n_values = 0;
+        size_t allocated_values = 0;
+        char *value;
+
+        if (!name) {
+            ovs_fatal(0, "%s: missing set name", line);
+        }
+        while ((value = strtok_r(NULL, " \t", &save_ptr)) != NULL) {
+            if (n_values >= allocated_values) {
+                values = x2nrealloc(values, &allocated_values,
+                                    sizeof *values);
+            }
+            values[n_values++] = value;
+        }
+
+        if (is_addr_set) {
+            expr_const_sets_add_integers(addr_sets, name, values, n_values);
+        } else {
+            /* The expressions are parsed for datapath 0. */
+            struct ds sb_name = DS_EMPTY_INITIALIZER;
+
+            get_sb_port_group_name(name, 0, &sb_name);
+            expr_const_sets_add_strings(port_groups, ds_cstr(&sb_name),
+                                        values, n_values, NULL);
+            ds_destroy(&sb_name);
+        }
+        free(values);
+    }
+
+    free(copy);
+    return is_addr_set || is_port_group;
+}
+
+static void
+test_benchmark_expr(struct ovs_cmdl_context *ctx OVS_UNUSED)
+{
+    struct shash symtab;
+    struct shash addr_sets;
+    struct shash port_groups;
+    struct simap ports;
+    struct ds input;
+
+    if (test_iterations <= 0) {
+        ovs_fatal(0, "number of iterations must be positive");
+    }
+
+    ovn_init_symtab(&symtab);
+    shash_init(&addr_sets);
+    shash_init(&port_groups);
+    simap_init(&ports);
+
+    struct expr_bench_totals totals[EXPR_BENCH_N_STAGES];
+    size_t n_exprs = 0, n_errors = 0, n_matches = 0, n_outliers = 0;
+    struct ds outliers = DS_EMPTY_INITIALIZER;
+    struct ds errors = DS_EMPTY_INITIALIZER;
+    int line_number = 0;
+
+    memset(totals, 0, sizeof totals);
+    ds_init(&input);
+    while (!ds_get_line(&input, stdin)) {
+        const char *s = ds_cstr(&input);
+
+        line_number++;
+        s += strspn(s, " \t");
+        if (!*s || *s == '#'
+            || expr_bench_parse_set(s, &addr_sets, &port_groups)) {
+            continue;
+        }
+
+        struct expr_bench_result r;
+        memset(&r, 0, sizeof r);
+        expr_bench_one(s, &symtab, &addr_sets, &port_groups, &ports, &r);
+
+        if (r.error) {
+            ds_put_format(&errors, "  line %d: %s\n", line_number, r.error);
+            n_errors++;
+            free(r.error);
+            continue;
+        }
+
+        for (size_t i = 0; i < EXPR_BENCH_N_STAGES; i++) {
+            totals[i].usec += r.stages[i].usec;
+            totals[i].n_allocs += r.stages[i].n_allocs;
+        }
+        n_exprs++;
+        n_matches += r.n_matches;
+
+        if (r.n_matches >= test_outlier_matches) {
+            const struct expr_bench_totals *t =
+                &r.stages[EXPR_BENCH_TO_MATCHES];
+
+            ds_put_format(&outliers, "  line %d: %"PRIuSIZE" matches, "
+                          "%.2f usec and %.1f allocations in to-matches\n"
+                          "    %s\n", line_number, r.n_matches,
+                          (double) t->usec / test_iterations,
+                          (double) t->n_allocs / test_iterations, s);
+            n_outliers++;
+        }
+    }
+    ds_destroy(&input);
+
+    size_t n_ops = MAX(n_exprs * test_iterations, 1);
+    struct expr_bench_totals total = { 0, 0 };
+
+    printf("Expressions: %"PRIuSIZE", errors: %"PRIuSIZE", "
+           "iterations: %d\n", n_exprs, n_errors, test_iterations);
+    printf("Matches: %"PRIuSIZE"\n\n", n_matches);
+    printf("%-12s %12s %12s %12s\n", "stage", "usec/expr", "expr/sec",
+           "allocs/expr");
+    for (size_t i = 0; i < EXPR_BENCH_N_STAGES; i++) {
+        expr_bench_print_stage(expr_bench_stage_names[i], &totals[i], n_ops);
+        total.usec += totals[i].usec;
+        total.n_allocs += totals[i].n_allocs;
+    }
+    expr_bench_print_stage("total", &total, n_ops);
+
+    printf("\nOutliers (at least %u matches): %"PRIuSIZE"\n%s",
+           test_outlier_matches, n_outliers, ds_cstr(&outliers));
+    if (n_errors) {
+        printf("\nErrors:\n%s", ds_cstr(&errors));
+    }
+
+    ds_destroy(&outliers);
+    ds_destroy(&errors);
+    simap_destroy(&ports);
+    expr_symtab_destroy(&symtab);
+    shash_destroy(&symtab);
+    expr_const_sets_destroy(&addr_sets);
+    shash_destroy(&addr_sets);
+    expr_const_sets_destroy(&port_groups);
+    shash_destroy(&port_groups);
+}
+
 /* Print the symbol table. */
 
 static void
@@ -1539,6 +1853,19 @@ expr-to-packets\n\
   Parses OVN expressions from stdin and prints out matching packets in\n\
   hexadecimal on stdout.\n\
 \n\
+benchmark-expr\n\
+  Compiles the OVN expressions from stdin, e.g., the matches of the\n\
+  Logical_Flow table, and prints the time and the number of memory\n\
+  allocations per expression of each stage: parse, annotate, simplify,\n\
+  normalize and to-matches.  Lines \"address-set NAME VALUE...\" and\n\
+  \"port-group NAME PORT...\" define the sets used by the expressions.\n\
+  Empty lines and lines starting with '#' are ignored.\n\
+  Available options:\n\
+    --iterations=N  Number of times each expression is compiled, default\n\
+        100.\n\
+    --outlier-matches=N  Report the expressions that generate at least N\n\
+        matches, default 100.\n\
+\n\
 evaluate-expr MICROFLOW\n\
   Parses OVN expressions from stdin and evaluates them against the flow\n\
   specified in MICROFLOW, which must be an expression that constrains\n\
@@ -1593,7 +1920,9 @@ test_ovn_main(int argc, char *argv[])
         OPT_SVARS,
         OPT_BITS,
         OPT_OPERATION,
-        OPT_PARALLEL
+        OPT_PARALLEL,
+        OPT_ITERATIONS,
+        OPT_OUTLIER_MATCHES
     };
     static const struct option long_options[] = {
         {"relops", required_argument, NULL, OPT_RELOPS},
@@ -1602,6 +1931,8 @@ test_ovn_main(int argc, char *argv[])
         {"bits", required_argument, NULL, OPT_BITS},
         {"operation", required_argument, NULL, OPT_OPERATION},
         {"parallel", required_argument, NULL, OPT_PARALLEL},
+        {"iterations", required_argument, NULL, OPT_ITERATIONS},
+        {"outlier-matches", required_argument, NULL, OPT_OUTLIER_MATCHES},
         {"more", no_argument, NULL, 'm'},
         {"help", no_argument, NULL, 'h'},
         {NULL, 0, NULL, 0},
@@ -1665,6 +1996,16 @@ test_ovn_main(int argc, char *argv[])
             test_parallel = atoi(optarg);
             break;
 
+        case OPT_ITERATIONS:
+            test_iterations = atoi(optarg);
+            break;
+
+        case OPT_OUTLIER_MATCHES:
+            if (!str_to_uint(optarg, 10, &test_outlier_matches)) {
+                ovs_fatal(0, "%s: invalid number of matches", optarg);
+            }
+            break;
+
         case 'm':
             verbosity++;
             break;
@@ -1700,6 +2041,7 @@ test_ovn_main(int argc, char *argv[])
         {"tree-shape", NULL, 1, 1, test_tree_shape, OVS_RO},
         {"exhaustive", NULL, 1, 1, test_exhaustive, OVS_RO},
         {"expr-to-packets", NULL, 0, 0, test_expr_to_packets, OVS_RO},
+        {"benchmark-expr", NULL, 0, 0, test_benchmark_expr, OVS_RO},
 
         /* Actions. */
         {"parse-actions", NULL, 0, 0, test_parse_actions, OVS_RO},
@@ -0,0 +1,151 @@
+/* Copyright (c) 2026, Red Hat, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+
+#include <limits.h>
+
+#include "lib/timer-wheel.h"
+#include "lib/ovn-util.h"
+#include "random.h"
+#include "tests/ovstest.h"
+
+struct test_timer {
+    struct timer_wheel_node node;
+    long long int expires;
+    bool expired;
+};
+
+static void
+test_schedule_cancel(struct ovs_cmdl_context *ctx OVS_UNUSED)
+{
+    struct timer_wheel tw;
+    long long int now = 1000;
+    timer_wheel_init(&tw, now);
+    ovs_assert(timer_wheel_is_empty(&tw));
+    ovs_assert(timer_wheel_next_expiry(&tw) == LLONG_MAX);
+
+    struct test_timer timers[3];
+    for (size_t i = 0; i < ARRAY_SIZE(timers); i++) {
+        timer_wheel_node_init(&timers[i].node);
+        ovs_assert(!timer_wheel_node_is_scheduled(&timers[i].node));
+    }
+
+    /* One timer on each of the first three levels. */
+    timer_wheel_schedule(&tw, &timers[0].node, now + 10);
+    timer_wheel_schedule(&tw, &timers[1].node, now + 100);
+    timer_wheel_schedule(&tw, &timers[2].node, now + 10000);
+    ovs_assert(timer_wheel_count(&tw) == 3);
+    ovs_assert(timer_wheel_next_expiry(&tw) == now + 10);
+
+    /* Nothing is due yet. */
+    ovs_assert(!timer_wheel_pop(&tw, now + 9));
+
+    timer_wheel_cancel(&tw, &timers[0].node);
+    ovs_assert(!timer_wheel_node_is_scheduled(&timers[0].node));
+    ovs_assert(timer_wheel_count(&tw) == 2);
+    ovs_assert(!timer_wheel_pop(&tw, now + 50));
+
+    /* Rescheduling moves the timer. */
+    timer_wheel_schedule(&tw, &timers[2].node, now + 60);
+    ovs_assert(timer_wheel_count(&tw) == 2);
+    ovs_assert(timer_wheel_pop(&tw, now + 60) == &timers[2].node);
+    ovs_assert(!timer_wheel_pop(&tw, now + 60));
+
+    ovs_assert(timer_wheel_pop(&tw, now + 200) == &timers[1].node);
+    ovs_assert(timer_wheel_is_empty(&tw));
+
+    /* Timers scheduled in the past expire right away. */
+    timer_wheel_schedule(&tw, &timers[0].node, now);
+    ovs_assert(timer_wheel_next_expiry(&tw) <= now + 200);
+    ovs_assert(timer_wheel_pop(&tw, now + 200) == &timers[0].node);
+    ovs_assert(timer_wheel_is_empty(&tw));
+
+    timer_wheel_destroy(&tw);
+}
+
+static void
+test_random(struct ovs_cmdl_context *ctx OVS_UNUSED)
+{
+    enum { N_TIMERS = 10000 };
+    struct test_timer *timers = xcalloc(N_TIMERS, sizeof *timers);
+    struct timer_wheel tw;
+    long long int now = random_uint32();
+    size_t n_scheduled = 0;
+
+    timer_wheel_init(&tw, now);
+    for (size_t i = 0; i < N_TIMERS; i++) {
+        struct test_timer *t = &timers[i];
+
+        /* Mostly short delays, but some beyond the range of the wheel. */
+        long long int delay = i % 10 ? random_range(20000)
+                                     : random_range(30000000);
+        t->expires = now + delay;
+        timer_wheel_node_init(&t->node);
+        timer_wheel_schedule(&tw, &t->node, t->expires);
+        n_scheduled++;
+    }
+
+    /* Cancel a few timers. */
+    for (size_t i = 0; i < N_TIMERS; i += 7) {
+        timer_wheel_cancel(&tw, &timers[i].node);
+        timers[i].expired = true;
+        n_scheduled--;
+    }
+    ovs_assert(timer_wheel_count(&tw) == n_scheduled);
+
+    /* Wake up exactly when the wheel asks to, every timer must expire at
+     * its expiration time. */
+    long long int next;
+    while ((next = timer_wheel_next_expiry(&tw)) != LLONG_MAX) {
+        ovs_assert(next >= now);
+        now = next;
+
+        struct timer_wheel_node *node;
+        while ((node = timer_wheel_pop(&tw, now))) {
+            struct test_timer *t = CONTAINER_OF(node, struct test_timer,
+                                                node);
+            ovs_assert(!t->expired);
+            ovs_assert(t->expires == now);
+            t->expired = true;
+            n_scheduled--;
+        }
+    }
+
+    ovs_assert(!n_scheduled);
+    for (size_t i = 0; i < N_TIMERS; i++) {
+        ovs_assert(timers[i].expired);
+    }
+
+    timer_wheel_destroy(&tw);
+    free(timers);
+}
+
+static void
+test_timer_wheel_main(int argc OVS_UNUSED, char *argv[] OVS_UNUSED)
+{
+    ovn_set_program_name(argv[0]);
+    static const struct ovs_cmdl_command commands[] = {
+        {"schedule-cancel", NULL, 0, 0, test_schedule_cancel, OVS_RO},
+        {"random",          NULL, 0, 0, test_random,          OVS_RO},
+        {NULL,              NULL, 0, 0, NULL,                 OVS_RO},
+    };
+    struct ovs_cmdl_context ctx;
+    ctx.argc = argc - 1;
+    ctx.argv = argv + 1;
+    ovs_cmdl_run_command(&ctx, commands);
+}
+
+OVSTEST_REGISTER("test-timer-wheel", test_timer_wheel_main);